@@ -370,6 +370,54 @@ protected:
 };
 using SeparableFilter = SeparableFilterForward;
 
+/**
+ * \brief resize, color conversion, normalization and layout conversion of
+ * an image in one pass
+ *
+ * src is an NHWC uint8 image, scale and bias are float32 tensors of shape
+ * (C,). dst(n, c, h, w) = resize(src)(n, h, w, c') * scale[c] + bias[c], where
+ * c' is c, or 2 - c for ColorMode::SWAP_RB. resize(src) is the uint8 result
+ * of an NHWC Resize on the same handle, including its rounding and saturation.
+ *
+ * dst is NCHW (N, C, OH, OW) or NCHW88 (N, ceil(C / 8), OH, OW, 8) with the
+ * padded channels set to zero; its dtype is Float32, or QuantizedS8 to be
+ * quantized as TypeCvt does.
+ */
+class ImagePreprocessBase : public OperatorBase {
+    DEF_OPR_IMPL_CTOR(ImagePreprocessBase, OperatorBase);
+    DEF_OPR_PARAM(ImagePreprocess);
+
+protected:
+    void deduce_layout_fwd(
+            const TensorLayout& src, const TensorLayout& scale,
+            const TensorLayout& bias, TensorLayout& dst);
+    void check_layout_fwd(
+            const TensorLayout& src, const TensorLayout& scale,
+            const TensorLayout& bias, const TensorLayout& dst);
+};
+
+class ImagePreprocessForward : public ImagePreprocessBase {
+    DEF_OPR_IMPL(ImagePreprocessForward, ImagePreprocessBase, 3, 1);
+
+public:
+    virtual void exec(
+            _megdnn_tensor_in src, _megdnn_tensor_in scale, _megdnn_tensor_in bias,
+            _megdnn_tensor_out dst, _megdnn_workspace workspace) = 0;
+    void deduce_layout(
+            const TensorLayout& src, const TensorLayout& scale,
+            const TensorLayout& bias, TensorLayout& dst);
+    virtual size_t get_workspace_in_bytes(
+            const TensorLayout& src, const TensorLayout& scale,
+            const TensorLayout& bias, const TensorLayout& dst) = 0;
+
+protected:
+    void check_exec(
+            const TensorLayout& src, const TensorLayout& scale,
+            const TensorLayout& bias, const TensorLayout& dst,
+            size_t workspace_in_bytes);
+};
+using ImagePreprocess = ImagePreprocessForward;
+
 }  // namespace megdnn
 
 #include "megdnn/internal/opr_header_epilogue.h"
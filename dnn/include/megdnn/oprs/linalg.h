@@ -80,6 +80,20 @@ public:
 
     static size_t pack_size(const Param::Format format);
 
+    //! bytes of one group of 32 weights in Format::W4_G32: a float32 scale
+    //! followed by 16 bytes of packed nibbles
+    static constexpr size_t w4_g32_group_bytes() { return 20; }
+
+    //! bytes of one block in Format::BSR_8X1: its int32 column and its 8
+    //! float32 values
+    static constexpr size_t bsr_8x1_block_bytes() { return 36; }
+
+    //! bytes of one block row in Format::BSR_8X1 holding at most max_nr_blocks
+    //! blocks, including the leading int32 number of blocks
+    static constexpr size_t bsr_8x1_row_bytes(size_t max_nr_blocks) {
+        return 4 + bsr_8x1_block_bytes() * max_nr_blocks;
+    }
+
     static Algorithm::OprType get_opr_type() {
         return Algorithm::OprType::MATRIX_MUL_FORWARD;
     }
@@ -544,7 +544,20 @@ pdef('PowC', 'power with constant exponent').add_fields('float32', 'exp', 0)
               'layout is (K/8, M/8, 8(k), 8(m)) x (K/8, N, 8(k))'),
           Doc('MK4_DOT = 3', 'Split 4 from M and K, better for neon dotprod:'
               'M/4, K/4, 4(m), 4(k)) x (K/4, N, 4(k)). if transposeA the '
-              'layout is (K/4, M/4, 4(m), 4(k)) x (K/4, N, 4(k))'))
+              'layout is (K/4, M/4, 4(m), 4(k)) x (K/4, N, 4(k))'),
+          Doc('W4_G32 = 4', 'Weight-only int4 with per-group scales: '
+              '(M, K) float32 x (N, K/32 * 20) byte = (M, N) float32. Row n '
+              'of B holds column n of the (K, N) weight as K/32 groups of 20 '
+              'bytes: a float32 scale followed by 16 bytes where byte j '
+              'stores q[j] in its low nibble and q[j + 16] in its high '
+              'nibble; q is signed 4-bit and the weight is scale * q. '
+              'transposeA and transposeB must be false'),
+          Doc('BSR_8X1 = 5', 'Block sparse A: (M/8, 4 + 36 * L) byte x (K, N) '
+              'float32 = (M, N) float32. The (M, K) float32 A is split into '
+              'blocks of 8 rows and 1 column; row r of A holds block row r '
+              'padded to L blocks: an int32 number b of non-zero blocks, L '
+              'int32 block columns and L blocks of 8 float32 values, of '
+              'which only the first b are used. transposeA must be false'))
  )
 
 (pdef('SVD').
@@ -846,6 +859,20 @@ pdef('Sleep').add_fields('float32', Doc('time', 'time to sleep in seconds'), 0)
  .add_enum_alias('InterpolationMode', 'WarpPerspectiveV1', name_field='imode')
  .add_enum_alias('Format', 'Convolution', default=1))
 
+(pdef('ImagePreprocess',
+      'resize an NHWC uint8 image, optionally swap its R and B channels, and '
+      'compute x * scale[c] + bias[c] for each channel in one pass')
+ .add_enum_alias('InterpolationMode', 'WarpPerspectiveV1', name_field='imode')
+ .add_enum('ColorMode',
+           Doc('NONE = 0', 'keep the channel order'),
+           Doc('SWAP_RB = 1', 'reverse the 3 channels, as RGB2BGR and BGR2RGB '
+               'of CvtColor'),
+           name_field='color_mode')
+ .add_enum_alias('Format', 'Convolution')
+ .add_fields('uint32',
+             Doc('out_h', 'height of the output, 0 to keep the input height'), 0,
+             Doc('out_w', 'width of the output, 0 to keep the input width'), 0))
+
 (pdef('Remap', version=0,is_legacy=True)
  .add_enum_alias('InterpolationMode', 'WarpPerspectiveV1', name_field='imode')
  .add_enum_alias('BorderMode', 'WarpPerspectiveV1', name_field='border_type')
@@ -0,0 +1,182 @@
+/**
+ * \file dnn/src/arm_common/convpooling/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/arm_common/convpooling/opr_impl.h"
+#include "src/arm_common/simd_macro/marm_neon.h"
+#include "src/fallback/convpooling/convpooling_helper.h"
+
+#include "src/common/utils.h"
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_arm_common_convpooling)
+
+namespace {
+
+using namespace megdnn;
+using namespace fallback::convpooling;
+
+//! 4 input columns of consecutive output columns for conv stride SW
+template <size_t SW>
+struct LoadCols;
+
+template <>
+struct LoadCols<1> {
+    static float32x4_t load(const float* ptr) { return vld1q_f32(ptr); }
+};
+
+template <>
+struct LoadCols<2> {
+    //! even elements of ptr[0, 8)
+    static float32x4_t load(const float* ptr) { return vld2q_f32(ptr).val[0]; }
+};
+
+/*!
+ * \brief output columns [c, c + nr_vec * 4) of a conv row, with bias
+ *
+ * Each filter tap is loaded once and used for nr_vec registers. The caller
+ * ensures that all the input columns read are inside the row.
+ */
+template <size_t SW, int nr_vec>
+void conv_block(
+        const KernParam& p, const float* src, const float* filter, float bias,
+        size_t oc, ptrdiff_t ih0, size_t c, float* out) {
+    float32x4_t acc[nr_vec];
+    for (int i = 0; i < nr_vec; ++i) {
+        acc[i] = vdupq_n_f32(bias);
+    }
+    for (size_t ic = 0; ic < p.IC; ++ic) {
+        const float* fptr = filter + (oc * p.IC + ic) * p.FH * p.FW;
+        for (size_t kh = 0; kh < p.FH; ++kh) {
+            ptrdiff_t ih = ih0 + static_cast<ptrdiff_t>(kh);
+            if (ih < 0 || ih >= static_cast<ptrdiff_t>(p.IH))
+                continue;
+            const float* in = src + (ic * p.IH + ih) * p.IW + c * SW - p.PW;
+            for (size_t kw = 0; kw < p.FW; ++kw) {
+                float w = p.weight(fptr, kh, kw);
+                for (int i = 0; i < nr_vec; ++i) {
+                    acc[i] = vmlaq_n_f32(
+                            acc[i], LoadCols<SW>::load(in + kw + i * 4 * SW), w);
+                }
+            }
+        }
+    }
+    for (int i = 0; i < nr_vec; ++i) {
+        vst1q_f32(out + c + i * 4, acc[i]);
+    }
+}
+
+template <size_t SW>
+void conv_row_sw(
+        const KernParam& p, const float* src, const float* filter, float bias,
+        size_t oc, size_t r, float* out) {
+    ptrdiff_t ih0 = static_cast<ptrdiff_t>(r * p.SH) - static_cast<ptrdiff_t>(p.PH);
+    //! output columns in [v_begin, v_end) read input columns inside the row,
+    //! including the odd column after the last one read by stride 2
+    size_t v_begin = div_ceil(p.PW, SW), v_end = 0;
+    ptrdiff_t last = static_cast<ptrdiff_t>(p.IW + p.PW) -
+                     static_cast<ptrdiff_t>(p.FW + SW - 1);
+    if (last >= 0) {
+        v_end = std::min(p.CW, static_cast<size_t>(last) / SW + 1);
+    }
+    if (v_begin >= v_end) {
+        conv_cols(p, src, filter, bias, oc, r, out, 0, p.CW);
+        return;
+    }
+    conv_cols(p, src, filter, bias, oc, r, out, 0, v_begin);
+    size_t c = v_begin;
+    for (; c + 16 <= v_end; c += 16) {
+        conv_block<SW, 4>(p, src, filter, bias, oc, ih0, c, out);
+    }
+    for (; c + 4 <= v_end; c += 4) {
+        conv_block<SW, 1>(p, src, filter, bias, oc, ih0, c, out);
+    }
+    conv_cols(p, src, filter, bias, oc, r, out, c, p.CW);
+}
+
+struct ConvPoolingKernNeon {
+    using Scalar = ScalarConvPoolingKern;
+
+    static void conv_row(
+            const KernParam& p, const float* src, const float* filter, float bias,
+            size_t oc, size_t r, float* out) {
+        if (p.SW == 1) {
+            conv_row_sw<1>(p, src, filter, bias, oc, r, out);
+        } else if (p.SW == 2) {
+            conv_row_sw<2>(p, src, filter, bias, oc, r, out);
+        } else {
+            Scalar::conv_row(p, src, filter, bias, oc, r, out);
+            return;
+        }
+        if (p.nonline == param::ConvPooling::NonlineMode::RELU) {
+            float32x4_t zero = vdupq_n_f32(0.f);
+            size_t c = 0;
+            for (; c + 4 <= p.CW; c += 4) {
+                vst1q_f32(out + c, vmaxq_f32(vld1q_f32(out + c), zero));
+            }
+            apply_nonline(p, out, c, p.CW);
+        } else {
+            apply_nonline(p, out, 0, p.CW);
+        }
+    }
+
+    static void pool_row(
+            const KernParam& p, const float* rows, size_t row_begin, size_t row_end,
+            float* vrow, float* dst_row) {
+        bool is_max = p.pool == param::ConvPooling::PoolMode::MAX;
+        float init = is_max ? -std::numeric_limits<float>::infinity() : 0.f;
+        size_t c = 0;
+        for (; c + 4 <= p.CW; c += 4) {
+            float32x4_t v = vdupq_n_f32(init);
+            for (size_t r = row_begin; r < row_end; ++r) {
+                float32x4_t x = vld1q_f32(rows + r % p.WH * p.CW + c);
+                v = is_max ? vmaxq_f32(v, x) : vaddq_f32(v, x);
+            }
+            vst1q_f32(vrow + c, v);
+        }
+        for (; c < p.CW; ++c) {
+            float v = init;
+            for (size_t r = row_begin; r < row_end; ++r) {
+                float x = rows[r % p.WH * p.CW + c];
+                v = is_max ? std::max(v, x) : v + x;
+            }
+            vrow[c] = v;
+        }
+        pool_cols(p, vrow, dst_row);
+    }
+};
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace arm_common {
+
+void ConvPoolingForwardImpl::exec(
+        const _megdnn_in TensorND src, const _megdnn_in TensorND filter,
+        const _megdnn_in TensorND bias, _megdnn_out TensorND dst,
+        _megdnn_out Workspace workspace) {
+    if (is_fused_available(src.layout, filter.layout, bias.layout, dst.layout)) {
+        auto p = make_kern_param(src.layout, filter.layout, bias.layout, dst.layout);
+        MIDOUT_BEGIN(megdnn_arm_common_convpooling, midout_iv(0)) {
+            fallback::convpooling::exec<ConvPoolingKernNeon>(
+                    static_cast<naive::HandleImpl*>(handle()), p, src, filter, bias,
+                    dst, workspace);
+            return;
+        }
+        MIDOUT_END();
+    }
+    fallback::ConvPoolingForwardImpl::exec(src, filter, bias, dst, workspace);
+}
+
+}  // namespace arm_common
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,31 @@
+/**
+ * \file dnn/src/arm_common/convpooling/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+#include "src/fallback/convpooling/opr_impl.h"
+
+namespace megdnn {
+namespace arm_common {
+
+//! the fused kernel of fallback with neon conv rows and vertical pooling
+class ConvPoolingForwardImpl : public fallback::ConvPoolingForwardImpl {
+public:
+    using fallback::ConvPoolingForwardImpl::ConvPoolingForwardImpl;
+    void exec(
+            const _megdnn_in TensorND src, const _megdnn_in TensorND filter,
+            const _megdnn_in TensorND bias, _megdnn_out TensorND dst,
+            _megdnn_out Workspace workspace) override;
+};
+
+}  // namespace arm_common
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
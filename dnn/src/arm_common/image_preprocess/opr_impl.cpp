@@ -0,0 +1,23 @@
+/**
+ * \file dnn/src/arm_common/image_preprocess/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/arm_common/image_preprocess/opr_impl.h"
+
+using namespace megdnn;
+using namespace arm_common;
+
+void ImagePreprocessForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_in scale, _megdnn_tensor_in bias,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    exec_with_resize(src, scale, bias, dst, workspace, true);
+}
+
+// vim: syntax=cpp.doxygen
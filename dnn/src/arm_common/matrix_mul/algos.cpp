@@ -13,6 +13,7 @@
 #include "src/arm_common/matrix_mul/exec_gemm_int8_int8_int16.h"
 #include "src/arm_common/matrix_mul/fp16/hgemv.h"
 #include "src/arm_common/matrix_mul/fp32/exec_sgemv.h"
+#include "src/arm_common/matrix_mul/fp32/gemm_bsr_8x1.h"
 #include "src/arm_common/matrix_mul/int8/gemv.h"
 
 #include "midout.h"
@@ -21,6 +22,7 @@ MIDOUT_DECL(megdnn_arm_hgemv)
 MIDOUT_DECL(megdnn_arm_exec_int8816)
 MIDOUT_DECL(megdnn_arm_exec_int8832)
 MIDOUT_DECL(megdnn_arm_exec_fp32)
+MIDOUT_DECL(megdnn_arm_exec_fp32_bsr_8x1)
 
 using namespace megdnn;
 using namespace arm_common;
@@ -380,4 +382,28 @@ MatrixMulImpl::kern_t MatrixMulImpl::AlgoF16Gemv::get_kern(const KernSizeParam&)
 }
 #endif
 
+/* ================== F32 BSR 8x1 algo ================== */
+MatrixMulImpl::kern_t MatrixMulImpl::AlgoF32BSR8x1::get_kern(
+        const KernSizeParam&) const {
+    auto f32_kern_bsr_8x1 = [](const MatrixMulImpl::KernParam& kern_param) {
+        MIDOUT_BEGIN(megdnn_arm_exec_fp32_bsr_8x1, midout_iv(0)) {
+            gemm_bsr_8x1_neon(
+                    kern_param.A<dt_byte>(), kern_param.LDA, kern_param.B<float>(),
+                    kern_param.LDB, kern_param.C<float>(), kern_param.LDC,
+                    kern_param.M, kern_param.N, kern_param.trB);
+        }
+        MIDOUT_END();
+    };
+    return f32_kern_bsr_8x1;
+}
+
+bool MatrixMulImpl::AlgoF32BSR8x1::usable(const KernSizeParam& kern_size_param) const {
+    return kern_size_param.format == param::MatrixMul::Format::BSR_8X1 &&
+           kern_size_param.compute_mode == Param::ComputeMode::DEFAULT &&
+           !kern_size_param.trA &&
+           kern_size_param.A_type.enumv() == DTypeEnum::Byte &&
+           kern_size_param.B_type.enumv() == DTypeEnum::Float32 &&
+           kern_size_param.C_type.enumv() == DTypeEnum::Float32;
+}
+
 // vim: syntax=cpp.doxygen
@@ -147,6 +147,18 @@ public:
     MEGDNN_DECL_ALGO_TYPE(ARM_COMMON_GEVM)
 };
 
+class MatrixMulImpl::AlgoF32BSR8x1 : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "ARM_COMMON_F32_BSR_8X1"; }
+    bool usable(const KernSizeParam&) const override;
+    size_t get_workspace(const KernSizeParam&) const override { return 0; }
+    kern_t get_kern(const KernSizeParam&) const override;
+    PackMode packmode() const override { return PackMode::NO_PACK; }
+    MEGDNN_OVERRIDE_MATMUL_DESC(8, 16, 1, 4, AlgoDataType::FLOAT32, BSR_8X1)
+    MEGDNN_DECL_ALGO_TYPE(ARM_COMMON_F32_BSR_8X1)
+};
+
 }  // namespace arm_common
 }  // namespace megdnn
 
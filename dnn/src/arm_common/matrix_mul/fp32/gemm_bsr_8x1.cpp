@@ -0,0 +1,187 @@
+/**
+ * \file dnn/src/arm_common/matrix_mul/fp32/gemm_bsr_8x1.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "src/arm_common/matrix_mul/fp32/gemm_bsr_8x1.h"
+
+#include "megdnn/oprs/linalg.h"
+#include "src/arm_common/simd_macro/marm_neon.h"
+#include "src/common/unroll_macro.h"
+#include "src/common/utils.h"
+
+#include <cstring>
+
+using namespace megdnn;
+using namespace arm_common;
+
+namespace {
+
+//! columns of C updated together by kern_cols()
+constexpr size_t MAX_COLS = 4;
+
+//! vectors of 4 columns updated together by kern_rows(); armv7 only has 16
+//! q registers, which are all taken by the accumulators of one vector
+#if MEGDNN_AARCH64
+constexpr size_t MAX_ROW_VEC = 2;
+#else
+constexpr size_t MAX_ROW_VEC = 1;
+#endif
+
+struct BlockRow {
+    int32_t nr_blocks;
+    const int32_t* cols;
+    const float* vals;
+
+    BlockRow(const dt_byte* row, size_t max_nr_blocks) {
+        memcpy(&nr_blocks, row, sizeof(int32_t));
+        cols = reinterpret_cast<const int32_t*>(row + sizeof(int32_t));
+        vals = reinterpret_cast<const float*>(
+                row + sizeof(int32_t) * (1 + max_nr_blocks));
+    }
+};
+
+/*!
+ * C[0:8, 0:4 * nr_vec] of one block row; each block is 8 values of A times
+ * 4 * nr_vec contiguous values in a row of B
+ */
+template <size_t nr_vec>
+void kern_rows(const BlockRow& row, const float* B, size_t LDB, float* C, size_t LDC) {
+    float32x4_t acc[8][2];
+#define cb(i)                         \
+    acc[i][0] = vdupq_n_f32(0.f);     \
+    if (nr_vec > 1) {                 \
+        acc[i][1] = vdupq_n_f32(0.f); \
+    }
+    UNROLL_CALL_RAW(8, cb);
+#undef cb
+    for (int32_t b = 0; b < row.nr_blocks; ++b) {
+        const float* b_row = B + row.cols[b] * LDB;
+        const float* vals = row.vals + b * 8;
+        float32x4_t b0 = vld1q_f32(b_row);
+        float32x4_t b1 = nr_vec > 1 ? vld1q_f32(b_row + 4) : b0;
+#define cb(i)                                            \
+    acc[i][0] = vmlaq_n_f32(acc[i][0], b0, vals[i]);     \
+    if (nr_vec > 1) {                                    \
+        acc[i][1] = vmlaq_n_f32(acc[i][1], b1, vals[i]); \
+    }
+        UNROLL_CALL_RAW(8, cb);
+#undef cb
+    }
+#define cb(i)                                  \
+    vst1q_f32(C + i * LDC, acc[i][0]);         \
+    if (nr_vec > 1) {                          \
+        vst1q_f32(C + i * LDC + 4, acc[i][1]); \
+    }
+    UNROLL_CALL_RAW(8, cb);
+#undef cb
+}
+
+/*!
+ * C[0:8, 0:nr_col] of one block row, where element (k, n) of B is at
+ * B[k * stride_k + n * stride_n]; each block is the 8 values of A times one
+ * element of B per column
+ */
+template <size_t nr_col>
+void kern_cols(
+        const BlockRow& row, const float* B, size_t stride_k, size_t stride_n,
+        float* C, size_t LDC) {
+    float32x4_t acc[MAX_COLS][2];
+#define cb(n)                                     \
+    if (n < nr_col) {                             \
+        acc[n][0] = acc[n][1] = vdupq_n_f32(0.f); \
+    }
+    UNROLL_CALL_RAW(4, cb);
+#undef cb
+    for (int32_t b = 0; b < row.nr_blocks; ++b) {
+        float32x4_t vals0 = vld1q_f32(row.vals + b * 8),
+                    vals1 = vld1q_f32(row.vals + b * 8 + 4);
+        const float* b_col = B + row.cols[b] * stride_k;
+#define cb(n)                                             \
+    if (n < nr_col) {                                     \
+        float b_val = b_col[n * stride_n];                \
+        acc[n][0] = vmlaq_n_f32(acc[n][0], vals0, b_val); \
+        acc[n][1] = vmlaq_n_f32(acc[n][1], vals1, b_val); \
+    }
+        UNROLL_CALL_RAW(4, cb);
+#undef cb
+    }
+    float tmp[8];
+#define cb(n)                                \
+    if (n < nr_col) {                        \
+        if (LDC == 1 && nr_col == 1) {       \
+            vst1q_f32(C, acc[n][0]);         \
+            vst1q_f32(C + 4, acc[n][1]);     \
+        } else {                             \
+            vst1q_f32(tmp, acc[n][0]);       \
+            vst1q_f32(tmp + 4, acc[n][1]);   \
+            for (size_t i = 0; i < 8; ++i) { \
+                C[i * LDC + n] = tmp[i];     \
+            }                                \
+        }                                    \
+    }
+    UNROLL_CALL_RAW(4, cb);
+#undef cb
+}
+
+void dispatch_cols(
+        const BlockRow& row, const float* B, size_t stride_k, size_t stride_n,
+        float* C, size_t LDC, size_t N) {
+    for (size_t n = 0; n < N; n += MAX_COLS) {
+        const float* b = B + n * stride_n;
+        switch (std::min(N - n, MAX_COLS)) {
+#define cb(nr_col)                                                 \
+    case nr_col:                                                   \
+        kern_cols<nr_col>(row, b, stride_k, stride_n, C + n, LDC); \
+        break;
+            cb(1);
+            cb(2);
+            cb(3);
+            cb(4);
+#undef cb
+            default:
+                megdnn_assert_internal(0);
+        }
+    }
+}
+
+}  // anonymous namespace
+
+void arm_common::gemm_bsr_8x1_neon(
+        const dt_byte* A, size_t LDA, const float* B, size_t LDB, float* C,
+        size_t LDC, size_t M, size_t N, bool trB) {
+    size_t max_nr_blocks =
+            (LDA - MatrixMul::bsr_8x1_row_bytes(0)) / MatrixMul::bsr_8x1_block_bytes();
+    auto get_row = [&](size_t r) { return BlockRow(A + r * LDA, max_nr_blocks); };
+    if (trB) {
+        for (size_t r = 0; r < M / 8; ++r) {
+            dispatch_cols(get_row(r), B, 1, LDB, C + r * 8 * LDC, LDC, N);
+        }
+        return;
+    }
+    //! the columns of B are the outer loop, so that the rows of B used by a
+    //! tile stay in cache while all the block rows visit them
+    size_t n = 0;
+    for (; n + 4 * MAX_ROW_VEC <= N; n += 4 * MAX_ROW_VEC) {
+        for (size_t r = 0; r < M / 8; ++r) {
+            kern_rows<MAX_ROW_VEC>(get_row(r), B + n, LDB, C + r * 8 * LDC + n, LDC);
+        }
+    }
+    for (; n + 4 <= N; n += 4) {
+        for (size_t r = 0; r < M / 8; ++r) {
+            kern_rows<1>(get_row(r), B + n, LDB, C + r * 8 * LDC + n, LDC);
+        }
+    }
+    if (n < N) {
+        for (size_t r = 0; r < M / 8; ++r) {
+            dispatch_cols(get_row(r), B + n, LDB, 1, C + r * 8 * LDC + n, LDC, N - n);
+        }
+    }
+}
+
+// vim: syntax=cpp.doxygen
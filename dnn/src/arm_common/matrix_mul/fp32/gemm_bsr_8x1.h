@@ -0,0 +1,32 @@
+/**
+ * \file dnn/src/arm_common/matrix_mul/fp32/gemm_bsr_8x1.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+
+#include "megdnn/dtype.h"
+
+#include <cstddef>
+
+namespace megdnn {
+namespace arm_common {
+
+/*!
+ * C(M, N) = A * B, where A is a (M, K) matrix packed in
+ * param::MatrixMul::Format::BSR_8X1 with block rows of LDA bytes, and B is
+ * (K, N), or (N, K) if trB; see x86::matmul::gemm_bsr_8x1_avx2().
+ */
+void gemm_bsr_8x1_neon(
+        const dt_byte* A, size_t LDA, const float* B, size_t LDB, float* C,
+        size_t LDC, size_t M, size_t N, bool trB);
+
+}  // namespace arm_common
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
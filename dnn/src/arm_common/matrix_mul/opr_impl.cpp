@@ -27,6 +27,7 @@ class MatrixMulImpl::AlgoPack : NonCopyableObj {
 #endif
     AlgoGevm gevm;
     AlgoF32GemvMK4 f32_gemv_mk4;
+    AlgoF32BSR8x1 f32_bsr_8x1;
 
     SmallVector<fallback::MatrixMulImpl::AlgoBase*> m_all_algos;
     fallback::MatrixMulImpl::AlgoBase::Mapper m_all_algos_map;
@@ -44,6 +45,7 @@ public:
         m_all_algos.emplace_back(&int8x8x32_gemv_mk4);
         m_all_algos.emplace_back(&f32_gemv_mk4);
         m_all_algos.emplace_back(&gevm);
+        m_all_algos.emplace_back(&f32_bsr_8x1);
 
         for (auto&& algo : m_all_algos) {
             m_all_algos_map.emplace(algo->info().desc, algo);
@@ -38,6 +38,7 @@ protected:
     class AlgoInt8x8x32Gemv;     // Arm_common Int8x8x32 Gemv
     class AlgoInt8x8x32GemvMK4;  // Arm_common Int8x8x32 Gemv NCHW44
     class AlgoGevm;              // Arm_common Gevm(support int8 and fp32)
+    class AlgoF32BSR8x1;         // Arm_common F32 block sparse weight
 #if __ARM_FEATURE_FP16_VECTOR_ARITHMETIC
     class AlgoF16Gemv;
 #endif
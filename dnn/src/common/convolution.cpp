@@ -1136,7 +1136,13 @@ void ConvolutionBackwardData::deduce_layout(
     MEGDNN_MARK_USED_VAR(errmsg);
     megdnn_assert_contiguous(filter);
     megdnn_assert_contiguous(diff);
-    megdnn_assert(filter.ndim == 4_z || filter.ndim == 5_z, "%s", errmsg().c_str());
+    if (param().format == Param::Format::NCHW88) {
+        megdnn_assert(
+                filter.ndim == 6_z || filter.ndim == 7_z, "%s", errmsg().c_str());
+    } else {
+        megdnn_assert(
+                filter.ndim == 4_z || filter.ndim == 5_z, "%s", errmsg().c_str());
+    }
     megdnn_assert(diff.ndim == 4_z || diff.ndim == 5_z, "%s", errmsg().c_str());
 
     deduce_dtype(filter.dtype, diff.dtype, grad.dtype);
@@ -1190,6 +1196,22 @@ void ConvolutionBackwardData::deduce_layout(
                 diff[3], cflt.dilated_spatial[1], cflt.stride[1], cflt.padding[1]);
         megdnn_assert(diff[4] == 4);
         grad[4] = 4;
+    } else if (param().format == Param::Format::NCHW88) {
+        megdnn_assert(
+                diff.ndim == 5, "valid diff ndim for NCHW88, expected=5, got=%zu",
+                diff.ndim);
+        megdnn_assert(cflt.ocpg * cflt.group == diff[1] * 8, "%s", errmsg().c_str());
+        grad.ndim = diff.ndim;
+        grad[0] = diff[0];
+        auto ic = cflt.icpg * cflt.group;
+        megdnn_assert(ic % 8 == 0);
+        grad[1] = ic / 8;
+        grad[2] = deduce(
+                diff[2], cflt.dilated_spatial[0], cflt.stride[0], cflt.padding[0]);
+        grad[3] = deduce(
+                diff[3], cflt.dilated_spatial[1], cflt.stride[1], cflt.padding[1]);
+        megdnn_assert(diff[4] == 8);
+        grad[4] = 8;
     } else {
         megdnn_assert(param().format == Param::Format::NHWCD4);
         megdnn_assert(
@@ -157,6 +157,7 @@ private:
     cb(ShuffleRNGBackward) \
     cb(SeparableConvForward) \
     cb(SeparableFilterForward) \
+    cb(ImagePreprocessForward) \
     cb(BNForward) \
     cb(BNBackward) \
     cb(GroupLocalForward) \
@@ -0,0 +1,87 @@
+/**
+ * \file dnn/src/common/image_preprocess.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "megdnn/oprs.h"
+
+#include "src/common/utils.h"
+
+namespace megdnn {
+
+void ImagePreprocessBase::deduce_layout_fwd(
+        const TensorLayout& src, const TensorLayout& scale, const TensorLayout& bias,
+        TensorLayout& dst) {
+    auto errmsg = [&]() {
+        return megdnn_layout_msg(src) + ", " + megdnn_layout_msg(scale) + ", " +
+               megdnn_layout_msg(bias) + ", " +
+               "imode=" + std::to_string((int)(param().imode)) + ", " +
+               "color_mode=" + std::to_string((int)(param().color_mode)) + ", " +
+               "format=" + std::to_string((int)(param().format)) + ", " +
+               "out_h=" + std::to_string(param().out_h) + ", " +
+               "out_w=" + std::to_string(param().out_w);
+    };
+    MEGDNN_MARK_USED_VAR(errmsg);
+    megdnn_assert_contiguous(src);
+    megdnn_assert_contiguous(scale);
+    megdnn_assert_contiguous(bias);
+    megdnn_assert(
+            src.ndim == 4_z && src.dtype == dtype::Uint8(), "%s", errmsg().c_str());
+    size_t n = src[0], ih = src[1], iw = src[2], c = src[3];
+    megdnn_assert(
+            scale.ndim == 1_z && scale.dtype == dtype::Float32() && scale[0] == c &&
+                    bias.ndim == 1_z && bias.dtype == dtype::Float32() &&
+                    bias[0] == c,
+            "%s", errmsg().c_str());
+    megdnn_assert(
+            param().imode == Param::InterpolationMode::LINEAR ||
+                    param().imode == Param::InterpolationMode::NEAREST,
+            "%s", errmsg().c_str());
+    megdnn_assert(
+            param().color_mode == Param::ColorMode::NONE || c == 3, "%s",
+            errmsg().c_str());
+    size_t oh = param().out_h ? param().out_h : ih,
+           ow = param().out_w ? param().out_w : iw;
+
+    DType dtype = dst.dtype.valid() ? dst.dtype : dtype::Float32();
+    megdnn_assert(
+            dtype == dtype::Float32() || dtype.enumv() == DTypeEnum::QuantizedS8,
+            "%s", errmsg().c_str());
+    if (param().format == Param::Format::NCHW) {
+        dst = TensorLayout(TensorShape({n, c, oh, ow}), dtype);
+    } else {
+        megdnn_assert(param().format == Param::Format::NCHW88, "%s", errmsg().c_str());
+        dst = TensorLayout(TensorShape({n, div_ceil<size_t>(c, 8), oh, ow, 8}), dtype);
+    }
+}
+
+void ImagePreprocessBase::check_layout_fwd(
+        const TensorLayout& src, const TensorLayout& scale, const TensorLayout& bias,
+        const TensorLayout& dst) {
+    TensorLayout dst_expected{dst.dtype};
+    deduce_layout_fwd(src, scale, bias, dst_expected);
+    megdnn_assert_eq_layout(dst_expected, dst);
+}
+
+void ImagePreprocessForward::deduce_layout(
+        const TensorLayout& src, const TensorLayout& scale, const TensorLayout& bias,
+        TensorLayout& dst) {
+    deduce_layout_fwd(src, scale, bias, dst);
+}
+
+void ImagePreprocessForward::check_exec(
+        const TensorLayout& src, const TensorLayout& scale, const TensorLayout& bias,
+        const TensorLayout& dst, size_t workspace_in_bytes) {
+    check_layout_fwd(src, scale, bias, dst);
+    auto required_workspace_in_bytes = get_workspace_in_bytes(src, scale, bias, dst);
+    megdnn_assert(workspace_in_bytes >= required_workspace_in_bytes);
+}
+
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,112 @@
+/**
+ * \file dnn/src/common/image_preprocess.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+
+#include "megdnn/opr_param_defs.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace megdnn {
+namespace image_preprocess {
+
+using InterpolationMode = param::ImagePreprocess::InterpolationMode;
+
+//! two source indices and their weights of an output index
+struct Coord {
+    int i0, i1;
+    float w0, w1;
+};
+
+//! the same mapping as ResizeBase::get_nearest_linear_coord
+inline Coord get_coord(InterpolationMode imode, int isize, int osize, int idx) {
+    if (isize == 1) {
+        return {0, 0, 1.f, 0.f};
+    }
+    float scale = static_cast<float>(osize) / isize;
+    float alpha = (idx + 0.5f) / scale - 0.5f;
+    int origin = static_cast<int>(std::floor(alpha));
+    alpha -= origin;
+    if (imode == InterpolationMode::NEAREST) {
+        origin = std::min(static_cast<int>(idx / scale), isize - 1);
+        alpha = 0;
+    }
+    if (origin < 0) {
+        origin = 0;
+        alpha = 0;
+    } else if (origin + 1 >= isize) {
+        origin = isize - 2;
+        alpha = 1;
+    }
+    return {origin, origin + 1, 1 - alpha, alpha};
+}
+
+/*
+ * Resize of an NHWC uint8 image with 1 or 3 channels goes to resize_cv on
+ * the CPU handles, whose mapping and rounding differ from ResizeBase. The
+ * functions below reproduce it, so that ImagePreprocess gets the same uint8
+ * image as Resize.
+ */
+
+//! whether NEAREST Resize of an image with C channels uses resize_cv
+inline bool is_cv_nearest(size_t C) {
+    return C == 1 || C == 3;
+}
+
+//! the same mapping as resize_nearest_8u of resize_cv
+inline int get_cv_nearest_src(int isize, int osize, int idx) {
+    const double scale = static_cast<double>(osize) / isize;
+    const double inv_scale = 1.0f / scale;
+    int ret = static_cast<int>(std::floor(idx * inv_scale));
+    return std::min(std::max(ret, 0), isize - 1);
+}
+
+//! Coord of NEAREST or LINEAR Resize of an image with C channels, where
+//! LINEAR is interpolated in float
+inline Coord get_resize_coord(
+        InterpolationMode imode, size_t C, int isize, int osize, int idx) {
+    if (imode == InterpolationMode::NEAREST && is_cv_nearest(C)) {
+        int i = get_cv_nearest_src(isize, osize, idx);
+        return {i, i, 1.f, 0.f};
+    }
+    return get_coord(imode, isize, osize, idx);
+}
+
+//! bits of the fixed-point weights of LINEAR resize_cv
+constexpr int CV_LINEAR_BITS = 11;
+constexpr int CV_LINEAR_ONE = 1 << CV_LINEAR_BITS;
+
+//! source index i0 and fixed-point weight w1 of i0 + 1 of an output index,
+//! the same as build_tabs_linear_8u of resize_cv; isize must be at least 2
+struct CvCoord {
+    int i0, w1;
+};
+
+inline CvCoord get_cv_linear_coord(int isize, int osize, int idx) {
+    const float scale = static_cast<float>(osize) / isize;
+    const float inv_scale = 1.0f / scale;
+    float alpha = (idx + 0.5f) * inv_scale - 0.5f;
+    int origin = static_cast<int>(std::floor(alpha));
+    alpha -= origin;
+    if (origin < 0) {
+        origin = 0;
+        alpha = 0;
+    } else if (origin + 1 >= isize) {
+        origin = isize - 2;
+        alpha = 1;
+    }
+    return {origin, static_cast<int>(alpha * CV_LINEAR_ONE)};
+}
+
+}  // namespace image_preprocess
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
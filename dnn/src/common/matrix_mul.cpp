@@ -14,6 +14,15 @@
 
 namespace megdnn {
 
+namespace {
+bool is_bsr_8x1_row_bytes(size_t row_bytes) {
+    return row_bytes >= MatrixMul::bsr_8x1_row_bytes(0) &&
+           (row_bytes - MatrixMul::bsr_8x1_row_bytes(0)) %
+                           MatrixMul::bsr_8x1_block_bytes() ==
+                   0;
+}
+}  // anonymous namespace
+
 void MatrixMulForward::deduce_dtype(DType A, DType B, DType& C) {
     // Expect that the user specifies output dtype (C), we then do sanity
     // check on the dtype supplied by the user. C_dtype and C_dtype2 are the
@@ -35,6 +44,9 @@ void MatrixMulForward::deduce_dtype(DType A, DType B, DType& C) {
         C_candi = dtype::QuantizedS32(mul_scale(A, B));
     } else if (A.enumv() == DTypeEnum::QuantizedS4) {
         C_candi = dtype::QuantizedS16(mul_scale(A, B));
+    } else if (A.enumv() == DTypeEnum::Byte) {
+        //! block sparse A of Format::BSR_8X1
+        C_candi = B;
     }
     if (!C.valid()) {
         C = C_candi;
@@ -46,6 +58,48 @@ void MatrixMulForward::deduce_dtype(DType A, DType B, DType& C) {
 
 void MatrixMulForward::deduce_layout(
         const TensorLayout& A, const TensorLayout& B, TensorLayout& C) {
+    if (param().format == param::MatrixMul::Format::W4_G32) {
+        megdnn_assert(
+                A.dtype == dtype::Float32() && B.dtype == dtype::Byte(),
+                "W4_G32 matmul requires float32 A and byte B, got %s and %s",
+                A.dtype.name(), B.dtype.name());
+        megdnn_assert(
+                A.ndim == 2 && B.ndim == 2,
+                "matmul requires input to be 2-dimensional; get: %s %s",
+                A.TensorShape::to_string().c_str(), B.TensorShape::to_string().c_str());
+        megdnn_assert(
+                !m_param.transposeA && !m_param.transposeB,
+                "W4_G32 matmul does not support transpose");
+        megdnn_assert(
+                B.shape[1] % w4_g32_group_bytes() == 0 &&
+                        A.shape[1] == B.shape[1] / w4_g32_group_bytes() * 32,
+                "shape mismatch in W4_G32 matmul: A is %s, B is %s",
+                A.TensorShape::to_string().c_str(), B.TensorShape::to_string().c_str());
+        deduce_dtype(A.dtype, B.dtype, C.dtype);
+        C = TensorLayout(TensorShape({A.shape[0], B.shape[0]}), C.dtype);
+        return;
+    }
+    if (param().format == param::MatrixMul::Format::BSR_8X1) {
+        megdnn_assert(
+                A.dtype == dtype::Byte() && B.dtype == dtype::Float32(),
+                "BSR_8X1 matmul requires byte A and float32 B, got %s and %s",
+                A.dtype.name(), B.dtype.name());
+        megdnn_assert(
+                A.ndim == 2 && B.ndim == 2,
+                "matmul requires input to be 2-dimensional; get: %s %s",
+                A.TensorShape::to_string().c_str(), B.TensorShape::to_string().c_str());
+        megdnn_assert(
+                !m_param.transposeA, "BSR_8X1 matmul does not support transposeA");
+        megdnn_assert(
+                is_bsr_8x1_row_bytes(A.shape[1]),
+                "bad block row size in BSR_8X1 matmul: A is %s",
+                A.TensorShape::to_string().c_str());
+        deduce_dtype(A.dtype, B.dtype, C.dtype);
+        C = TensorLayout(
+                TensorShape({A.shape[0] * 8, B.shape[m_param.transposeB ? 0 : 1]}),
+                C.dtype);
+        return;
+    }
     megdnn_assert(
             A.dtype.enumv() == B.dtype.enumv(),
             "matmul input should be of same dtype, got %s and %s", A.dtype.name(),
@@ -117,6 +171,52 @@ void MatrixMulForward::check_exec(
         return msg;
     };
     MEGDNN_MARK_USED_VAR(errmsg);
+    if (param().format == param::MatrixMul::Format::W4_G32) {
+        megdnn_assert(
+                A.ndim == 2 && B.ndim == 2 && C.ndim == 2 && !m_param.transposeA &&
+                        !m_param.transposeB,
+                "%s", errmsg().c_str());
+        megdnn_assert(A.stride[1] == 1);
+        megdnn_assert(A.stride[0] >= static_cast<ptrdiff_t>(A.shape[1]));
+        megdnn_assert_contiguous(B);
+        megdnn_assert(C.stride[1] == 1);
+        megdnn_assert(C.stride[0] >= static_cast<ptrdiff_t>(C.shape[1]));
+        megdnn_assert(A.shape[0] == C.shape[0], "%s", errmsg().c_str());
+        megdnn_assert(B.shape[0] == C.shape[1], "%s", errmsg().c_str());
+        megdnn_assert(
+                B.shape[1] % w4_g32_group_bytes() == 0 &&
+                        A.shape[1] == B.shape[1] / w4_g32_group_bytes() * 32,
+                "%s", errmsg().c_str());
+        megdnn_assert(
+                A.dtype == dtype::Float32() && B.dtype == dtype::Byte() &&
+                        C.dtype == dtype::Float32(),
+                "%s", errmsg().c_str());
+        auto required_workspace_in_bytes = get_workspace_in_bytes(A, B, C);
+        megdnn_assert(workspace_in_bytes >= required_workspace_in_bytes);
+        return;
+    }
+    if (param().format == param::MatrixMul::Format::BSR_8X1) {
+        megdnn_assert(
+                A.ndim == 2 && B.ndim == 2 && C.ndim == 2 && !m_param.transposeA,
+                "%s", errmsg().c_str());
+        megdnn_assert_contiguous(A);
+        megdnn_assert(B.stride[1] == 1);
+        megdnn_assert(B.stride[0] >= static_cast<ptrdiff_t>(B.shape[1]));
+        megdnn_assert(C.stride[1] == 1);
+        megdnn_assert(C.stride[0] >= static_cast<ptrdiff_t>(C.shape[1]));
+        megdnn_assert(A.shape[0] * 8 == C.shape[0], "%s", errmsg().c_str());
+        megdnn_assert(
+                B.shape[m_param.transposeB ? 0 : 1] == C.shape[1], "%s",
+                errmsg().c_str());
+        megdnn_assert(is_bsr_8x1_row_bytes(A.shape[1]), "%s", errmsg().c_str());
+        megdnn_assert(
+                A.dtype == dtype::Byte() && B.dtype == dtype::Float32() &&
+                        C.dtype == dtype::Float32(),
+                "%s", errmsg().c_str());
+        auto required_workspace_in_bytes = get_workspace_in_bytes(A, B, C);
+        megdnn_assert(workspace_in_bytes >= required_workspace_in_bytes);
+        return;
+    }
     if (param().format == param::MatrixMul::Format::DEFAULT) {
         megdnn_assert_eq_size_t(A.ndim, 2_z);
         megdnn_assert_eq_size_t(B.ndim, 2_z);
@@ -199,6 +299,9 @@ size_t MatrixMulForward::pack_size(const Param::Format format) {
             return 4;
         case Param::Format::MK8:
             return 8;
+        case Param::Format::W4_G32:
+        case Param::Format::BSR_8X1:
+            return 1;
         default:
             megdnn_throw("Unknown matmul format.");
     }
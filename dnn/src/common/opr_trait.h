@@ -92,6 +92,7 @@ DEF(Flip, 2, true, true);
 DEF(ROICopy, 2, true, true);
 DEF(Rotate, 2, true, true);
 DEF(CvtColor, 2, true, true);
+DEF(ImagePreprocessForward, 4, true, true);
 DEF(WarpAffine, 3, true, false);
 DEF(GaussianBlur, 2, true, true);
 DEF(Resize, 2, true, false);
@@ -0,0 +1,28 @@
+/**
+ * \file dnn/src/cuda/image_preprocess/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "src/cuda/image_preprocess/opr_impl.h"
+#include "src/common/utils.h"
+
+namespace megdnn {
+namespace cuda {
+
+void ImagePreprocessForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_in scale, _megdnn_tensor_in bias,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(src.layout, scale.layout, bias.layout, dst.layout, workspace.size);
+    megdnn_assert(false, "ImagePreprocess is not supported in CUDA");
+}
+
+}  // namespace cuda
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
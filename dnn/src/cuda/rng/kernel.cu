@@ -229,5 +229,8 @@ INST(megdnn::dtype::Float32)
 INST(megdnn::dtype::Float16)
 INST(megdnn::dtype::BFloat16)
 #undef INST
+
+INST_RUN_ELEMWISE(random::UniformPhiloxKernel, dt_float32, 0);
+INST_RUN_ELEMWISE(random::GaussianPhiloxKernel, dt_float32, 0);
 }  // namespace cuda
 }  // namespace megdnn
\ No newline at end of file
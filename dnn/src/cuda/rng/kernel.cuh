@@ -37,6 +37,117 @@ QUALIFIERS float _curand_uniform(Philox* state) {
     return r;
 }
 
+constexpr uint32_t PHILOX_M4x32_0 = 0xD2511F53, PHILOX_M4x32_1 = 0xCD9E8D57,
+                   PHILOX_W32_0 = 0x9E3779B9, PHILOX_W32_1 = 0xBB67AE85;
+
+//! 2^-32 and 2^-32 * 2 * pi, the same as fallback/rng/rng_helper.h
+constexpr float TWO_POW32_INV = 2.3283064e-10f,
+                TWO_POW32_INV_2PI = 2.3283064e-10f * 6.2831855f;
+
+/*!
+ * \brief Philox-4x32-10 of block \p block in subsequence 0 with key \p seed
+ *
+ * The key and counter layout are the same as fallback::rng::Philox4x32, so
+ * the cuda and cpu oprs generate the same stream for the same seed.
+ */
+__device__ __forceinline__ uint4 philox4x32_10(uint64_t seed, uint64_t block) {
+    uint4 ctr = make_uint4(
+            static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32), 0, 0);
+    uint32_t k0 = static_cast<uint32_t>(seed), k1 = static_cast<uint32_t>(seed >> 32);
+#pragma unroll
+    for (int r = 0; r < 10; ++r) {
+        uint32_t hi0 = __umulhi(PHILOX_M4x32_0, ctr.x), lo0 = PHILOX_M4x32_0 * ctr.x,
+                 hi1 = __umulhi(PHILOX_M4x32_1, ctr.z), lo1 = PHILOX_M4x32_1 * ctr.z;
+        ctr = make_uint4(hi1 ^ ctr.y ^ k0, lo1, hi0 ^ ctr.w ^ k1, lo0);
+        k0 += PHILOX_W32_0;
+        k1 += PHILOX_W32_1;
+    }
+    return ctr;
+}
+
+//! explicit rounding ops to avoid fma contraction, which changes the result
+__device__ __forceinline__ float philox_uint2float(uint32_t x) {
+    return __fadd_rn(
+            __fmul_rn(__uint2float_rn(x), TWO_POW32_INV), TWO_POW32_INV / 2.f);
+}
+
+__device__ __forceinline__ float philox_uint2angle(uint32_t x) {
+    return __fadd_rn(
+            __fmul_rn(__uint2float_rn(x), TWO_POW32_INV_2PI), TWO_POW32_INV_2PI / 2.f);
+}
+
+__device__ __forceinline__ void philox_box_muller(
+        float u, float v, float mean, float stddev, float* dst) {
+    float s = __fmul_rn(sqrtf(__fmul_rn(-2.f, logf(u))), stddev);
+    dst[0] = __fadd_rn(__fmul_rn(sinf(v), s), mean);
+    dst[1] = __fadd_rn(__fmul_rn(cosf(v), s), mean);
+}
+
+//! each idx fills 4 outputs from counter block offset + idx
+struct UniformPhiloxKernel {
+    float* output;
+    size_t size;
+    uint64_t seed, offset;
+
+    __device__ void operator()(uint32_t idx) {
+        uint4 r = philox4x32_10(seed, offset + idx);
+        float val[4] = {
+                philox_uint2float(r.x), philox_uint2float(r.y),
+                philox_uint2float(r.z), philox_uint2float(r.w)};
+        size_t base = static_cast<size_t>(idx) * 4;
+#pragma unroll
+        for (int i = 0; i < 4; ++i) {
+            if (base + i < size) {
+                output[base + i] = val[i];
+            }
+        }
+    }
+
+#if MEGDNN_CC_HOST
+    UniformPhiloxKernel(const TensorND& output, uint64_t seed, uint64_t offset)
+            : output{output.ptr<dt_float32>()},
+              size{output.layout.total_nr_elems()},
+              seed{seed},
+              offset{offset} {}
+#endif
+};
+
+struct GaussianPhiloxKernel {
+    float* output;
+    size_t size;
+    float mean, stddev;
+    uint64_t seed, offset;
+
+    __device__ void operator()(uint32_t idx) {
+        uint4 r = philox4x32_10(seed, offset + idx);
+        float val[4];
+        philox_box_muller(
+                philox_uint2float(r.x), philox_uint2angle(r.y), mean, stddev, val);
+        philox_box_muller(
+                philox_uint2float(r.z), philox_uint2angle(r.w), mean, stddev,
+                val + 2);
+        size_t base = static_cast<size_t>(idx) * 4;
+#pragma unroll
+        for (int i = 0; i < 4; ++i) {
+            if (base + i < size) {
+                output[base + i] = val[i];
+            }
+        }
+    }
+
+#if MEGDNN_CC_HOST
+    GaussianPhiloxKernel(
+            const TensorND& output, float mean, float stddev, uint64_t seed,
+            uint64_t offset)
+            : output{output.ptr<dt_float32>()},
+              size{output.layout.total_nr_elems()},
+              mean{mean},
+              stddev{stddev},
+              seed{seed},
+              offset{offset} {}
+#endif
+};
+
 template <typename ctype, typename = void>
 struct RandomKernel;
 
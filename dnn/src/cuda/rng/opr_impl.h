@@ -11,54 +11,53 @@
  */
 #pragma once
 
-#include <curand.h>
 #include "megdnn/oprs.h"
 #include "src/cuda/handle.h"
 
 namespace megdnn {
 namespace cuda {
 
-class CuRandHandle {
-    curandGenerator_t m_gen;
-    uint64_t m_seed;
-
-    CuRandHandle(const CuRandHandle&) = delete;
-    CuRandHandle& operator=(const CuRandHandle&) = delete;
+/*!
+ * \brief uniform and gaussian oprs use a Philox-4x32-10 stream in the same way
+ *      as the fallback oprs, see fallback/rng/rng_helper.h
+ *
+ * The offset is in counter blocks of 4 values, and is reset when seed changes.
+ */
+class UniformRNGImpl : public UniformRNG {
+    uint64_t m_seed, m_offset;
+    cudaStream_t m_stream;
 
 public:
-    CuRandHandle(cudaStream_t stream, uint64_t seed = 0);
-    ~CuRandHandle();
-
-    void seed(uint64_t seed);
+    UniformRNGImpl(Handle* handle);
+    void exec(_megdnn_tensor_inout dst, _megdnn_workspace) override;
 
-    curandGenerator_t gen() const { return m_gen; }
+    size_t get_workspace_in_bytes(const TensorLayout&) override { return 0; }
 
     void ensure_seed(uint64_t seed) {
         if (m_seed != seed) {
-            this->seed(seed);
+            m_seed = seed;
+            m_offset = 0;
         }
     }
 };
 
-class UniformRNGImpl : public UniformRNG {
-    CuRandHandle m_curand_handle;
-
-public:
-    UniformRNGImpl(Handle* handle);
-    void exec(_megdnn_tensor_inout dst, _megdnn_workspace) override;
-
-    size_t get_workspace_in_bytes(const TensorLayout&) override { return 0; }
-};
-
 class GaussianRNGImpl : public GaussianRNG {
-    CuRandHandle m_curand_handle;
+    uint64_t m_seed, m_offset;
+    cudaStream_t m_stream;
 
 public:
     GaussianRNGImpl(Handle* handle);
 
     void exec(_megdnn_tensor_inout dst, _megdnn_workspace) override;
 
-    size_t get_workspace_in_bytes(const TensorLayout& layout) override;
+    size_t get_workspace_in_bytes(const TensorLayout&) override { return 0; }
+
+    void ensure_seed(uint64_t seed) {
+        if (m_seed != seed) {
+            m_seed = seed;
+            m_offset = 0;
+        }
+    }
 };
 
 class GammaRNGImpl : public GammaRNG {
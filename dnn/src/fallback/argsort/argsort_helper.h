@@ -0,0 +1,170 @@
+/**
+ * \file dnn/src/fallback/argsort/argsort_helper.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+
+#include "megdnn/arch.h"
+#include "megdnn/dtype.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace megdnn {
+namespace fallback {
+namespace argsort {
+
+/*!
+ * \brief map a value to an unsigned integer whose natural order is the same as
+ *      the order of the value
+ *
+ * Only the dtypes with a specialization here can use the fast sorting and
+ * selection kernels; other dtypes go to the naive impls.
+ */
+template <typename ctype>
+struct OrderedKey {
+    static constexpr bool valid = false;
+};
+
+template <>
+struct OrderedKey<dt_float32> {
+    static constexpr bool valid = true;
+    static MEGDNN_FORCE_INLINE uint32_t get(dt_float32 v) {
+        uint32_t u;
+        memcpy(&u, &v, sizeof(u));
+        //! -0.0 and +0.0 compare equal, so they must share the same key
+        u = u == 0x80000000u ? 0u : u;
+        uint32_t mask = static_cast<uint32_t>(-static_cast<int32_t>(u >> 31)) |
+                        0x80000000u;
+        return u ^ mask;
+    }
+};
+
+template <>
+struct OrderedKey<dt_int32> {
+    static constexpr bool valid = true;
+    static MEGDNN_FORCE_INLINE uint32_t get(dt_int32 v) {
+        return static_cast<uint32_t>(v) ^ 0x80000000u;
+    }
+};
+
+/*!
+ * \brief pack value key and index into one integer, so sorting the packed
+ *      integers orders elements by value and then by index
+ *
+ * If \p flip is true the whole packed word is complemented, which gives
+ * descending order of both value and index, i.e. the order of
+ * std::greater<std::pair<ctype, int>>.
+ */
+template <typename ctype>
+MEGDNN_FORCE_INLINE uint64_t pack_key(ctype val, uint32_t idx, bool flip) {
+    uint64_t p = (static_cast<uint64_t>(OrderedKey<ctype>::get(val)) << 32) | idx;
+    return flip ? ~p : p;
+}
+
+MEGDNN_FORCE_INLINE uint32_t unpack_idx(uint64_t p, bool flip) {
+    return static_cast<uint32_t>(flip ? ~p : p);
+}
+
+//! max length of rows that are sorted by the bitonic network
+static constexpr size_t BITONIC_MAX_LEN = 32;
+
+/*!
+ * \brief bitonic sorting network on a fixed-size array
+ *
+ * This is a scalar compare-exchange loop: the exchange sequence does not
+ * depend on the data, which avoids branch mispredictions on short rows, but
+ * it is not a SIMD sort.
+ */
+template <size_t N>
+MEGDNN_FORCE_INLINE void bitonic_sort(uint64_t* x) {
+    static_assert(N && !(N & (N - 1)), "N must be power of 2");
+    for (size_t k = 2; k <= N; k <<= 1) {
+        for (size_t j = k >> 1; j > 0; j >>= 1) {
+            for (size_t i = 0; i < N; ++i) {
+                size_t l = i ^ j;
+                if (l > i) {
+                    uint64_t a = x[i], b = x[l];
+                    uint64_t lo = a < b ? a : b, hi = a < b ? b : a;
+                    bool up = !(i & k);
+                    x[i] = up ? lo : hi;
+                    x[l] = up ? hi : lo;
+                }
+            }
+        }
+    }
+}
+
+/*!
+ * \brief sort \p n packed keys with n <= BITONIC_MAX_LEN in place
+ *
+ * \param buf buffer of at least BITONIC_MAX_LEN elements; its first \p n
+ *      elements are the input, and the tail is used as padding
+ */
+MEGDNN_FORCE_INLINE void sort_short(uint64_t* buf, size_t n) {
+    for (size_t i = n; i < BITONIC_MAX_LEN; ++i) {
+        buf[i] = UINT64_MAX;
+    }
+    if (n <= 8) {
+        bitonic_sort<8>(buf);
+    } else if (n <= 16) {
+        bitonic_sort<16>(buf);
+    } else {
+        bitonic_sort<BITONIC_MAX_LEN>(buf);
+    }
+}
+
+/*!
+ * \brief stable LSD radix sort on the high 32 bits (the value key) of packed
+ *      keys
+ *
+ * Since the low 32 bits (the index) are already in ascending order in \p src,
+ * stability makes the result fully sorted.
+ *
+ * \param src input buffer
+ * \param tmp temporary buffer of the same size as \p src
+ * \return the buffer holding the result, which is either \p src or \p tmp
+ */
+inline uint64_t* radix_sort_by_key(uint64_t* src, uint64_t* tmp, size_t n) {
+    constexpr size_t RADIX_BITS = 8, RADIX = 1 << RADIX_BITS;
+    size_t hist[4][RADIX];
+    memset(hist, 0, sizeof(hist));
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t key = static_cast<uint32_t>(src[i] >> 32);
+        ++hist[0][key & 0xff];
+        ++hist[1][(key >> 8) & 0xff];
+        ++hist[2][(key >> 16) & 0xff];
+        ++hist[3][key >> 24];
+    }
+    for (size_t pass = 0; pass < 4; ++pass) {
+        auto h = hist[pass];
+        //! skip the pass if all keys share the same digit
+        if (h[(src[0] >> (32 + pass * RADIX_BITS)) & 0xff] == n) {
+            continue;
+        }
+        size_t sum = 0;
+        for (size_t i = 0; i < RADIX; ++i) {
+            size_t c = h[i];
+            h[i] = sum;
+            sum += c;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            tmp[h[(src[i] >> (32 + pass * RADIX_BITS)) & 0xff]++] = src[i];
+        }
+        std::swap(src, tmp);
+    }
+    return src;
+}
+
+}  // namespace argsort
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,124 @@
+/**
+ * \file dnn/src/fallback/argsort/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "src/fallback/argsort/opr_impl.h"
+#include "src/fallback/argsort/argsort_helper.h"
+
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_fallback_argsort)
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+//! rows longer than this are sorted by radix sort
+constexpr size_t RADIX_SORT_MIN_LEN = 2048;
+
+size_t get_nr_threads(Handle* handle) {
+    return static_cast<naive::HandleImpl*>(handle)->megcore_dispatcher()->nr_threads();
+}
+
+size_t get_row_buf_size(size_t N) {
+    return std::max(N, argsort::BITONIC_MAX_LEN) * 2;
+}
+
+template <typename ctype>
+void sort_row(
+        const ctype* sptr, ctype* dptr, dt_int32* iptr, size_t N, bool ascending,
+        uint64_t* buf) {
+    using namespace argsort;
+    bool flip = !ascending;
+    uint64_t* result = buf;
+    if (ascending) {
+        for (size_t i = 0; i < N; ++i) {
+            buf[i] = pack_key(sptr[i], i, false);
+        }
+    } else {
+        //! keep the low (index) bits ascending, as required by the radix sort
+        for (size_t i = 0; i < N; ++i) {
+            buf[i] = pack_key(sptr[N - 1 - i], N - 1 - i, true);
+        }
+    }
+    if (N <= BITONIC_MAX_LEN) {
+        sort_short(buf, N);
+    } else if (N >= RADIX_SORT_MIN_LEN) {
+        result = radix_sort_by_key(buf, buf + N, N);
+    } else {
+        std::sort(buf, buf + N);
+    }
+    for (size_t i = 0; i < N; ++i) {
+        uint32_t idx = unpack_idx(result[i], flip);
+        iptr[i] = idx;
+        dptr[i] = sptr[idx];
+    }
+}
+
+}  // anonymous namespace
+
+size_t ArgsortForwardImpl::get_workspace_in_bytes(
+        const TensorLayout& src, const TensorLayout&, const TensorLayout&) {
+    return get_nr_threads(handle()) * get_row_buf_size(src.shape[1]) *
+           sizeof(uint64_t);
+}
+
+void ArgsortForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_tensor_out indices,
+        _megdnn_workspace workspace) {
+    check_exec(src.layout, dst.layout, indices.layout, workspace.size);
+    size_t M = src.layout.shape[0], N = src.layout.shape[1];
+    megdnn_assert(N <= std::numeric_limits<uint32_t>::max());
+    if (!M) {
+        return;
+    }
+    bool ascending = param().order == Order::ASCENDING;
+    auto handle_ptr = static_cast<naive::HandleImpl*>(handle());
+    size_t nr_threads = handle_ptr->megcore_dispatcher()->nr_threads();
+    //! group short rows so that each task does a reasonable amount of work
+    size_t rows_per_task = std::max<size_t>(1, 4096 / std::max<size_t>(N, 1));
+    rows_per_task = std::min(rows_per_task, div_ceil(M, nr_threads));
+    size_t nr_tasks = div_ceil(M, rows_per_task);
+    size_t buf_size = get_row_buf_size(N);
+    switch (src.layout.dtype.enumv()) {
+#define cb(dt)                                                                      \
+    case DTypeTrait<dt>::enumv: {                                                   \
+        using ctype = DTypeTrait<dt>::ctype;                                        \
+        MIDOUT_BEGIN(megdnn_fallback_argsort, ctype) {                              \
+            auto kern = [=](size_t task_id, size_t thread_id) {                     \
+                auto sptr = src.ptr<ctype>();                                       \
+                auto dptr = dst.ptr<ctype>();                                       \
+                auto iptr = indices.ptr<dt_int32>();                                \
+                auto buf = workspace.ptr<uint64_t>() + thread_id * buf_size;        \
+                size_t row_end = std::min(M, (task_id + 1) * rows_per_task);        \
+                for (size_t m = task_id * rows_per_task; m < row_end; ++m) {        \
+                    sort_row(                                                       \
+                            sptr + m * N, dptr + m * N, iptr + m * N, N, ascending, \
+                            buf);                                                   \
+                }                                                                   \
+            };                                                                      \
+            handle_ptr->dispatch_kern(kern, nr_tasks);                              \
+            return;                                                                 \
+        }                                                                           \
+        MIDOUT_END();                                                               \
+    }
+        cb(::megdnn::dtype::Float32);
+        cb(::megdnn::dtype::Int32);
+#undef cb
+        default:
+            break;
+    }
+    naive::ArgsortForwardImpl::exec(src, dst, indices, workspace);
+}
+
+// vim: syntax=cpp.doxygen
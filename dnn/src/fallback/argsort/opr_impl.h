@@ -0,0 +1,38 @@
+/**
+ * \file dnn/src/fallback/argsort/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+#include "src/naive/argsort/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+
+/*!
+ * \brief row-parallel argsort
+ *
+ * Rows are sorted as packed (key, index) integers: short rows by a bitonic
+ * network, long rows by LSD radix sort and others by std::sort. Dtypes
+ * without an ordered key fall back to naive.
+ */
+class ArgsortForwardImpl : public naive::ArgsortForwardImpl {
+public:
+    using naive::ArgsortForwardImpl::ArgsortForwardImpl;
+    void exec(
+            _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_tensor_out indices,
+            _megdnn_workspace workspace) override;
+    size_t get_workspace_in_bytes(
+            const TensorLayout& src, const TensorLayout& dst,
+            const TensorLayout& indices) override;
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -27,8 +27,6 @@ BatchedMatrixMulForwardImpl::AlgoPack::AlgoPack() {
 
 BatchedMatrixMulForwardImpl::AlgoPack BatchedMatrixMulForwardImpl::sm_algo_pack;
 
-MEGDNN_DEF_GET_ALGO_FROM_DESC(BatchedMatrixMulForwardImpl)
-
 BatchedMatrixMulForwardImpl::AlgoBase::SizeArgs::SizeArgs(
         BatchedMatrixMulForwardImpl* o, const TensorLayout& A, const TensorLayout& B,
         const TensorLayout& C)
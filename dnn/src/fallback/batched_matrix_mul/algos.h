@@ -34,6 +34,10 @@ protected:
 public:
     enum class AlgoType : uint32_t {
         fallback_BLAS,
+#if MEGDNN_X86
+        //! x86
+        X86_F32_AVX2_6X16 = 1 << 8,
+#endif
     };
     using Mapper = std::unordered_map<AlgorithmDesc, AlgoBase*>;
 
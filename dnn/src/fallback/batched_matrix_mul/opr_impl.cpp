@@ -16,20 +16,38 @@
 #include "src/common/utils.cuh"
 #include "src/fallback/handle.h"
 
+#if MEGDNN_X86
+#include "src/x86/batched_matrix_mul/opr_impl.h"
+#endif
+
 using namespace megdnn;
 using namespace fallback;
 
+std::vector<BatchedMatrixMulForwardImpl::AlgoBase*> BatchedMatrixMulForwardImpl::
+        get_all_packed_algo() {
+    return sm_algo_pack.all_algos;
+}
+
 std::vector<BatchedMatrixMulForwardImpl::Algorithm*> BatchedMatrixMulForwardImpl::
         get_all_algorithms(
                 const TensorLayout& A, const TensorLayout& B, const TensorLayout& C) {
     AlgoBase::SizeArgs args{this, A, B, C};
-    return megdnn::get_all_algorithms<BatchedMatrixMulForwardImpl>(args);
+    std::vector<Algorithm*> ret;
+    for (auto&& algo : get_all_packed_algo()) {
+        if (algo->is_available(args)) {
+            ret.push_back(algo);
+        }
+    }
+    return ret;
 }
 std::vector<BatchedMatrixMulForwardImpl::Algorithm*> BatchedMatrixMulForwardImpl::
         get_all_algorithms_safe(
                 const TensorLayout& A, const TensorLayout& B, const TensorLayout& C) {
-    AlgoBase::SizeArgs args{this, A, B, C};
-    return megdnn::get_all_algorithms_safe<BatchedMatrixMulForwardImpl>(args);
+    auto ret_safe = get_all_algorithms(A, B, C);
+    megdnn_assert(
+            !ret_safe.empty(), "no algorithm for %s",
+            AlgoBase::SizeArgs(this, A, B, C).to_string().c_str());
+    return ret_safe;
 }
 
 BatchedMatrixMulForwardImpl::Algorithm* BatchedMatrixMulForwardImpl::
@@ -38,15 +56,29 @@ BatchedMatrixMulForwardImpl::Algorithm* BatchedMatrixMulForwardImpl::
                 size_t workspace_limit_in_bytes, const AlgoAttribute& positive_attr,
                 const AlgoAttribute& negative_attr) {
     AlgoBase::SizeArgs args{this, A, B, C};
-    if (sm_algo_pack.algo_default.is_available_attribute(
-                args, positive_attr, negative_attr, workspace_limit_in_bytes)) {
-        return &sm_algo_pack.algo_default;
-    }
     return megdnn::get_algo_match_attribute<BatchedMatrixMulForwardImpl>(
-            sm_algo_pack.all_algos, args, workspace_limit_in_bytes,
+            get_all_packed_algo(), args, workspace_limit_in_bytes,
             "batched matrix mul forward", positive_attr, negative_attr);
 }
 
+BatchedMatrixMulForwardImpl::Algorithm* BatchedMatrixMulForwardImpl::
+        get_algorithm_from_desc(const AlgorithmDesc& desc) {
+    switch (desc.handle_type) {
+        case Handle::HandleType::FALLBACK: {
+            const auto& map = algo_pack().all_algos_map();
+            megdnn_assert(map.find(desc) != map.end());
+            return map.at(desc);
+        }
+#if MEGDNN_X86
+        case Handle::HandleType::X86:
+            return x86::BatchedMatrixMulForwardImpl::get_algo_from_desc(desc);
+#endif
+        default:
+            megdnn_throw("Unknown handle type");
+            return nullptr;
+    }
+}
+
 size_t BatchedMatrixMulForwardImpl::get_workspace_in_bytes(
         const TensorLayout& A, const TensorLayout& B, const TensorLayout& C) {
     return get_dnn_workspace(this, A, B, C);
@@ -32,6 +32,10 @@ public:
     static const AlgoPack& algo_pack() { return sm_algo_pack; }
     Algorithm* get_algorithm_from_desc(const AlgorithmDesc&) override;
 
+protected:
+    //! all the algos of this opr, the arch specific ones come first
+    virtual std::vector<AlgoBase*> get_all_packed_algo();
+
 private:
     std::vector<Algorithm*> get_all_algorithms(
             const TensorLayout& /*A*/, const TensorLayout& /*B*/,
@@ -239,6 +239,9 @@ public:
             X86_DIRECT_AVX2_STRD2_INT8,
             X86_MKLDNN_QINT8,
             X86_MKLDNN_MATMUL_QINT8,
+            X86_CHANWISE_AVX2_F32_NCHW,
+            X86_CHANWISE_AVX2_F32_NCHW88,
+            X86_WINOGRAD_F43_8x8_F32,
 #elif MEGDNN_AARCH64 || MEGDNN_ARMV7
             ARM_COMMON_WINOGRAD_F23_FP16 = 1 << 8,
             ARM_COMMON_WINOGRAD_F45_FP16,
@@ -25,6 +25,9 @@
 #if MEGDNN_AARCH64 || MEGDNN_ARMV7
 #include "src/arm_common/convolution/opr_impl.h"
 #endif
+#if MEGDNN_X86
+#include "src/x86/convolution/opr_impl.h"
+#endif
 
 #include <cstring>
 #include <unordered_map>
@@ -568,7 +571,8 @@ ConvolutionBackwardDataImpl::NCBKernSizeParam ConvolutionBackwardDataImpl::
         return v;
     };
     size_t spatial_pos;
-    if (param().format == Param::Format::NCHW) {
+    if (param().format == Param::Format::NCHW ||
+        param().format == Param::Format::NCHW88) {
         spatial_pos = 2;
     } else {
         megdnn_assert(param().format == Param::Format::NHWC, "invalid conv format");
@@ -633,6 +637,7 @@ void ConvolutionBackwardDataImpl::exec_with_ncb_kern(const NCBKernParam& param)
     } else {
         megdnn_assert(
                 p1g.filter_meta.format == Param::Format::NCHW ||
+                        p1g.filter_meta.format == Param::Format::NCHW88 ||
                         p1g.filter_meta.format == Param::Format::NHWC,
                 "invalid conv format");
         auto run = [kptr, p1g_orig = p1g, group]() {
@@ -651,7 +656,8 @@ void ConvolutionBackwardDataImpl::exec_with_ncb_kern(const NCBKernParam& param)
                     p1g.filter_type.size();
             p1g.grad_extra_mem_size =
                     (group - 1) * p1g.filter_meta.icpg * p1g.grad_type.size();
-            if (p1g.filter_meta.format == Param::Format::NCHW) {
+            if (p1g.filter_meta.format == Param::Format::NCHW ||
+                p1g.filter_meta.format == Param::Format::NCHW88) {
                 istrd *= p1g.isz[0] * p1g.isz[1];
                 ostrd *= p1g.osz[0] * p1g.osz[1];
                 p1g.diff_extra_mem_size *= p1g.isz[0] * p1g.isz[1];
@@ -790,6 +796,10 @@ ConvolutionBackwardDataImpl::Algorithm* ConvolutionBackwardDataImpl::
             case Handle::HandleType::ARMV7:
                 return arm_common::ConvolutionBackwardDataImpl::get_algo_from_desc(
                         desc);
+#endif
+#if MEGDNN_X86
+            case Handle::HandleType::X86:
+                return x86::ConvolutionBackwardDataImpl::get_algo_from_desc(desc);
 #endif
             case Handle::HandleType::NAIVE: {
                 auto algo = static_cast<naive::HandleImpl*>(handle())
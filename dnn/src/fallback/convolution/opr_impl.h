@@ -408,6 +408,12 @@ protected:
             ARM_COMMON_DIRECT_STRD1_DOT_QU8,
             ARM_COMMON_DIRECT_STRD2_DOT_QU8
 #endif
+
+#if MEGDNN_X86
+            X86_F32_DECONV_DIRECT_STRIDE2 = 1 << 8,
+            X86_F32_DECONV_SUBPIXEL,
+            X86_F32_DECONV_NCHW88,
+#endif
         };
 
         virtual bool usable(
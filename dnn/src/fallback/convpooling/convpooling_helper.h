@@ -0,0 +1,255 @@
+/**
+ * \file dnn/src/fallback/convpooling/convpooling_helper.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace megdnn {
+namespace fallback {
+namespace convpooling {
+
+using Param = param::ConvPooling;
+
+struct KernParam {
+    size_t IC, IH, IW, OC, FH, FW, SH, SW, PH, PW;
+    //! conv output
+    size_t CH, CW;
+    //! pooling window, stride and pad
+    size_t WH, WW, PSH, PSW, PPH, PPW;
+    size_t OH, OW;
+    bool xcorr;
+    Param::NonlineMode nonline;
+    Param::PoolMode pool;
+
+    //! filter value of tap (kh, kw) in the filter \p fptr of one channel
+    float weight(const float* fptr, size_t kh, size_t kw) const {
+        return xcorr ? fptr[kh * FW + kw] : fptr[(FH - 1 - kh) * FW + FW - 1 - kw];
+    }
+};
+
+//! floats of workspace used by a thread: the ring of WH conv rows and the
+//! vertically pooled row
+inline size_t get_thread_workspace(size_t WH, size_t CW) {
+    return (WH + 1) * CW;
+}
+
+/*!
+ * \brief columns [cw_begin, cw_end) of row \p r of conv output channel oc,
+ *      with bias but without nonlinearity
+ *
+ * The taps are visited per column, so it is meant for the border columns
+ * that are not handled by a vectorized kernel.
+ */
+inline void conv_cols(
+        const KernParam& p, const float* src, const float* filter, float bias,
+        size_t oc, size_t r, float* out, size_t cw_begin, size_t cw_end) {
+    ptrdiff_t ih0 = static_cast<ptrdiff_t>(r * p.SH) - static_cast<ptrdiff_t>(p.PH);
+    for (size_t cw = cw_begin; cw < cw_end; ++cw) {
+        ptrdiff_t iw0 =
+                static_cast<ptrdiff_t>(cw * p.SW) - static_cast<ptrdiff_t>(p.PW);
+        float sum = bias;
+        for (size_t ic = 0; ic < p.IC; ++ic) {
+            const float* fptr = filter + (oc * p.IC + ic) * p.FH * p.FW;
+            for (size_t kh = 0; kh < p.FH; ++kh) {
+                ptrdiff_t ih = ih0 + static_cast<ptrdiff_t>(kh);
+                if (ih < 0 || ih >= static_cast<ptrdiff_t>(p.IH))
+                    continue;
+                const float* in_row = src + (ic * p.IH + ih) * p.IW;
+                for (size_t kw = 0; kw < p.FW; ++kw) {
+                    ptrdiff_t iw = iw0 + static_cast<ptrdiff_t>(kw);
+                    if (iw >= 0 && iw < static_cast<ptrdiff_t>(p.IW)) {
+                        sum += p.weight(fptr, kh, kw) * in_row[iw];
+                    }
+                }
+            }
+        }
+        out[cw] = sum;
+    }
+}
+
+//! apply the nonlinearity to out[begin, end)
+inline void apply_nonline(const KernParam& p, float* out, size_t begin, size_t end) {
+    switch (p.nonline) {
+        case Param::NonlineMode::RELU:
+            for (size_t cw = begin; cw < end; ++cw) {
+                out[cw] = std::max(out[cw], 0.f);
+            }
+            break;
+        case Param::NonlineMode::SIGMOID:
+            for (size_t cw = begin; cw < end; ++cw) {
+                out[cw] = 1.f / (1.f + std::exp(-out[cw]));
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+//! pool dst_row[0, OW) horizontally from the vertically pooled row \p vrow
+inline void pool_cols(const KernParam& p, const float* vrow, float* dst_row) {
+    float area = static_cast<float>(p.WH * p.WW);
+    for (size_t ow = 0; ow < p.OW; ++ow) {
+        ptrdiff_t c0 =
+                static_cast<ptrdiff_t>(ow * p.PSW) - static_cast<ptrdiff_t>(p.PPW);
+        size_t col_begin = std::max<ptrdiff_t>(c0, 0),
+               col_end = std::min<ptrdiff_t>(c0 + p.WW, p.CW);
+        if (p.pool == Param::PoolMode::MAX) {
+            float ans = -std::numeric_limits<float>::infinity();
+            for (size_t c = col_begin; c < col_end; ++c) {
+                ans = std::max(ans, vrow[c]);
+            }
+            dst_row[ow] = ans;
+        } else {
+            //! pads are counted as zeros
+            float sum = 0.f;
+            for (size_t c = col_begin; c < col_end; ++c) {
+                sum += vrow[c];
+            }
+            dst_row[ow] = sum / area;
+        }
+    }
+}
+
+/*!
+ * \brief scalar kernels of one channel
+ *
+ * Specialized kernels (e.g. SIMD ones) should provide the same interface and
+ * can be plugged into exec().
+ */
+struct ScalarConvPoolingKern {
+    //! row \p r of conv output channel oc, with bias and nonlinearity applied
+    static void conv_row(
+            const KernParam& p, const float* src, const float* filter, float bias,
+            size_t oc, size_t r, float* out) {
+        for (size_t cw = 0; cw < p.CW; ++cw) {
+            out[cw] = bias;
+        }
+        ptrdiff_t ih0 =
+                static_cast<ptrdiff_t>(r * p.SH) - static_cast<ptrdiff_t>(p.PH);
+        for (size_t ic = 0; ic < p.IC; ++ic) {
+            const float* fptr = filter + (oc * p.IC + ic) * p.FH * p.FW;
+            for (size_t kh = 0; kh < p.FH; ++kh) {
+                ptrdiff_t ih = ih0 + static_cast<ptrdiff_t>(kh);
+                if (ih < 0 || ih >= static_cast<ptrdiff_t>(p.IH))
+                    continue;
+                const float* in_row = src + (ic * p.IH + ih) * p.IW;
+                for (size_t kw = 0; kw < p.FW; ++kw) {
+                    float w = p.weight(fptr, kh, kw);
+                    //! input column of output column cw is cw * SW + d
+                    ptrdiff_t d =
+                            static_cast<ptrdiff_t>(kw) - static_cast<ptrdiff_t>(p.PW);
+                    if (d >= static_cast<ptrdiff_t>(p.IW))
+                        continue;
+                    size_t cw_begin = d >= 0 ? 0 : div_ceil<size_t>(-d, p.SW),
+                           cw_end = std::min(p.CW, (p.IW - 1 - d) / p.SW + 1);
+                    if (p.SW == 1) {
+                        const float* in = in_row + d;
+                        for (size_t cw = cw_begin; cw < cw_end; ++cw) {
+                            out[cw] += w * in[cw];
+                        }
+                    } else {
+                        for (size_t cw = cw_begin; cw < cw_end; ++cw) {
+                            out[cw] += w * in_row[cw * p.SW + d];
+                        }
+                    }
+                }
+            }
+        }
+        apply_nonline(p, out, 0, p.CW);
+    }
+
+    /*!
+     * \brief pool rows [row_begin, row_end) of the ring \p rows into dst_row
+     * \param vrow CW floats to hold the vertically pooled row
+     */
+    static void pool_row(
+            const KernParam& p, const float* rows, size_t row_begin, size_t row_end,
+            float* vrow, float* dst_row) {
+        for (size_t c = 0; c < p.CW; ++c) {
+            vrow[c] = p.pool == Param::PoolMode::MAX
+                            ? -std::numeric_limits<float>::infinity()
+                            : 0.f;
+        }
+        for (size_t r = row_begin; r < row_end; ++r) {
+            const float* row = rows + r % p.WH * p.CW;
+            if (p.pool == Param::PoolMode::MAX) {
+                for (size_t c = 0; c < p.CW; ++c) {
+                    vrow[c] = std::max(vrow[c], row[c]);
+                }
+            } else {
+                for (size_t c = 0; c < p.CW; ++c) {
+                    vrow[c] += row[c];
+                }
+            }
+        }
+        pool_cols(p, vrow, dst_row);
+    }
+};
+
+/*!
+ * \brief compute dst(n, oc) from src(n) with \p ws holding WH conv output rows
+ *      followed by the vertically pooled row
+ */
+template <class Kern>
+void conv_pooling_channel(
+        const KernParam& p, const float* src, const float* filter, float bias,
+        size_t oc, float* dst, float* ws) {
+    float *rows = ws, *vrow = ws + p.WH * p.CW;
+    //! conv rows below next_row have been computed; row r lives in slot
+    //! r % WH, and is not overwritten before the last window reading it
+    size_t next_row = 0;
+    for (size_t oh = 0; oh < p.OH; ++oh) {
+        ptrdiff_t r0 =
+                static_cast<ptrdiff_t>(oh * p.PSH) - static_cast<ptrdiff_t>(p.PPH);
+        size_t row_begin = std::max<ptrdiff_t>(r0, 0),
+               row_end = std::min<ptrdiff_t>(r0 + p.WH, p.CH);
+        for (size_t r = std::max(next_row, row_begin); r < row_end; ++r) {
+            Kern::conv_row(p, src, filter, bias, oc, r, rows + r % p.WH * p.CW);
+        }
+        next_row = std::max(next_row, row_end);
+        Kern::pool_row(p, rows, row_begin, row_end, vrow, dst + oh * p.OW);
+    }
+}
+
+/*!
+ * \brief run the fused kernel with one task per output channel of one image;
+ *      \p workspace holds get_thread_workspace() floats per thread
+ */
+template <class Kern = ScalarConvPoolingKern>
+void exec(
+        naive::HandleImpl* handle, const KernParam& p, const TensorND& src,
+        const TensorND& filter, const TensorND& bias, const TensorND& dst,
+        const Workspace& workspace) {
+    size_t N = src.layout[0], ws_size = get_thread_workspace(p.WH, p.CW);
+    megdnn_assert(
+            workspace.size >= handle->megcore_dispatcher()->nr_threads() * ws_size *
+                                      sizeof(float));
+    auto kern = [=](size_t task_id, size_t thread_id) {
+        size_t n = task_id / p.OC, oc = task_id % p.OC;
+        conv_pooling_channel<Kern>(
+                p, src.ptr<float>() + n * p.IC * p.IH * p.IW, filter.ptr<float>(),
+                bias.ptr<float>()[oc], oc,
+                dst.ptr<float>() + (n * p.OC + oc) * p.OH * p.OW,
+                workspace.ptr<float>() + thread_id * ws_size);
+    };
+    handle->dispatch_kern(kern, N * p.OC);
+}
+
+}  // namespace convpooling
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
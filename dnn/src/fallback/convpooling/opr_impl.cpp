@@ -0,0 +1,109 @@
+/**
+ * \file dnn/src/fallback/convpooling/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "src/fallback/convpooling/opr_impl.h"
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_fallback_convpooling)
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+size_t get_nr_threads(Handle* handle) {
+    return static_cast<naive::HandleImpl*>(handle)
+            ->megcore_dispatcher()
+            ->nr_threads();
+}
+
+}  // anonymous namespace
+
+bool ConvPoolingForwardImpl::is_fused_available(
+        const TensorLayout& src, const TensorLayout& filter, const TensorLayout& bias,
+        const TensorLayout& dst) const {
+    auto&& p = param();
+    return src.dtype == dtype::Float32() && filter.dtype == dtype::Float32() &&
+           bias.dtype == dtype::Float32() && dst.dtype == dtype::Float32() &&
+           src.ndim == 4 && filter.ndim == 4 && dst.ndim == 4 &&
+           src.is_contiguous() && filter.is_contiguous() && bias.is_contiguous() &&
+           dst.is_contiguous() && bias.total_nr_elems() == filter[0] &&
+           p.pool_pad_h < p.pool_shape_h && p.pool_pad_w < p.pool_shape_w &&
+           p.conv_stride_h && p.conv_stride_w && p.pool_stride_h && p.pool_stride_w;
+}
+
+size_t ConvPoolingForwardImpl::get_workspace_in_bytes(
+        const TensorLayout& src, const TensorLayout& filter, const TensorLayout& bias,
+        const TensorLayout& dst) {
+    if (!is_fused_available(src, filter, bias, dst)) {
+        return naive::ConvPoolingForwardImpl::get_workspace_in_bytes(
+                src, filter, bias, dst);
+    }
+    auto&& p = param();
+    size_t CW = (src[3] + 2 * p.conv_pad_w - filter[3]) / p.conv_stride_w + 1;
+    return get_nr_threads(handle()) *
+           convpooling::get_thread_workspace(p.pool_shape_h, CW) * sizeof(float);
+}
+
+convpooling::KernParam ConvPoolingForwardImpl::make_kern_param(
+        const TensorLayout& src, const TensorLayout& filter, const TensorLayout& bias,
+        const TensorLayout& dst) {
+    TensorLayout dst_expected;
+    deduce_layout(src, filter, bias, dst_expected);
+    megdnn_assert_eq_layout(dst_expected, dst);
+    megdnn_assert(filter[1] == src[1]);
+
+    auto&& param = this->param();
+    convpooling::KernParam p;
+    p.IC = src[1];
+    p.IH = src[2];
+    p.IW = src[3];
+    p.OC = filter[0];
+    p.FH = filter[2];
+    p.FW = filter[3];
+    p.SH = param.conv_stride_h;
+    p.SW = param.conv_stride_w;
+    p.PH = param.conv_pad_h;
+    p.PW = param.conv_pad_w;
+    p.CH = (p.IH + 2 * p.PH - p.FH) / p.SH + 1;
+    p.CW = (p.IW + 2 * p.PW - p.FW) / p.SW + 1;
+    p.WH = param.pool_shape_h;
+    p.WW = param.pool_shape_w;
+    p.PSH = param.pool_stride_h;
+    p.PSW = param.pool_stride_w;
+    p.PPH = param.pool_pad_h;
+    p.PPW = param.pool_pad_w;
+    p.OH = dst[2];
+    p.OW = dst[3];
+    p.xcorr = param.convMode == Param::ConvMode::CROSS_CORRELATION;
+    p.nonline = param.nonlineMode;
+    p.pool = param.poolMode;
+    return p;
+}
+
+void ConvPoolingForwardImpl::exec(
+        const _megdnn_in TensorND src, const _megdnn_in TensorND filter,
+        const _megdnn_in TensorND bias, _megdnn_out TensorND dst,
+        _megdnn_out Workspace workspace) {
+    if (!is_fused_available(src.layout, filter.layout, bias.layout, dst.layout)) {
+        naive::ConvPoolingForwardImpl::exec(src, filter, bias, dst, workspace);
+        return;
+    }
+    auto p = make_kern_param(src.layout, filter.layout, bias.layout, dst.layout);
+    MIDOUT_BEGIN(megdnn_fallback_convpooling, midout_iv(0)) {
+        convpooling::exec(
+                static_cast<naive::HandleImpl*>(handle()), p, src, filter, bias, dst,
+                workspace);
+    }
+    MIDOUT_END();
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,52 @@
+/**
+ * \file dnn/src/fallback/convpooling/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+#include "src/fallback/convpooling/convpooling_helper.h"
+#include "src/naive/convpooling/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+
+/*!
+ * \brief conv + bias + nonlinearity + pooling without the conv output
+ *
+ * Each task computes one output channel of one image. Conv output rows are
+ * produced into a ring buffer of pool_shape_h rows just before the pooled
+ * rows that need them, so the conv output never leaves the cache. Float32
+ * NCHW is supported; other cases fall back to naive. The kernels here are
+ * scalar, and x86/arm_common plug in SIMD ones, see convpooling_helper.h.
+ */
+class ConvPoolingForwardImpl : public naive::ConvPoolingForwardImpl {
+public:
+    using naive::ConvPoolingForwardImpl::ConvPoolingForwardImpl;
+    void exec(
+            const _megdnn_in TensorND src, const _megdnn_in TensorND filter,
+            const _megdnn_in TensorND bias, _megdnn_out TensorND dst,
+            _megdnn_out Workspace workspace) override;
+    size_t get_workspace_in_bytes(
+            const TensorLayout& src, const TensorLayout& filter,
+            const TensorLayout& bias, const TensorLayout& dst) override;
+
+protected:
+    bool is_fused_available(
+            const TensorLayout& src, const TensorLayout& filter,
+            const TensorLayout& bias, const TensorLayout& dst) const;
+
+    //! check the layouts of a fused exec and get its kernel param
+    convpooling::KernParam make_kern_param(
+            const TensorLayout& src, const TensorLayout& filter,
+            const TensorLayout& bias, const TensorLayout& dst);
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,203 @@
+/**
+ * \file dnn/src/fallback/cumsum/cumsum_helper.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include <algorithm>
+
+namespace megdnn {
+namespace fallback {
+namespace cumsum {
+
+//! number of elements of a block in the two-pass scan of long axes; it does
+//! not depend on the number of threads, so results are reproducible
+constexpr size_t BLOCK_SIZE = 16384;
+//! number of columns scanned together when the axis is not the last one
+constexpr size_t COL_CHUNK = 256;
+//! expected minimal number of elements processed by one task
+constexpr size_t MIN_TASK_SIZE = 4096;
+
+/*!
+ * \brief scalar scan kernels on a contiguous segment
+ *
+ * Specialized kernels (e.g. SIMD ones) should provide the same interface and
+ * can be plugged into exec_cumsum().
+ */
+template <typename T>
+struct ScalarScanKern {
+    /*!
+     * \brief scan src[0, len) from the beginning, with \p init added to every
+     *      output
+     * \return init + sum(src[0, len))
+     */
+    static T forward(const T* src, T* dst, size_t len, T init, bool exclusive) {
+        T sum = init;
+        if (exclusive) {
+            for (size_t i = 0; i < len; ++i) {
+                dst[i] = sum;
+                sum += src[i];
+            }
+        } else {
+            for (size_t i = 0; i < len; ++i) {
+                sum += src[i];
+                dst[i] = sum;
+            }
+        }
+        return sum;
+    }
+
+    //! like forward(), but scan from the end of the segment
+    static T backward(const T* src, T* dst, size_t len, T init, bool exclusive) {
+        T sum = init;
+        if (exclusive) {
+            for (size_t i = len; i > 0; --i) {
+                dst[i - 1] = sum;
+                sum += src[i - 1];
+            }
+        } else {
+            for (size_t i = len; i > 0; --i) {
+                sum += src[i - 1];
+                dst[i - 1] = sum;
+            }
+        }
+        return sum;
+    }
+
+    static T sum(const T* src, size_t len) {
+        T sum = T(0);
+        for (size_t i = 0; i < len; ++i) {
+            sum += src[i];
+        }
+        return sum;
+    }
+};
+
+//! whether the two-pass blocked scan is used
+inline bool use_blocked_scan(size_t B, size_t C) {
+    return C == 1 && B > BLOCK_SIZE;
+}
+
+inline size_t get_workspace_in_bytes(
+        size_t A, size_t B, size_t C, size_t dtype_size) {
+    if (use_blocked_scan(B, C)) {
+        return A * div_ceil(B, BLOCK_SIZE) * dtype_size;
+    }
+    return 0;
+}
+
+/*!
+ * \brief scan along axis B of a contiguous tensor of shape (A, B, C)
+ *
+ * - C > 1: columns are scanned in chunks of COL_CHUNK, which is vectorized
+ *   along C; tasks are split over A and the column chunks
+ * - C == 1 and short B: rows are grouped into tasks
+ * - C == 1 and long B: two-pass scan; the first pass computes the sum of each
+ *   block, followed by a serial scan of the block sums, and the second pass
+ *   scans each block with its offset
+ *
+ * \param workspace at least get_workspace_in_bytes() bytes
+ */
+template <typename T, typename Kern = ScalarScanKern<T>>
+void exec_cumsum(
+        naive::HandleImpl* handle, const TensorND& src, const TensorND& dst,
+        void* workspace, size_t A, size_t B, size_t C, bool exclusive, bool reverse) {
+    if (C > 1) {
+        size_t nr_chunks = div_ceil(C, COL_CHUNK);
+        auto kern = [=](size_t task_id, size_t) {
+            size_t a = task_id / nr_chunks, c0 = task_id % nr_chunks * COL_CHUNK;
+            size_t width = std::min(COL_CHUNK, C - c0);
+            const T* sptr = src.ptr<T>() + a * B * C + c0;
+            T* dptr = dst.ptr<T>() + a * B * C + c0;
+            T acc[COL_CHUNK];
+            std::fill_n(acc, width, T(0));
+            for (size_t i = 0; i < B; ++i) {
+                size_t b = reverse ? B - 1 - i : i;
+                const T* s = sptr + b * C;
+                T* d = dptr + b * C;
+                if (exclusive) {
+                    for (size_t c = 0; c < width; ++c) {
+                        d[c] = acc[c];
+                        acc[c] += s[c];
+                    }
+                } else {
+                    for (size_t c = 0; c < width; ++c) {
+                        acc[c] += s[c];
+                        d[c] = acc[c];
+                    }
+                }
+            }
+        };
+        handle->dispatch_kern(kern, A * nr_chunks);
+        return;
+    }
+
+    auto scan = [exclusive, reverse](const T* s, T* d, size_t len, T init) {
+        return reverse ? Kern::backward(s, d, len, init, exclusive)
+                       : Kern::forward(s, d, len, init, exclusive);
+    };
+
+    if (!use_blocked_scan(B, C)) {
+        size_t rows_per_task = std::max<size_t>(1, MIN_TASK_SIZE / B);
+        size_t nr_tasks = div_ceil(A, rows_per_task);
+        auto kern = [=](size_t task_id, size_t) {
+            size_t row_end = std::min(A, (task_id + 1) * rows_per_task);
+            for (size_t a = task_id * rows_per_task; a < row_end; ++a) {
+                scan(src.ptr<T>() + a * B, dst.ptr<T>() + a * B, B, T(0));
+            }
+        };
+        handle->dispatch_kern(kern, nr_tasks);
+        return;
+    }
+
+    size_t nr_blocks = div_ceil(B, BLOCK_SIZE);
+    T* block_sums = static_cast<T*>(workspace);
+    auto block_range = [B, reverse](size_t blk, size_t& begin, size_t& len) {
+        //! block 0 is always the one where the scan starts
+        begin = blk * BLOCK_SIZE;
+        len = std::min(BLOCK_SIZE, B - begin);
+        if (reverse) {
+            begin = B - begin - len;
+        }
+    };
+    auto sum_kern = [=](size_t task_id, size_t) {
+        size_t a = task_id / nr_blocks, blk = task_id % nr_blocks, begin, len;
+        block_range(blk, begin, len);
+        block_sums[task_id] = Kern::sum(src.ptr<T>() + a * B + begin, len);
+    };
+    handle->dispatch_kern(sum_kern, A * nr_blocks);
+    auto offset_kern = [=]() {
+        for (size_t a = 0; a < A; ++a) {
+            T* sums = block_sums + a * nr_blocks;
+            T acc = T(0);
+            for (size_t blk = 0; blk < nr_blocks; ++blk) {
+                T cur = sums[blk];
+                sums[blk] = acc;
+                acc += cur;
+            }
+        }
+    };
+    handle->dispatch_kern(offset_kern);
+    auto scan_kern = [=](size_t task_id, size_t) {
+        size_t a = task_id / nr_blocks, blk = task_id % nr_blocks, begin, len;
+        block_range(blk, begin, len);
+        scan(src.ptr<T>() + a * B + begin, dst.ptr<T>() + a * B + begin, len,
+             block_sums[task_id]);
+    };
+    handle->dispatch_kern(scan_kern, A * nr_blocks);
+}
+
+}  // namespace cumsum
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
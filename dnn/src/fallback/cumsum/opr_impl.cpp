@@ -0,0 +1,58 @@
+/**
+ * \file dnn/src/fallback/cumsum/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "src/fallback/cumsum/opr_impl.h"
+#include "src/fallback/cumsum/cumsum_helper.h"
+
+#include "src/common/reduce_helper.h"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_fallback_cumsum)
+
+namespace megdnn {
+namespace fallback {
+
+size_t CumsumForwardImpl::get_workspace_in_bytes(
+        const TensorLayout& src, const TensorLayout&) {
+    size_t A, B, C;
+    reduce::get_ABC(src, A, B, C, param().axis);
+    return cumsum::get_workspace_in_bytes(A, B, C, src.dtype.size());
+}
+
+void CumsumForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(src.layout, dst.layout, workspace.size);
+
+    size_t A, B, C;
+    reduce::get_ABC(src.layout, A, B, C, param().axis);
+    auto handle_ptr = static_cast<naive::HandleImpl*>(handle());
+#define cb(DType)                                                     \
+    if (src.layout.dtype == DType()) {                                \
+        using ctype = DTypeTrait<DType>::ctype;                       \
+        MIDOUT_BEGIN(megdnn_fallback_cumsum, ctype) {                 \
+            cumsum::exec_cumsum<ctype>(                               \
+                    handle_ptr, src, dst, workspace.raw_ptr, A, B, C, \
+                    param().exclusive, param().reverse);              \
+            return;                                                   \
+        }                                                             \
+        MIDOUT_END();                                                 \
+    }
+    MEGDNN_FOREACH_COMPUTING_DTYPE(cb)
+#undef cb
+    naive::CumsumForwardImpl::exec(src, dst, workspace);
+}
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -14,216 +14,289 @@
 #include "src/common/utils.h"
 #include "src/naive/handle.h"
 
+#include <algorithm>
+
 #include "midout.h"
 
-MIDOUT_DECL(megdnn_fallback_elemwise_unary)
-MIDOUT_DECL(megdnn_fallback_elemwise_binary)
+MIDOUT_DECL(megdnn_fallback_elemwise_strided)
 MIDOUT_DECL(megdnn_fallback_elemwise_exec_UNARY_INT)
 MIDOUT_DECL(megdnn_fallback_elemwise_exec_UNARY_FLOAT)
+MIDOUT_DECL(megdnn_fallback_elemwise_exec_UNARY_BOOL)
 MIDOUT_DECL(megdnn_fallback_elemwise_exec_BINARY_INT)
 MIDOUT_DECL(megdnn_fallback_elemwise_exec_BINARY_FLOAT)
+MIDOUT_DECL(megdnn_fallback_elemwise_exec_BINARY_BOOL)
+MIDOUT_DECL(megdnn_fallback_elemwise_exec_TERNARY_INT)
+MIDOUT_DECL(megdnn_fallback_elemwise_exec_TERNARY_FLOAT)
 
-namespace megdnn {
-namespace fallback {
+using namespace megdnn;
 
-template <typename dtype, uint32_t mode>
-void ElemwiseImpl::unary_kern(const ElemwiseOpParamN<1>& param) {
-    using ctype = typename DTypeTrait<dtype>::ctype;
-    using Kern = ElemwiseKern<megcorePlatformCPU, mode, ctype>;
-    MIDOUT_BEGIN(megdnn_fallback_elemwise_unary, ctype, midout_iv(mode)) {
-        // only specialize for the most common 1-dim case
-        auto tot = param.size;
-        auto stride = param[0].layout.stride[0];
-        auto src0 = param[0];
-        auto dst_tensor = *m_dst;
-        if (param.max_ndim == 1) {
-            MIDOUT_BEGIN(
-                    megdnn_fallback_elemwise_unary, ctype, midout_iv(mode),
-                    midout_iv(1)) {
-                MEGDNN_DISPATCH_CPU_KERN_OPR({
-                    ctype* __restrict src = static_cast<ctype*>(src0.raw_ptr());
-                    ctype* __restrict dst = static_cast<ctype*>(dst_tensor.raw_ptr());
-                    for (size_t i = 0; i < tot; ++i) {
-                        dst[i] = Kern::apply(src[i * stride]);
-                    }
-                });
-                return;
-            }
-            MIDOUT_END();
+namespace {
+
+/*!
+ * \brief the operands broadcast to the shape of dst, with size-1 axes dropped
+ *      and adjacent axes merged if they are contiguous for every operand
+ *
+ * e.g. adding a (1, 1, 1, C) bias to an NHWC tensor becomes a (N*H*W, C) loop
+ * and a (1, C, 1, 1) bias to an NCHW tensor becomes a (N, C, H*W) loop.
+ */
+template <int arity>
+struct CollapsedLayout {
+    size_t ndim, size;
+    size_t shape[TensorLayout::MAX_NDIM];
+    ptrdiff_t stride[arity][TensorLayout::MAX_NDIM];
+};
+
+template <int arity>
+CollapsedLayout<arity> collapse_layouts(
+        const TensorNDArray& srcs, const TensorLayout& dst) {
+    TensorLayout src[arity];
+    for (int i = 0; i < arity; ++i) {
+        src[i] = srcs[i].layout.broadcast(dst);
+    }
+    CollapsedLayout<arity> ret;
+    ret.ndim = 0;
+    ret.size = dst.total_nr_elems();
+    for (size_t axis = dst.ndim; axis--;) {
+        if (dst.shape[axis] == 1) {
+            continue;
+        }
+        bool merge = ret.ndim > 0;
+        for (int i = 0; i < arity && merge; ++i) {
+            size_t last = ret.ndim - 1;
+            merge = src[i].stride[axis] ==
+                    ret.stride[i][last] * static_cast<ptrdiff_t>(ret.shape[last]);
+        }
+        if (merge) {
+            ret.shape[ret.ndim - 1] *= dst.shape[axis];
+            continue;
+        }
+        ret.shape[ret.ndim] = dst.shape[axis];
+        for (int i = 0; i < arity; ++i) {
+            ret.stride[i][ret.ndim] = src[i].stride[axis];
         }
-        naive::ElemwiseForwardImpl::exec(*m_src, *m_dst);
+        ++ret.ndim;
     }
-    MIDOUT_END();
+    if (!ret.ndim) {
+        ret.ndim = 1;
+        ret.shape[0] = 1;
+        for (int i = 0; i < arity; ++i) {
+            ret.stride[i][0] = 0;
+        }
+    }
+    //! the axes are collected from the innermost one
+    std::reverse(ret.shape, ret.shape + ret.ndim);
+    for (int i = 0; i < arity; ++i) {
+        std::reverse(ret.stride[i], ret.stride[i] + ret.ndim);
+    }
+    return ret;
 }
 
-template <typename dtype, uint32_t mode>
-void ElemwiseImpl::binary_kern(const ElemwiseOpParamN<2>& param) {
-    using ctype = typename DTypeTrait<dtype>::ctype;
-    using Kern = ElemwiseKern<megcorePlatformCPU, mode, ctype>;
+template <int arity>
+struct StridedParam {
+    CollapsedLayout<arity> layout;
+    TensorND src[arity];
+    TensorND dst;
+};
 
-    MIDOUT_BEGIN(megdnn_fallback_elemwise_binary, ctype, midout_iv(mode)) {
-        if (param.max_ndim == 1) {
-            MIDOUT_BEGIN(
-                    megdnn_fallback_elemwise_binary, ctype, midout_iv(mode),
-                    midout_iv(1)) {
-                auto tot = param.size;
-                auto as = param[0].layout.stride[0], bs = param[1].layout.stride[0];
-                auto src0 = param[0];
-                auto src1 = param[1];
-                auto dst_tensor = *m_dst;
-
-                MEGDNN_DISPATCH_CPU_KERN_OPR({
-                    ctype* __restrict a = static_cast<ctype*>(src0.raw_ptr());
-                    ctype* __restrict b = static_cast<ctype*>(src1.raw_ptr());
-                    ctype* __restrict dst = static_cast<ctype*>(dst_tensor.raw_ptr());
-                    for (size_t i = 0; i < tot; ++i) {
-                        dst[i] = Kern::apply(a[i * as], b[i * bs]);
-                    }
-                });
-                return;
+//! how an operand moves along the innermost axis
+enum class StrideClass { CONTIG, SCALAR, STRIDED };
+
+template <StrideClass cls>
+MEGDNN_ALWAYS_INLINE ptrdiff_t inner_stride(ptrdiff_t stride) {
+    return cls == StrideClass::CONTIG ? 1 : (cls == StrideClass::SCALAR ? 0 : stride);
+}
+
+/*!
+ * \brief dst[0:len] = Kern(src[0][i * stride[0]], ...)
+ *
+ * The strides of contiguous and scalar operands are compile-time constants, so
+ * the compiler can vectorize the loop for the target.
+ */
+template <typename ctype, class Kern, StrideClass... cls>
+struct InnerLoop;
+
+template <typename ctype, class Kern, StrideClass c0>
+struct InnerLoop<ctype, Kern, c0> {
+    static void run(
+            const ctype* const* src, const ptrdiff_t* stride, ctype* __restrict dst,
+            ptrdiff_t len) {
+        const ctype* __restrict a = src[0];
+        ptrdiff_t sa = inner_stride<c0>(stride[0]);
+        for (ptrdiff_t i = 0; i < len; ++i) {
+            dst[i] = Kern::apply(a[i * sa]);
+        }
+    }
+};
+
+template <typename ctype, class Kern, StrideClass c0, StrideClass c1>
+struct InnerLoop<ctype, Kern, c0, c1> {
+    static void run(
+            const ctype* const* src, const ptrdiff_t* stride, ctype* __restrict dst,
+            ptrdiff_t len) {
+        const ctype* __restrict a = src[0];
+        const ctype* __restrict b = src[1];
+        ptrdiff_t sa = inner_stride<c0>(stride[0]), sb = inner_stride<c1>(stride[1]);
+        for (ptrdiff_t i = 0; i < len; ++i) {
+            dst[i] = Kern::apply(a[i * sa], b[i * sb]);
+        }
+    }
+};
+
+template <typename ctype, class Kern, StrideClass c0, StrideClass c1, StrideClass c2>
+struct InnerLoop<ctype, Kern, c0, c1, c2> {
+    static void run(
+            const ctype* const* src, const ptrdiff_t* stride, ctype* __restrict dst,
+            ptrdiff_t len) {
+        const ctype* __restrict a = src[0];
+        const ctype* __restrict b = src[1];
+        const ctype* __restrict c = src[2];
+        ptrdiff_t sa = inner_stride<c0>(stride[0]), sb = inner_stride<c1>(stride[1]),
+                  sc = inner_stride<c2>(stride[2]);
+        for (ptrdiff_t i = 0; i < len; ++i) {
+            dst[i] = Kern::apply(a[i * sa], b[i * sb], c[i * sc]);
+        }
+    }
+};
+
+//! compute the elements [begin, end) of dst in the flattened order
+template <typename ctype, class Kern, StrideClass... cls>
+void run_chunk(const StridedParam<sizeof...(cls)>& param, size_t begin, size_t end) {
+    constexpr int arity = sizeof...(cls);
+    auto&& ly = param.layout;
+    size_t ndim = ly.ndim, inner = ly.shape[ndim - 1];
+    size_t idx[TensorLayout::MAX_NDIM];
+    const ctype* src[arity];
+    ptrdiff_t stride[arity];
+    for (int i = 0; i < arity; ++i) {
+        src[i] = static_cast<const ctype*>(param.src[i].raw_ptr());
+        stride[i] = ly.stride[i][ndim - 1];
+    }
+    for (size_t axis = ndim, rem = begin; axis--;) {
+        idx[axis] = rem % ly.shape[axis];
+        rem /= ly.shape[axis];
+        for (int i = 0; i < arity; ++i) {
+            src[i] += static_cast<ptrdiff_t>(idx[axis]) * ly.stride[i][axis];
+        }
+    }
+    ctype* dst = static_cast<ctype*>(param.dst.raw_ptr()) + begin;
+    for (size_t pos = begin; pos < end;) {
+        size_t len = std::min(inner - idx[ndim - 1], end - pos);
+        InnerLoop<ctype, Kern, cls...>::run(src, stride, dst, len);
+        pos += len;
+        dst += len;
+        idx[ndim - 1] += len;
+        for (int i = 0; i < arity; ++i) {
+            src[i] += static_cast<ptrdiff_t>(len) * stride[i];
+        }
+        for (size_t axis = ndim - 1; axis && idx[axis] == ly.shape[axis]; --axis) {
+            idx[axis] = 0;
+            ++idx[axis - 1];
+            for (int i = 0; i < arity; ++i) {
+                src[i] += ly.stride[i][axis - 1] -
+                          static_cast<ptrdiff_t>(ly.shape[axis]) * ly.stride[i][axis];
             }
-            MIDOUT_END();
         }
+    }
+}
 
-        if (std::min(param[0].layout.ndim, param[1].layout.ndim) > 1) {
-            return naive::ElemwiseForwardImpl::exec(*m_src, *m_dst);
+template <int arity>
+using ChunkFunc = void (*)(const StridedParam<arity>&, size_t, size_t);
+
+//! select the loop specialized for the classes of the operands
+template <typename ctype, class Kern, int nr_left, StrideClass... cls>
+struct ChunkFuncSelector {
+    static ChunkFunc<nr_left + sizeof...(cls)> get(const StrideClass* classes) {
+        if (classes[sizeof...(cls)] == StrideClass::SCALAR) {
+            return ChunkFuncSelector<
+                    ctype, Kern, nr_left - 1, cls...,
+                    StrideClass::SCALAR>::get(classes);
         }
+        return ChunkFuncSelector<
+                ctype, Kern, nr_left - 1, cls..., StrideClass::CONTIG>::get(classes);
+    }
+};
 
-        if (param.max_ndim == 2) {
-            if (param[0].layout.ndim == 1) {
-                MIDOUT_BEGIN(
-                        megdnn_fallback_elemwise_binary, ctype, midout_iv(mode),
-                        midout_iv(21)) {
-                    auto as = param[0].layout.stride[0],
-                         bs0 = param[1].layout.stride[0],
-                         bs1 = param[1].layout.stride[1];
-                    auto n0 = param[1].layout.shape[0], n1 = param[1].layout.shape[1];
-                    auto src0 = param[0];
-                    auto src1 = param[1];
-                    auto dst_tensor = *m_dst;
-
-                    MEGDNN_DISPATCH_CPU_KERN_OPR({
-                        ctype* __restrict a = static_cast<ctype*>(src0.raw_ptr());
-                        ctype* __restrict b = static_cast<ctype*>(src1.raw_ptr());
-                        ctype* __restrict dst =
-                                static_cast<ctype*>(dst_tensor.raw_ptr());
-                        ptrdiff_t toff = 0;
-                        for (size_t i = 0; i < n0; ++i) {
-                            for (size_t j = 0; j < n1; ++j) {
-                                dst[toff] =
-                                        Kern::apply(a[as * toff], b[bs0 * i + bs1 * j]);
-                                ++toff;
-                            }
-                        }
-                    });
-                    return;
-                }
-                MIDOUT_END();
-            }
+template <typename ctype, class Kern, StrideClass... cls>
+struct ChunkFuncSelector<ctype, Kern, 0, cls...> {
+    static ChunkFunc<sizeof...(cls)> get(const StrideClass*) {
+        return run_chunk<ctype, Kern, cls...>;
+    }
+};
 
-            MIDOUT_BEGIN(
-                    megdnn_fallback_elemwise_binary, ctype, midout_iv(mode),
-                    midout_iv(22)) {
-                megdnn_assert(param[1].layout.ndim == 1);
-                auto bs = param[1].layout.stride[0], as0 = param[0].layout.stride[0],
-                     as1 = param[0].layout.stride[1];
-                auto n0 = param[0].layout.shape[0], n1 = param[0].layout.shape[1];
-                auto src0 = param[0];
-                auto src1 = param[1];
-                auto dst_tensor = *m_dst;
-
-                MEGDNN_DISPATCH_CPU_KERN_OPR({
-                    ctype* __restrict a = static_cast<ctype*>(src0.raw_ptr());
-                    ctype* __restrict b = static_cast<ctype*>(src1.raw_ptr());
-                    ctype* __restrict dst = static_cast<ctype*>(dst_tensor.raw_ptr());
-                    ptrdiff_t toff = 0;
-                    for (size_t i = 0; i < n0; ++i) {
-                        for (size_t j = 0; j < n1; ++j) {
-                            dst[toff] = Kern::apply(a[as0 * i + as1 * j], b[toff * bs]);
-                            ++toff;
-                        }
-                    }
-                });
-                return;
-            }
-            MIDOUT_END();
-        }
+//! strided operands are rare enough to share a single loop with all the
+//! strides known at runtime
+template <typename ctype, class Kern, int nr_left, StrideClass... cls>
+struct AllStrided
+        : AllStrided<ctype, Kern, nr_left - 1, StrideClass::STRIDED, cls...> {};
 
-        if (param.max_ndim == 3) {
-            auto brd_101 = [](const TensorND& t) {
-                auto&& l = t.layout;
-                return l.ndim == 3 && l.stride[0] == 0 && l.stride[2] == 0;
-            };
-            if (param[0].layout.ndim == 1 && brd_101(param[1])) {
-                MIDOUT_BEGIN(
-                        megdnn_fallback_elemwise_binary, ctype, midout_iv(mode),
-                        midout_iv(31)) {
-                    auto as = param[0].layout.stride[0], bs = param[1].layout.stride[1];
-                    auto n0 = param[1].layout.shape[0], n1 = param[1].layout.shape[1],
-                         n2 = param[1].layout.shape[2];
-                    auto src0 = param[0];
-                    auto src1 = param[1];
-                    auto dst_tensor = *m_dst;
-
-                    MEGDNN_DISPATCH_CPU_KERN_OPR({
-                        ctype* __restrict a = static_cast<ctype*>(src0.raw_ptr());
-                        ctype* __restrict b = static_cast<ctype*>(src1.raw_ptr());
-                        ctype* __restrict dst =
-                                static_cast<ctype*>(dst_tensor.raw_ptr());
-                        size_t toff = 0;
-                        for (size_t i = 0; i < n0; ++i) {
-                            for (size_t j = 0; j < n1; ++j) {
-                                for (size_t k = 0; k < n2; ++k) {
-                                    dst[toff] = Kern::apply(a[as * toff], b[bs * j]);
-                                    ++toff;
-                                }
-                            }
-                        }
-                    });
-                    return;
-                }
-                MIDOUT_END();
-            }
-            if (param[1].layout.ndim == 1 && brd_101(param[0])) {
-                MIDOUT_BEGIN(
-                        megdnn_fallback_elemwise_binary, ctype, midout_iv(mode),
-                        midout_iv(32)) {
-                    auto as = param[0].layout.stride[1], bs = param[1].layout.stride[0];
-                    auto n0 = param[0].layout.shape[0], n1 = param[0].layout.shape[1],
-                         n2 = param[0].layout.shape[2];
-                    auto src0 = param[0];
-                    auto src1 = param[1];
-                    auto dst_tensor = *m_dst;
-                    MEGDNN_DISPATCH_CPU_KERN_OPR({
-                        ctype* __restrict a = static_cast<ctype*>(src0.raw_ptr());
-                        ctype* __restrict b = static_cast<ctype*>(src1.raw_ptr());
-                        ctype* __restrict dst =
-                                static_cast<ctype*>(dst_tensor.raw_ptr());
-                        size_t toff = 0;
-                        for (size_t i = 0; i < n0; ++i) {
-                            for (size_t j = 0; j < n1; ++j) {
-                                for (size_t k = 0; k < n2; ++k) {
-                                    dst[toff] = Kern::apply(a[as * j], b[bs * toff]);
-                                    ++toff;
-                                }
-                            }
-                        }
-                    });
-                    return;
-                }
-                MIDOUT_END();
-            }
-        }
+template <typename ctype, class Kern, StrideClass... cls>
+struct AllStrided<ctype, Kern, 0, cls...> {
+    static ChunkFunc<sizeof...(cls)> get() { return run_chunk<ctype, Kern, cls...>; }
+};
 
-        naive::ElemwiseForwardImpl::exec(*m_src, *m_dst);
+//! bytes of all the operands touched by one task, so that a task stays in the
+//! L2 cache and tasks are fine-grained enough to balance among threads
+constexpr size_t TASK_BYTES = 64 * 1024;
+//! task boundaries are aligned to cache lines of dst to avoid false sharing
+constexpr size_t TASK_ALIGN = 64;
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace fallback {
+
+template <int arity, typename dtype, uint32_t mode>
+void ElemwiseImpl::strided_kern() {
+    using ctype = typename DTypeTrait<dtype>::ctype;
+    using Kern = ElemwiseKern<megcorePlatformCPU, mode, ctype>;
+    MIDOUT_BEGIN(
+            megdnn_fallback_elemwise_strided, ctype, midout_iv(mode),
+            midout_iv(arity)) {
+        auto elparam = make_elemwise_op_param<arity>();
+        StridedParam<arity> param;
+        param.layout = collapse_layouts<arity>(*m_src, m_dst->layout);
+        megdnn_assert(param.layout.size == elparam.size);
+        param.dst = *m_dst;
+        StrideClass classes[arity];
+        bool strided = false;
+        for (int i = 0; i < arity; ++i) {
+            param.src[i] = elparam[i];
+            auto stride = param.layout.stride[i][param.layout.ndim - 1];
+            classes[i] = stride == 1   ? StrideClass::CONTIG
+                       : stride == 0 ? StrideClass::SCALAR
+                                     : StrideClass::STRIDED;
+            strided |= classes[i] == StrideClass::STRIDED;
+        }
+        auto func = strided ? AllStrided<ctype, Kern, arity>::get()
+                            : ChunkFuncSelector<ctype, Kern, arity>::get(classes);
+
+        size_t size = param.layout.size,
+               chunk = round_up(
+                       std::max(TASK_BYTES / ((arity + 1) * sizeof(ctype)), TASK_ALIGN),
+                       TASK_ALIGN);
+        if (size <= chunk) {
+            MEGDNN_DISPATCH_CPU_KERN_OPR(func(param, 0, size));
+            return;
+        }
+        auto kern = [param, func, size, chunk](size_t index, size_t) {
+            size_t begin = index * chunk;
+            func(param, begin, std::min(begin + chunk, size));
+        };
+        MEGDNN_DISPATCH_MULTI_THREAD_CPU_KERN_OPR(kern, div_ceil(size, chunk));
     }
     MIDOUT_END();
 }
 
 void ElemwiseImpl::exec(const TensorNDArray& srcs, _megdnn_tensor_out dst) {
-    if (!dst.layout.is_contiguous()) {
+    if (!dst.layout.is_contiguous() ||
+        dst.layout.format.type() != TensorFormat::Type::DEFAULT) {
         return naive::ElemwiseForwardImpl::exec(srcs, dst);
     }
+    for (auto&& src : srcs) {
+        if (src.layout.format.type() != TensorFormat::Type::DEFAULT) {
+            return naive::ElemwiseForwardImpl::exec(srcs, dst);
+        }
+    }
 
     m_src = &srcs;
     m_dst = &dst;
@@ -255,6 +328,19 @@ void ElemwiseImpl::exec(const TensorNDArray& srcs, _megdnn_tensor_out dst) {
         if (srcs.size() == 2) {
 #define ARITY BINARY
             SWITCH_MODE
+#undef ARITY
+        }
+
+        if (srcs.size() == 3) {
+#define ARITY TERNARY
+            //! FUSE_MUL_ADD3 is only listed as a float mode, but it is also
+            //! defined for integers
+            switch (m_param.mode) {
+                MEGDNN_FOREACH_ELEMWISE_MODE_TERNARY_INT(SWITCH_MODE_CB)
+                MEGDNN_ELEMWISE_MODE_ENABLE(FUSE_MUL_ADD3, SWITCH_MODE_CB)
+                default:
+                    megdnn_throw("bad mode");
+            }
 #undef ARITY
         }
 #undef CAT
@@ -271,10 +357,33 @@ void ElemwiseImpl::exec(const TensorNDArray& srcs, _megdnn_tensor_out dst) {
             SWITCH_MODE
 #undef ARITY
         }
+
+        if (srcs.size() == 3) {
+#define ARITY TERNARY
+            SWITCH_MODE
+#undef ARITY
+        }
+#undef CAT
+    } else if (dst.layout.dtype.category() == DTypeCategory::BOOL) {
+#define CAT BOOL
+        if (srcs.size() == 1) {
+#define ARITY UNARY
+            SWITCH_MODE
+#undef ARITY
+        }
+
+        if (srcs.size() == 2) {
+#define ARITY BINARY
+            SWITCH_MODE
+#undef ARITY
+        }
 #undef CAT
     }
 
-#undef cb
+#undef SWITCH_MODE
+#undef SWITCH_MODE_CB
+#undef CONCAT
+#undef CONCAT2
     naive::ElemwiseForwardImpl::exec(srcs, dst);
 }
 
@@ -286,10 +395,9 @@ void ElemwiseImpl::exec(const TensorNDArray& srcs, _megdnn_tensor_out dst) {
 
 template <uint32_t mode>
 void ElemwiseImpl::exec_UNARY_INT() {
-    auto param = make_elemwise_op_param<1>();
 #define cb(_dt)                  \
     case DTypeTrait<_dt>::enumv: \
-        return unary_kern<_dt, mode>(param);
+        return strided_kern<1, _dt, mode>();
 
     SWITCH_DTYPE(INT, cb)
 
@@ -298,22 +406,26 @@ void ElemwiseImpl::exec_UNARY_INT() {
 
 template <uint32_t mode>
 void ElemwiseImpl::exec_UNARY_FLOAT() {
-    auto param = make_elemwise_op_param<1>();
 #define cb(_dt)                  \
     case DTypeTrait<_dt>::enumv: \
-        return unary_kern<_dt, mode>(param);
+        return strided_kern<1, _dt, mode>();
 
     SWITCH_DTYPE(FLOAT, cb)
 
 #undef cb
 }
 
+template <uint32_t mode>
+void ElemwiseImpl::exec_UNARY_BOOL() {
+    megdnn_assert(m_dst->layout.dtype == dtype::Bool(), "bad dtype");
+    strided_kern<1, dtype::Bool, mode>();
+}
+
 template <uint32_t mode>
 void ElemwiseImpl::exec_BINARY_INT() {
-    auto param = make_elemwise_op_param<2>();
 #define cb(_dt)                  \
     case DTypeTrait<_dt>::enumv: \
-        return binary_kern<_dt, mode>(param);
+        return strided_kern<2, _dt, mode>();
 
     SWITCH_DTYPE(INT, cb)
 
@@ -322,10 +434,37 @@ void ElemwiseImpl::exec_BINARY_INT() {
 
 template <uint32_t mode>
 void ElemwiseImpl::exec_BINARY_FLOAT() {
-    auto param = make_elemwise_op_param<2>();
 #define cb(_dt)                  \
     case DTypeTrait<_dt>::enumv: \
-        return binary_kern<_dt, mode>(param);
+        return strided_kern<2, _dt, mode>();
+
+    SWITCH_DTYPE(FLOAT, cb)
+
+#undef cb
+}
+
+template <uint32_t mode>
+void ElemwiseImpl::exec_BINARY_BOOL() {
+    megdnn_assert(m_dst->layout.dtype == dtype::Bool(), "bad dtype");
+    strided_kern<2, dtype::Bool, mode>();
+}
+
+template <uint32_t mode>
+void ElemwiseImpl::exec_TERNARY_INT() {
+#define cb(_dt)                  \
+    case DTypeTrait<_dt>::enumv: \
+        return strided_kern<3, _dt, mode>();
+
+    SWITCH_DTYPE(INT, cb)
+
+#undef cb
+}
+
+template <uint32_t mode>
+void ElemwiseImpl::exec_TERNARY_FLOAT() {
+#define cb(_dt)                  \
+    case DTypeTrait<_dt>::enumv: \
+        return strided_kern<3, _dt, mode>();
 
     SWITCH_DTYPE(FLOAT, cb)
 
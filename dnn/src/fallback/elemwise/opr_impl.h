@@ -15,8 +15,9 @@ namespace megdnn {
 namespace fallback {
 
 class ElemwiseImpl : public naive::ElemwiseForwardImpl {
-    template <typename dtype, uint32_t mode>
-    void unary_kern(const ElemwiseOpParamN<1>& param);
+    //! run any broadcast pattern of the arity inputs, see opr_impl.cpp
+    template <int arity, typename dtype, uint32_t mode>
+    void strided_kern();
 
     template <uint32_t mode>
     void exec_UNARY_INT();
@@ -24,8 +25,8 @@ class ElemwiseImpl : public naive::ElemwiseForwardImpl {
     template <uint32_t mode>
     void exec_UNARY_FLOAT();
 
-    template <typename dtype, uint32_t mode>
-    void binary_kern(const ElemwiseOpParamN<2>& param);
+    template <uint32_t mode>
+    void exec_UNARY_BOOL();
 
     template <uint32_t mode>
     void exec_BINARY_INT();
@@ -33,6 +34,15 @@ class ElemwiseImpl : public naive::ElemwiseForwardImpl {
     template <uint32_t mode>
     void exec_BINARY_FLOAT();
 
+    template <uint32_t mode>
+    void exec_BINARY_BOOL();
+
+    template <uint32_t mode>
+    void exec_TERNARY_INT();
+
+    template <uint32_t mode>
+    void exec_TERNARY_FLOAT();
+
 public:
     using naive::ElemwiseForwardImpl::ElemwiseForwardImpl;
     void exec(const TensorNDArray& srcs, _megdnn_tensor_out dst) override;
@@ -13,15 +13,21 @@
 #include "src/common/handle_impl.h"
 
 #include "src/fallback/add_update/opr_impl.h"
+#include "src/fallback/argsort/opr_impl.h"
 #include "src/fallback/batched_matrix_mul/opr_impl.h"
 #include "src/fallback/concat/opr_impl.h"
 #include "src/fallback/conv_bias/opr_impl.h"
+#include "src/fallback/convpooling/opr_impl.h"
 #include "src/fallback/convolution/opr_impl.h"
+#include "src/fallback/cumsum/opr_impl.h"
 #include "src/fallback/elemwise/opr_impl.h"
 #include "src/fallback/elemwise_multi_type/opr_impl.h"
 #include "src/fallback/flip/opr_impl.h"
 #include "src/fallback/gaussian_blur/opr_impl.h"
+#include "src/fallback/image_preprocess/opr_impl.h"
 #include "src/fallback/group_local/opr_impl.h"
+#include "src/fallback/indexing_multi_axis_vec/opr_impl.h"
+#include "src/fallback/indexing_one_hot/opr_impl.h"
 #include "src/fallback/mask_conv/opr_impl.h"
 #include "src/fallback/matrix_mul/opr_impl.h"
 #include "src/fallback/pooling/opr_impl.h"
@@ -30,10 +36,12 @@
 #include "src/fallback/relayout/opr_impl.h"
 #include "src/fallback/repeat/opr_impl.h"
 #include "src/fallback/resize/opr_impl.h"
+#include "src/fallback/rng/opr_impl.h"
 #include "src/fallback/roi_copy/opr_impl.h"
 #include "src/fallback/rotate/opr_impl.h"
 #include "src/fallback/split/opr_impl.h"
 #include "src/fallback/tile/opr_impl.h"
+#include "src/fallback/topk/opr_impl.h"
 #include "src/fallback/type_cvt/opr_impl.h"
 #include "src/fallback/warp_perspective/opr_impl.h"
 
@@ -61,6 +69,7 @@ MEGDNN_SPECIALIZE_CREATE_OPERATOR(TypeCvt)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(GroupLocal)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(Flip)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(GaussianBlur)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(ImagePreprocessForward)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(ROICopy)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(Rotate)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(ElemwiseMultiType)
@@ -69,7 +78,21 @@ MEGDNN_SPECIALIZE_CREATE_OPERATOR(MaskConvForward)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(Resize)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(BatchedMatrixMulForward)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(ConvBias)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(ConvPoolingForward)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(PowC)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(TopK)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(ArgsortForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(CumsumForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(IndexingMultiAxisVec)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(IndexingSetMultiAxisVec)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(IndexingIncrMultiAxisVec)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(IndexingOneHotForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(IndexingSetOneHotForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(UniformRNG)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(GaussianRNG)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(GammaRNG)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(PoissonRNG)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(BetaRNG)
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpragmas"
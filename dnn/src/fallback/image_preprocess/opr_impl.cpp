@@ -0,0 +1,235 @@
+/**
+ * \file dnn/src/fallback/image_preprocess/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "src/fallback/image_preprocess/opr_impl.h"
+
+#include "src/common/image_preprocess.h"
+#include "src/common/rounding_converter.cuh"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include <cstring>
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_fallback_image_preprocess)
+
+using namespace megdnn;
+using namespace fallback;
+using namespace image_preprocess;
+
+namespace {
+
+using Param = param::ImagePreprocess;
+
+size_t get_nr_threads(Handle* handle) {
+    return static_cast<naive::HandleImpl*>(handle)
+            ->megcore_dispatcher()
+            ->nr_threads();
+}
+
+//! horizontal source offsets in elements of a row and their weights; w1_cv
+//! is the fixed-point weight of x1 for cv_linear
+struct ColCoord {
+    int x0, x1;
+    float w0, w1;
+    int w1_cv;
+};
+
+struct KernParam {
+    const uint8_t* src;
+    const float* scale;
+    const float* bias;
+    void* dst;
+    DType dtype;
+    size_t IH, IW, C, OH, OW;
+    InterpolationMode imode;
+    bool swap_rb, nchw88;
+    //! LINEAR is computed like resize_cv, otherwise like fallback Resize
+    bool cv_linear;
+};
+
+inline void store(dt_float32* ptr, float val, const DType&) {
+    *ptr = val;
+}
+
+inline void store(dt_qint8* ptr, float val, const DType& dtype) {
+    *ptr = dtype.param<dtype::QuantizedS8>().quantize(val);
+}
+
+//! rows [oh_begin, oh_end) of image n; fixed_c is C if nonzero
+template <typename T, size_t fixed_c, bool cv_linear>
+void do_rows(
+        const KernParam& p, size_t n, size_t oh_begin, size_t oh_end,
+        ColCoord* cols) {
+    const size_t C = fixed_c ? fixed_c : p.C;
+    for (size_t ow = 0; ow < p.OW; ++ow) {
+        if (cv_linear) {
+            auto cw = get_cv_linear_coord(p.IW, p.OW, ow);
+            cols[ow] = {static_cast<int>(cw.i0 * C), static_cast<int>((cw.i0 + 1) * C),
+                        0.f, 0.f, cw.w1};
+        } else {
+            auto cw = get_resize_coord(p.imode, C, p.IW, p.OW, ow);
+            cols[ow] = {static_cast<int>(cw.i0 * C), static_cast<int>(cw.i1 * C),
+                        cw.w0, cw.w1, 0};
+        }
+    }
+    auto dtype = p.dtype;
+    rounding::RoundingConverter<uint8_t> round_u8;
+    const uint8_t* img = p.src + n * p.IH * p.IW * C;
+    size_t OCB = div_ceil<size_t>(C, 8);
+    for (size_t oh = oh_begin; oh < oh_end; ++oh) {
+        Coord ch;
+        int h1_cv = 0;
+        if (cv_linear) {
+            auto cv = get_cv_linear_coord(p.IH, p.OH, oh);
+            ch = {cv.i0, cv.i0 + 1, 0.f, 0.f};
+            h1_cv = cv.w1;
+        } else {
+            ch = get_resize_coord(p.imode, C, p.IH, p.OH, oh);
+        }
+        const uint8_t* row0 = img + ch.i0 * p.IW * C;
+        const uint8_t* row1 = img + ch.i1 * p.IW * C;
+        for (size_t c = 0; c < C; ++c) {
+            size_t sc = p.swap_rb ? C - 1 - c : c;
+            float scale = p.scale[c], bias = p.bias[c];
+            T* out;
+            size_t step;
+            if (p.nchw88) {
+                out = static_cast<T*>(p.dst) +
+                      ((n * OCB + c / 8) * p.OH + oh) * p.OW * 8 + c % 8;
+                step = 8;
+            } else {
+                out = static_cast<T*>(p.dst) + ((n * C + c) * p.OH + oh) * p.OW;
+                step = 1;
+            }
+            for (size_t ow = 0; ow < p.OW; ++ow) {
+                const ColCoord& cw = cols[ow];
+                uint8_t resized;
+                //! round to uint8 exactly as the Resize being fused does
+                if (cv_linear) {
+                    int w1 = cw.w1_cv, w0 = CV_LINEAR_ONE - w1;
+                    int top = row0[cw.x1 + sc] * w1 + row0[cw.x0 + sc] * w0;
+                    int bottom = row1[cw.x1 + sc] * w1 + row1[cw.x0 + sc] * w0;
+                    resized = (h1_cv * bottom + (CV_LINEAR_ONE - h1_cv) * top) >>
+                              (CV_LINEAR_BITS * 2);
+                } else {
+                    resized = round_u8(
+                            row0[cw.x0 + sc] * ch.w0 * cw.w0 +
+                            row0[cw.x1 + sc] * ch.w0 * cw.w1 +
+                            row1[cw.x0 + sc] * ch.w1 * cw.w0 +
+                            row1[cw.x1 + sc] * ch.w1 * cw.w1);
+                }
+                store(out + ow * step, resized * scale + bias, dtype);
+            }
+        }
+        if (p.nchw88 && C % 8) {
+            //! zero the padded channels of the last block
+            T* out = static_cast<T*>(p.dst) +
+                     ((n * OCB + OCB - 1) * p.OH + oh) * p.OW * 8;
+            for (size_t ow = 0; ow < p.OW; ++ow) {
+                for (size_t c = C % 8; c < 8; ++c) {
+                    store(out + ow * 8 + c, 0.f, dtype);
+                }
+            }
+        }
+    }
+}
+
+template <typename T, bool cv_linear>
+void do_rows_dispatch(
+        const KernParam& p, size_t n, size_t oh_begin, size_t oh_end,
+        ColCoord* cols) {
+    switch (p.C) {
+        case 1:
+            do_rows<T, 1, cv_linear>(p, n, oh_begin, oh_end, cols);
+            break;
+        case 3:
+            do_rows<T, 3, cv_linear>(p, n, oh_begin, oh_end, cols);
+            break;
+        default:
+            do_rows<T, 0, cv_linear>(p, n, oh_begin, oh_end, cols);
+            break;
+    }
+}
+
+template <typename T>
+void do_rows_dispatch(
+        const KernParam& p, size_t n, size_t oh_begin, size_t oh_end,
+        ColCoord* cols) {
+    if (p.cv_linear) {
+        do_rows_dispatch<T, true>(p, n, oh_begin, oh_end, cols);
+    } else {
+        do_rows_dispatch<T, false>(p, n, oh_begin, oh_end, cols);
+    }
+}
+
+}  // anonymous namespace
+
+size_t ImagePreprocessForwardImpl::get_workspace_in_bytes(
+        const TensorLayout&, const TensorLayout&, const TensorLayout&,
+        const TensorLayout& dst) {
+    return get_nr_threads(handle()) * dst[3] * sizeof(ColCoord);
+}
+
+void ImagePreprocessForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_in scale, _megdnn_tensor_in bias,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    exec_with_resize(src, scale, bias, dst, workspace, false);
+}
+
+void ImagePreprocessForwardImpl::exec_with_resize(
+        _megdnn_tensor_in src, _megdnn_tensor_in scale, _megdnn_tensor_in bias,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace, bool cv_resize) {
+    check_exec(src.layout, scale.layout, bias.layout, dst.layout, workspace.size);
+    KernParam p;
+    p.src = src.ptr<dt_uint8>();
+    p.scale = scale.ptr<dt_float32>();
+    p.bias = bias.ptr<dt_float32>();
+    p.dst = dst.raw_ptr();
+    p.dtype = dst.layout.dtype;
+    p.IH = src.layout[1];
+    p.IW = src.layout[2];
+    p.C = src.layout[3];
+    p.OH = dst.layout[2];
+    p.OW = dst.layout[3];
+    p.imode = param().imode;
+    p.swap_rb = param().color_mode == Param::ColorMode::SWAP_RB;
+    p.nchw88 = param().format == Param::Format::NCHW88;
+    //! resize_cv asserts that the images have at least 2 rows and columns
+    p.cv_linear = cv_resize && is_cv_nearest(p.C) &&
+                  p.imode == InterpolationMode::LINEAR && p.IH >= 2 && p.IW >= 2 &&
+                  p.OH >= 2 && p.OW >= 2;
+
+    size_t N = src.layout[0], nr_threads = get_nr_threads(handle());
+    //! about 4 tasks per thread to balance the load
+    size_t rows_per_task = std::max<size_t>(1, N * p.OH / (nr_threads * 4)),
+           tasks_per_image = div_ceil(p.OH, rows_per_task);
+    auto cols_base = workspace.ptr<ColCoord>();
+    bool is_float = p.dtype == dtype::Float32();
+    MIDOUT_BEGIN(megdnn_fallback_image_preprocess, midout_iv(is_float)) {
+        auto kern = [=](size_t task_id, size_t thread_id) {
+            size_t n = task_id / tasks_per_image,
+                   oh_begin = task_id % tasks_per_image * rows_per_task,
+                   oh_end = std::min(oh_begin + rows_per_task, p.OH);
+            ColCoord* cols = cols_base + thread_id * p.OW;
+            if (is_float) {
+                do_rows_dispatch<dt_float32>(p, n, oh_begin, oh_end, cols);
+            } else {
+                do_rows_dispatch<dt_qint8>(p, n, oh_begin, oh_end, cols);
+            }
+        };
+        static_cast<naive::HandleImpl*>(handle())->dispatch_kern(
+                kern, N * tasks_per_image);
+    }
+    MIDOUT_END();
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,47 @@
+/**
+ * \file dnn/src/fallback/image_preprocess/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+#include "src/naive/image_preprocess/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+
+/*!
+ * \brief each task produces a block of output rows of one image for all
+ * channels, reading the two source rows of each output row once; the
+ * horizontal coordinates are computed per task into the workspace
+ */
+class ImagePreprocessForwardImpl : public naive::ImagePreprocessForwardImpl {
+public:
+    using naive::ImagePreprocessForwardImpl::ImagePreprocessForwardImpl;
+    void exec(
+            _megdnn_tensor_in src, _megdnn_tensor_in scale, _megdnn_tensor_in bias,
+            _megdnn_tensor_out dst, _megdnn_workspace workspace) override;
+    size_t get_workspace_in_bytes(
+            const TensorLayout& src, const TensorLayout& scale,
+            const TensorLayout& bias, const TensorLayout& dst) override;
+
+protected:
+    /*!
+     * \brief exec with the resized image rounded to uint8 like Resize of the
+     *      handle
+     * \param cv_resize whether Resize of the handle uses resize_cv for NHWC
+     *      uint8 images of 1 or 3 channels, as x86 and arm_common do
+     */
+    void exec_with_resize(
+            _megdnn_tensor_in src, _megdnn_tensor_in scale, _megdnn_tensor_in bias,
+            _megdnn_tensor_out dst, _megdnn_workspace workspace, bool cv_resize);
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,325 @@
+/**
+ * \file dnn/src/fallback/indexing_multi_axis_vec/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "src/fallback/indexing_multi_axis_vec/opr_impl.h"
+
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include "midout.h"
+
+#include <cstring>
+
+MIDOUT_DECL(megdnn_fallback_indexing_multi_axis_vec)
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+using IndexDesc = IndexingMultiAxisVecBase::IndexDesc;
+
+//! expected number of bytes copied by one task
+constexpr size_t TASK_BYTES = 32 * 1024;
+//! minimal number of columns of a task when data slices are split by columns
+constexpr size_t MIN_COLS = 256;
+
+/*!
+ * \brief description of the fast path
+ *
+ * data is viewed as data[outer, idx_0, ..., idx_{n-1}, inner] where all the
+ * index vectors are 1-dim with the same length, the non-index axes before
+ * them collapse into one axis and those after them are contiguous; value is
+ * then a contiguous (outer, nr_idx, inner) tensor, and each (outer, idx) pair
+ * is called a row.
+ */
+struct FastParam {
+    size_t nr_index, nr_idx, outer, inner;
+    ptrdiff_t outer_stride;
+    size_t axis_shape[TensorLayout::MAX_NDIM];
+    ptrdiff_t axis_stride[TensorLayout::MAX_NDIM], idx_stride[TensorLayout::MAX_NDIM];
+
+    size_t nr_rows() const { return outer * nr_idx; }
+};
+
+/*!
+ * \brief collapse the given axes of a layout into a single axis
+ * \return whether the axes can be collapsed
+ */
+bool collapse_axes(
+        const TensorLayout& layout, const size_t* axes, size_t nr_axes, size_t& size,
+        ptrdiff_t& stride) {
+    size = 1;
+    stride = 1;
+    for (size_t i = nr_axes; i; --i) {
+        size_t shp = layout.shape[axes[i - 1]];
+        ptrdiff_t std = layout.stride[axes[i - 1]];
+        if (shp == 1) {
+            continue;
+        }
+        if (size == 1) {
+            size = shp;
+            stride = std;
+        } else if (std == stride * static_cast<ptrdiff_t>(size)) {
+            size *= shp;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool init_fast_param(
+        const TensorLayout& data, const TensorLayout& value, const IndexDesc& index,
+        size_t idx_axis, FastParam& param) {
+    if (!value.is_contiguous() || !value.total_nr_elems()) {
+        return false;
+    }
+    TensorShape idx_shape;
+    {
+        TensorShapeArray idx_shapes;
+        for (auto&& i : index) {
+            idx_shapes.push_back(i.vec.layout);
+        }
+        Elemwise::deduce_shape(idx_shapes, idx_shape);
+    }
+    if (idx_shape.ndim != 1) {
+        return false;
+    }
+    param.nr_index = index.size();
+    param.nr_idx = idx_shape[0];
+    for (size_t i = 0; i < index.size(); ++i) {
+        param.axis_shape[i] = data.shape[index[i].axis];
+        param.axis_stride[i] = data.stride[index[i].axis];
+        param.idx_stride[i] = index[i].vec.layout.broadcast(idx_shape).stride[0];
+    }
+
+    size_t nonidx_axes[TensorLayout::MAX_NDIM],
+            nr_nonidx_axes = IndexingMultiAxisVecBase::get_nonindex_axes(
+                    data.ndim, index, nonidx_axes);
+    megdnn_assert(idx_axis <= nr_nonidx_axes);
+    ptrdiff_t inner_stride;
+    return collapse_axes(
+                   data, nonidx_axes, idx_axis, param.outer, param.outer_stride) &&
+           collapse_axes(
+                   data, nonidx_axes + idx_axis, nr_nonidx_axes - idx_axis,
+                   param.inner, inner_stride) &&
+           (param.inner == 1 || inner_stride == 1);
+}
+
+/*!
+ * \brief call func(row, offset) for each row in [begin, end), where offset is
+ *      the offset of the row in data
+ */
+template <class Func>
+void foreach_row(
+        const FastParam& param, const IndexDesc& index, size_t begin, size_t end,
+        Func&& func) {
+    const dt_int32* idx_ptr[TensorLayout::MAX_NDIM];
+    for (size_t i = 0; i < param.nr_index; ++i) {
+        idx_ptr[i] = index[i].vec.ptr<dt_int32>();
+    }
+    //! strides may be negative, so offsets are computed in ptrdiff_t
+    ptrdiff_t nr_idx = static_cast<ptrdiff_t>(param.nr_idx),
+              outer = static_cast<ptrdiff_t>(begin) / nr_idx,
+              idx = static_cast<ptrdiff_t>(begin) % nr_idx;
+    for (size_t row = begin; row < end; ++row) {
+        ptrdiff_t offset = outer * param.outer_stride;
+        for (size_t i = 0; i < param.nr_index; ++i) {
+            ptrdiff_t shape = static_cast<ptrdiff_t>(param.axis_shape[i]);
+            ptrdiff_t data_idx = idx_ptr[i][idx * param.idx_stride[i]];
+            if (data_idx < 0) {
+                data_idx += shape;
+            }
+            megdnn_assert(
+                    data_idx >= 0 && data_idx < shape,
+                    "bad index value for index %zu at output %td", i, idx);
+            offset += data_idx * param.axis_stride[i];
+        }
+        func(row, offset);
+        if (++idx == nr_idx) {
+            idx = 0;
+            ++outer;
+        }
+    }
+}
+
+struct OprFwd {
+    static constexpr bool modify_data = false;
+    template <typename ctype>
+    static void apply(ctype* data, ctype* value, size_t len) {
+        if (len == 1) {
+            *value = *data;
+        } else {
+            memcpy(value, data, len * sizeof(ctype));
+        }
+    }
+};
+
+struct OprSet {
+    static constexpr bool modify_data = true;
+    template <typename ctype>
+    static void apply(ctype* data, ctype* value, size_t len) {
+        if (len == 1) {
+            *data = *value;
+        } else {
+            memcpy(data, value, len * sizeof(ctype));
+        }
+    }
+};
+
+struct OprIncr {
+    static constexpr bool modify_data = true;
+    template <typename ctype>
+    static void apply(ctype* data, ctype* value, size_t len) {
+        for (size_t i = 0; i < len; ++i) {
+            data[i] += value[i];
+        }
+    }
+};
+
+/*!
+ * \brief run the fast path
+ *
+ * Rows are independent for OprFwd, so they are simply split into tasks. For
+ * oprs modifying data, a row may be written multiple times if there are
+ * duplicated indices, and it must be written in the order of rows. Thus wide
+ * rows are split by columns, and otherwise each task owns a range of data
+ * memory and applies the rows starting in that range; every task visits all
+ * the rows in order, so the result is the same as the serial one.
+ */
+template <typename ctype, class Opr>
+void exec_fast(
+        naive::HandleImpl* handle, const TensorND& data, const TensorND& value,
+        const IndexDesc& index, const FastParam& param) {
+    size_t nr_threads = handle->megcore_dispatcher()->nr_threads();
+    size_t nr_rows = param.nr_rows(), inner = param.inner;
+    size_t rows_per_task =
+            std::max<size_t>(1, TASK_BYTES / (inner * sizeof(ctype)));
+    if (!Opr::modify_data) {
+        rows_per_task = std::min(rows_per_task, div_ceil(nr_rows, nr_threads));
+        auto kern = [=](size_t task_id, size_t) {
+            ctype *dptr = data.ptr<ctype>(), *vptr = value.ptr<ctype>();
+            size_t begin = task_id * rows_per_task,
+                   end = std::min(nr_rows, begin + rows_per_task);
+            foreach_row(param, index, begin, end, [&](size_t row, ptrdiff_t off) {
+                Opr::apply(dptr + off, vptr + row * inner, inner);
+            });
+        };
+        handle->dispatch_kern(kern, div_ceil(nr_rows, rows_per_task));
+        return;
+    }
+
+    if (nr_threads == 1 || nr_rows <= rows_per_task) {
+        auto kern = [=]() {
+            ctype *dptr = data.ptr<ctype>(), *vptr = value.ptr<ctype>();
+            foreach_row(param, index, 0, nr_rows, [&](size_t row, ptrdiff_t off) {
+                Opr::apply(dptr + off, vptr + row * inner, inner);
+            });
+        };
+        handle->dispatch_kern(kern);
+        return;
+    }
+
+    if (inner >= MIN_COLS * 2) {
+        size_t cols_per_task = std::max(MIN_COLS, div_ceil(inner, nr_threads));
+        auto kern = [=](size_t task_id, size_t) {
+            ctype *dptr = data.ptr<ctype>(), *vptr = value.ptr<ctype>();
+            size_t col = task_id * cols_per_task,
+                   width = std::min(cols_per_task, inner - col);
+            foreach_row(param, index, 0, nr_rows, [&](size_t row, ptrdiff_t off) {
+                Opr::apply(dptr + off + col, vptr + row * inner + col, width);
+            });
+        };
+        handle->dispatch_kern(kern, div_ceil(inner, cols_per_task));
+        return;
+    }
+
+    auto span = data.layout.span();
+    ptrdiff_t low = span.low_elem, dist = span.dist_elem(),
+              nr_tasks = static_cast<ptrdiff_t>(nr_threads);
+    auto kern = [=](size_t task_id, size_t) {
+        ctype *dptr = data.ptr<ctype>(), *vptr = value.ptr<ctype>();
+        ptrdiff_t tid = static_cast<ptrdiff_t>(task_id);
+        ptrdiff_t begin = low + dist * tid / nr_tasks,
+                  end = low + dist * (tid + 1) / nr_tasks;
+        foreach_row(param, index, 0, nr_rows, [&](size_t row, ptrdiff_t off) {
+            if (off >= begin && off < end) {
+                Opr::apply(dptr + off, vptr + row * inner, inner);
+            }
+        });
+    };
+    handle->dispatch_kern(kern, nr_threads);
+}
+
+/*!
+ * \return whether the fast path is applicable; otherwise the naive impl
+ *      should be used
+ */
+template <class Opr>
+bool dispatch_fast(
+        Handle* handle, const TensorND& data, const TensorND& value,
+        const IndexDesc& index, size_t idx_axis) {
+    FastParam param;
+    if (!init_fast_param(data.layout, value.layout, index, idx_axis, param) ||
+        (Opr::modify_data && !data.layout.is_non_overlapping_strong())) {
+        return false;
+    }
+    auto handle_ptr = static_cast<naive::HandleImpl*>(handle);
+    switch (data.layout.dtype.enumv()) {
+#define cb(_dt)                                                             \
+    case DTypeTrait<_dt>::enumv: {                                          \
+        using ctype = DTypeTrait<_dt>::ctype;                               \
+        MIDOUT_BEGIN(megdnn_fallback_indexing_multi_axis_vec, ctype, Opr) { \
+            exec_fast<ctype, Opr>(handle_ptr, data, value, index, param);   \
+            return true;                                                    \
+        }                                                                   \
+        MIDOUT_END();                                                       \
+        break;                                                              \
+    }
+        MEGDNN_FOREACH_COMPUTING_DTYPE(cb)
+        cb(::megdnn::dtype::Bool)
+#undef cb
+        default:
+            break;
+    }
+    return false;
+}
+
+}  // anonymous namespace
+
+void IndexingMultiAxisVecImpl::exec(
+        _megdnn_tensor_in src, const IndexDesc& index, _megdnn_tensor_out dst,
+        _megdnn_workspace workspace) {
+    auto info = check_exec(src.layout, index, dst.layout, workspace.size);
+    if (!dispatch_fast<OprFwd>(handle(), src, dst, index, info.idx_axis)) {
+        naive::IndexingMultiAxisVecImpl::exec(src, index, dst, workspace);
+    }
+}
+
+void IndexingSetMultiAxisVecImpl::exec(
+        _megdnn_tensor_in data, _megdnn_tensor_out value, const IndexDesc& index,
+        _megdnn_workspace workspace) {
+    auto info = check_exec(data.layout, value.layout, index, workspace.size);
+    if (!dispatch_fast<OprSet>(handle(), data, value, index, info.idx_axis)) {
+        naive::IndexingSetMultiAxisVecImpl::exec(data, value, index, workspace);
+    }
+}
+
+void IndexingIncrMultiAxisVecImpl::exec(
+        _megdnn_tensor_in data, _megdnn_tensor_out value, const IndexDesc& index,
+        _megdnn_workspace workspace) {
+    auto info = check_exec(data.layout, value.layout, index, workspace.size);
+    if (!dispatch_fast<OprIncr>(handle(), data, value, index, info.idx_axis)) {
+        naive::IndexingIncrMultiAxisVecImpl::exec(data, value, index, workspace);
+    }
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,164 @@
+/**
+ * \file dnn/src/fallback/indexing_one_hot/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "src/fallback/indexing_one_hot/opr_impl.h"
+
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_fallback_indexing_one_hot)
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+//! expected minimal number of elements processed by one task
+constexpr size_t MIN_TASK_SIZE = 4096;
+
+/*!
+ * \brief shape of the contiguous data viewed as (A, M, C), where M is the
+ *      indexed axis; index and the sub tensor are then (A, C)
+ */
+struct OneHotShape {
+    size_t A, M, C;
+
+    OneHotShape(const TensorLayout& data, size_t axis) {
+        A = C = 1;
+        for (size_t i = 0; i < axis; ++i) {
+            A *= data.shape[i];
+        }
+        M = data.shape[axis];
+        for (size_t i = axis + 1; i < data.ndim; ++i) {
+            C *= data.shape[i];
+        }
+    }
+};
+
+/*!
+ * \brief split the A axis into tasks and call func(a) for each row in a task
+ *
+ * Different rows never touch the same element, so they can be processed in
+ * any order.
+ */
+template <class Func>
+void dispatch_rows(naive::HandleImpl* handle, const OneHotShape& shp, Func func) {
+    if (!shp.A || !shp.C) {
+        return;
+    }
+    size_t nr_threads = handle->megcore_dispatcher()->nr_threads();
+    size_t rows_per_task = std::max<size_t>(1, MIN_TASK_SIZE / shp.C);
+    rows_per_task = std::min(rows_per_task, div_ceil(shp.A, nr_threads));
+    size_t A = shp.A;
+    auto kern = [=](size_t task_id, size_t) {
+        size_t end = std::min(A, (task_id + 1) * rows_per_task);
+        for (size_t a = task_id * rows_per_task; a < end; ++a) {
+            func(a);
+        }
+    };
+    handle->dispatch_kern(kern, div_ceil(A, rows_per_task));
+}
+
+MEGDNN_FORCE_INLINE size_t check_idx(dt_int32 idx, size_t M) {
+    megdnn_assert(
+            idx >= 0 && static_cast<size_t>(idx) < M,
+            "bad value in IndexingOneHot index: input shape is %zu, "
+            "index value is %d",
+            M, idx);
+    return idx;
+}
+
+template <typename ctype>
+void exec_get(
+        naive::HandleImpl* handle, const TensorND& src, const TensorND& index,
+        const TensorND& dst, const OneHotShape& shp) {
+    size_t M = shp.M, C = shp.C;
+    dispatch_rows(handle, shp, [=](size_t a) {
+        const ctype* sptr = src.ptr<ctype>() + a * M * C;
+        const dt_int32* iptr = index.ptr<dt_int32>() + a * C;
+        ctype* dptr = dst.ptr<ctype>() + a * C;
+        for (size_t c = 0; c < C; ++c) {
+            dptr[c] = sptr[check_idx(iptr[c], M) * C + c];
+        }
+    });
+}
+
+template <typename ctype>
+void exec_set(
+        naive::HandleImpl* handle, const TensorND& data, const TensorND& index,
+        const TensorND& sub, const OneHotShape& shp) {
+    size_t M = shp.M, C = shp.C;
+    dispatch_rows(handle, shp, [=](size_t a) {
+        ctype* dptr = data.ptr<ctype>() + a * M * C;
+        const dt_int32* iptr = index.ptr<dt_int32>() + a * C;
+        const ctype* sptr = sub.ptr<ctype>() + a * C;
+        for (size_t c = 0; c < C; ++c) {
+            dptr[check_idx(iptr[c], M) * C + c] = sptr[c];
+        }
+    });
+}
+
+}  // anonymous namespace
+
+void IndexingOneHotForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_in index, _megdnn_tensor_out dst,
+        _megdnn_workspace workspace) {
+    check_exec(src.layout, index.layout, dst.layout, workspace.size);
+    OneHotShape shp(src.layout, param().axis);
+    auto handle_ptr = static_cast<naive::HandleImpl*>(handle());
+#define cb(_dt)                                                               \
+    case DTypeTrait<_dt>::enumv: {                                            \
+        using ctype = DTypeTrait<_dt>::ctype;                                 \
+        MIDOUT_BEGIN(megdnn_fallback_indexing_one_hot, ctype, midout_iv(0)) { \
+            exec_get<ctype>(handle_ptr, src, index, dst, shp);                \
+            return;                                                           \
+        }                                                                     \
+        MIDOUT_END();                                                         \
+        break;                                                                \
+    }
+    switch (src.layout.dtype.enumv()) {
+        MEGDNN_FOREACH_COMPUTING_DTYPE(cb)
+        cb(::megdnn::dtype::Quantized8Asymm)
+        default:
+            break;
+    }
+#undef cb
+    naive::IndexingOneHotForwardImpl::exec(src, index, dst, workspace);
+}
+
+void IndexingSetOneHotForwardImpl::exec(
+        _megdnn_tensor_inout data, _megdnn_tensor_in index, _megdnn_tensor_in sub,
+        _megdnn_workspace workspace) {
+    check_exec(data.layout, index.layout, sub.layout, workspace.size);
+    OneHotShape shp(data.layout, param().axis);
+    auto handle_ptr = static_cast<naive::HandleImpl*>(handle());
+#define cb(_dt)                                                               \
+    case DTypeTrait<_dt>::enumv: {                                            \
+        using ctype = DTypeTrait<_dt>::ctype;                                 \
+        MIDOUT_BEGIN(megdnn_fallback_indexing_one_hot, ctype, midout_iv(1)) { \
+            exec_set<ctype>(handle_ptr, data, index, sub, shp);               \
+            return;                                                           \
+        }                                                                     \
+        MIDOUT_END();                                                         \
+        break;                                                                \
+    }
+    switch (data.layout.dtype.enumv()) {
+        MEGDNN_FOREACH_COMPUTING_DTYPE(cb)
+        cb(::megdnn::dtype::Quantized8Asymm)
+        default:
+            break;
+    }
+#undef cb
+    naive::IndexingSetOneHotForwardImpl::exec(data, index, sub, workspace);
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,36 @@
+/**
+ * \file dnn/src/fallback/indexing_one_hot/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+#include "src/naive/indexing_one_hot/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+
+class IndexingOneHotForwardImpl : public naive::IndexingOneHotForwardImpl {
+public:
+    using naive::IndexingOneHotForwardImpl::IndexingOneHotForwardImpl;
+    void exec(
+            _megdnn_tensor_in src, _megdnn_tensor_in index, _megdnn_tensor_out dst,
+            _megdnn_workspace workspace) override;
+};
+
+class IndexingSetOneHotForwardImpl : public naive::IndexingSetOneHotForwardImpl {
+public:
+    using naive::IndexingSetOneHotForwardImpl::IndexingSetOneHotForwardImpl;
+    void exec(
+            _megdnn_tensor_inout data, _megdnn_tensor_in index, _megdnn_tensor_in sub,
+            _megdnn_workspace workspace) override;
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
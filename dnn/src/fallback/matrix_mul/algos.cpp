@@ -22,6 +22,8 @@
 MIDOUT_DECL(megdnn_fb_matmul_f32_kern)
 MIDOUT_DECL(megdnn_fb_matmul_f32_gemm_gemv_like)
 MIDOUT_DECL(megdnn_fb_matmul_naive)
+MIDOUT_DECL(megdnn_fb_matmul_f32_w4_g32)
+MIDOUT_DECL(megdnn_fb_matmul_f32_bsr_8x1)
 
 using namespace megdnn;
 using namespace fallback;
@@ -205,4 +207,125 @@ MatrixMulImpl::kern_t MatrixMulImpl::AlgoNaive::get_kern(const KernSizeParam&) c
     return kern_naive;
 }
 
+/* ===================== F32 W4_G32 algo ===================== */
+namespace {
+void f32_w4_g32_kern(const MatrixMulImpl::KernParam& kern_param) {
+    MIDOUT_BEGIN(megdnn_fb_matmul_f32_w4_g32, void) {
+        size_t M = kern_param.M, N = kern_param.N, K = kern_param.K;
+        size_t LDA = kern_param.LDA, LDC = kern_param.LDC;
+        const float* A = kern_param.A<float>();
+        const dt_byte* B = kern_param.B<dt_byte>();
+        float* C = kern_param.C<float>();
+        constexpr size_t group_bytes = MatrixMul::w4_g32_group_bytes();
+        size_t nr_groups = K / 32;
+        float weight[32];
+        for (size_t n = 0; n < N; ++n) {
+            for (size_t m = 0; m < M; ++m) {
+                C[m * LDC + n] = 0.f;
+            }
+            for (size_t g = 0; g < nr_groups; ++g) {
+                const dt_byte* group = B + (n * nr_groups + g) * group_bytes;
+                float scale;
+                memcpy(&scale, group, sizeof(float));
+                auto nibbles = reinterpret_cast<const uint8_t*>(group + 4);
+                for (size_t k = 0; k < 16; ++k) {
+                    int lo = nibbles[k] & 0xF, hi = nibbles[k] >> 4;
+                    weight[k] = scale * ((lo ^ 8) - 8);
+                    weight[k + 16] = scale * ((hi ^ 8) - 8);
+                }
+                for (size_t m = 0; m < M; ++m) {
+                    const float* a = A + m * LDA + g * 32;
+                    float sum = 0.f;
+                    for (size_t k = 0; k < 32; ++k) {
+                        sum += a[k] * weight[k];
+                    }
+                    C[m * LDC + n] += sum;
+                }
+            }
+        }
+    }
+    MIDOUT_END();
+}
+}  // anonymous namespace
+
+bool MatrixMulImpl::AlgoF32W4G32::usable(const KernSizeParam& kern_size_param) const {
+    return kern_size_param.format == param::MatrixMul::Format::W4_G32 &&
+           kern_size_param.compute_mode == param::MatrixMul::ComputeMode::DEFAULT &&
+           !kern_size_param.trA && !kern_size_param.trB &&
+           kern_size_param.A_type == dtype::Float32() &&
+           kern_size_param.B_type == dtype::Byte() &&
+           kern_size_param.C_type == dtype::Float32() && kern_size_param.K % 32 == 0;
+}
+
+MatrixMulImpl::kern_t MatrixMulImpl::AlgoF32W4G32::get_kern(
+        const KernSizeParam&) const {
+    return f32_w4_g32_kern;
+}
+
+/* ===================== F32 BSR_8X1 algo ===================== */
+namespace {
+void f32_bsr_8x1_kern(const MatrixMulImpl::KernParam& kern_param) {
+    MIDOUT_BEGIN(megdnn_fb_matmul_f32_bsr_8x1, void) {
+        size_t M = kern_param.M, N = kern_param.N;
+        size_t LDA = kern_param.LDA, LDB = kern_param.LDB, LDC = kern_param.LDC;
+        const dt_byte* A = kern_param.A<dt_byte>();
+        const float* B = kern_param.B<float>();
+        float* C = kern_param.C<float>();
+        size_t max_nr_blocks = (LDA - MatrixMul::bsr_8x1_row_bytes(0)) /
+                               MatrixMul::bsr_8x1_block_bytes();
+        for (size_t r = 0; r < M / 8; ++r) {
+            const dt_byte* row = A + r * LDA;
+            int32_t nr_blocks;
+            memcpy(&nr_blocks, row, sizeof(int32_t));
+            auto cols = reinterpret_cast<const int32_t*>(row + 4);
+            auto vals = reinterpret_cast<const float*>(row + 4 + max_nr_blocks * 4);
+            float* c = C + r * 8 * LDC;
+            if (kern_param.trB) {
+                //! the 8 rows of a block are accumulated together
+                for (size_t n = 0; n < N; ++n) {
+                    float acc[8] = {0};
+                    for (int32_t b = 0; b < nr_blocks; ++b) {
+                        float b_val = B[n * LDB + cols[b]];
+                        for (size_t i = 0; i < 8; ++i) {
+                            acc[i] += vals[b * 8 + i] * b_val;
+                        }
+                    }
+                    for (size_t i = 0; i < 8; ++i) {
+                        c[i * LDC + n] = acc[i];
+                    }
+                }
+            } else {
+                for (size_t i = 0; i < 8; ++i) {
+                    std::fill_n(c + i * LDC, N, 0.f);
+                }
+                for (int32_t b = 0; b < nr_blocks; ++b) {
+                    const float* b_row = B + cols[b] * LDB;
+                    for (size_t i = 0; i < 8; ++i) {
+                        float val = vals[b * 8 + i];
+                        float* c_row = c + i * LDC;
+                        for (size_t n = 0; n < N; ++n) {
+                            c_row[n] += val * b_row[n];
+                        }
+                    }
+                }
+            }
+        }
+    }
+    MIDOUT_END();
+}
+}  // anonymous namespace
+
+bool MatrixMulImpl::AlgoF32BSR8x1::usable(const KernSizeParam& kern_size_param) const {
+    return kern_size_param.format == param::MatrixMul::Format::BSR_8X1 &&
+           kern_size_param.compute_mode == param::MatrixMul::ComputeMode::DEFAULT &&
+           !kern_size_param.trA && kern_size_param.A_type == dtype::Byte() &&
+           kern_size_param.B_type == dtype::Float32() &&
+           kern_size_param.C_type == dtype::Float32();
+}
+
+MatrixMulImpl::kern_t MatrixMulImpl::AlgoF32BSR8x1::get_kern(
+        const KernSizeParam&) const {
+    return f32_bsr_8x1_kern;
+}
+
 // vim: syntax=cpp.doxygen
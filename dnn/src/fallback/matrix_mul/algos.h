@@ -80,6 +80,30 @@ public:
             DEFAULT)
 };
 
+class MatrixMulImpl::AlgoF32W4G32 final : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "FB_F32_W4_G32"; }
+    bool usable(const KernSizeParam&) const override;
+    size_t get_workspace(const KernSizeParam&) const override { return 0; }
+    kern_t get_kern(const KernSizeParam&) const override;
+    PackMode packmode() const override { return PackMode::NO_PACK; }
+    MEGDNN_DECL_ALGO_TYPE(FB_F32_W4_G32)
+    MEGDNN_OVERRIDE_MATMUL_DESC(8, 16, 1, 4, AlgoDataType::FLOAT32, W4_G32)
+};
+
+class MatrixMulImpl::AlgoF32BSR8x1 final : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "FB_F32_BSR_8X1"; }
+    bool usable(const KernSizeParam&) const override;
+    size_t get_workspace(const KernSizeParam&) const override { return 0; }
+    kern_t get_kern(const KernSizeParam&) const override;
+    PackMode packmode() const override { return PackMode::NO_PACK; }
+    MEGDNN_DECL_ALGO_TYPE(FB_F32_BSR_8X1)
+    MEGDNN_OVERRIDE_MATMUL_DESC(8, 1, 1, 4, AlgoDataType::FLOAT32, BSR_8X1)
+};
+
 }  // namespace fallback
 }  // namespace megdnn
 
@@ -36,6 +36,8 @@ class MatrixMulImpl::AlgoPack : NonCopyableObj {
     AlgoF32K8x12x1 f32_k8x12x1;
     AlgoGemv gemv;
     AlgoNaive naive;
+    AlgoF32W4G32 f32_w4_g32;
+    AlgoF32BSR8x1 f32_bsr_8x1;
     SmallVector<AlgoBase*> m_all_algos;
     AlgoBase::Mapper m_all_algos_map;
 
@@ -43,6 +45,8 @@ public:
     AlgoPack() {
         m_all_algos.emplace_back(&gemv);
         m_all_algos.emplace_back(&f32_k8x12x1);
+        m_all_algos.emplace_back(&f32_w4_g32);
+        m_all_algos.emplace_back(&f32_bsr_8x1);
         m_all_algos.emplace_back(&naive);
         for (auto&& algo : m_all_algos) {
             m_all_algos_map.emplace(algo->info().desc, algo);
@@ -194,6 +198,10 @@ MatrixMulImpl::KernSizeParam MatrixMulImpl::make_kern_size_param(
     kern_size_param.M = C.shape[0];
     kern_size_param.N = C.shape[1];
     kern_size_param.K = A[1 - param().transposeA];
+    if (param().format == param::MatrixMul::Format::BSR_8X1) {
+        //! A is packed, so K is only known from B
+        kern_size_param.K = B[param().transposeB];
+    }
     kern_size_param.LDA = A.stride[0];
     kern_size_param.LDB = B.stride[0];
     kern_size_param.LDC = C.stride[0];
@@ -263,6 +271,20 @@ void MatrixMulImpl::exec(
 
 MatrixMulImpl::AlgoDataType MatrixMulImpl::KernSizeParam::deduce_algo_data_type()
         const {
+    if (format == param::MatrixMul::Format::W4_G32) {
+        megdnn_assert(
+                A_type.enumv() == DTypeEnum::Float32 &&
+                        B_type.enumv() == DTypeEnum::Byte,
+                "W4_G32 matmul requires float32 A and byte B\n");
+        return MatrixMulImpl::AlgoDataType::FLOAT32;
+    }
+    if (format == param::MatrixMul::Format::BSR_8X1) {
+        megdnn_assert(
+                A_type.enumv() == DTypeEnum::Byte &&
+                        B_type.enumv() == DTypeEnum::Float32,
+                "BSR_8X1 matmul requires byte A and float32 B\n");
+        return MatrixMulImpl::AlgoDataType::FLOAT32;
+    }
     megdnn_assert(
             A_type.enumv() == B_type.enumv(),
             "Matmul A type and B type of different ctype\n");
@@ -112,6 +112,8 @@ public:
             FB_F32K8x12x1 = 1 << 0,
             FB_GEMV,
             FB_NAIVE,
+            FB_F32_W4_G32,
+            FB_F32_BSR_8X1,
 
 #if MEGDNN_X86
             //! x86
@@ -126,6 +128,8 @@ public:
             X86_F32_6x16,
             X86_INT8X8X32_VNNI,
             X86_INT8X8X32_MKLDNN,
+            X86_F32_W4_G32,
+            X86_F32_BSR_8X1,
 #elif MEGDNN_AARCH64 || MEGDNN_ARMV7
             ARM_COMMON_INT8X8X16 = 1 << 8,
             ARM_COMMON_INT8X8X32_GEMV,
@@ -134,6 +138,7 @@ public:
             ARM_COMMON_F32_GEMV_MK4,
             ARM_COMMON_F16_GEMV,
             ARM_COMMON_GEVM,
+            ARM_COMMON_F32_BSR_8X1,
 #if MEGDNN_AARCH64
             AARCH64_F32_K8X12X1 = 1 << 16,
             AARCH64_F32_MK4_K8X12X1,
@@ -239,6 +244,8 @@ private:
     class AlgoF32K8x12x1;  // Fallback F32 Kernel 8x12x1
     class AlgoGemv;
     class AlgoNaive;
+    class AlgoF32W4G32;  // Fallback F32 x int4 weight with per-group scales
+    class AlgoF32BSR8x1;  // Fallback block sparse F32
     class AlgoPack;
     //! maintain all the algos of in the opr of fallback
     static const AlgoPack& algo_pack();
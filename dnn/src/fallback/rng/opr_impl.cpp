@@ -0,0 +1,142 @@
+/**
+ * \file dnn/src/fallback/rng/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "src/fallback/rng/opr_impl.h"
+#include "src/naive/rng/sampler.h"
+
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_fallback_rng)
+
+using namespace megdnn;
+using namespace fallback;
+
+void UniformRNGImpl::exec(_megdnn_tensor_inout dst, _megdnn_workspace workspace) {
+    if (dst.layout.dtype != dtype::Float32()) {
+        naive::UniformRNGImpl::exec(dst, workspace);
+        return;
+    }
+    check_exec(dst.layout, workspace.size);
+    MIDOUT_BEGIN(megdnn_fallback_rng, midout_iv(0)) {
+        rng::exec_uniform(
+                static_cast<naive::HandleImpl*>(handle()), dst,
+                m_philox_ctr.ensure_seed(m_param.seed));
+    }
+    MIDOUT_END();
+}
+
+void GaussianRNGImpl::exec(_megdnn_tensor_inout dst, _megdnn_workspace workspace) {
+    if (dst.layout.dtype != dtype::Float32()) {
+        naive::GaussianRNGImpl::exec(dst, workspace);
+        return;
+    }
+    check_exec(dst.layout, workspace.size);
+    MIDOUT_BEGIN(megdnn_fallback_rng, midout_iv(1)) {
+        rng::exec_gaussian(
+                static_cast<naive::HandleImpl*>(handle()), dst,
+                m_philox_ctr.ensure_seed(m_param.seed), m_param.mean, m_param.std);
+    }
+    MIDOUT_END();
+}
+
+void GammaRNGImpl::exec(
+        _megdnn_tensor_in shape, _megdnn_tensor_in scale, _megdnn_tensor_out dst,
+        _megdnn_workspace workspace) {
+    check_exec(shape.layout, scale.layout, dst.layout, workspace.size);
+    auto size = dst.layout.total_nr_elems();
+    auto handle_ptr = static_cast<naive::HandleImpl*>(handle());
+    auto&& ctr = m_philox_ctr.ensure_seed(m_param.seed);
+    switch (dst.layout.dtype.enumv()) {
+#define cb(_dt)                                                                  \
+    case DTypeTrait<_dt>::enumv: {                                               \
+        using ctype = DTypeTrait<_dt>::ctype;                                    \
+        MIDOUT_BEGIN(megdnn_fallback_rng, ctype, midout_iv(2)) {                 \
+            rng::dispatch_elems(                                                 \
+                    handle_ptr, size, ctr, [=](rng::PhiloxStream& s, size_t i) { \
+                        naive::rng::fill_gamma<float>(                           \
+                                &s, dst.ptr<ctype>() + i, 1,                     \
+                                shape.ptr<ctype>() + i, scale.ptr<ctype>() + i); \
+                    });                                                          \
+            return;                                                              \
+        }                                                                        \
+        MIDOUT_END();                                                            \
+        break;                                                                   \
+    }
+        MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+        default:
+            megdnn_throw("bad dtype");
+    }
+}
+
+void PoissonRNGImpl::exec(
+        _megdnn_tensor_in lam, _megdnn_tensor_inout dst, _megdnn_workspace workspace) {
+    check_exec(lam.layout, dst.layout, workspace.size);
+    auto size = dst.layout.total_nr_elems();
+    auto handle_ptr = static_cast<naive::HandleImpl*>(handle());
+    auto&& ctr = m_philox_ctr.ensure_seed(m_param.seed);
+    switch (dst.layout.dtype.enumv()) {
+#define cb(_dt)                                                                  \
+    case DTypeTrait<_dt>::enumv: {                                               \
+        using ctype = DTypeTrait<_dt>::ctype;                                    \
+        MIDOUT_BEGIN(megdnn_fallback_rng, ctype, midout_iv(3)) {                 \
+            rng::dispatch_elems(                                                 \
+                    handle_ptr, size, ctr, [=](rng::PhiloxStream& s, size_t i) { \
+                        naive::rng::fill_poisson<float>(                         \
+                                &s, dst.ptr<ctype>() + i, lam.ptr<ctype>() + i,  \
+                                1);                                              \
+                    });                                                          \
+            return;                                                              \
+        }                                                                        \
+        MIDOUT_END();                                                            \
+        break;                                                                   \
+    }
+        MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+        default:
+            megdnn_throw("bad dtype");
+    }
+}
+
+void BetaRNGImpl::exec(
+        _megdnn_tensor_in alpha, _megdnn_tensor_in beta, _megdnn_tensor_out dst,
+        _megdnn_workspace workspace) {
+    check_exec(alpha.layout, beta.layout, dst.layout, workspace.size);
+    auto size = dst.layout.total_nr_elems();
+    auto handle_ptr = static_cast<naive::HandleImpl*>(handle());
+    auto&& ctr = m_philox_ctr.ensure_seed(m_param.seed);
+    switch (dst.layout.dtype.enumv()) {
+#define cb(_dt)                                                                  \
+    case DTypeTrait<_dt>::enumv: {                                               \
+        using ctype = DTypeTrait<_dt>::ctype;                                    \
+        MIDOUT_BEGIN(megdnn_fallback_rng, ctype, midout_iv(4)) {                 \
+            rng::dispatch_elems(                                                 \
+                    handle_ptr, size, ctr, [=](rng::PhiloxStream& s, size_t i) { \
+                        naive::rng::fill_beta<float>(                            \
+                                &s, dst.ptr<ctype>() + i,                        \
+                                alpha.ptr<ctype>() + i, beta.ptr<ctype>() + i,   \
+                                1);                                              \
+                    });                                                          \
+            return;                                                              \
+        }                                                                        \
+        MIDOUT_END();                                                            \
+        break;                                                                   \
+    }
+        MEGDNN_FOREACH_COMPUTING_DTYPE_FLOAT(cb)
+#undef cb
+        default:
+            megdnn_throw("bad dtype");
+    }
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,74 @@
+/**
+ * \file dnn/src/fallback/rng/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+#include "src/fallback/rng/rng_helper.h"
+#include "src/naive/rng/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+
+/*
+ * The RNG oprs here use the Philox-4x32-10 generator and are multithreaded;
+ * the results do not depend on the number of threads. Dtypes not supported
+ * here go to the naive impls, which use a different generator.
+ */
+
+class UniformRNGImpl : public naive::UniformRNGImpl {
+protected:
+    rng::PhiloxCounter m_philox_ctr;
+
+public:
+    using naive::UniformRNGImpl::UniformRNGImpl;
+    void exec(_megdnn_tensor_inout dst, _megdnn_workspace) override;
+};
+
+class GaussianRNGImpl : public naive::GaussianRNGImpl {
+protected:
+    rng::PhiloxCounter m_philox_ctr;
+
+public:
+    using naive::GaussianRNGImpl::GaussianRNGImpl;
+    void exec(_megdnn_tensor_inout dst, _megdnn_workspace) override;
+};
+
+class GammaRNGImpl : public naive::GammaRNGImpl {
+    rng::PhiloxCounter m_philox_ctr;
+
+public:
+    using naive::GammaRNGImpl::GammaRNGImpl;
+    void exec(
+            _megdnn_tensor_in shape, _megdnn_tensor_in scale, _megdnn_tensor_out dst,
+            _megdnn_workspace) override;
+};
+
+class PoissonRNGImpl : public naive::PoissonRNGImpl {
+    rng::PhiloxCounter m_philox_ctr;
+
+public:
+    using naive::PoissonRNGImpl::PoissonRNGImpl;
+    void exec(_megdnn_tensor_in lam, _megdnn_tensor_inout dst, _megdnn_workspace)
+            override;
+};
+
+class BetaRNGImpl : public naive::BetaRNGImpl {
+    rng::PhiloxCounter m_philox_ctr;
+
+public:
+    using naive::BetaRNGImpl::BetaRNGImpl;
+    void exec(
+            _megdnn_tensor_in alpha, _megdnn_tensor_in beta, _megdnn_tensor_out dst,
+            _megdnn_workspace) override;
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
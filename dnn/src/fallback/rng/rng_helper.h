@@ -0,0 +1,271 @@
+/**
+ * \file dnn/src/fallback/rng/rng_helper.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace megdnn {
+namespace fallback {
+namespace rng {
+
+//! number of counter blocks (each producing 4 values) of one task
+constexpr size_t TASK_BLOCKS = 4096;
+
+constexpr uint32_t PHILOX_M4x32_0 = 0xD2511F53, PHILOX_M4x32_1 = 0xCD9E8D57,
+                   PHILOX_W32_0 = 0x9E3779B9, PHILOX_W32_1 = 0xBB67AE85;
+
+//! 2^-32 and 2^-32 * 2 * pi, used to map uint32 to floats like curand does
+constexpr float TWO_POW32_INV = 2.3283064e-10f,
+                TWO_POW32_INV_2PI = 2.3283064e-10f * 6.2831855f;
+
+/*!
+ * \brief the Philox-4x32-10 counter-based generator
+ *
+ * See "Parallel Random Numbers: As Easy as 1, 2, 3" by Salmon et al. The
+ * output is a pure function of the 128-bit counter and the 64-bit key, so any
+ * part of a random stream can be generated independently. The counter layout
+ * follows curand: the low 64 bits are the block index in a subsequence and the
+ * high 64 bits are the subsequence id.
+ */
+class Philox4x32 {
+    uint32_t m_key[2];
+
+    static MEGDNN_FORCE_INLINE uint32_t mulhilo(uint32_t a, uint32_t b, uint32_t* hi) {
+        uint64_t p = static_cast<uint64_t>(a) * b;
+        *hi = static_cast<uint32_t>(p >> 32);
+        return static_cast<uint32_t>(p);
+    }
+
+public:
+    explicit Philox4x32(uint64_t seed)
+            : m_key{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)} {}
+
+    uint32_t key(size_t i) const { return m_key[i]; }
+
+    //! generate 4 values from the counter \p ctr in place
+    MEGDNN_FORCE_INLINE void operator()(uint32_t* ctr) const {
+        uint32_t k0 = m_key[0], k1 = m_key[1];
+        for (int r = 0; r < 10; ++r) {
+            uint32_t hi0, hi1;
+            uint32_t lo0 = mulhilo(PHILOX_M4x32_0, ctr[0], &hi0),
+                     lo1 = mulhilo(PHILOX_M4x32_1, ctr[2], &hi1);
+            ctr[0] = hi1 ^ ctr[1] ^ k0;
+            ctr[1] = lo1;
+            ctr[2] = hi0 ^ ctr[3] ^ k1;
+            ctr[3] = lo0;
+            k0 += PHILOX_W32_0;
+            k1 += PHILOX_W32_1;
+        }
+    }
+
+    //! generate 4 values of block \p block in subsequence \p subseq
+    MEGDNN_FORCE_INLINE void operator()(
+            uint64_t block, uint64_t subseq, uint32_t* out) const {
+        out[0] = static_cast<uint32_t>(block);
+        out[1] = static_cast<uint32_t>(block >> 32);
+        out[2] = static_cast<uint32_t>(subseq);
+        out[3] = static_cast<uint32_t>(subseq >> 32);
+        (*this)(out);
+    }
+};
+
+//! map to a float in (0, 1], the same as curand_uniform()
+MEGDNN_FORCE_INLINE float uint2float(uint32_t x) {
+    return static_cast<float>(x) * TWO_POW32_INV + TWO_POW32_INV / 2.f;
+}
+
+//! map to an angle in (0, 2 * pi]
+MEGDNN_FORCE_INLINE float uint2angle(uint32_t x) {
+    return static_cast<float>(x) * TWO_POW32_INV_2PI + TWO_POW32_INV_2PI / 2.f;
+}
+
+/*!
+ * \brief Box-Muller transform in the same way as curand_normal2()
+ * \param u uniform number in (0, 1], see uint2float()
+ * \param v uniform angle, see uint2angle()
+ */
+MEGDNN_FORCE_INLINE void box_muller(
+        float u, float v, float mean, float stddev, float* dst) {
+    float s = std::sqrt(-2.f * std::log(u)) * stddev;
+    dst[0] = std::sin(v) * s + mean;
+    dst[1] = std::cos(v) * s + mean;
+}
+
+/*!
+ * \brief seed and counter offset of an opr
+ *
+ * Every exec consumes a fresh range of counters, so successive calls give
+ * different results while the whole sequence only depends on the seed.
+ */
+class PhiloxCounter {
+    uint64_t m_seed = 0, m_offset = 0;
+
+public:
+    //! reset the offset if seed changed
+    PhiloxCounter& ensure_seed(uint64_t seed) {
+        if (seed != m_seed) {
+            m_seed = seed;
+            m_offset = 0;
+        }
+        return *this;
+    }
+
+    uint64_t seed() const { return m_seed; }
+
+    //! get the current offset and then advance it by \p nr_blocks
+    uint64_t advance(uint64_t nr_blocks) {
+        uint64_t ret = m_offset;
+        m_offset += nr_blocks;
+        return ret;
+    }
+};
+
+/*!
+ * \brief scalar kernels filling a contiguous segment from consecutive counter
+ *      blocks of subsequence 0, starting at block \p block
+ *
+ * Each block gives 4 outputs, and the last block may be partially used.
+ * Specialized kernels (e.g. SIMD ones) should provide the same interface and
+ * the same results, and can be plugged into exec_uniform() and
+ * exec_gaussian().
+ */
+struct ScalarPhiloxKern {
+    static void uniform(
+            const Philox4x32& philox, uint64_t block, float* dst, size_t n) {
+        uint32_t r[4];
+        for (size_t i = 0; i < n; i += 4, ++block) {
+            philox(block, 0, r);
+            for (size_t j = 0; j < std::min<size_t>(4, n - i); ++j) {
+                dst[i + j] = uint2float(r[j]);
+            }
+        }
+    }
+
+    static void gaussian(
+            const Philox4x32& philox, uint64_t block, float* dst, size_t n,
+            float mean, float stddev) {
+        uint32_t r[4];
+        float z[4];
+        for (size_t i = 0; i < n; i += 4, ++block) {
+            philox(block, 0, r);
+            box_muller(uint2float(r[0]), uint2angle(r[1]), mean, stddev, z);
+            box_muller(uint2float(r[2]), uint2angle(r[3]), mean, stddev, z + 2);
+            for (size_t j = 0; j < std::min<size_t>(4, n - i); ++j) {
+                dst[i + j] = z[j];
+            }
+        }
+    }
+};
+
+/*!
+ * \brief split the output into tasks of TASK_BLOCKS counter blocks; the
+ *      result does not depend on the number of threads
+ * \param func func(block, dst, n) fills dst[0, n) from block
+ */
+template <class Func>
+void dispatch_blocks(
+        naive::HandleImpl* handle, const TensorND& dst, uint64_t block, Func func) {
+    size_t size = dst.layout.total_nr_elems(),
+           nr_tasks = div_ceil(size, TASK_BLOCKS * 4);
+    auto kern = [=](size_t task_id, size_t) {
+        size_t begin = task_id * TASK_BLOCKS * 4,
+               n = std::min(TASK_BLOCKS * 4, size - begin);
+        func(block + task_id * TASK_BLOCKS, dst.ptr<dt_float32>() + begin, n);
+    };
+    handle->dispatch_kern(kern, nr_tasks);
+}
+
+//! fill fp32 \p dst with uniform numbers in (0, 1]
+template <class Kern = ScalarPhiloxKern>
+void exec_uniform(naive::HandleImpl* handle, const TensorND& dst, PhiloxCounter& ctr) {
+    size_t size = dst.layout.total_nr_elems();
+    Philox4x32 philox{ctr.seed()};
+    uint64_t block = ctr.advance(div_ceil<size_t>(size, 4));
+    dispatch_blocks(handle, dst, block, [philox](uint64_t blk, float* ptr, size_t n) {
+        Kern::uniform(philox, blk, ptr, n);
+    });
+}
+
+//! fill fp32 \p dst with gaussian numbers
+template <class Kern = ScalarPhiloxKern>
+void exec_gaussian(
+        naive::HandleImpl* handle, const TensorND& dst, PhiloxCounter& ctr, float mean,
+        float stddev) {
+    size_t size = dst.layout.total_nr_elems();
+    Philox4x32 philox{ctr.seed()};
+    uint64_t block = ctr.advance(div_ceil<size_t>(size, 4));
+    dispatch_blocks(
+            handle, dst, block,
+            [philox, mean, stddev](uint64_t blk, float* ptr, size_t n) {
+                Kern::gaussian(philox, blk, ptr, n, mean, stddev);
+            });
+}
+
+/*!
+ * \brief random stream of a single element for the samplers in
+ *      naive/rng/sampler.h, which may consume any number of values
+ *
+ * Element i uses subsequence i, and the low and high 32 bits of the block
+ * index are the index in the stream and the exec count of the opr.
+ */
+class PhiloxStream {
+    const Philox4x32& m_philox;
+    uint64_t m_subseq;
+    uint32_t m_block = 0, m_call, m_buf[4];
+    size_t m_pos = 4;
+
+public:
+    PhiloxStream(const Philox4x32& philox, uint64_t subseq, uint32_t call)
+            : m_philox{philox}, m_subseq{subseq}, m_call{call} {}
+
+    uint64_t operator()() {
+        if (m_pos == 4) {
+            m_philox(
+                    (static_cast<uint64_t>(m_call) << 32) | m_block++, m_subseq,
+                    m_buf);
+            m_pos = 0;
+        }
+        uint64_t ret = (static_cast<uint64_t>(m_buf[m_pos]) << 32) | m_buf[m_pos + 1];
+        m_pos += 2;
+        return ret;
+    }
+};
+
+/*!
+ * \brief run \p func(stream, i) for each element i in parallel, where stream
+ *      is the PhiloxStream of the element
+ */
+template <class Func>
+void dispatch_elems(
+        naive::HandleImpl* handle, size_t size, PhiloxCounter& ctr, Func func) {
+    constexpr size_t ELEMS_PER_TASK = 1024;
+    Philox4x32 philox{ctr.seed()};
+    uint32_t call = static_cast<uint32_t>(ctr.advance(1));
+    auto kern = [=](size_t task_id, size_t) {
+        size_t end = std::min(size, (task_id + 1) * ELEMS_PER_TASK);
+        for (size_t i = task_id * ELEMS_PER_TASK; i < end; ++i) {
+            PhiloxStream stream{philox, i, call};
+            func(stream, i);
+        }
+    };
+    handle->dispatch_kern(kern, div_ceil(size, ELEMS_PER_TASK));
+}
+
+}  // namespace rng
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,242 @@
+/**
+ * \file dnn/src/fallback/topk/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "src/fallback/topk/opr_impl.h"
+#include "src/fallback/argsort/argsort_helper.h"
+
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+
+#include "midout.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+MIDOUT_DECL(megdnn_fallback_topk)
+
+using namespace megdnn;
+using namespace fallback;
+
+namespace {
+
+using Mode = param::TopK::Mode;
+
+//! heap selection is used if k <= HEAP_MAX_K and k * HEAP_MIN_RATIO <= n
+constexpr size_t HEAP_MAX_K = 64;
+constexpr size_t HEAP_MIN_RATIO = 16;
+//! rows at least this long use radix select
+constexpr size_t RADIX_SELECT_MIN_LEN = 4096;
+
+size_t get_nr_threads(Handle* handle) {
+    return static_cast<naive::HandleImpl*>(handle)->megcore_dispatcher()->nr_threads();
+}
+
+size_t get_row_buf_size(size_t n) {
+    return std::max(n, argsort::BITONIC_MAX_LEN);
+}
+
+/*!
+ * \brief select the k smallest packed keys in the row by MSD radix on the
+ *      value keys
+ *
+ * Ties at the threshold are taken in the order of the packed keys, i.e. by
+ * ascending index, or by descending index if \p flip is true, so the same
+ * elements are selected as by the other paths of topk_row().
+ * \return index of the k-th element in the row
+ */
+template <typename ctype>
+uint32_t radix_select(
+        const ctype* sptr, size_t n, size_t k, bool flip, bool need_all,
+        uint64_t* buf) {
+    using namespace argsort;
+    uint32_t key_xor = flip ? ~0u : 0u;
+    uint32_t prefix = 0, mask = 0;
+    size_t rem = k;
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        size_t hist[256];
+        memset(hist, 0, sizeof(hist));
+        for (size_t j = 0; j < n; ++j) {
+            uint32_t key = OrderedKey<ctype>::get(sptr[j]) ^ key_xor;
+            if ((key & mask) == prefix) {
+                ++hist[(key >> shift) & 0xff];
+            }
+        }
+        uint32_t digit = 0;
+        while (hist[digit] < rem) {
+            rem -= hist[digit];
+            ++digit;
+        }
+        prefix |= digit << shift;
+        mask |= 0xffu << shift;
+    }
+
+    //! now there are exactly k - rem keys less than prefix, and the first rem
+    //! keys equal to prefix in packed key order complete the selection
+    uint32_t kth = 0;
+    size_t cnt = 0;
+    for (size_t t = 0; t < n; ++t) {
+        size_t j = flip ? n - 1 - t : t;
+        uint32_t key = OrderedKey<ctype>::get(sptr[j]) ^ key_xor;
+        if (key < prefix) {
+            if (need_all) {
+                buf[cnt++] = pack_key(sptr[j], j, flip);
+            }
+        } else if (key == prefix && rem) {
+            if (need_all) {
+                buf[cnt++] = pack_key(sptr[j], j, flip);
+            }
+            if (!--rem) {
+                kth = j;
+                if (!need_all) {
+                    break;
+                }
+            }
+        }
+    }
+    return kth;
+}
+
+/*!
+ * \brief compute top-k of a single row
+ *
+ * Selection works on the packed (key, index) integers, see
+ * argsort::pack_key(); for negative k the keys are flipped so that the k
+ * smallest packed keys are always selected.
+ */
+template <typename ctype>
+void topk_row(
+        const ctype* sptr, size_t n, int k, Mode mode, ctype* vptr, int* iptr,
+        uint64_t* buf) {
+    using namespace argsort;
+    bool flip = k < 0;
+    size_t kk = std::abs(k);
+    auto fill = [&]() {
+        for (size_t j = 0; j < n; ++j) {
+            buf[j] = pack_key(sptr[j], j, flip);
+        }
+    };
+
+    if (n <= BITONIC_MAX_LEN) {
+        fill();
+        sort_short(buf, n);
+    } else if (kk <= HEAP_MAX_K && kk * HEAP_MIN_RATIO <= n) {
+        //! max-heap of the kk smallest keys seen so far
+        for (size_t j = 0; j < kk; ++j) {
+            buf[j] = pack_key(sptr[j], j, flip);
+        }
+        std::make_heap(buf, buf + kk);
+        for (size_t j = kk; j < n; ++j) {
+            uint64_t p = pack_key(sptr[j], j, flip);
+            if (p < buf[0]) {
+                std::pop_heap(buf, buf + kk);
+                buf[kk - 1] = p;
+                std::push_heap(buf, buf + kk);
+            }
+        }
+        if (mode == Mode::KTH_ONLY) {
+            vptr[0] = sptr[unpack_idx(buf[0], flip)];
+            return;
+        }
+        if (mode == Mode::VALUE_IDX_SORTED) {
+            std::sort_heap(buf, buf + kk);
+        }
+    } else if (n >= RADIX_SELECT_MIN_LEN) {
+        uint32_t kth =
+                radix_select(sptr, n, kk, flip, mode != Mode::KTH_ONLY, buf);
+        if (mode == Mode::KTH_ONLY) {
+            vptr[0] = sptr[kth];
+            return;
+        }
+        if (mode == Mode::VALUE_IDX_SORTED) {
+            std::sort(buf, buf + kk);
+        }
+    } else {
+        fill();
+        std::nth_element(buf, buf + kk - 1, buf + n);
+        if (mode == Mode::VALUE_IDX_SORTED) {
+            std::sort(buf, buf + kk - 1);
+        }
+    }
+
+    if (mode == Mode::KTH_ONLY) {
+        vptr[0] = sptr[unpack_idx(buf[kk - 1], flip)];
+        return;
+    }
+    for (size_t j = 0; j < kk; ++j) {
+        uint32_t idx = unpack_idx(buf[j], flip);
+        vptr[j] = sptr[idx];
+        iptr[j] = idx;
+    }
+}
+
+}  // anonymous namespace
+
+void TopKImpl::do_exec(
+        int k, _megdnn_tensor_in data, _megdnn_tensor_out values, int32_t* indices,
+        _megdnn_workspace workspace) {
+    size_t m = data.layout[0], n = data.layout[1];
+    ptrdiff_t lda = data.layout.stride[0];
+    megdnn_assert(n <= std::numeric_limits<uint32_t>::max());
+    if (!m) {
+        return;
+    }
+    auto mode = param().mode;
+    size_t kk = std::abs(k);
+    size_t out_stride = mode == Mode::KTH_ONLY ? 1 : kk;
+    auto handle_ptr = static_cast<naive::HandleImpl*>(handle());
+    size_t nr_threads = handle_ptr->megcore_dispatcher()->nr_threads();
+    //! group short rows so that each task does a reasonable amount of work
+    size_t rows_per_task = std::max<size_t>(1, 4096 / std::max<size_t>(n, 1));
+    rows_per_task = std::min(rows_per_task, div_ceil(m, nr_threads));
+    size_t nr_tasks = div_ceil(m, rows_per_task);
+    size_t buf_size = get_row_buf_size(n);
+    switch (data.layout.dtype.enumv()) {
+#define cb(dt)                                                                  \
+    case DTypeTrait<dt>::enumv: {                                               \
+        using ctype = DTypeTrait<dt>::ctype;                                    \
+        MIDOUT_BEGIN(megdnn_fallback_topk, ctype) {                             \
+            auto kern = [=](size_t task_id, size_t thread_id) {                 \
+                auto sptr = data.ptr<ctype>();                                  \
+                auto vptr = values.ptr<ctype>();                                \
+                auto buf = workspace.ptr<uint64_t>() + thread_id * buf_size;    \
+                size_t row_end = std::min(m, (task_id + 1) * rows_per_task);    \
+                for (size_t i = task_id * rows_per_task; i < row_end; ++i) {    \
+                    topk_row(                                                   \
+                            sptr + i * lda, n, k, mode, vptr + i * out_stride,  \
+                            indices ? indices + i * out_stride : nullptr, buf); \
+                }                                                               \
+            };                                                                  \
+            handle_ptr->dispatch_kern(kern, nr_tasks);                          \
+            return;                                                             \
+        }                                                                       \
+        MIDOUT_END();                                                           \
+    }
+        cb(::megdnn::dtype::Float32);
+        cb(::megdnn::dtype::Int32);
+#undef cb
+        default:
+            break;
+    }
+    naive::TopKImpl::do_exec(k, data, values, indices, workspace);
+}
+
+size_t TopKImpl::get_workspace_in_bytes(
+        int k, const TensorLayout& data, const TensorLayout& values,
+        const TensorLayout& indices) {
+    size_t fast = get_nr_threads(handle()) * get_row_buf_size(data[1]) *
+                  sizeof(uint64_t);
+    return std::max(
+            fast,
+            naive::TopKImpl::get_workspace_in_bytes(k, data, values, indices));
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,42 @@
+/**
+ * \file dnn/src/fallback/topk/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+
+#include "src/naive/topk/opr_impl.h"
+
+namespace megdnn {
+namespace fallback {
+
+/*!
+ * \brief row-parallel top-k
+ *
+ * The selection algorithm is chosen per row by k and n: a bitonic network for
+ * short rows, a heap for small k, radix select for long rows and
+ * std::nth_element for the rest.
+ */
+class TopKImpl : public naive::TopKImpl {
+protected:
+    void do_exec(
+            int k, _megdnn_tensor_in data, _megdnn_tensor_out values, int32_t* indices,
+            _megdnn_workspace workspace) override;
+
+public:
+    using naive::TopKImpl::TopKImpl;
+
+    size_t get_workspace_in_bytes(
+            int k, const TensorLayout& data, const TensorLayout& values,
+            const TensorLayout& indices) override;
+};
+
+}  // namespace fallback
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
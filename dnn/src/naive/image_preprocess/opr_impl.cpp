@@ -0,0 +1,87 @@
+/**
+ * \file dnn/src/naive/image_preprocess/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "src/naive/image_preprocess/opr_impl.h"
+#include "src/naive/handle.h"
+
+#include "src/common/image_preprocess.h"
+#include "src/common/rounding_converter.cuh"
+#include "src/common/utils.h"
+
+namespace megdnn {
+namespace naive {
+
+namespace {
+inline void store(dt_float32* ptr, float val, DType) {
+    *ptr = val;
+}
+
+inline void store(dt_qint8* ptr, float val, DType dtype) {
+    *ptr = dtype.param<dtype::QuantizedS8>().quantize(val);
+}
+}  // anonymous namespace
+
+void ImagePreprocessForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_in scale, _megdnn_tensor_in bias,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    check_exec(src.layout, scale.layout, bias.layout, dst.layout, workspace.size);
+    if (dst.layout.dtype == dtype::Float32()) {
+        MEGDNN_DISPATCH_CPU_KERN_OPR(exec_internal<dt_float32>(src, scale, bias, dst));
+    } else {
+        megdnn_assert(dst.layout.dtype.enumv() == DTypeEnum::QuantizedS8);
+        MEGDNN_DISPATCH_CPU_KERN_OPR(exec_internal<dt_qint8>(src, scale, bias, dst));
+    }
+}
+
+template <typename T>
+void ImagePreprocessForwardImpl::exec_internal(
+        _megdnn_tensor_in src, _megdnn_tensor_in scale, _megdnn_tensor_in bias,
+        _megdnn_tensor_out dst) {
+    using namespace image_preprocess;
+    int N = src.layout[0], IH = src.layout[1], IW = src.layout[2], C = src.layout[3];
+    bool nchw88 = param().format == Param::Format::NCHW88;
+    int OH = dst.layout[2], OW = dst.layout[3],
+        OC = nchw88 ? dst.layout[1] * 8 : C;
+    bool swap_rb = param().color_mode == Param::ColorMode::SWAP_RB;
+    auto sptr = src.ptr<dt_uint8>();
+    auto dptr = dst.ptr<T>();
+    auto dtype = dst.layout.dtype;
+    rounding::RoundingConverter<uint8_t> round_u8;
+
+    rep(n, N) rep(oh, OH) rep(ow, OW) {
+        auto ch = get_resize_coord(param().imode, C, IH, OH, oh),
+             cw = get_resize_coord(param().imode, C, IW, OW, ow);
+        rep(c, OC) {
+            float val = 0;
+            if (c < C) {
+                int sc = swap_rb ? C - 1 - c : c;
+                auto pix = [&](int h, int w) {
+                    return sptr[((n * IH + h) * IW + w) * C + sc];
+                };
+                //! the same expression and rounding as naive Resize
+                uint8_t resized = round_u8(
+                        pix(ch.i0, cw.i0) * ch.w0 * cw.w0 +
+                        pix(ch.i0, cw.i1) * ch.w0 * cw.w1 +
+                        pix(ch.i1, cw.i0) * ch.w1 * cw.w0 +
+                        pix(ch.i1, cw.i1) * ch.w1 * cw.w1);
+                val = resized * scale.ptr<dt_float32>()[c] +
+                      bias.ptr<dt_float32>()[c];
+            }
+            size_t idx = nchw88 ? (((n * OC + c) / 8 * OH + oh) * OW + ow) * 8 + c % 8
+                                : ((n * C + c) * OH + oh) * OW + ow;
+            store(dptr + idx, val, dtype);
+        }
+    }
+}
+
+}  // namespace naive
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
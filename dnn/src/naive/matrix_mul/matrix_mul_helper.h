@@ -10,6 +10,7 @@
  */
 #pragma once
 #include <cstddef>
+#include <cstring>
 #include "megdnn/dtype.h"
 #include "src/naive/handle.h"
 
@@ -141,6 +142,63 @@ void run_matrix_mul_mk8_tpl(
     }
 }
 
+//! A is float32 (M, K), B is the W4_G32 packed weight of N rows
+inline void run_matrix_mul_w4_g32(
+        const dt_float32* A, const dt_byte* B, dt_float32* C, size_t M, size_t N,
+        size_t K, size_t LDA, size_t LDC) {
+    constexpr size_t group_bytes = MatrixMul::w4_g32_group_bytes();
+    size_t nr_groups = K / 32;
+    for (size_t m = 0; m < M; ++m) {
+        for (size_t n = 0; n < N; ++n) {
+            dt_float32 res = 0;
+            for (size_t g = 0; g < nr_groups; ++g) {
+                const dt_byte* group = B + (n * nr_groups + g) * group_bytes;
+                dt_float32 scale;
+                memcpy(&scale, group, sizeof(dt_float32));
+                const uint8_t* nibbles = reinterpret_cast<const uint8_t*>(group + 4);
+                for (size_t k = 0; k < 32; ++k) {
+                    uint8_t bits = k < 16 ? nibbles[k] & 0xF : nibbles[k - 16] >> 4;
+                    int q = static_cast<int>(bits ^ 8) - 8;
+                    res += A[m * LDA + g * 32 + k] * (scale * q);
+                }
+            }
+            C[m * LDC + n] = res;
+        }
+    }
+}
+
+//! A is the BSR_8X1 packed (M, K) matrix with block rows of LDA bytes, B is
+//! float32 (K, N), or (N, K) if transB
+inline void run_matrix_mul_bsr_8x1(
+        const dt_byte* A, const dt_float32* B, dt_float32* C, size_t M, size_t N,
+        size_t LDA, size_t LDB, size_t LDC, bool transB) {
+    size_t max_nr_blocks =
+            (LDA - MatrixMul::bsr_8x1_row_bytes(0)) / MatrixMul::bsr_8x1_block_bytes();
+    for (size_t r = 0; r < M / 8; ++r) {
+        const dt_byte* row = A + r * LDA;
+        int32_t nr_blocks;
+        memcpy(&nr_blocks, row, sizeof(int32_t));
+        for (size_t i = 0; i < 8; ++i) {
+            for (size_t n = 0; n < N; ++n) {
+                C[(r * 8 + i) * LDC + n] = 0;
+            }
+        }
+        for (int32_t b = 0; b < nr_blocks; ++b) {
+            int32_t col;
+            memcpy(&col, row + 4 + b * 4, sizeof(int32_t));
+            for (size_t i = 0; i < 8; ++i) {
+                dt_float32 val;
+                memcpy(&val, row + 4 + max_nr_blocks * 4 + (b * 8 + i) * 4,
+                       sizeof(dt_float32));
+                for (size_t n = 0; n < N; ++n) {
+                    dt_float32 b_val = transB ? B[n * LDB + col] : B[col * LDB + n];
+                    C[(r * 8 + i) * LDC + n] += val * b_val;
+                }
+            }
+        }
+    }
+}
+
 template <bool transA, bool transB>
 void exec_matrix_mul_quint4x4x32_helper(
         const void* A, const void* B, void* C, void* workspace, size_t M, size_t N,
@@ -248,6 +306,25 @@ void dispatch_ta_tb(
         size_t K, ptrdiff_t LDA, ptrdiff_t LDB, ptrdiff_t LDC, DType A_type,
         DType B_type, DType C_type, const MatrixMul::Param::Format& format,
         const MatrixMul::Param::ComputeMode& compute_mode) {
+    if (format == param::MatrixMul::Format::W4_G32) {
+        megdnn_assert(
+                !TA && !TB && A_type == dtype::Float32() &&
+                C_type == dtype::Float32());
+        MEGDNN_MARK_USED_VAR(B_type);
+        MEGDNN_MARK_USED_VAR(LDB);
+        return run_matrix_mul_w4_g32(
+                static_cast<const dt_float32*>(A), static_cast<const dt_byte*>(B),
+                static_cast<dt_float32*>(C), M, N, K, LDA, LDC);
+    }
+    if (format == param::MatrixMul::Format::BSR_8X1) {
+        megdnn_assert(
+                !TA && B_type == dtype::Float32() && C_type == dtype::Float32());
+        MEGDNN_MARK_USED_VAR(A_type);
+        MEGDNN_MARK_USED_VAR(K);
+        return run_matrix_mul_bsr_8x1(
+                static_cast<const dt_byte*>(A), static_cast<const dt_float32*>(B),
+                static_cast<dt_float32*>(C), M, N, LDA, LDB, LDC, TB);
+    }
 #define cb(_itype, _otype, _comp_type)                                            \
     if (format == param::MatrixMul::Format::DEFAULT) {                            \
         return run_matrix_mul_tpl<_itype, _otype, TA, TB, _comp_type>(            \
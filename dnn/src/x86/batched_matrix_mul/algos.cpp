@@ -0,0 +1,291 @@
+/**
+ * \file dnn/src/x86/batched_matrix_mul/algos.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "src/x86/batched_matrix_mul/algos.h"
+
+#include "src/common/unroll_macro.h"
+#include "src/common/utils.h"
+#include "src/naive/handle.h"
+#include "src/x86/utils.h"
+
+#include <immintrin.h>
+#ifdef WIN32
+#include <avx2intrin.h>
+#include <avxintrin.h>
+#include <fmaintrin.h>
+#endif
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_x86_batched_matmul)
+
+using namespace megdnn;
+using namespace x86;
+
+namespace {
+
+//! rows and columns computed by one micro kernel
+constexpr size_t MR = 6, NR = 16;
+//! rows and columns (in NR panels) of the C tile computed by one task
+constexpr size_t M_TILE = MR * 8, N_TILE_PANELS = 8;
+//! expected minimal number of MACs of a task when batches are grouped
+constexpr size_t MIN_TASK_MACS = 64 * 1024;
+
+struct GemmShape {
+    size_t batch, M, N, K;
+    bool trA, trB;
+
+    GemmShape(const TensorLayout& A, const TensorLayout& B, bool trA, bool trB)
+            : batch{A.shape[0]},
+              M{A.shape[trA ? 2 : 1]},
+              N{B.shape[trB ? 1 : 2]},
+              K{A.shape[trA ? 1 : 2]},
+              trA{trA},
+              trB{trB} {}
+
+    size_t nr_panels() const { return div_ceil(N, NR); }
+
+    //! number of packed copies of B; a shared B is only packed once
+    size_t nr_packed_b(const TensorLayout& B) const {
+        return (batch == 1 || B.stride[0] == 0) ? 1 : batch;
+    }
+
+    size_t packed_panel_size() const { return K * NR; }
+};
+
+/*!
+ * \brief pack columns [n0, n0 + n) of B into a K x NR panel, padded with zeros
+ *
+ * If \p trans, B is stored as N x K.
+ */
+void pack_b_panel(
+        const float* b, size_t ldb, bool trans, size_t K, size_t n0, size_t n,
+        float* out) {
+    if (!trans) {
+        for (size_t k = 0; k < K; ++k) {
+            const float* src = b + k * ldb + n0;
+            float* dst = out + k * NR;
+            std::copy(src, src + n, dst);
+            std::fill(dst + n, dst + NR, 0.f);
+        }
+    } else {
+        for (size_t j = 0; j < n; ++j) {
+            const float* src = b + (n0 + j) * ldb;
+            for (size_t k = 0; k < K; ++k) {
+                out[k * NR + j] = src[k];
+            }
+        }
+        for (size_t k = 0; k < K; ++k) {
+            std::fill(out + k * NR + n, out + (k + 1) * NR, 0.f);
+        }
+    }
+}
+
+/*!
+ * \brief compute an MR_ x (NV * 8) block of C from A and a packed B panel
+ *
+ * The block sizes are compile-time constants and the loops over them are
+ * unrolled, so that the accumulators stay in registers; only the first \p n
+ * columns are written.
+ */
+template <size_t MR_, size_t NV, bool TRANS_A>
+MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+void gemm_kern(
+        const float* a, size_t lda, const float* packed_b, size_t K, float* c,
+        size_t ldc, size_t n) {
+    static_assert(MR_ <= MR && NV <= NR / 8, "bad block size");
+    __m256 acc[MR][NR / 8], b0, b1;
+#define cb(i)                                \
+    if (i < MR_) {                           \
+        acc[i][0] = _mm256_setzero_ps();     \
+        if (NV > 1) {                        \
+            acc[i][1] = _mm256_setzero_ps(); \
+        }                                    \
+    }
+    UNROLL_CALL_RAW(6, cb)
+#undef cb
+    for (size_t k = 0; k < K; ++k) {
+        b0 = _mm256_loadu_ps(packed_b + k * NR);
+        if (NV > 1) {
+            b1 = _mm256_loadu_ps(packed_b + k * NR + 8);
+        }
+#define cb(i)                                                                     \
+    if (i < MR_) {                                                                \
+        __m256 av =                                                               \
+                _mm256_broadcast_ss(TRANS_A ? a + k * lda + i : a + i * lda + k); \
+        acc[i][0] = _mm256_fmadd_ps(av, b0, acc[i][0]);                           \
+        if (NV > 1) {                                                             \
+            acc[i][1] = _mm256_fmadd_ps(av, b1, acc[i][1]);                       \
+        }                                                                         \
+    }
+        UNROLL_CALL_RAW(6, cb)
+#undef cb
+    }
+    if (n == NV * 8) {
+#define cb(i)                                             \
+    if (i < MR_) {                                        \
+        _mm256_storeu_ps(c + i * ldc, acc[i][0]);         \
+        if (NV > 1) {                                     \
+            _mm256_storeu_ps(c + i * ldc + 8, acc[i][1]); \
+        }                                                 \
+    }
+        UNROLL_CALL_RAW(6, cb)
+#undef cb
+    } else {
+        //! the mask of the first cnt lanes is loaded from mask_table + 8 - cnt
+        static const int32_t mask_table[16] = {-1, -1, -1, -1, -1, -1, -1, -1,
+                                               0,  0,  0,  0,  0,  0,  0,  0};
+        size_t cnt0 = std::min<size_t>(8, n), cnt1 = n - cnt0;
+        __m256i mask0 = _mm256_loadu_si256(
+                        reinterpret_cast<const __m256i*>(mask_table + 8 - cnt0)),
+                mask1 = _mm256_loadu_si256(
+                        reinterpret_cast<const __m256i*>(mask_table + 8 - cnt1));
+#define cb(i)                                                       \
+    if (i < MR_) {                                                  \
+        _mm256_maskstore_ps(c + i * ldc, mask0, acc[i][0]);         \
+        if (NV > 1) {                                               \
+            _mm256_maskstore_ps(c + i * ldc + 8, mask1, acc[i][1]); \
+        }                                                           \
+    }
+        UNROLL_CALL_RAW(6, cb)
+#undef cb
+    }
+}
+
+template <size_t NV, bool TRANS_A>
+void dispatch_kern_rows(
+        size_t mr, const float* a, size_t lda, const float* packed_b, size_t K,
+        float* c, size_t ldc, size_t n) {
+    switch (mr) {
+#define cb(_mr)                                                      \
+    case _mr:                                                        \
+        gemm_kern<_mr, NV, TRANS_A>(a, lda, packed_b, K, c, ldc, n); \
+        break;
+        cb(1) cb(2) cb(3) cb(4) cb(5) cb(6)
+#undef cb
+        default:
+            megdnn_assert_internal(0);
+    }
+}
+
+/*!
+ * \brief compute rows [m0, m1) and panels [p0, p1) of one batch of C
+ * \param a the batch of A
+ * \param packed_b the packed B of the batch
+ */
+template <bool TRANS_A>
+void compute_tile(
+        const GemmShape& shp, const float* a, size_t lda, const float* packed_b,
+        float* c, size_t ldc, size_t m0, size_t m1, size_t p0, size_t p1) {
+    for (size_t p = p0; p < p1; ++p) {
+        const float* pb = packed_b + p * shp.packed_panel_size();
+        size_t n0 = p * NR, n = std::min(NR, shp.N - n0);
+        for (size_t m = m0; m < m1; m += MR) {
+            size_t mr = std::min(MR, m1 - m);
+            const float* ap = TRANS_A ? a + m : a + m * lda;
+            float* cp = c + m * ldc + n0;
+            if (n > 8) {
+                dispatch_kern_rows<2, TRANS_A>(mr, ap, lda, pb, shp.K, cp, ldc, n);
+            } else {
+                dispatch_kern_rows<1, TRANS_A>(mr, ap, lda, pb, shp.K, cp, ldc, n);
+            }
+        }
+    }
+}
+
+template <bool TRANS_A>
+void exec_f32(
+        naive::HandleImpl* handle, const GemmShape& shp, const TensorND& A,
+        const TensorND& B, const TensorND& C, float* packed_b) {
+    size_t nr_panels = shp.nr_panels(), nr_packed_b = shp.nr_packed_b(B.layout),
+           panel_size = shp.packed_panel_size();
+    size_t m_tiles = div_ceil(shp.M, M_TILE),
+           n_tiles = div_ceil(nr_panels, N_TILE_PANELS);
+
+    auto pack_kern = [=](size_t task_id, size_t) {
+        size_t b = task_id / n_tiles, nt = task_id % n_tiles;
+        size_t p1 = std::min(nr_panels, (nt + 1) * N_TILE_PANELS);
+        const float* bptr = B.ptr<dt_float32>() + b * B.layout.stride[0];
+        for (size_t p = nt * N_TILE_PANELS; p < p1; ++p) {
+            pack_b_panel(
+                    bptr, B.layout.stride[1], shp.trB, shp.K, p * NR,
+                    std::min(NR, shp.N - p * NR),
+                    packed_b + (b * nr_panels + p) * panel_size);
+        }
+    };
+    handle->dispatch_kern(pack_kern, nr_packed_b * n_tiles);
+
+    //! group small matrices of several batches into one task
+    size_t tiles_per_batch = m_tiles * n_tiles, batches_per_task = 1;
+    if (tiles_per_batch == 1) {
+        batches_per_task = std::max<size_t>(
+                1, MIN_TASK_MACS / std::max<size_t>(1, shp.M * shp.N * shp.K));
+    }
+    size_t nr_batch_groups = div_ceil(shp.batch, batches_per_task);
+    auto compute_kern = [=](size_t task_id, size_t) {
+        size_t group = task_id / tiles_per_batch, tile = task_id % tiles_per_batch;
+        size_t mt = tile / n_tiles, nt = tile % n_tiles;
+        size_t m0 = mt * M_TILE, m1 = std::min(shp.M, m0 + M_TILE),
+               p0 = nt * N_TILE_PANELS, p1 = std::min(nr_panels, p0 + N_TILE_PANELS);
+        size_t b_end = std::min(shp.batch, (group + 1) * batches_per_task);
+        for (size_t b = group * batches_per_task; b < b_end; ++b) {
+            compute_tile<TRANS_A>(
+                    shp, A.ptr<dt_float32>() + b * A.layout.stride[0],
+                    A.layout.stride[1],
+                    packed_b + (nr_packed_b == 1 ? 0 : b) * nr_panels * panel_size,
+                    C.ptr<dt_float32>() + b * C.layout.stride[0], C.layout.stride[1],
+                    m0, m1, p0, p1);
+        }
+    };
+    handle->dispatch_kern(compute_kern, nr_batch_groups * tiles_per_batch);
+}
+
+}  // anonymous namespace
+
+bool BatchedMatrixMulForwardImpl::AlgoF32AVX2M6N16::is_available(
+        const SizeArgs& args) const {
+    auto&& param = args.opr->param();
+    return args.layout_a.dtype == dtype::Float32() &&
+           args.layout_b.dtype == dtype::Float32() &&
+           args.layout_c.dtype == dtype::Float32() &&
+           param.compute_mode == param::MatrixMul::ComputeMode::DEFAULT &&
+           param.format == param::MatrixMul::Format::DEFAULT &&
+           is_supported(SIMDType::AVX2) && is_supported(SIMDType::FMA);
+}
+
+size_t BatchedMatrixMulForwardImpl::AlgoF32AVX2M6N16::get_workspace_in_bytes(
+        const SizeArgs& args) const {
+    auto&& param = args.opr->param();
+    GemmShape shp{args.layout_a, args.layout_b, param.transposeA, param.transposeB};
+    return shp.nr_packed_b(args.layout_b) * shp.nr_panels() *
+           shp.packed_panel_size() * sizeof(dt_float32);
+}
+
+void BatchedMatrixMulForwardImpl::AlgoF32AVX2M6N16::exec(const ExecArgs& args) const {
+    auto&& param = args.opr->param();
+    GemmShape shp{args.layout_a, args.layout_b, param.transposeA, param.transposeB};
+    if (!shp.batch || !shp.M || !shp.N) {
+        return;
+    }
+    auto handle = static_cast<naive::HandleImpl*>(args.opr->handle());
+    auto packed_b = args.workspace.ptr<dt_float32>();
+    MIDOUT_BEGIN(megdnn_x86_batched_matmul, midout_iv(0)) {
+        if (shp.trA) {
+            exec_f32<true>(
+                    handle, shp, args.tensor_a, args.tensor_b, args.tensor_c, packed_b);
+        } else {
+            exec_f32<false>(
+                    handle, shp, args.tensor_a, args.tensor_b, args.tensor_c, packed_b);
+        }
+    }
+    MIDOUT_END();
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,37 @@
+/**
+ * \file dnn/src/x86/batched_matrix_mul/algos.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+
+#include "src/x86/batched_matrix_mul/opr_impl.h"
+
+namespace megdnn {
+namespace x86 {
+
+/*!
+ * \brief fp32 batched gemm with 6x16 avx2 micro kernels
+ *
+ * Tasks are split over batch x M tiles x N tiles. B is packed into panels of
+ * 16 columns beforehand, only once if it is shared by all the batches.
+ */
+class BatchedMatrixMulForwardImpl::AlgoF32AVX2M6N16 final : public AlgoBase {
+public:
+    bool is_available(const SizeArgs& args) const override;
+    size_t get_workspace_in_bytes(const SizeArgs& args) const override;
+    const char* name() const override { return "X86_BATCHED_F32_6x16"; }
+    void exec(const ExecArgs& args) const override;
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    MEGDNN_DECL_ALGO_TYPE(X86_F32_AVX2_6X16)
+};
+
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,55 @@
+/**
+ * \file dnn/src/x86/batched_matrix_mul/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "src/x86/batched_matrix_mul/opr_impl.h"
+#include "src/common/metahelper.h"
+#include "src/x86/batched_matrix_mul/algos.h"
+
+using namespace megdnn;
+using namespace x86;
+
+class BatchedMatrixMulForwardImpl::AlgoPack : NonCopyableObj {
+    AlgoF32AVX2M6N16 f32_avx2_6x16;
+
+    std::vector<fallback::BatchedMatrixMulForwardImpl::AlgoBase*> m_all_algos;
+    fallback::BatchedMatrixMulForwardImpl::AlgoBase::Mapper m_all_algos_map;
+
+public:
+    AlgoPack() {
+        m_all_algos.emplace_back(&f32_avx2_6x16);
+        for (auto&& algo : m_all_algos) {
+            m_all_algos_map.emplace(algo->info().desc, algo);
+        }
+    }
+
+    const std::vector<fallback::BatchedMatrixMulForwardImpl::AlgoBase*>& all_algos()
+            const {
+        return m_all_algos;
+    }
+    const AlgoBase::Mapper& all_algos_map() const { return m_all_algos_map; }
+};
+
+const BatchedMatrixMulForwardImpl::AlgoPack& BatchedMatrixMulForwardImpl::algo_pack() {
+    static AlgoPack algo_pack;
+    return algo_pack;
+}
+
+MEGDNN_FB_DEF_GET_ALGO_FROM_DESC(BatchedMatrixMulForwardImpl)
+
+std::vector<fallback::BatchedMatrixMulForwardImpl::AlgoBase*>
+BatchedMatrixMulForwardImpl::get_all_packed_algo() {
+    auto&& algos = fallback::BatchedMatrixMulForwardImpl::get_all_packed_algo();
+    algos.insert(
+            algos.begin(), algo_pack().all_algos().begin(),
+            algo_pack().all_algos().end());
+    return std::move(algos);
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,46 @@
+/**
+ * \file dnn/src/x86/batched_matrix_mul/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+#include "src/common/algo_base.h"
+#include "src/fallback/batched_matrix_mul/algos.h"
+#include "src/fallback/batched_matrix_mul/opr_impl.h"
+
+namespace megdnn {
+namespace x86 {
+
+class BatchedMatrixMulForwardImpl : public fallback::BatchedMatrixMulForwardImpl {
+public:
+    using fallback::BatchedMatrixMulForwardImpl::BatchedMatrixMulForwardImpl;
+    class AlgoBase : public fallback::BatchedMatrixMulForwardImpl::AlgoBase {
+    public:
+        AlgoBase() : fallback::BatchedMatrixMulForwardImpl::AlgoBase() {
+            m_handle_type = Handle::HandleType::X86;
+        }
+    };
+
+    MEGDNN_FB_DECL_GET_ALGO_FROM_DESC(BatchedMatrixMulForwardImpl);
+
+protected:
+    std::vector<fallback::BatchedMatrixMulForwardImpl::AlgoBase*> get_all_packed_algo()
+            override;
+
+private:
+    class AlgoF32AVX2M6N16;
+    class AlgoPack;
+
+public:
+    static const AlgoPack& algo_pack();
+};
+
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
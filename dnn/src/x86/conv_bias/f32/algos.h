@@ -86,6 +86,41 @@ public:
     }
     MEGDNN_DECL_ALGO_TYPE(X86_DIRECT_STRD2)
 };
+/* ===================== channel-wise algo ===================== */
+class ConvBiasImpl::AlgoF32ChanWiseNCHW final : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "X86_CONV_BIAS_CHANWISE_AVX2_F32_NCHW"; }
+    bool usable(
+            const NCBKernSizeParam& param,
+            AlgoSelectionStrategy algo_selection_strategy) const override;
+    size_t get_workspace(const NCBKernSizeParam& param) const override;
+    SmallVector<NCBKern> dispatch_kerns(const NCBKernSizeParam& param) const override;
+
+    ConvAlgoTypePack get_algo_type() const override {
+        return {AlgoDataType::FLOAT32, AlgoCategory::DIRECT};
+    }
+    MEGDNN_DECL_ALGO_TYPE(X86_CHANWISE_AVX2_F32_NCHW)
+};
+
+class ConvBiasImpl::AlgoF32ChanWiseNCHW88 final : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override {
+        return "X86_CONV_BIAS_CHANWISE_AVX2_F32_NCHW88";
+    }
+    bool usable(
+            const NCBKernSizeParam& param,
+            AlgoSelectionStrategy algo_selection_strategy) const override;
+    size_t get_workspace(const NCBKernSizeParam& param) const override;
+    SmallVector<NCBKern> dispatch_kerns(const NCBKernSizeParam& param) const override;
+
+    ConvAlgoTypePack get_algo_type() const override {
+        return {AlgoDataType::FLOAT32, AlgoCategory::DIRECT};
+    }
+    MEGDNN_DECL_ALGO_TYPE(X86_CHANWISE_AVX2_F32_NCHW88)
+};
+
 /* =========================== winograd ======================== */
 class ConvBiasImpl::AlgoFP32WinogradF63_8x8 final : public AlgoBase {
 public:
@@ -104,6 +139,23 @@ public:
     MEGDNN_DECL_ALGO_TYPE(X86_WINOGRAD_F63_8x8_F32)
 };
 
+class ConvBiasImpl::AlgoFP32WinogradF43_8x8 final : public AlgoBase {
+public:
+    AlgoFP32WinogradF43_8x8(
+            fallback::MatrixMulImpl::AlgoBase* matmul_algo, uint32_t tile_size)
+            : m_matmul_algo{matmul_algo}, m_tile_size{tile_size} {}
+    const char* name() const override {
+        if (m_name.empty()) {
+            m_name = ConvBiasImpl::algo_name<ConvBias::WinogradParam>(
+                    m_matmul_algo->name(), {8, 4, m_tile_size});
+        }
+        return m_name.c_str();
+    }
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    MEGDNN_WINOGRAD_ALGO_FUN_DECLARE(AlgoDataType::FLOAT32);
+    MEGDNN_DECL_ALGO_TYPE(X86_WINOGRAD_F43_8x8_F32)
+};
+
 class ConvBiasImpl::AlgoFP32WinogradF23_8x8 final : public AlgoBase {
 public:
     AlgoFP32WinogradF23_8x8(
@@ -0,0 +1,217 @@
+/**
+ * \file dnn/src/x86/conv_bias/f32/channel_wise_algo.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/x86/conv_bias/f32/algos.h"
+#include "src/x86/conv_bias/f32/channel_wise_kern.h"
+#include "src/x86/elemwise_op.h"
+#include "src/x86/utils.h"
+
+#include "midout.h"
+
+using namespace megdnn;
+using namespace x86;
+using namespace channel_wise_f32;
+
+MIDOUT_DECL(megdnn_x86_conv_bias_fp32_channel_wise)
+
+namespace {
+
+bool chanwise_usable(
+        const ConvBiasImpl::NCBKernSizeParam& param, param::ConvBias::Format format) {
+    auto&& fm = param.filter_meta;
+    auto FH = fm.spatial[0];
+    bool ok_type =
+            (param.src_type.enumv() == DTypeEnum::Float32 &&
+             param.filter_type.enumv() == DTypeEnum::Float32 &&
+             param.dst_type.enumv() == DTypeEnum::Float32);
+    bool ok_format = fm.format == format && fm.icpg == 1 && fm.ocpg == 1;
+    bool ok_filter = fm.spatial_ndim == 2 && FH == fm.spatial[1] &&
+                     (FH == 3 || FH == 5 || FH == 7);
+    bool ok_slide = fm.dilation[0] == 1 && fm.dilation[1] == 1 &&
+                    fm.stride[0] == fm.stride[1] &&
+                    (fm.stride[0] == 1 || fm.stride[0] == 2);
+    bool ok_nonline = param.nonlineMode == param::ConvBias::NonlineMode::IDENTITY ||
+                      param.nonlineMode == param::ConvBias::NonlineMode::RELU ||
+                      param.nonlineMode == param::ConvBias::NonlineMode::SIGMOID ||
+                      param.nonlineMode == param::ConvBias::NonlineMode::H_SWISH;
+    bool ok_conv = !fm.should_flip;
+    return ok_type && ok_format && ok_filter && ok_slide && ok_nonline && ok_conv &&
+           is_supported(SIMDType::AVX2) && is_supported(SIMDType::FMA);
+}
+
+//! number of floats of the workspace of each thread
+size_t workspace_per_thread(const ConvBiasImpl::NCBKernSizeParam& param, bool nchw88) {
+    auto&& fm = param.filter_meta;
+    size_t OH = param.osz[0], OW = param.osz[1], FH = fm.spatial[0],
+           FW = fm.spatial[1], stride = fm.stride[0];
+    return nchw88 ? get_nchw88_workspace(
+                            OH, OW, FH, FW, fm.padding[0], fm.padding[1], stride)
+                  : get_nchw_workspace(OH, OW, FH, FW, stride);
+}
+
+size_t chanwise_workspace(const ConvBiasImpl::NCBKernSizeParam& param, bool nchw88) {
+    return workspace_per_thread(param, nchw88) * sizeof(float) * param.nr_threads;
+}
+
+//! select the kernel by stride, filter size, bias mode and nonlinearity
+conv_fun get_conv_fun(const ConvBiasImpl::NCBKernSizeParam& param, bool nchw88) {
+    conv_fun do_conv_fun = nullptr;
+    int stride = param.filter_meta.stride[0];
+#define DO_CONV_KERN_FUN(_layout, _stride, _filter, _bias_mode, _op)            \
+    MIDOUT_BEGIN(                                                               \
+            megdnn_x86_conv_bias_fp32_channel_wise,                             \
+            midout_iv(#_layout #_stride #_filter #_bias_mode #_op##_hash)) {    \
+        do_conv_fun = do_conv_kern_##_layout<                                   \
+                _filter, _stride, _bias_mode, _op<SIMDType::AVX2, dt_float32>>; \
+    }                                                                           \
+    MIDOUT_END();
+
+#define GET_OP_PARAM(_layout, _stride, _filter, _bias_mode)                    \
+    switch (param.nonlineMode) {                                               \
+        case param::ConvBias::NonlineMode::IDENTITY:                           \
+            DO_CONV_KERN_FUN(_layout, _stride, _filter, _bias_mode, NoneOp)    \
+            break;                                                             \
+        case param::ConvBias::NonlineMode::RELU:                               \
+            DO_CONV_KERN_FUN(_layout, _stride, _filter, _bias_mode, ReluOp)    \
+            break;                                                             \
+        case param::ConvBias::NonlineMode::SIGMOID:                            \
+            DO_CONV_KERN_FUN(_layout, _stride, _filter, _bias_mode, SigmoidOp) \
+            break;                                                             \
+        case param::ConvBias::NonlineMode::H_SWISH:                            \
+            DO_CONV_KERN_FUN(_layout, _stride, _filter, _bias_mode, HSwishOp)  \
+            break;                                                             \
+        default:                                                               \
+            megdnn_assert(0);                                                  \
+            break;                                                             \
+    }
+
+#define GET_BIAS_MODE_PARAM(_layout, _stride, _filter)                           \
+    switch (param.bias_mode) {                                                   \
+        case BiasMode::NO_BIAS:                                                  \
+            GET_OP_PARAM(_layout, _stride, _filter, BiasMode::NO_BIAS)           \
+            break;                                                               \
+        case BiasMode::BROADCAST_CHANNEL_BIAS:                                   \
+            GET_OP_PARAM(                                                        \
+                    _layout, _stride, _filter, BiasMode::BROADCAST_CHANNEL_BIAS) \
+            break;                                                               \
+        case BiasMode::BIAS:                                                     \
+            GET_OP_PARAM(_layout, _stride, _filter, BiasMode::BIAS)              \
+            break;                                                               \
+        default:                                                                 \
+            megdnn_assert(0);                                                    \
+            break;                                                               \
+    }
+
+#define DISPATCH_CONV_KERN(_layout, _stride)         \
+    switch (param.filter_meta.spatial[0]) {          \
+        case 3:                                      \
+            GET_BIAS_MODE_PARAM(_layout, _stride, 3) \
+            break;                                   \
+        case 5:                                      \
+            GET_BIAS_MODE_PARAM(_layout, _stride, 5) \
+            break;                                   \
+        case 7:                                      \
+            GET_BIAS_MODE_PARAM(_layout, _stride, 7) \
+            break;                                   \
+        default:                                     \
+            megdnn_assert(0);                        \
+            break;                                   \
+    }
+
+#define DISPATCH_STRIDE(_layout)        \
+    if (1 == stride) {                  \
+        DISPATCH_CONV_KERN(_layout, 1); \
+    } else {                            \
+        DISPATCH_CONV_KERN(_layout, 2); \
+    }
+
+    if (nchw88) {
+        DISPATCH_STRIDE(nchw88);
+    } else {
+        DISPATCH_STRIDE(nchw);
+    }
+
+#undef DO_CONV_KERN_FUN
+#undef GET_OP_PARAM
+#undef GET_BIAS_MODE_PARAM
+#undef DISPATCH_CONV_KERN
+#undef DISPATCH_STRIDE
+
+    megdnn_assert(do_conv_fun);
+    return do_conv_fun;
+}
+
+SmallVector<ConvBiasImpl::NCBKern> chanwise_kerns(
+        const ConvBiasImpl::NCBKernSizeParam& param, bool nchw88) {
+    size_t pack_group_size = nchw88 ? 8 : 1;
+    conv_fun do_conv_fun = get_conv_fun(param, nchw88);
+    size_t ws_per_thread = workspace_per_thread(param, nchw88);
+    auto do_conv = [do_conv_fun, pack_group_size, ws_per_thread](
+                           const ConvBiasImpl::NCBKernParam& kern_param,
+                           const ConvBiasImpl::NCBKernIndex& ncb_index) {
+        size_t PH = kern_param.filter_meta.padding[0];
+        size_t PW = kern_param.filter_meta.padding[1];
+        size_t OH = kern_param.osz[0];
+        size_t OW = kern_param.osz[1];
+        size_t IH = kern_param.isz[0];
+        size_t IW = kern_param.isz[1];
+
+        size_t batch_id = ncb_index.ndrange_id[0];
+        size_t group_id = ncb_index.ndrange_id[1];
+        const float* sptr =
+                kern_param.src<float>(batch_id, group_id, 0, pack_group_size);
+        const float* fptr = kern_param.filter<float>(group_id, pack_group_size);
+        float* dst = kern_param.dst<float>(batch_id, group_id, 0, pack_group_size);
+        const float* bptr =
+                kern_param.bias<float>(batch_id, group_id, 0, pack_group_size);
+        float* workspace = static_cast<float*>(kern_param.workspace_ptr) +
+                           ncb_index.thread_id * ws_per_thread;
+        do_conv_fun(sptr, fptr, bptr, dst, IH, IW, OH, OW, PH, PW, workspace);
+    };
+    CpuNDRange ncb_range = {param.n, param.filter_meta.group / pack_group_size};
+    return {{do_conv, ncb_range}};
+}
+
+}  // anonymous namespace
+
+/* ===================== NCHW ===================== */
+bool ConvBiasImpl::AlgoF32ChanWiseNCHW::usable(
+        const NCBKernSizeParam& param, AlgoSelectionStrategy) const {
+    return chanwise_usable(param, param::ConvBias::Format::NCHW);
+}
+
+size_t ConvBiasImpl::AlgoF32ChanWiseNCHW::get_workspace(
+        const NCBKernSizeParam& param) const {
+    return chanwise_workspace(param, false);
+}
+
+SmallVector<ConvBiasImpl::NCBKern> ConvBiasImpl::AlgoF32ChanWiseNCHW::dispatch_kerns(
+        const NCBKernSizeParam& param) const {
+    return chanwise_kerns(param, false);
+}
+
+/* ===================== NCHW88 ===================== */
+bool ConvBiasImpl::AlgoF32ChanWiseNCHW88::usable(
+        const NCBKernSizeParam& param, AlgoSelectionStrategy) const {
+    return chanwise_usable(param, param::ConvBias::Format::NCHW88);
+}
+
+size_t ConvBiasImpl::AlgoF32ChanWiseNCHW88::get_workspace(
+        const NCBKernSizeParam& param) const {
+    return chanwise_workspace(param, true);
+}
+
+SmallVector<ConvBiasImpl::NCBKern> ConvBiasImpl::AlgoF32ChanWiseNCHW88::
+        dispatch_kerns(const NCBKernSizeParam& param) const {
+    return chanwise_kerns(param, true);
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,349 @@
+/**
+ * \file dnn/src/x86/conv_bias/f32/channel_wise_kern.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/x86/conv_bias/f32/channel_wise_kern.h"
+#include "src/common/unroll_macro.h"
+#include "src/common/utils.h"
+#include "src/x86/elemwise_op.h"
+
+#include <immintrin.h>
+#ifdef WIN32
+#include <avx2intrin.h>
+#include <avxintrin.h>
+#include <fmaintrin.h>
+#endif
+#include <cstring>
+
+using namespace megdnn;
+using namespace x86;
+using namespace channel_wise_f32;
+
+namespace {
+
+//! number of output vectors computed together, which stay in registers
+constexpr int NR_OW_VEC = 4;
+constexpr int NR_OW_PIX = 8;
+
+template <BiasMode bias_mode>
+struct BiasInit;
+
+template <>
+struct BiasInit<BiasMode::NO_BIAS> {
+    MEGDNN_ATTRIBUTE_TARGET("avx2")
+    static __m256 nchw88(const float*, size_t) { return _mm256_setzero_ps(); }
+    MEGDNN_ATTRIBUTE_TARGET("avx2")
+    static __m256 nchw(const float*, size_t, __m256i) { return _mm256_setzero_ps(); }
+};
+
+template <>
+struct BiasInit<BiasMode::BROADCAST_CHANNEL_BIAS> {
+    MEGDNN_ATTRIBUTE_TARGET("avx2")
+    static __m256 nchw88(const float* bias, size_t) { return _mm256_loadu_ps(bias); }
+    MEGDNN_ATTRIBUTE_TARGET("avx2")
+    static __m256 nchw(const float* bias, size_t, __m256i) {
+        return _mm256_broadcast_ss(bias);
+    }
+};
+
+template <>
+struct BiasInit<BiasMode::BIAS> {
+    //! \p offset is the offset of the output pixel
+    MEGDNN_ATTRIBUTE_TARGET("avx2")
+    static __m256 nchw88(const float* bias, size_t offset) {
+        return _mm256_loadu_ps(bias + offset * 8);
+    }
+    MEGDNN_ATTRIBUTE_TARGET("avx2")
+    static __m256 nchw(const float* bias, size_t offset, __m256i mask) {
+        return _mm256_maskload_ps(bias + offset, mask);
+    }
+};
+
+//! mask of the first n lanes
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+inline __m256i get_mask(size_t n) {
+    alignas(32) static const int32_t mask_table[16] = {-1, -1, -1, -1, -1, -1,
+                                                       -1, -1, 0,  0,  0,  0,
+                                                       0,  0,  0,  0};
+    return _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(mask_table + 8 - std::min<size_t>(n, 8)));
+}
+
+/* ======================== NCHW88 ======================== */
+
+/*!
+ * Each pixel is a vector of 8 channels, so the filter of a tap is one vector
+ * and NR_OW_PIX adjacent output pixels of a row are accumulated in registers.
+ * \param sptr first input row of the output row, with row stride \p IW
+ */
+template <int filter, int stride, int nr_pix, BiasMode bias_mode, typename Op>
+MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+inline void nchw88_compute_pixels(
+        const float* sptr, const float* fptr, const float* bias, float* dst,
+        size_t IW, size_t offset, const Op& op) {
+    __m256 acc[NR_OW_PIX];
+#define cb(i)                                                   \
+    if (i < nr_pix) {                                           \
+        acc[i] = BiasInit<bias_mode>::nchw88(bias, offset + i); \
+    }
+    UNROLL_CALL_RAW(8, cb);
+#undef cb
+    for (int fh = 0; fh < filter; ++fh) {
+        const float* row = sptr + fh * IW * 8;
+        for (int fw = 0; fw < filter; ++fw) {
+            __m256 w = _mm256_loadu_ps(fptr + (fh * filter + fw) * 8);
+#define cb(i)                                                             \
+    if (i < nr_pix) {                                                     \
+        acc[i] = _mm256_fmadd_ps(                                         \
+                _mm256_loadu_ps(row + (i * stride + fw) * 8), w, acc[i]); \
+    }
+            UNROLL_CALL_RAW(8, cb);
+#undef cb
+        }
+    }
+#define cb(i)                                      \
+    if (i < nr_pix) {                              \
+        _mm256_storeu_ps(dst + i * 8, op(acc[i])); \
+    }
+    UNROLL_CALL_RAW(8, cb);
+#undef cb
+}
+
+/* ======================== NCHW ======================== */
+
+/*!
+ * The src of a channel is copied into a zero-padded buffer in which every
+ * row is split into \p stride phases, where phase p holds the columns
+ * p, p + stride, p + 2 * stride, ..., so the inputs of 8 adjacent outputs at a
+ * filter tap are always 8 contiguous floats. nr_vec output vectors of a row
+ * are accumulated in registers with the filter taps broadcast.
+ * \param sptr first padded row of the output row
+ * \param nr_tail number of valid lanes of the last vector
+ */
+template <int filter, int stride, int nr_vec, BiasMode bias_mode, typename Op>
+MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+inline void nchw_compute_vectors(
+        const float* sptr, const float* fptr, const float* bias, float* dst,
+        size_t row_stride, size_t phase_stride, size_t offset, size_t nr_tail,
+        const Op& op) {
+    __m256 acc[NR_OW_VEC];
+    __m256i tail_mask = get_mask(nr_tail), full_mask = get_mask(8);
+#define cb(i)                                                                   \
+    if (i < nr_vec) {                                                           \
+        acc[i] = BiasInit<bias_mode>::nchw(                                     \
+                bias, offset + i * 8, i == nr_vec - 1 ? tail_mask : full_mask); \
+    }
+    UNROLL_CALL_RAW(4, cb);
+#undef cb
+    for (int fh = 0; fh < filter; ++fh) {
+        const float* row = sptr + fh * row_stride;
+        for (int fw = 0; fw < filter; ++fw) {
+            const float* phase = row + (fw % stride) * phase_stride + fw / stride;
+            __m256 w = _mm256_broadcast_ss(fptr + fh * filter + fw);
+#define cb(i)                                                                \
+    if (i < nr_vec) {                                                        \
+        acc[i] = _mm256_fmadd_ps(_mm256_loadu_ps(phase + i * 8), w, acc[i]); \
+    }
+            UNROLL_CALL_RAW(4, cb);
+#undef cb
+        }
+    }
+#define cb(i)                                                    \
+    if (i < nr_vec - 1) {                                        \
+        _mm256_storeu_ps(dst + i * 8, op(acc[i]));               \
+    } else if (i == nr_vec - 1) {                                \
+        _mm256_maskstore_ps(dst + i * 8, tail_mask, op(acc[i])); \
+    }
+    UNROLL_CALL_RAW(4, cb);
+#undef cb
+}
+
+//! width of a phase of a padded row
+size_t nchw_phase_width(size_t OW, size_t FW, size_t stride) {
+    return round_up<size_t>(OW, 8) + (FW - 1) / stride;
+}
+
+//! pad a row of \p IW floats and split it into phases
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+void nchw_copy_row(
+        const float* srow, float* drow, size_t IW, size_t PW, size_t stride,
+        size_t phase_stride) {
+    for (size_t p = 0; p < stride; ++p) {
+        float* dphase = drow + p * phase_stride;
+        //! [begin, end) of the phase is inside the input row
+        size_t begin = p >= PW ? 0 : div_ceil<size_t>(PW - p, stride),
+               end = std::min(phase_stride, div_ceil<size_t>(IW + PW - p, stride));
+        begin = std::min(begin, end);
+        std::memset(dphase, 0, begin * sizeof(float));
+        const float* sphase = srow + begin * stride + p - PW;
+        if (stride == 1) {
+            std::memcpy(dphase + begin, sphase, (end - begin) * sizeof(float));
+        } else {
+            size_t j = begin;
+            if (stride == 2) {
+                //! pick the even elements of 16 floats, until the load
+                //! would go beyond the row
+                const float* srow_end = srow + IW;
+                for (; j + 8 <= end && sphase + (j - begin) * 2 + 16 <= srow_end;
+                     j += 8) {
+                    const float* sp = sphase + (j - begin) * 2;
+                    __m256 even = _mm256_shuffle_ps(
+                            _mm256_loadu_ps(sp), _mm256_loadu_ps(sp + 8),
+                            _MM_SHUFFLE(2, 0, 2, 0));
+                    _mm256_storeu_ps(
+                            dphase + j,
+                            _mm256_castpd_ps(_mm256_permute4x64_pd(
+                                    _mm256_castps_pd(even),
+                                    _MM_SHUFFLE(3, 1, 2, 0))));
+                }
+            }
+            for (; j < end; ++j) {
+                dphase[j] = sphase[(j - begin) * stride];
+            }
+        }
+        std::memset(dphase + end, 0, (phase_stride - end) * sizeof(float));
+    }
+}
+
+}  // anonymous namespace
+
+size_t channel_wise_f32::get_nchw_workspace(
+        size_t OH, size_t OW, size_t FH, size_t FW, size_t stride) {
+    size_t rows = (OH - 1) * stride + FH;
+    return rows * stride * nchw_phase_width(OW, FW, stride);
+}
+
+size_t channel_wise_f32::get_nchw88_workspace(
+        size_t OH, size_t OW, size_t FH, size_t FW, size_t PH, size_t PW,
+        size_t stride) {
+    if (PH == 0 && PW == 0) {
+        return 0;
+    }
+    return ((OH - 1) * stride + FH) * ((OW - 1) * stride + FW) * 8;
+}
+
+template <int filter, int stride, BiasMode bias_mode, typename Op>
+MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+void channel_wise_f32::do_conv_kern_nchw88(
+        const float* src, const float* filter_ptr, const float* bias, float* dst,
+        size_t IH, size_t IW, size_t OH, size_t OW, size_t PH, size_t PW,
+        float* workspace) {
+    //! copy src into a zero-padded buffer which holds exactly the input used
+    if (PH || PW) {
+        size_t IH2 = (OH - 1) * stride + filter, IW2 = (OW - 1) * stride + filter;
+        for (size_t ih2 = 0; ih2 < IH2; ++ih2) {
+            float* drow = workspace + ih2 * IW2 * 8;
+            size_t ih = ih2 - PH;
+            if (ih2 < PH || ih >= IH) {
+                std::memset(drow, 0, IW2 * 8 * sizeof(float));
+                continue;
+            }
+            size_t left = std::min(PW, IW2), copy = std::min(IW, IW2 - left);
+            std::memset(drow, 0, left * 8 * sizeof(float));
+            std::memcpy(drow + left * 8, src + ih * IW * 8, copy * 8 * sizeof(float));
+            std::memset(
+                    drow + (left + copy) * 8, 0,
+                    (IW2 - left - copy) * 8 * sizeof(float));
+        }
+        src = workspace;
+        IW = IW2;
+    }
+    Op op;
+    for (size_t oh = 0; oh < OH; ++oh) {
+        const float* sptr = src + oh * stride * IW * 8;
+        float* dptr = dst + oh * OW * 8;
+        size_t ow = 0;
+        for (; ow + NR_OW_PIX <= OW; ow += NR_OW_PIX) {
+            nchw88_compute_pixels<filter, stride, NR_OW_PIX, bias_mode>(
+                    sptr + ow * stride * 8, filter_ptr, bias, dptr + ow * 8, IW,
+                    oh * OW + ow, op);
+        }
+        for (; ow < OW; ++ow) {
+            nchw88_compute_pixels<filter, stride, 1, bias_mode>(
+                    sptr + ow * stride * 8, filter_ptr, bias, dptr + ow * 8, IW,
+                    oh * OW + ow, op);
+        }
+    }
+}
+
+template <int filter, int stride, BiasMode bias_mode, typename Op>
+MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+void channel_wise_f32::do_conv_kern_nchw(
+        const float* src, const float* filter_ptr, const float* bias, float* dst,
+        size_t IH, size_t IW, size_t OH, size_t OW, size_t PH, size_t PW,
+        float* workspace) {
+    size_t IH2 = (OH - 1) * stride + filter,
+           phase_stride = nchw_phase_width(OW, filter, stride),
+           row_stride = phase_stride * stride;
+    //! pad and split the rows into phases, see nchw_compute_vectors()
+    for (size_t ih2 = 0; ih2 < IH2; ++ih2) {
+        float* drow = workspace + ih2 * row_stride;
+        size_t ih = ih2 - PH;
+        if (ih2 < PH || ih >= IH) {
+            std::memset(drow, 0, row_stride * sizeof(float));
+            continue;
+        }
+        nchw_copy_row(src + ih * IW, drow, IW, PW, stride, phase_stride);
+    }
+    Op op;
+    constexpr size_t BLOCK = NR_OW_VEC * 8;
+    for (size_t oh = 0; oh < OH; ++oh) {
+        const float* sptr = workspace + oh * stride * row_stride;
+        float* dptr = dst + oh * OW;
+        size_t ow = 0;
+        for (; ow + BLOCK <= OW; ow += BLOCK) {
+            nchw_compute_vectors<filter, stride, NR_OW_VEC, bias_mode>(
+                    sptr + ow, filter_ptr, bias, dptr + ow, row_stride,
+                    phase_stride, oh * OW + ow, 8, op);
+        }
+        for (; ow < OW; ow += 8) {
+            nchw_compute_vectors<filter, stride, 1, bias_mode>(
+                    sptr + ow, filter_ptr, bias, dptr + ow, row_stride,
+                    phase_stride, oh * OW + ow, OW - ow, op);
+        }
+    }
+}
+
+#define INSTANTIATION(_layout, _filter, _stride, _bias, _op)                  \
+    template void channel_wise_f32::do_conv_kern_##_layout<                   \
+            _filter, _stride, _bias, _op<SIMDType::AVX2, dt_float32>>(        \
+            const float*, const float*, const float*, float*, size_t, size_t, \
+            size_t, size_t, size_t, size_t, float*);
+
+#define FOR_OP(_layout, _filter, _stride, _bias)               \
+    INSTANTIATION(_layout, _filter, _stride, _bias, NoneOp)    \
+    INSTANTIATION(_layout, _filter, _stride, _bias, ReluOp)    \
+    INSTANTIATION(_layout, _filter, _stride, _bias, SigmoidOp) \
+    INSTANTIATION(_layout, _filter, _stride, _bias, HSwishOp)
+
+#define FOR_BIAS(_layout, _filter, _stride)                             \
+    FOR_OP(_layout, _filter, _stride, BiasMode::NO_BIAS)                \
+    FOR_OP(_layout, _filter, _stride, BiasMode::BROADCAST_CHANNEL_BIAS) \
+    FOR_OP(_layout, _filter, _stride, BiasMode::BIAS)
+
+#define FOR_FILTER(_layout, _stride) \
+    FOR_BIAS(_layout, 3, _stride)    \
+    FOR_BIAS(_layout, 5, _stride)    \
+    FOR_BIAS(_layout, 7, _stride)
+
+#define FOR_STRIDE(_layout) \
+    FOR_FILTER(_layout, 1)  \
+    FOR_FILTER(_layout, 2)
+
+FOR_STRIDE(nchw)
+FOR_STRIDE(nchw88)
+
+#undef FOR_STRIDE
+#undef FOR_FILTER
+#undef FOR_BIAS
+#undef FOR_OP
+#undef INSTANTIATION
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,57 @@
+/**
+ * \file dnn/src/x86/conv_bias/f32/channel_wise_kern.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "src/x86/conv_bias/opr_impl.h"
+
+namespace megdnn {
+namespace x86 {
+namespace channel_wise_f32 {
+
+/*!
+ * \brief compute one channel (NCHW) or one pack of 8 channels (NCHW88) of a
+ *      channel-wise conv with fused bias and nonlinearity
+ * \param workspace per-thread workspace of get_nchw_workspace() or
+ *      get_nchw88_workspace() floats
+ */
+using conv_fun = void (*)(
+        const float* src, const float* filter, const float* bias, float* dst,
+        size_t IH, size_t IW, size_t OH, size_t OW, size_t PH, size_t PW,
+        float* workspace);
+
+//! number of floats of the padded src copy used by the NCHW kernels
+size_t get_nchw_workspace(
+        size_t OH, size_t OW, size_t FH, size_t FW, size_t stride);
+
+//! number of floats of the padded src copy used by the NCHW88 kernels, which
+//! is 0 if there is no padding
+size_t get_nchw88_workspace(
+        size_t OH, size_t OW, size_t FH, size_t FW, size_t PH, size_t PW,
+        size_t stride);
+
+template <int filter, int stride, BiasMode bias_mode, typename Op>
+void do_conv_kern_nchw(
+        const float* src, const float* filter_ptr, const float* bias, float* dst,
+        size_t IH, size_t IW, size_t OH, size_t OW, size_t PH, size_t PW,
+        float* workspace);
+
+template <int filter, int stride, BiasMode bias_mode, typename Op>
+void do_conv_kern_nchw88(
+        const float* src, const float* filter_ptr, const float* bias, float* dst,
+        size_t IH, size_t IW, size_t OH, size_t OW, size_t PH, size_t PW,
+        float* workspace);
+
+}  // namespace channel_wise_f32
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -35,58 +35,42 @@ using namespace x86;
 namespace {
 constexpr size_t alpha = 6 + 3 - 1;
 struct InputTransform6X3_NCHW88 {
-    template <bool inner>
+    //! copy the part of a border tile inside the image to the zero-filled
+    //! patchT, whose row stride is alpha * 8
     MEGDNN_ATTRIBUTE_TARGET("avx2")
-    static void prepare(
-            const float* input, float* patch, float* patchT, int ih_start, int iw_start,
-            size_t IH, size_t IW, size_t ic, size_t IC) {
-        MEGDNN_MARK_USED_VAR(patch);
-        size_t IW8 = IW * 8;              //! For nchw88 mode
-        size_t iw8_start = iw_start * 8;  //! For nchw88 mode
+    static void prepare_border(
+            const float* input, float* patchT, int ih_start, int iw_start, size_t IH,
+            size_t IW, size_t ic) {
+        size_t IW8 = IW * 8;  //! For nchw88 mode
         size_t icb = ic / 8;
-        if (!(inner && ic + 8 < IC)) {
-            memset(patchT, 0, sizeof(float) * 8 * alpha * alpha);
-        }
-        if (inner) {
-            //! Copy to continue memory patchT,
-            //! TODO:can be optimized
-            const float* input_ptr =
-                    input + icb * IH * IW8 + ih_start * IW8 + iw8_start;
-            for (size_t ih = 0; ih < alpha; ih++) {
-#define cb(i) auto v##i = _mm256_loadu_ps(input_ptr + 8 * i);
-                UNROLL_CALL_NOWRAPPER(8, cb);
-#undef cb
-
-#define cb(i) _mm256_storeu_ps(patchT + ih * 8 * alpha + i * 8, v##i);
-
-                UNROLL_CALL_NOWRAPPER(8, cb);
-#undef cb
-                input_ptr += IW8;
-            }
-        } else {
-            int ih0_act = std::max<int>(ih_start, 0),
-                ih1_act = std::min<int>(ih_start + alpha, IH),
-                iw0_act = std::max<int>(iw_start, 0),
-                iw1_act = std::min<int>(iw_start + alpha, IW);
-            const float* input_ptr = input + icb * IH * IW8;
-            // partial copy
-            for (int ih = ih0_act; ih < ih1_act; ++ih) {
-                for (int iw = iw0_act; iw < iw1_act; ++iw) {
-                    size_t iho = ih - ih_start, iwo = iw - iw_start;
-                    auto src = _mm256_loadu_ps(input_ptr + ih * IW8 + iw * 8);
-                    _mm256_storeu_ps(patchT + iho * 8 * alpha + iwo * 8, src);
-                }
+        memset(patchT, 0, sizeof(float) * 8 * alpha * alpha);
+        int ih0_act = std::max<int>(ih_start, 0),
+            ih1_act = std::min<int>(ih_start + alpha, IH),
+            iw0_act = std::max<int>(iw_start, 0),
+            iw1_act = std::min<int>(iw_start + alpha, IW);
+        const float* input_ptr = input + icb * IH * IW8;
+        // partial copy
+        for (int ih = ih0_act; ih < ih1_act; ++ih) {
+            for (int iw = iw0_act; iw < iw1_act; ++iw) {
+                size_t iho = ih - ih_start, iwo = iw - iw_start;
+                auto src = _mm256_loadu_ps(input_ptr + ih * IW8 + iw * 8);
+                _mm256_storeu_ps(patchT + iho * 8 * alpha + iwo * 8, src);
             }
         }
     }
 
+    /*!
+     * \param src the first pixel of the tile, rows of which are \p row_stride
+     *      floats apart; inner tiles are read from the input directly, so no
+     *      copy is needed
+     */
     MEGDNN_ATTRIBUTE_TARGET("avx2")
     static void transform(
-            const float* patchT, float* input_transform_buf, size_t unit_idx,
-            size_t nr_units_in_tile, size_t ic, size_t IC) {
+            const float* src, size_t row_stride, float* input_transform_buf,
+            size_t unit_idx, size_t nr_units_in_tile, size_t ic, size_t IC) {
         // BT * d * B
 #define cb(m, n) \
-    Vector<float, 8> d##m##n = Vector<float, 8>::load(patchT + m * 8 * 8 + n * 8);
+    Vector<float, 8> d##m##n = Vector<float, 8>::load(src + m * row_stride + n * 8);
         UNROLL_CALL_NOWRAPPER_D2(8, 8, cb);
 #undef cb
 
@@ -333,8 +317,7 @@ void winograd_nchw88_6x3_8x8_f::input(
 
     // OW = IW + 2 * PW - KERNEL_SIZE + 1
     auto units_w = div_ceil<size_t>(IW + 2 * PW - KERNEL_SIZE + 1, OUTPUT_BLOCK_SIZE);
-    float* patch = transform_mid_buf;
-    float* patchT = transform_mid_buf + 8 * alpha * alpha;
+    float* patchT = transform_mid_buf;
 
     for (size_t ic = 0; ic < IC; ic += 8) {
         rep(unit_idx, nr_units_in_tile) {
@@ -345,17 +328,17 @@ void winograd_nchw88_6x3_8x8_f::input(
             int iw_start = nw * OUTPUT_BLOCK_SIZE - PW;
             if (ih_start >= 0 && ih_start + alpha <= static_cast<size_t>(IH) &&
                 iw_start >= 0 && iw_start + alpha <= static_cast<size_t>(IW)) {
-                InputTransform6X3_NCHW88::prepare<true>(
-                        input, patch, patchT, ih_start, iw_start, IH, IW, ic, IC);
+                const float* src =
+                        input + ((ic / 8 * IH + ih_start) * IW + iw_start) * 8;
                 InputTransform6X3_NCHW88::transform(
-                        patchT, input_transform_buf, unit_idx, nr_units_in_tile, ic,
-                        IC);
+                        src, IW * 8, input_transform_buf, unit_idx, nr_units_in_tile,
+                        ic, IC);
             } else {
-                InputTransform6X3_NCHW88::prepare<false>(
-                        input, patch, patchT, ih_start, iw_start, IH, IW, ic, IC);
+                InputTransform6X3_NCHW88::prepare_border(
+                        input, patchT, ih_start, iw_start, IH, IW, ic);
                 InputTransform6X3_NCHW88::transform(
-                        patchT, input_transform_buf, unit_idx, nr_units_in_tile, ic,
-                        IC);
+                        patchT, alpha * 8, input_transform_buf, unit_idx,
+                        nr_units_in_tile, ic, IC);
             }
         }
     }
@@ -62,6 +62,44 @@ MEGDNN_WINOGRAD_ALGO_FUN_DEFINE_ALL(
         AlgoFP32WinogradF63_8x8, winograd::winograd_nchw88_6x3_8x8_f,
         megdnn_x86_winograd_fp32, param::MatrixMul::Format::MK8);
 
+/* ======================= AlgoFP32WinogradF43_8*8 ======================== */
+
+bool ConvBiasImpl::AlgoFP32WinogradF43_8x8::usable(
+        const NCBKernSizeParam& param,
+        AlgoSelectionStrategy /*algo_selection_strategy*/) const {
+    MEGDNN_MARK_USED_VAR(param);
+    MIDOUT_BEGIN(megdnn_x86_winograd_fp32, 3, 0) {
+        //! TODO: now nchw88 winograd only support Dense mode
+        if (param.filter_meta.icpg % 8 != 0 || param.filter_meta.ocpg % 8 != 0 ||
+            param.filter_meta.group != 1)
+            return false;
+        using Strategy = winograd::winograd_nchw88_4x3_8x8_f;
+        Strategy strategy(param.src_type, param.filter_type, param.dst_type);
+        auto&& matmul_param =
+                megdnn::winograd::ConvBias<Strategy, param::MatrixMul::Format::MK8>(
+                        strategy, m_tile_size, param)
+                        .get_matmul_kern_param(param);
+        return m_matmul_algo->usable(matmul_param) &&
+               param.filter_meta.format == param::ConvBias::Format::NCHW88 &&
+               !param.filter_meta.should_flip &&
+               (param.filter_meta.spatial[0] == param.filter_meta.spatial[1] &&
+                param.filter_meta.spatial[0] == 3) &&
+               (param.filter_meta.stride[0] == param.filter_meta.stride[1] &&
+                param.filter_meta.stride[0] == 1) &&
+               (param.filter_meta.dilation[0] == param.filter_meta.dilation[1] &&
+                param.filter_meta.dilation[0] == 1) &&
+               param.compute_mode == param::ConvBias::ComputeMode::DEFAULT &&
+               param.src_type.enumv() == DTypeEnum::Float32 &&
+               is_supported(SIMDType::AVX2);
+    }
+    MIDOUT_END();
+    return false;
+}
+
+MEGDNN_WINOGRAD_ALGO_FUN_DEFINE_ALL(
+        AlgoFP32WinogradF43_8x8, winograd::winograd_nchw88_4x3_8x8_f,
+        megdnn_x86_winograd_fp32, param::MatrixMul::Format::MK8);
+
 /* ======================= AlgoFP32WinogradF23_8*8 ======================== */
 
 bool ConvBiasImpl::AlgoFP32WinogradF23_8x8::usable(
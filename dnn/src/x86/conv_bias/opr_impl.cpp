@@ -34,6 +34,8 @@ bool is_fallback_or_naive(const detail::Algorithm* algo) {
 class ConvBiasImpl::AlgoPack : NonCopyableObj {
     AlgoDirect stride1_direct;
     AlgoDirectStride2 stride2_direct;
+    AlgoF32ChanWiseNCHW f32_chanwise_nchw;
+    AlgoF32ChanWiseNCHW88 f32_chanwise_nchw88;
     AlgoDirectAvx2Stride1Int8 avx2_stride1_direct_int8;
     AlgoAVX2DirectConvStride2 avx2_stride2_direct;
     AlgoChanWiseAvx2Stride1Qint8 avx2_stride1_chanwsie_qint8;
@@ -51,6 +53,10 @@ class ConvBiasImpl::AlgoPack : NonCopyableObj {
 
 public:
     AlgoPack() {
+        //! the channel-wise algos are only usable by depthwise conv, in which
+        //! case they are preferred to the general direct ones
+        m_all_no_winograd_algo.emplace_back(&f32_chanwise_nchw88);
+        m_all_no_winograd_algo.emplace_back(&f32_chanwise_nchw);
         //! FIXME: preference to use mkldnn algo on VNNI devices
         //! But now mkldnn algo preference issue with NCHW->NHWC->NCHW
 #if MEGDNN_X86_WITH_MKL_DNN
@@ -78,6 +84,10 @@ public:
                         static_cast<fallback::MatrixMulImpl::AlgoBase*>(algo),
                         tile_size));
                 m_winograd_algos.emplace_back(refhold.back().get());
+                refhold.emplace_back(new AlgoFP32WinogradF43_8x8(
+                        static_cast<fallback::MatrixMulImpl::AlgoBase*>(algo),
+                        tile_size));
+                m_winograd_algos.emplace_back(refhold.back().get());
                 refhold.emplace_back(new AlgoFP32WinogradF23_8x8(
                         static_cast<fallback::MatrixMulImpl::AlgoBase*>(algo),
                         tile_size));
@@ -52,7 +52,10 @@ public:
 private:
     class AlgoDirect;
     class AlgoDirectStride2;
+    class AlgoF32ChanWiseNCHW;
+    class AlgoF32ChanWiseNCHW88;
     class AlgoFP32WinogradF63_8x8;
+    class AlgoFP32WinogradF43_8x8;
     class AlgoFP32WinogradF23_8x8;
     class AlgoDirectAvx2Stride1Int8;
     class AlgoAVX2DirectConvStride2;
@@ -0,0 +1,111 @@
+/**
+ * \file dnn/src/x86/convolution/f32/algos.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+
+#include "src/x86/convolution/f32/algos.h"
+#include "src/x86/convolution/f32/conv_backdata.h"
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_x86_deconv_f32)
+
+using namespace megdnn;
+using namespace x86;
+
+/* ===================== ConvolutionBackwardData ===================== */
+/* ===================== direct stride2 algo ===================== */
+bool ConvolutionBackwardDataImpl::AlgoF32DirectStride2::usable(
+        fallback::ConvolutionBackwardDataImpl*, const NCBKernSizeParam& param) const {
+    return deconv::can_direct_stride2_f32(param);
+}
+
+size_t ConvolutionBackwardDataImpl::AlgoF32DirectStride2::get_workspace(
+        fallback::ConvolutionBackwardDataImpl*, const NCBKernSizeParam& param) const {
+    MIDOUT_BEGIN(
+            megdnn_x86_deconv_f32,
+            midout_iv("AlgoF32DirectStride2::get_workspace"_hash)) {
+        return deconv::get_workspace_in_bytes_direct_stride2_f32(param);
+    }
+    MIDOUT_END();
+    return 0;
+}
+
+ConvolutionBackwardDataImpl::ncb_kern_t ConvolutionBackwardDataImpl::
+        AlgoF32DirectStride2::dispatch_kern(
+                fallback::ConvolutionBackwardDataImpl*, const NCBKernSizeParam&) const {
+    MIDOUT_BEGIN(
+            megdnn_x86_deconv_f32,
+            midout_iv("AlgoF32DirectStride2::dispatch_kern"_hash)) {
+        return deconv::direct_stride2_f32;
+    }
+    MIDOUT_END();
+    return {};
+}
+
+/* ===================== sub-pixel algo ===================== */
+bool ConvolutionBackwardDataImpl::AlgoF32SubPixel::usable(
+        fallback::ConvolutionBackwardDataImpl*, const NCBKernSizeParam& param) const {
+    return deconv::can_subpixel_f32(param);
+}
+
+size_t ConvolutionBackwardDataImpl::AlgoF32SubPixel::get_workspace(
+        fallback::ConvolutionBackwardDataImpl*, const NCBKernSizeParam& param) const {
+    MIDOUT_BEGIN(
+            megdnn_x86_deconv_f32,
+            midout_iv("AlgoF32SubPixel::get_workspace"_hash)) {
+        return deconv::get_workspace_in_bytes_subpixel_f32(param);
+    }
+    MIDOUT_END();
+    return 0;
+}
+
+ConvolutionBackwardDataImpl::ncb_kern_t ConvolutionBackwardDataImpl::
+        AlgoF32SubPixel::dispatch_kern(
+                fallback::ConvolutionBackwardDataImpl*, const NCBKernSizeParam&) const {
+    MIDOUT_BEGIN(
+            megdnn_x86_deconv_f32,
+            midout_iv("AlgoF32SubPixel::dispatch_kern"_hash)) {
+        return deconv::subpixel_f32;
+    }
+    MIDOUT_END();
+    return {};
+}
+
+/* ===================== nchw88 algo ===================== */
+bool ConvolutionBackwardDataImpl::AlgoF32NCHW88::usable(
+        fallback::ConvolutionBackwardDataImpl*, const NCBKernSizeParam& param) const {
+    return deconv::can_nchw88_f32(param);
+}
+
+size_t ConvolutionBackwardDataImpl::AlgoF32NCHW88::get_workspace(
+        fallback::ConvolutionBackwardDataImpl*, const NCBKernSizeParam& param) const {
+    MIDOUT_BEGIN(
+            megdnn_x86_deconv_f32,
+            midout_iv("AlgoF32NCHW88::get_workspace"_hash)) {
+        return deconv::get_workspace_in_bytes_nchw88_f32(param);
+    }
+    MIDOUT_END();
+    return 0;
+}
+
+ConvolutionBackwardDataImpl::ncb_kern_t ConvolutionBackwardDataImpl::
+        AlgoF32NCHW88::dispatch_kern(
+                fallback::ConvolutionBackwardDataImpl*, const NCBKernSizeParam&) const {
+    MIDOUT_BEGIN(
+            megdnn_x86_deconv_f32,
+            midout_iv("AlgoF32NCHW88::dispatch_kern"_hash)) {
+        return deconv::nchw88_f32;
+    }
+    MIDOUT_END();
+    return {};
+}
+
+// vim: syntax=cpp.doxygen
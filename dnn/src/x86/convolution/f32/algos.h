@@ -0,0 +1,83 @@
+/**
+ * \file dnn/src/x86/convolution/f32/algos.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+
+#pragma once
+
+#include "src/x86/convolution/opr_impl.h"
+
+namespace megdnn {
+namespace x86 {
+
+/* ===================== ConvolutionBackwardData ===================== */
+
+class ConvolutionBackwardDataImpl::AlgoF32DirectStride2 final : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "X86_F32_DECONV_DIRECT_STRIDE2"; }
+
+    bool usable(fallback::ConvolutionBackwardDataImpl*, const NCBKernSizeParam& param)
+            const override;
+
+    size_t get_workspace(
+            fallback::ConvolutionBackwardDataImpl*,
+            const NCBKernSizeParam& param) const override;
+
+    ncb_kern_t dispatch_kern(
+            fallback::ConvolutionBackwardDataImpl*,
+            const NCBKernSizeParam&) const override;
+
+    bool is_preferred(const NCBKernSizeParam&) const override { return true; }
+    MEGDNN_DECL_ALGO_TYPE(X86_F32_DECONV_DIRECT_STRIDE2)
+};
+
+class ConvolutionBackwardDataImpl::AlgoF32SubPixel final : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "X86_F32_DECONV_SUBPIXEL"; }
+
+    bool usable(fallback::ConvolutionBackwardDataImpl*, const NCBKernSizeParam& param)
+            const override;
+
+    size_t get_workspace(
+            fallback::ConvolutionBackwardDataImpl*,
+            const NCBKernSizeParam& param) const override;
+
+    ncb_kern_t dispatch_kern(
+            fallback::ConvolutionBackwardDataImpl*,
+            const NCBKernSizeParam&) const override;
+    MEGDNN_DECL_ALGO_TYPE(X86_F32_DECONV_SUBPIXEL)
+};
+
+class ConvolutionBackwardDataImpl::AlgoF32NCHW88 final : public AlgoBase {
+public:
+    AlgoAttribute attribute() const override { return AlgoAttribute::REPRODUCIBLE; }
+    const char* name() const override { return "X86_F32_DECONV_NCHW88"; }
+
+    bool usable(fallback::ConvolutionBackwardDataImpl*, const NCBKernSizeParam& param)
+            const override;
+
+    size_t get_workspace(
+            fallback::ConvolutionBackwardDataImpl*,
+            const NCBKernSizeParam& param) const override;
+
+    ncb_kern_t dispatch_kern(
+            fallback::ConvolutionBackwardDataImpl*,
+            const NCBKernSizeParam&) const override;
+
+    bool is_preferred(const NCBKernSizeParam&) const override { return true; }
+    MEGDNN_DECL_ALGO_TYPE(X86_F32_DECONV_NCHW88)
+};
+
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
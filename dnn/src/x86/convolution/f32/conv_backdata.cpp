@@ -0,0 +1,566 @@
+/**
+ * \file dnn/src/x86/convolution/f32/conv_backdata.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/x86/convolution/f32/conv_backdata.h"
+#include "src/common/unroll_macro.h"
+#include "src/common/utils.h"
+#include "src/x86/utils.h"
+
+#include <immintrin.h>
+#include <algorithm>
+#include <cstring>
+
+using namespace megdnn;
+using namespace x86;
+using namespace deconv;
+
+namespace {
+
+/*!
+ * \brief taps of phase r of a spatial dim
+ *
+ * grad index r + S * i takes filter index f0 + S * a from diff index
+ * i + base - a, for a in [0, ntaps); nout is the number of grad indices of
+ * the phase.
+ */
+struct Phase {
+    size_t f0, base, ntaps, nout;
+};
+
+Phase get_phase(size_t r, size_t S, size_t P, size_t F, size_t O) {
+    Phase ret;
+    ret.f0 = (r + P) % S;
+    ret.base = (r + P) / S;
+    ret.ntaps = ret.f0 < F ? (F - ret.f0 + S - 1) / S : 0;
+    ret.nout = r < O ? (O - r + S - 1) / S : 0;
+    return ret;
+}
+
+//! zero padding of a spatial dim of diff
+struct Padding {
+    size_t lo, size;
+};
+
+/*!
+ * \brief get the padding such that all the phases read diff in bounds
+ * \param extra number of elements that may be read past the last output of a
+ *      phase
+ */
+Padding get_padding(size_t I, size_t S, size_t P, size_t F, size_t O, size_t extra) {
+    ptrdiff_t lo = 0, hi = I;
+    for (size_t r = 0; r < S; ++r) {
+        Phase ph = get_phase(r, S, P, F, O);
+        if (!ph.ntaps) {
+            continue;
+        }
+        //! a phase without output may still be computed with another one
+        size_t nout = std::max<size_t>(ph.nout, 1);
+        lo = std::min(lo, static_cast<ptrdiff_t>(ph.base) + 1 -
+                                  static_cast<ptrdiff_t>(ph.ntaps));
+        hi = std::max(hi, static_cast<ptrdiff_t>(nout + ph.base + extra));
+    }
+    return {static_cast<size_t>(-lo), static_cast<size_t>(hi - lo)};
+}
+
+//! copy \p C planes of IH * IW elements of \p pack floats into the zero padded
+//! buffer
+void pad_diff(
+        const float* src, float* dst, size_t C, size_t IH, size_t IW, Padding ph,
+        Padding pw, size_t pack) {
+    std::memset(dst, 0, sizeof(float) * C * ph.size * pw.size * pack);
+    for (size_t c = 0; c < C; ++c) {
+        for (size_t h = 0; h < IH; ++h) {
+            std::memcpy(
+                    dst + ((c * ph.size + h + ph.lo) * pw.size + pw.lo) * pack,
+                    src + (c * IH + h) * IW * pack, sizeof(float) * IW * pack);
+        }
+    }
+}
+
+//! offsets of the taps of a phase in the padded diff and in the filter
+struct Taps {
+    size_t nr = 0;
+    SmallVector<ptrdiff_t> src;
+    SmallVector<size_t> filter;
+
+    Taps(const Phase& ph, const Phase& pw, size_t SH, size_t SW, size_t FW,
+         size_t PIW, size_t pack) {
+        for (size_t a = 0; a < ph.ntaps; ++a) {
+            for (size_t b = 0; b < pw.ntaps; ++b) {
+                src.push_back(-static_cast<ptrdiff_t>((a * PIW + b) * pack));
+                filter.push_back(
+                        ((ph.f0 + SH * a) * FW + pw.f0 + SW * b) * pack * pack);
+                ++nr;
+            }
+        }
+    }
+};
+
+bool can_nchw_f32(const NCBKernSizeParam& param) {
+    auto&& fm = param.filter_meta;
+    return fm.format == param::Convolution::Format::NCHW &&
+           param.diff_type.enumv() == DTypeEnum::Float32 &&
+           param.filter_type.enumv() == DTypeEnum::Float32 &&
+           param.grad_type.enumv() == DTypeEnum::Float32 && fm.spatial_ndim == 2 &&
+           fm.group == 1 && fm.dilation[0] == 1 && fm.dilation[1] == 1 &&
+           !fm.should_flip && is_supported(SIMDType::AVX2) &&
+           is_supported(SIMDType::FMA);
+}
+
+/* ===================== nchw ===================== */
+
+//! number of floats read past the last output of a phase row in nchw
+constexpr size_t NCHW_EXTRA = 15;
+
+/*!
+ * \brief number of floats read past the last output of a phase row for
+ *      stride \p SW
+ *
+ * The stride-2 kernel reads 16 columns of both phases for every 32 outputs,
+ * and phase 1 has one output less than phase 0 when OW is odd, e.g. it reads
+ * 16 * (k + 1) columns of a phase 1 with 16 * k outputs when OW = 32 * k + 1.
+ */
+size_t get_nchw_extra(size_t SW) {
+    return SW == 2 ? NCHW_EXTRA + 1 : NCHW_EXTRA;
+}
+
+//! grad channels computed together by the sub-pixel and stride-2 kernels
+constexpr size_t NCHW_IC_BLOCK = 4, STRIDE2_IC_BLOCK = 3;
+
+WorkspaceBundle get_nchw_bundle(const NCBKernSizeParam& param) {
+    UNPACK_CONV_F32_NCB_KERN_SIZES(param);
+    MEGDNN_MARK_USED_VAR(N);
+    MEGDNN_MARK_USED_VAR(IC);
+    Padding ph = get_padding(IH, SH, PH, FH, OH, 0),
+            pw = get_padding(IW, SW, PW, FW, OW, get_nchw_extra(SW));
+    return {nullptr, {sizeof(float) * OC * ph.size * pw.size}};
+}
+
+/*!
+ * \brief compute 16 columns of a phase row for nr_ic grad channels
+ * \param src padded diff at the first column of the output
+ * \param filter filter at (oc=0, ic=ic0)
+ * \param dst nr_ic * 16 floats
+ */
+template <int nr_ic>
+MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+void nchw_phase_block(
+        const float* src, const float* filter, float* dst, size_t OC,
+        size_t src_plane, size_t filter_oc_stride, size_t FHW, const Taps& taps) {
+    __m256 acc[NCHW_IC_BLOCK][2];
+#define cb(k)                            \
+    if (k < nr_ic) {                     \
+        acc[k][0] = _mm256_setzero_ps(); \
+        acc[k][1] = _mm256_setzero_ps(); \
+    }
+    UNROLL_CALL_RAW(4, cb);
+#undef cb
+    for (size_t t = 0; t < taps.nr; ++t) {
+        const float* s = src + taps.src[t];
+        const float* w = filter + taps.filter[t];
+        for (size_t oc = 0; oc < OC; ++oc) {
+            __m256 d0 = _mm256_loadu_ps(s), d1 = _mm256_loadu_ps(s + 8);
+#define cb(k)                                           \
+    if (k < nr_ic) {                                    \
+        __m256 wk = _mm256_broadcast_ss(w + k * FHW);   \
+        acc[k][0] = _mm256_fmadd_ps(d0, wk, acc[k][0]); \
+        acc[k][1] = _mm256_fmadd_ps(d1, wk, acc[k][1]); \
+    }
+            UNROLL_CALL_RAW(4, cb);
+#undef cb
+            s += src_plane;
+            w += filter_oc_stride;
+        }
+    }
+#define cb(k)                                          \
+    if (k < nr_ic) {                                   \
+        _mm256_storeu_ps(dst + k * 16, acc[k][0]);     \
+        _mm256_storeu_ps(dst + k * 16 + 8, acc[k][1]); \
+    }
+    UNROLL_CALL_RAW(4, cb);
+#undef cb
+}
+
+//! accumulate the taps of a phase to 16 columns of nr_ic grad channels
+template <int nr_ic>
+MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+inline void nchw_stride2_taps(
+        const float* src, const float* filter, __m256 (*acc)[2], size_t OC,
+        size_t src_plane, size_t filter_oc_stride, size_t FHW, const Taps& taps) {
+    for (size_t t = 0; t < taps.nr; ++t) {
+        const float* s = src + taps.src[t];
+        const float* w = filter + taps.filter[t];
+        for (size_t oc = 0; oc < OC; ++oc) {
+            __m256 d0 = _mm256_loadu_ps(s), d1 = _mm256_loadu_ps(s + 8);
+#define cb(k)                                           \
+    if (k < nr_ic) {                                    \
+        __m256 wk = _mm256_broadcast_ss(w + k * FHW);   \
+        acc[k][0] = _mm256_fmadd_ps(d0, wk, acc[k][0]); \
+        acc[k][1] = _mm256_fmadd_ps(d1, wk, acc[k][1]); \
+    }
+            UNROLL_CALL_RAW(3, cb);
+#undef cb
+            s += src_plane;
+            w += filter_oc_stride;
+        }
+    }
+}
+
+//! store 32 interleaved columns of the two phases
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+inline void nchw_stride2_store(
+        const __m256* phase0, const __m256* phase1, float* dst, size_t nr_valid) {
+    float tmp[32];
+    float* d = nr_valid == 32 ? dst : tmp;
+    for (int v = 0; v < 2; ++v) {
+        __m256 lo = _mm256_unpacklo_ps(phase0[v], phase1[v]);
+        __m256 hi = _mm256_unpackhi_ps(phase0[v], phase1[v]);
+        _mm256_storeu_ps(d + v * 16, _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(d + v * 16 + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+    if (nr_valid != 32) {
+        std::memcpy(dst, tmp, sizeof(float) * nr_valid);
+    }
+}
+
+/*!
+ * \brief compute 32 columns of a stride-2 grad row for nr_ic grad channels
+ *
+ * The 16 columns of the two width phases are interleaved in registers.
+ *
+ * \param src0 padded diff at the first column of phase 0
+ * \param src1 padded diff at the first column of phase 1
+ * \param dst grad at the first column of channel ic0
+ * \param nr_valid number of columns to write, at most 32
+ */
+template <int nr_ic>
+MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+void nchw_stride2_block(
+        const float* src0, const float* src1, const float* filter, float* dst,
+        size_t OC, size_t src_plane, size_t filter_oc_stride, size_t FHW,
+        size_t dst_plane, const Taps& taps0, const Taps& taps1, size_t nr_valid) {
+    __m256 acc0[STRIDE2_IC_BLOCK][2], acc1[STRIDE2_IC_BLOCK][2];
+#define cb(k)                                     \
+    if (k < nr_ic) {                              \
+        acc0[k][0] = acc0[k][1] = acc1[k][0] =    \
+                acc1[k][1] = _mm256_setzero_ps(); \
+    }
+    UNROLL_CALL_RAW(3, cb);
+#undef cb
+    nchw_stride2_taps<nr_ic>(
+            src0, filter, acc0, OC, src_plane, filter_oc_stride, FHW, taps0);
+    nchw_stride2_taps<nr_ic>(
+            src1, filter, acc1, OC, src_plane, filter_oc_stride, FHW, taps1);
+#define cb(k)                                                                \
+    if (k < nr_ic) {                                                         \
+        nchw_stride2_store(acc0[k], acc1[k], dst + k * dst_plane, nr_valid); \
+    }
+    UNROLL_CALL_RAW(3, cb);
+#undef cb
+}
+
+#define DISPATCH_NR_IC(_func, _nr_ic, ...) \
+    switch (_nr_ic) {                      \
+        case 4:                            \
+            _func<4>(__VA_ARGS__);         \
+            break;                         \
+        case 3:                            \
+            _func<3>(__VA_ARGS__);         \
+            break;                         \
+        case 2:                            \
+            _func<2>(__VA_ARGS__);         \
+            break;                         \
+        default:                           \
+            _func<1>(__VA_ARGS__);         \
+            break;                         \
+    }
+
+void do_subpixel(
+        const float* diff, const float* filter, float* grad, float* padded,
+        const NCBKernSizeParam& param) {
+    UNPACK_CONV_F32_NCB_KERN_SIZES(param);
+    MEGDNN_MARK_USED_VAR(N);
+    Padding pad_h = get_padding(IH, SH, PH, FH, OH, 0),
+            pad_w = get_padding(IW, SW, PW, FW, OW, get_nchw_extra(SW));
+    size_t PIW = pad_w.size, src_plane = pad_h.size * PIW;
+    pad_diff(diff, padded, OC, IH, IW, pad_h, pad_w, 1);
+    float out[NCHW_IC_BLOCK * 16];
+    for (size_t ry = 0; ry < std::min<size_t>(SH, OH); ++ry) {
+        Phase ph = get_phase(ry, SH, PH, FH, OH);
+        for (size_t rx = 0; rx < std::min<size_t>(SW, OW); ++rx) {
+            Phase pw = get_phase(rx, SW, PW, FW, OW);
+            Taps taps{ph, pw, SH, SW, FW, PIW, 1};
+            for (size_t ic = 0; ic < IC; ic += NCHW_IC_BLOCK) {
+                size_t nr_ic = std::min(NCHW_IC_BLOCK, IC - ic);
+                for (size_t i = 0; i < ph.nout; ++i) {
+                    const float* src_row =
+                            padded + (i + ph.base + pad_h.lo) * PIW + pad_w.lo +
+                            pw.base;
+                    float* dst_row = grad + (ic * OH + ry + SH * i) * OW + rx;
+                    for (size_t j = 0; j < pw.nout; j += 16) {
+                        DISPATCH_NR_IC(
+                                nchw_phase_block, nr_ic, src_row + j,
+                                filter + ic * FH * FW, out, OC, src_plane,
+                                IC * FH * FW, FH * FW, taps);
+                        size_t nr_valid = std::min<size_t>(16, pw.nout - j);
+                        for (size_t k = 0; k < nr_ic; ++k) {
+                            float* d = dst_row + k * OH * OW + SW * j;
+                            for (size_t q = 0; q < nr_valid; ++q) {
+                                d[q * SW] = out[k * 16 + q];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void do_direct_stride2(
+        const float* diff, const float* filter, float* grad, float* padded,
+        const NCBKernSizeParam& param) {
+    UNPACK_CONV_F32_NCB_KERN_SIZES(param);
+    MEGDNN_MARK_USED_VAR(N);
+    MEGDNN_MARK_USED_VAR(SH);
+    MEGDNN_MARK_USED_VAR(SW);
+    Padding pad_h = get_padding(IH, 2, PH, FH, OH, 0),
+            pad_w = get_padding(IW, 2, PW, FW, OW, get_nchw_extra(2));
+    size_t PIW = pad_w.size, src_plane = pad_h.size * PIW;
+    pad_diff(diff, padded, OC, IH, IW, pad_h, pad_w, 1);
+    Phase pw0 = get_phase(0, 2, PW, FW, OW), pw1 = get_phase(1, 2, PW, FW, OW);
+    for (size_t ry = 0; ry < std::min<size_t>(2, OH); ++ry) {
+        Phase ph = get_phase(ry, 2, PH, FH, OH);
+        Taps taps0{ph, pw0, 2, 2, FW, PIW, 1}, taps1{ph, pw1, 2, 2, FW, PIW, 1};
+        for (size_t ic = 0; ic < IC; ic += STRIDE2_IC_BLOCK) {
+            size_t nr_ic = std::min(STRIDE2_IC_BLOCK, IC - ic);
+            for (size_t i = 0; i < ph.nout; ++i) {
+                const float* src_row =
+                        padded + (i + ph.base + pad_h.lo) * PIW + pad_w.lo;
+                float* dst_row = grad + (ic * OH + ry + 2 * i) * OW;
+                for (size_t x = 0; x < OW; x += 32) {
+                    DISPATCH_NR_IC(
+                            nchw_stride2_block, nr_ic, src_row + x / 2 + pw0.base,
+                            src_row + x / 2 + pw1.base, filter + ic * FH * FW,
+                            dst_row + x, OC, src_plane, IC * FH * FW, FH * FW,
+                            OH * OW, taps0, taps1, std::min<size_t>(32, OW - x));
+                }
+            }
+        }
+    }
+}
+
+#undef DISPATCH_NR_IC
+
+/* ===================== nchw88 ===================== */
+
+WorkspaceBundle get_nchw88_bundle(const NCBKernSizeParam& param) {
+    UNPACK_CONV_F32_NCB_KERN_SIZES(param);
+    MEGDNN_MARK_USED_VAR(N);
+    Padding ph = get_padding(IH, SH, PH, FH, OH, 0),
+            pw = get_padding(IW, SW, PW, FW, OW, 0);
+    return {nullptr,
+            {sizeof(float) * OC * ph.size * pw.size,
+             sizeof(float) * OC * IC * FH * FW}};
+}
+
+//! transpose the filter from {OC/8, IC/8, FH, FW, 8(ic), 8(oc)} to
+//! {IC/8, OC/8, FH, FW, 8(oc), 8(ic)}, so a filter vector is 8 grad channels
+void pack_nchw88_filter(
+        const float* src, float* dst, size_t OCB, size_t ICB, size_t FHW) {
+    for (size_t ocb = 0; ocb < OCB; ++ocb) {
+        for (size_t icb = 0; icb < ICB; ++icb) {
+            const float* s = src + (ocb * ICB + icb) * FHW * 64;
+            float* d = dst + (icb * OCB + ocb) * FHW * 64;
+            for (size_t f = 0; f < FHW; ++f) {
+                for (size_t i = 0; i < 8; ++i) {
+                    for (size_t o = 0; o < 8; ++o) {
+                        d[f * 64 + o * 8 + i] = s[f * 64 + i * 8 + o];
+                    }
+                }
+            }
+        }
+    }
+}
+
+/*!
+ * \brief compute nr_pix consecutive pixels of a phase row for 8 grad channels
+ * \param src padded diff at the first pixel
+ * \param filter packed filter at (icb, ocb=0)
+ * \param dst grad at the first pixel
+ * \param dst_step distance in floats of two pixels in grad
+ */
+template <int nr_pix>
+MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+void nchw88_phase_block(
+        const float* src, const float* filter, float* dst, size_t OCB,
+        size_t src_plane, size_t filter_ocb_stride, const Taps& taps,
+        size_t dst_step) {
+    __m256 acc[8];
+#define cb(p)                         \
+    if (p < nr_pix) {                 \
+        acc[p] = _mm256_setzero_ps(); \
+    }
+    UNROLL_CALL_RAW(8, cb);
+#undef cb
+    for (size_t t = 0; t < taps.nr; ++t) {
+        const float* s = src + taps.src[t];
+        const float* w = filter + taps.filter[t];
+        for (size_t ocb = 0; ocb < OCB; ++ocb) {
+            for (int c = 0; c < 8; ++c) {
+                __m256 wv = _mm256_loadu_ps(w + c * 8);
+#define cb(p)                                                                     \
+    if (p < nr_pix) {                                                             \
+        acc[p] = _mm256_fmadd_ps(_mm256_broadcast_ss(s + p * 8 + c), wv, acc[p]); \
+    }
+                UNROLL_CALL_RAW(8, cb);
+#undef cb
+            }
+            s += src_plane;
+            w += filter_ocb_stride;
+        }
+    }
+#define cb(p)                                         \
+    if (p < nr_pix) {                                 \
+        _mm256_storeu_ps(dst + p * dst_step, acc[p]); \
+    }
+    UNROLL_CALL_RAW(8, cb);
+#undef cb
+}
+
+//! pixels computed together in nchw88
+constexpr size_t NCHW88_PIX_BLOCK = 8;
+
+void do_nchw88(
+        const float* diff, const float* filter, float* grad, float* padded,
+        const NCBKernSizeParam& param) {
+    UNPACK_CONV_F32_NCB_KERN_SIZES(param);
+    MEGDNN_MARK_USED_VAR(N);
+    size_t OCB = OC / 8, ICB = IC / 8;
+    Padding pad_h = get_padding(IH, SH, PH, FH, OH, 0),
+            pad_w = get_padding(IW, SW, PW, FW, OW, 0);
+    size_t PIW = pad_w.size, src_plane = pad_h.size * PIW * 8;
+    pad_diff(diff, padded, OCB, IH, IW, pad_h, pad_w, 8);
+    for (size_t ry = 0; ry < std::min<size_t>(SH, OH); ++ry) {
+        Phase ph = get_phase(ry, SH, PH, FH, OH);
+        for (size_t rx = 0; rx < std::min<size_t>(SW, OW); ++rx) {
+            Phase pw = get_phase(rx, SW, PW, FW, OW);
+            Taps taps{ph, pw, SH, SW, FW, PIW, 8};
+            for (size_t icb = 0; icb < ICB; ++icb) {
+                const float* fptr = filter + icb * OCB * FH * FW * 64;
+                for (size_t i = 0; i < ph.nout; ++i) {
+                    const float* src_row =
+                            padded +
+                            ((i + ph.base + pad_h.lo) * PIW + pad_w.lo + pw.base) * 8;
+                    float* dst_row = grad + ((icb * OH + ry + SH * i) * OW + rx) * 8;
+                    size_t j = 0;
+                    for (; j + NCHW88_PIX_BLOCK <= pw.nout; j += NCHW88_PIX_BLOCK) {
+                        nchw88_phase_block<NCHW88_PIX_BLOCK>(
+                                src_row + j * 8, fptr, dst_row + j * SW * 8, OCB,
+                                src_plane, FH * FW * 64, taps, SW * 8);
+                    }
+#define cb(_nr_pix)                                                          \
+    case _nr_pix:                                                            \
+        nchw88_phase_block<_nr_pix>(                                         \
+                src_row + j * 8, fptr, dst_row + j * SW * 8, OCB, src_plane, \
+                FH * FW * 64, taps, SW * 8);                                 \
+        break;
+                    switch (pw.nout - j) {
+                        cb(1) cb(2) cb(3) cb(4) cb(5) cb(6) cb(7) default : break;
+                    }
+#undef cb
+                }
+            }
+        }
+    }
+}
+
+}  // anonymous namespace
+
+/* ===================== direct stride2 ===================== */
+
+bool deconv::can_direct_stride2_f32(const NCBKernSizeParam& param) {
+    auto&& fm = param.filter_meta;
+    return can_nchw_f32(param) && fm.stride[0] == 2 && fm.stride[1] == 2;
+}
+
+size_t deconv::get_workspace_in_bytes_direct_stride2_f32(
+        const NCBKernSizeParam& param) {
+    return get_nchw_bundle(param).total_size_in_bytes();
+}
+
+void deconv::direct_stride2_f32(const NCBKernParam& param) {
+    auto bundle = get_nchw_bundle(param);
+    bundle.set(param.workspace_ptr);
+    for (size_t n = 0; n < param.n; ++n) {
+        do_direct_stride2(
+                param.diff<float>() + n * param.inp_bs, param.filter<float>(),
+                param.grad<float>() + n * param.out_bs,
+                static_cast<float*>(bundle.get(0)), param);
+    }
+}
+
+/* ===================== sub-pixel ===================== */
+
+bool deconv::can_subpixel_f32(const NCBKernSizeParam& param) {
+    return can_nchw_f32(param);
+}
+
+size_t deconv::get_workspace_in_bytes_subpixel_f32(const NCBKernSizeParam& param) {
+    return get_nchw_bundle(param).total_size_in_bytes();
+}
+
+void deconv::subpixel_f32(const NCBKernParam& param) {
+    auto bundle = get_nchw_bundle(param);
+    bundle.set(param.workspace_ptr);
+    for (size_t n = 0; n < param.n; ++n) {
+        do_subpixel(
+                param.diff<float>() + n * param.inp_bs, param.filter<float>(),
+                param.grad<float>() + n * param.out_bs,
+                static_cast<float*>(bundle.get(0)), param);
+    }
+}
+
+/* ===================== nchw88 ===================== */
+
+bool deconv::can_nchw88_f32(const NCBKernSizeParam& param) {
+    auto&& fm = param.filter_meta;
+    return fm.format == param::Convolution::Format::NCHW88 &&
+           param.diff_type.enumv() == DTypeEnum::Float32 &&
+           param.filter_type.enumv() == DTypeEnum::Float32 &&
+           param.grad_type.enumv() == DTypeEnum::Float32 &&
+           param.diff_layout.ndim == 5 && param.grad_layout.ndim == 5 &&
+           fm.spatial_ndim == 2 && fm.group == 1 && fm.icpg % 8 == 0 &&
+           fm.ocpg % 8 == 0 && fm.dilation[0] == 1 && fm.dilation[1] == 1 &&
+           !fm.should_flip && is_supported(SIMDType::AVX2) &&
+           is_supported(SIMDType::FMA);
+}
+
+size_t deconv::get_workspace_in_bytes_nchw88_f32(const NCBKernSizeParam& param) {
+    return get_nchw88_bundle(param).total_size_in_bytes();
+}
+
+void deconv::nchw88_f32(const NCBKernParam& param) {
+    auto&& fm = param.filter_meta;
+    auto bundle = get_nchw88_bundle(param);
+    bundle.set(param.workspace_ptr);
+    float* packed_filter = static_cast<float*>(bundle.get(1));
+    pack_nchw88_filter(
+            param.filter<float>(), packed_filter, fm.ocpg / 8, fm.icpg / 8,
+            fm.spatial[0] * fm.spatial[1]);
+    for (size_t n = 0; n < param.n; ++n) {
+        do_nchw88(
+                param.diff<float>() + n * param.inp_bs, packed_filter,
+                param.grad<float>() + n * param.out_bs,
+                static_cast<float*>(bundle.get(0)), param);
+    }
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,51 @@
+/**
+ * \file dnn/src/x86/convolution/f32/conv_backdata.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "src/x86/convolution/opr_impl.h"
+
+#include <cstddef>
+
+namespace megdnn {
+namespace x86 {
+namespace deconv {
+
+using NCBKernSizeParam = ConvolutionBackwardDataImpl::NCBKernSizeParam;
+using NCBKernParam = ConvolutionBackwardDataImpl::NCBKernParam;
+
+/*!
+ * All the kernels below compute a deconv as SH * SW stride-1 convs on the
+ * diff, one for each phase (y % SH, x % SW) of grad, so every grad element is
+ * written once and no col buffer is needed.
+ */
+
+//! nchw, stride 2; both width phases of a grad row are computed together and
+//! interleaved in registers
+bool can_direct_stride2_f32(const NCBKernSizeParam& param);
+size_t get_workspace_in_bytes_direct_stride2_f32(const NCBKernSizeParam& param);
+void direct_stride2_f32(const NCBKernParam& param);
+
+//! nchw, any stride; each phase is computed separately and scattered to grad
+bool can_subpixel_f32(const NCBKernSizeParam& param);
+size_t get_workspace_in_bytes_subpixel_f32(const NCBKernSizeParam& param);
+void subpixel_f32(const NCBKernParam& param);
+
+//! nchw88, any stride; vectorized over the 8 packed grad channels
+bool can_nchw88_f32(const NCBKernSizeParam& param);
+size_t get_workspace_in_bytes_nchw88_f32(const NCBKernSizeParam& param);
+void nchw88_f32(const NCBKernParam& param);
+
+}  // namespace deconv
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,83 @@
+/**
+ * \file dnn/src/x86/convolution/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/x86/convolution/opr_impl.h"
+#include "src/common/metahelper.h"
+#include "src/x86/convolution/f32/algos.h"
+
+using namespace megdnn;
+using namespace x86;
+
+/* ===================== ConvolutionBackwardData ===================== */
+class ConvolutionBackwardDataImpl::AlgoPack : NonCopyableObj {
+    AlgoF32NCHW88 f32_nchw88;
+    AlgoF32DirectStride2 f32_direct_stride2;
+    AlgoF32SubPixel f32_subpixel;
+
+    fallback::ConvolutionBackwardDataImpl::AlgoBase::Mapper m_all_algos_map;
+    SmallVector<fallback::ConvolutionBackwardDataImpl::AlgoBase*> m_all_algos;
+
+public:
+    AlgoPack() {
+        m_all_algos.emplace_back(&f32_nchw88);
+        m_all_algos.emplace_back(&f32_direct_stride2);
+        m_all_algos.emplace_back(&f32_subpixel);
+
+        for (auto&& algo : m_all_algos) {
+            m_all_algos_map.emplace(algo->info().desc, algo);
+        }
+    }
+
+    const SmallVector<fallback::ConvolutionBackwardDataImpl::AlgoBase*>& all_algos()
+            const {
+        return m_all_algos;
+    }
+    const AlgoBase::Mapper& all_algos_map() const { return m_all_algos_map; }
+};
+
+const ConvolutionBackwardDataImpl::AlgoPack& ConvolutionBackwardDataImpl::algo_pack() {
+    static AlgoPack algo_pack;
+    return algo_pack;
+}
+
+MEGDNN_FB_DEF_GET_ALGO_FROM_DESC(ConvolutionBackwardDataImpl)
+
+SmallVector<fallback::ConvolutionBackwardDataImpl::AlgoBase*>
+ConvolutionBackwardDataImpl::get_all_packed_algo() {
+    auto&& algos = fallback::ConvolutionBackwardDataImpl::get_all_packed_algo();
+    algos.insert(
+            algos.begin(), algo_pack().all_algos().begin(),
+            algo_pack().all_algos().end());
+    return std::move(algos);
+}
+
+ConvolutionBackwardDataImpl::ncb_kern_t ConvolutionBackwardDataImpl::
+        ncb_1g_dispatch_kern(Algorithm* algo, const NCBKernSizeParam& param) {
+    if (algo->handle_type() == Handle::HandleType::X86) {
+        return static_cast<AlgoBase*>(algo)->dispatch_kern(this, param);
+    }
+    return fallback::ConvolutionBackwardDataImpl::ncb_1g_dispatch_kern(algo, param);
+}
+
+size_t ConvolutionBackwardDataImpl::ncb_1g_get_workspace(
+        Algorithm* algo, const NCBKernSizeParam& param) {
+    if (algo->handle_type() == Handle::HandleType::X86) {
+        return static_cast<AlgoBase*>(algo)->get_workspace(this, param);
+    }
+    return fallback::ConvolutionBackwardDataImpl::ncb_1g_get_workspace(algo, param);
+}
+
+const char* ConvolutionBackwardDataImpl::get_algorithm_set_name() const {
+    // x86 version 0
+    return "DeconvX86V0";
+}
+
+// vim: syntax=cpp.doxygen
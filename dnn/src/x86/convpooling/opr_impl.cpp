@@ -0,0 +1,204 @@
+/**
+ * \file dnn/src/x86/convpooling/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/x86/convpooling/opr_impl.h"
+#include "src/fallback/convpooling/convpooling_helper.h"
+
+#include "src/common/utils.h"
+#include "src/x86/handle.h"
+#include "src/x86/utils.h"
+
+#include <immintrin.h>
+#ifdef WIN32
+#include <avx2intrin.h>
+#include <avxintrin.h>
+#include <fmaintrin.h>
+#endif
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_x86_convpooling)
+
+namespace {
+
+using namespace megdnn;
+using namespace fallback::convpooling;
+
+//! 8 input columns of consecutive output columns for conv stride SW
+template <size_t SW>
+struct LoadCols;
+
+template <>
+struct LoadCols<1> {
+    MEGDNN_ATTRIBUTE_TARGET("avx2")
+    static __m256 load(const float* ptr) { return _mm256_loadu_ps(ptr); }
+};
+
+template <>
+struct LoadCols<2> {
+    //! even elements of ptr[0, 16)
+    MEGDNN_ATTRIBUTE_TARGET("avx2")
+    static __m256 load(const float* ptr) {
+        __m256 a = _mm256_loadu_ps(ptr), b = _mm256_loadu_ps(ptr + 8);
+        //! a0 a2 b0 b2 | a4 a6 b4 b6
+        __m256 even = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        return _mm256_castpd_ps(_mm256_permute4x64_pd(
+                _mm256_castps_pd(even), _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+};
+
+/*!
+ * \brief output columns [c, c + nr_vec * 8) of a conv row, with bias
+ *
+ * Each filter tap is broadcast once and used for nr_vec registers. The caller
+ * ensures that all the input columns read are inside the row.
+ */
+template <size_t SW, int nr_vec>
+MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+void conv_block(
+        const KernParam& p, const float* src, const float* filter, float bias,
+        size_t oc, ptrdiff_t ih0, size_t c, float* out) {
+    __m256 acc[nr_vec];
+    for (int i = 0; i < nr_vec; ++i) {
+        acc[i] = _mm256_set1_ps(bias);
+    }
+    for (size_t ic = 0; ic < p.IC; ++ic) {
+        const float* fptr = filter + (oc * p.IC + ic) * p.FH * p.FW;
+        for (size_t kh = 0; kh < p.FH; ++kh) {
+            ptrdiff_t ih = ih0 + static_cast<ptrdiff_t>(kh);
+            if (ih < 0 || ih >= static_cast<ptrdiff_t>(p.IH))
+                continue;
+            const float* in = src + (ic * p.IH + ih) * p.IW + c * SW - p.PW;
+            for (size_t kw = 0; kw < p.FW; ++kw) {
+                __m256 w = _mm256_set1_ps(p.weight(fptr, kh, kw));
+                for (int i = 0; i < nr_vec; ++i) {
+                    acc[i] = _mm256_fmadd_ps(
+                            LoadCols<SW>::load(in + kw + i * 8 * SW), w, acc[i]);
+                }
+            }
+        }
+    }
+    for (int i = 0; i < nr_vec; ++i) {
+        _mm256_storeu_ps(out + c + i * 8, acc[i]);
+    }
+}
+
+template <size_t SW>
+MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+void conv_row_sw(
+        const KernParam& p, const float* src, const float* filter, float bias,
+        size_t oc, size_t r, float* out) {
+    ptrdiff_t ih0 = static_cast<ptrdiff_t>(r * p.SH) - static_cast<ptrdiff_t>(p.PH);
+    //! output columns in [v_begin, v_end) read input columns inside the row,
+    //! including the odd column after the last one read by stride 2
+    size_t v_begin = div_ceil(p.PW, SW), v_end = 0;
+    ptrdiff_t last = static_cast<ptrdiff_t>(p.IW + p.PW) -
+                     static_cast<ptrdiff_t>(p.FW + SW - 1);
+    if (last >= 0) {
+        v_end = std::min(p.CW, static_cast<size_t>(last) / SW + 1);
+    }
+    if (v_begin >= v_end) {
+        conv_cols(p, src, filter, bias, oc, r, out, 0, p.CW);
+        return;
+    }
+    conv_cols(p, src, filter, bias, oc, r, out, 0, v_begin);
+    size_t c = v_begin;
+    for (; c + 32 <= v_end; c += 32) {
+        conv_block<SW, 4>(p, src, filter, bias, oc, ih0, c, out);
+    }
+    for (; c + 8 <= v_end; c += 8) {
+        conv_block<SW, 1>(p, src, filter, bias, oc, ih0, c, out);
+    }
+    conv_cols(p, src, filter, bias, oc, r, out, c, p.CW);
+}
+
+struct ConvPoolingKernAVX2 {
+    using Scalar = ScalarConvPoolingKern;
+
+    MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+    static void conv_row(
+            const KernParam& p, const float* src, const float* filter, float bias,
+            size_t oc, size_t r, float* out) {
+        if (p.SW == 1) {
+            conv_row_sw<1>(p, src, filter, bias, oc, r, out);
+        } else if (p.SW == 2) {
+            conv_row_sw<2>(p, src, filter, bias, oc, r, out);
+        } else {
+            Scalar::conv_row(p, src, filter, bias, oc, r, out);
+            return;
+        }
+        if (p.nonline == param::ConvPooling::NonlineMode::RELU) {
+            __m256 zero = _mm256_setzero_ps();
+            size_t c = 0;
+            for (; c + 8 <= p.CW; c += 8) {
+                _mm256_storeu_ps(
+                        out + c, _mm256_max_ps(_mm256_loadu_ps(out + c), zero));
+            }
+            apply_nonline(p, out, c, p.CW);
+        } else {
+            apply_nonline(p, out, 0, p.CW);
+        }
+    }
+
+    MEGDNN_ATTRIBUTE_TARGET("avx2")
+    static void pool_row(
+            const KernParam& p, const float* rows, size_t row_begin, size_t row_end,
+            float* vrow, float* dst_row) {
+        bool is_max = p.pool == param::ConvPooling::PoolMode::MAX;
+        float init = is_max ? -std::numeric_limits<float>::infinity() : 0.f;
+        size_t c = 0;
+        for (; c + 8 <= p.CW; c += 8) {
+            __m256 v = _mm256_set1_ps(init);
+            for (size_t r = row_begin; r < row_end; ++r) {
+                __m256 x = _mm256_loadu_ps(rows + r % p.WH * p.CW + c);
+                v = is_max ? _mm256_max_ps(v, x) : _mm256_add_ps(v, x);
+            }
+            _mm256_storeu_ps(vrow + c, v);
+        }
+        for (; c < p.CW; ++c) {
+            float v = init;
+            for (size_t r = row_begin; r < row_end; ++r) {
+                float x = rows[r % p.WH * p.CW + c];
+                v = is_max ? std::max(v, x) : v + x;
+            }
+            vrow[c] = v;
+        }
+        pool_cols(p, vrow, dst_row);
+    }
+};
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace x86 {
+
+void ConvPoolingForwardImpl::exec(
+        const _megdnn_in TensorND src, const _megdnn_in TensorND filter,
+        const _megdnn_in TensorND bias, _megdnn_out TensorND dst,
+        _megdnn_out Workspace workspace) {
+    if (is_fused_available(src.layout, filter.layout, bias.layout, dst.layout) &&
+        is_supported(SIMDType::AVX2) && is_supported(SIMDType::FMA)) {
+        auto p = make_kern_param(src.layout, filter.layout, bias.layout, dst.layout);
+        MIDOUT_BEGIN(megdnn_x86_convpooling, midout_iv(0)) {
+            fallback::convpooling::exec<ConvPoolingKernAVX2>(
+                    static_cast<naive::HandleImpl*>(handle()), p, src, filter, bias,
+                    dst, workspace);
+            return;
+        }
+        MIDOUT_END();
+    }
+    fallback::ConvPoolingForwardImpl::exec(src, filter, bias, dst, workspace);
+}
+
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,172 @@
+/**
+ * \file dnn/src/x86/cumsum/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "src/x86/cumsum/opr_impl.h"
+#include "src/fallback/cumsum/cumsum_helper.h"
+
+#include "src/common/reduce_helper.h"
+#include "src/common/utils.h"
+#include "src/x86/handle.h"
+#include "src/x86/utils.h"
+
+#include <immintrin.h>
+#ifdef WIN32
+#include <avx2intrin.h>
+#include <avxintrin.h>
+#endif
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_x86_cumsum)
+
+namespace {
+
+using namespace megdnn;
+
+//! inclusive prefix sum of the 8 lanes
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+inline __m256 prefix_sum_avx2(__m256 x) {
+    x = _mm256_add_ps(
+            x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 4)));
+    x = _mm256_add_ps(
+            x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 8)));
+    //! add the total of the low 128-bit lane to the high lane
+    __m256 t = _mm256_permute_ps(x, _MM_SHUFFLE(3, 3, 3, 3));
+    t = _mm256_permute2f128_ps(t, t, 0x08);
+    return _mm256_add_ps(x, t);
+}
+
+//! inclusive suffix sum of the 8 lanes
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+inline __m256 suffix_sum_avx2(__m256 x) {
+    x = _mm256_add_ps(
+            x, _mm256_castsi256_ps(_mm256_srli_si256(_mm256_castps_si256(x), 4)));
+    x = _mm256_add_ps(
+            x, _mm256_castsi256_ps(_mm256_srli_si256(_mm256_castps_si256(x), 8)));
+    //! add the total of the high 128-bit lane to the low lane
+    __m256 t = _mm256_permute_ps(x, _MM_SHUFFLE(0, 0, 0, 0));
+    t = _mm256_permute2f128_ps(t, t, 0x81);
+    return _mm256_add_ps(x, t);
+}
+
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+inline __m256 broadcast_last_avx2(__m256 x) {
+    __m256 t = _mm256_permute_ps(x, _MM_SHUFFLE(3, 3, 3, 3));
+    return _mm256_permute2f128_ps(t, t, 0x11);
+}
+
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+inline __m256 broadcast_first_avx2(__m256 x) {
+    __m256 t = _mm256_permute_ps(x, _MM_SHUFFLE(0, 0, 0, 0));
+    return _mm256_permute2f128_ps(t, t, 0x00);
+}
+
+/*!
+ * \brief fp32 scan kernels with in-register prefix sums
+ *
+ * Exclusive scans shift the input by one lane before the in-register scan, so
+ * that the outputs are not computed by subtraction.
+ */
+struct ScanKernAVX2 {
+    using Scalar = fallback::cumsum::ScalarScanKern<float>;
+
+    MEGDNN_ATTRIBUTE_TARGET("avx2")
+    static float forward(
+            const float* src, float* dst, size_t len, float init, bool exclusive) {
+        __m256 carry = _mm256_set1_ps(init);
+        __m256 zero = _mm256_setzero_ps();
+        __m256i shift_idx = _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6);
+        size_t i = 0;
+        for (; i + 8 <= len; i += 8) {
+            __m256 x = _mm256_loadu_ps(src + i);
+            if (exclusive) {
+                __m256 xs = _mm256_permutevar8x32_ps(x, shift_idx);
+                xs = _mm256_blend_ps(xs, zero, 0x01);
+                __m256 y = _mm256_add_ps(prefix_sum_avx2(xs), carry);
+                _mm256_storeu_ps(dst + i, y);
+                carry = broadcast_last_avx2(_mm256_add_ps(y, x));
+            } else {
+                __m256 y = _mm256_add_ps(prefix_sum_avx2(x), carry);
+                _mm256_storeu_ps(dst + i, y);
+                carry = broadcast_last_avx2(y);
+            }
+        }
+        return Scalar::forward(
+                src + i, dst + i, len - i, _mm256_cvtss_f32(carry), exclusive);
+    }
+
+    MEGDNN_ATTRIBUTE_TARGET("avx2")
+    static float backward(
+            const float* src, float* dst, size_t len, float init, bool exclusive) {
+        __m256 carry = _mm256_set1_ps(init);
+        __m256 zero = _mm256_setzero_ps();
+        __m256i shift_idx = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 7);
+        size_t i = len;
+        for (; i >= 8; i -= 8) {
+            __m256 x = _mm256_loadu_ps(src + i - 8);
+            if (exclusive) {
+                __m256 xs = _mm256_permutevar8x32_ps(x, shift_idx);
+                xs = _mm256_blend_ps(xs, zero, 0x80);
+                __m256 y = _mm256_add_ps(suffix_sum_avx2(xs), carry);
+                _mm256_storeu_ps(dst + i - 8, y);
+                carry = broadcast_first_avx2(_mm256_add_ps(y, x));
+            } else {
+                __m256 y = _mm256_add_ps(suffix_sum_avx2(x), carry);
+                _mm256_storeu_ps(dst + i - 8, y);
+                carry = broadcast_first_avx2(y);
+            }
+        }
+        return Scalar::backward(src, dst, i, _mm256_cvtss_f32(carry), exclusive);
+    }
+
+    MEGDNN_ATTRIBUTE_TARGET("avx2")
+    static float sum(const float* src, size_t len) {
+        __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps();
+        size_t i = 0;
+        for (; i + 16 <= len; i += 16) {
+            s0 = _mm256_add_ps(s0, _mm256_loadu_ps(src + i));
+            s1 = _mm256_add_ps(s1, _mm256_loadu_ps(src + i + 8));
+        }
+        s0 = _mm256_add_ps(s0, s1);
+        __m128 s = _mm_add_ps(_mm256_castps256_ps128(s0), _mm256_extractf128_ps(s0, 1));
+        s = _mm_hadd_ps(s, s);
+        s = _mm_hadd_ps(s, s);
+        return _mm_cvtss_f32(s) + Scalar::sum(src + i, len - i);
+    }
+};
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace x86 {
+
+void CumsumForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    size_t A, B, C;
+    reduce::get_ABC(src.layout, A, B, C, param().axis);
+    //! the middle-axis case is vectorized by the compiler in fallback
+    if (src.layout.dtype == dtype::Float32() && C == 1 &&
+        is_supported(SIMDType::AVX2)) {
+        check_exec(src.layout, dst.layout, workspace.size);
+        MIDOUT_BEGIN(megdnn_x86_cumsum, midout_iv(0)) {
+            fallback::cumsum::exec_cumsum<float, ScanKernAVX2>(
+                    static_cast<naive::HandleImpl*>(handle()), src, dst,
+                    workspace.raw_ptr, A, B, C, param().exclusive, param().reverse);
+            return;
+        }
+        MIDOUT_END();
+    }
+    fallback::CumsumForwardImpl::exec(src, dst, workspace);
+}
+
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -15,16 +15,22 @@
 #include "src/x86/handle.h"
 
 #include "src/x86/add_update/opr_impl.h"
+#include "src/x86/batched_matrix_mul/opr_impl.h"
 #include "src/x86/conv_bias/opr_impl.h"
+#include "src/x86/convolution/opr_impl.h"
+#include "src/x86/convpooling/opr_impl.h"
+#include "src/x86/cumsum/opr_impl.h"
 #include "src/x86/cvt_color/opr_impl.h"
 #include "src/x86/elemwise/opr_impl.h"
 #include "src/x86/elemwise_multi_type/opr_impl.h"
 #include "src/x86/gaussian_blur/opr_impl.h"
+#include "src/x86/image_preprocess/opr_impl.h"
 #include "src/x86/local/opr_impl.h"
 #include "src/x86/lrn/opr_impl.h"
 #include "src/x86/matrix_mul/opr_impl.h"
 #include "src/x86/pooling/opr_impl.h"
 #include "src/x86/resize/opr_impl.h"
+#include "src/x86/rng/opr_impl.h"
 #include "src/x86/separable_conv/opr_impl.h"
 #include "src/x86/separable_filter/opr_impl.h"
 #include "src/x86/type_cvt/opr_impl.h"
@@ -87,6 +93,13 @@ MEGDNN_SPECIALIZE_CREATE_OPERATOR(WarpPerspective)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(AddUpdate)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(TypeCvt)
 MEGDNN_SPECIALIZE_CREATE_OPERATOR(ConvBias)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(ConvolutionBackwardData)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(ConvPoolingForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(ImagePreprocessForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(CumsumForward)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(UniformRNG)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(GaussianRNG)
+MEGDNN_SPECIALIZE_CREATE_OPERATOR(BatchedMatrixMulForward)
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpragmas"
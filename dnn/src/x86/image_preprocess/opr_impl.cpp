@@ -0,0 +1,24 @@
+/**
+ * \file dnn/src/x86/image_preprocess/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/x86/image_preprocess/opr_impl.h"
+#include "src/x86/utils.h"
+
+using namespace megdnn;
+using namespace x86;
+
+void ImagePreprocessForwardImpl::exec(
+        _megdnn_tensor_in src, _megdnn_tensor_in scale, _megdnn_tensor_in bias,
+        _megdnn_tensor_out dst, _megdnn_workspace workspace) {
+    exec_with_resize(src, scale, bias, dst, workspace, is_supported(SIMDType::SSE4_2));
+}
+
+// vim: syntax=cpp.doxygen
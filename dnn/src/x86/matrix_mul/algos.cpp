@@ -13,6 +13,8 @@
 #include "src/x86/matrix_mul/algos.h"
 #include "src/common/utils.h"
 #include "src/fallback/matrix_mul/gemm_impl.h"
+#include "src/x86/matrix_mul/f32/gemm_bsr_8x1.h"
+#include "src/x86/matrix_mul/f32/gemm_w4_g32.h"
 #include "src/x86/matrix_mul/f32/strategy.h"
 #include "src/x86/matrix_mul/int8/strategy.h"
 
@@ -21,6 +23,8 @@
 MIDOUT_DECL(megdnn_x86_matmul_kern)
 MIDOUT_DECL(megdnn_x86_matmul_kern_mk8_8x8)
 MIDOUT_DECL(megdnn_x86_matmul_kern_mkldnn)
+MIDOUT_DECL(megdnn_x86_matmul_kern_w4_g32)
+MIDOUT_DECL(megdnn_x86_matmul_kern_bsr_8x1)
 using namespace megdnn;
 using namespace x86;
 
@@ -652,6 +656,67 @@ size_t MatrixMulImpl::AlgoF32MK8_8x8::get_workspace(
     MIDOUT_END();
 }
 
+/*************************AlgoF32W4G32********************/
+MatrixMulImpl::kern_t MatrixMulImpl::AlgoF32W4G32::get_kern(
+        const KernSizeParam&) const {
+    auto f32_kern_w4_g32 = [](const MatrixMulImpl::KernParam& kern_param) {
+        MIDOUT_BEGIN(megdnn_x86_matmul_kern_w4_g32, midout_iv(0)) {
+            matmul::gemm_w4_g32_avx2(
+                    kern_param.A<float>(), kern_param.LDA, kern_param.B<dt_byte>(),
+                    kern_param.C<float>(), kern_param.LDC, kern_param.M, kern_param.N,
+                    kern_param.K, kern_param.workspace_ptr);
+        }
+        MIDOUT_END();
+    };
+    return f32_kern_w4_g32;
+}
+
+bool MatrixMulImpl::AlgoF32W4G32::usable(const KernSizeParam& kern_size_param) const {
+    return kern_size_param.format == param::MatrixMul::Format::W4_G32 &&
+           kern_size_param.compute_mode == Param::ComputeMode::DEFAULT &&
+           !kern_size_param.trA && !kern_size_param.trB &&
+           kern_size_param.A_type.enumv() == DTypeEnum::Float32 &&
+           kern_size_param.B_type.enumv() == DTypeEnum::Byte &&
+           kern_size_param.C_type.enumv() == DTypeEnum::Float32 &&
+           kern_size_param.K % 32 == 0 && is_supported(SIMDType::AVX2) &&
+           is_supported(SIMDType::FMA);
+}
+
+size_t MatrixMulImpl::AlgoF32W4G32::get_workspace(
+        const KernSizeParam& kern_param) const {
+    MIDOUT_BEGIN(megdnn_x86_matmul_kern_w4_g32, midout_iv(1)) {
+        return matmul::gemm_w4_g32_avx2_workspace(
+                kern_param.M, kern_param.N, kern_param.K);
+    }
+    MIDOUT_END();
+    return 0;
+}
+
+/*************************AlgoF32BSR8x1********************/
+MatrixMulImpl::kern_t MatrixMulImpl::AlgoF32BSR8x1::get_kern(
+        const KernSizeParam&) const {
+    auto f32_kern_bsr_8x1 = [](const MatrixMulImpl::KernParam& kern_param) {
+        MIDOUT_BEGIN(megdnn_x86_matmul_kern_bsr_8x1, midout_iv(0)) {
+            matmul::gemm_bsr_8x1_avx2(
+                    kern_param.A<dt_byte>(), kern_param.LDA, kern_param.B<float>(),
+                    kern_param.LDB, kern_param.C<float>(), kern_param.LDC,
+                    kern_param.M, kern_param.N, kern_param.trB);
+        }
+        MIDOUT_END();
+    };
+    return f32_kern_bsr_8x1;
+}
+
+bool MatrixMulImpl::AlgoF32BSR8x1::usable(const KernSizeParam& kern_size_param) const {
+    return kern_size_param.format == param::MatrixMul::Format::BSR_8X1 &&
+           kern_size_param.compute_mode == Param::ComputeMode::DEFAULT &&
+           !kern_size_param.trA &&
+           kern_size_param.A_type.enumv() == DTypeEnum::Byte &&
+           kern_size_param.B_type.enumv() == DTypeEnum::Float32 &&
+           kern_size_param.C_type.enumv() == DTypeEnum::Float32 &&
+           is_supported(SIMDType::AVX2) && is_supported(SIMDType::FMA);
+}
+
 /*************************AlgoFloatAVX2M6N16********************/
 MatrixMulImpl::kern_t MatrixMulImpl::AlgoFloatAVX2M6N16::get_kern(
         const KernSizeParam&) const {
@@ -0,0 +1,199 @@
+/**
+ * \file dnn/src/x86/matrix_mul/f32/gemm_bsr_8x1.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/x86/matrix_mul/f32/gemm_bsr_8x1.h"
+
+#include "megdnn/oprs/linalg.h"
+#include "src/common/unroll_macro.h"
+#include "src/common/utils.h"
+
+#include <immintrin.h>
+#ifdef WIN32
+#include <avx2intrin.h>
+#include <avxintrin.h>
+#include <fmaintrin.h>
+#endif
+
+#include <cstring>
+
+using namespace megdnn;
+using namespace x86;
+
+namespace {
+
+//! columns of C updated together by kern_cols()
+constexpr size_t MAX_COLS = 4;
+
+struct BlockRow {
+    int32_t nr_blocks;
+    const int32_t* cols;
+    const float* vals;
+
+    BlockRow(const dt_byte* row, size_t max_nr_blocks) {
+        memcpy(&nr_blocks, row, sizeof(int32_t));
+        cols = reinterpret_cast<const int32_t*>(row + sizeof(int32_t));
+        vals = reinterpret_cast<const float*>(
+                row + sizeof(int32_t) * (1 + max_nr_blocks));
+    }
+};
+
+/*!
+ * C[0:8, 0:8 * nr_vec] of one block row; each block is 8 broadcast values of
+ * A times 8 * nr_vec contiguous values in a row of B
+ */
+template <size_t nr_vec>
+MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+void kern_rows(const BlockRow& row, const float* B, size_t LDB, float* C, size_t LDC) {
+    __m256 acc[8][2];
+#define cb(i)                            \
+    acc[i][0] = _mm256_setzero_ps();     \
+    if (nr_vec > 1) {                    \
+        acc[i][1] = _mm256_setzero_ps(); \
+    }
+    UNROLL_CALL_RAW(8, cb);
+#undef cb
+    for (int32_t b = 0; b < row.nr_blocks; ++b) {
+        const float* b_row = B + row.cols[b] * LDB;
+        const float* vals = row.vals + b * 8;
+        __m256 b0 = _mm256_loadu_ps(b_row);
+        __m256 b1 = nr_vec > 1 ? _mm256_loadu_ps(b_row + 8) : b0;
+#define cb(i)                                              \
+    {                                                      \
+        __m256 w = _mm256_broadcast_ss(vals + i);          \
+        acc[i][0] = _mm256_fmadd_ps(w, b0, acc[i][0]);     \
+        if (nr_vec > 1) {                                  \
+            acc[i][1] = _mm256_fmadd_ps(w, b1, acc[i][1]); \
+        }                                                  \
+    }
+        UNROLL_CALL_RAW(8, cb);
+#undef cb
+    }
+#define cb(i)                                         \
+    _mm256_storeu_ps(C + i * LDC, acc[i][0]);         \
+    if (nr_vec > 1) {                                 \
+        _mm256_storeu_ps(C + i * LDC + 8, acc[i][1]); \
+    }
+    UNROLL_CALL_RAW(8, cb);
+#undef cb
+}
+
+/*!
+ * C[0:8, 0:nr_col] of one block row, where element (k, n) of B is at
+ * B[k * stride_k + n * stride_n]; each block is the 8 values of A times one
+ * broadcast element of B per column. Even and odd blocks are accumulated
+ * separately to hide the fma latency when nr_col is small.
+ */
+template <size_t nr_col>
+MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+void kern_cols(
+        const BlockRow& row, const float* B, size_t stride_k, size_t stride_n,
+        float* C, size_t LDC) {
+    __m256 acc[2][MAX_COLS];
+#define cb(n)                                        \
+    if (n < nr_col) {                                \
+        acc[0][n] = acc[1][n] = _mm256_setzero_ps(); \
+    }
+    UNROLL_CALL_RAW(4, cb);
+#undef cb
+#define cb(n, p)                                                       \
+    if (n < nr_col) {                                                  \
+        acc[p][n] = _mm256_fmadd_ps(                                   \
+                _mm256_broadcast_ss(b_col##p + n * stride_n), vals##p, \
+                acc[p][n]);                                            \
+    }
+    int32_t b = 0;
+    for (; b + 2 <= row.nr_blocks; b += 2) {
+        __m256 vals0 = _mm256_loadu_ps(row.vals + b * 8),
+               vals1 = _mm256_loadu_ps(row.vals + b * 8 + 8);
+        const float* b_col0 = B + row.cols[b] * stride_k;
+        const float* b_col1 = B + row.cols[b + 1] * stride_k;
+        UNROLL_CALL_RAW(4, cb, 0);
+        UNROLL_CALL_RAW(4, cb, 1);
+    }
+    if (b < row.nr_blocks) {
+        __m256 vals0 = _mm256_loadu_ps(row.vals + b * 8);
+        const float* b_col0 = B + row.cols[b] * stride_k;
+        UNROLL_CALL_RAW(4, cb, 0);
+    }
+#undef cb
+    float tmp[8];
+#define cb(n)                                             \
+    if (n < nr_col) {                                     \
+        __m256 sum = _mm256_add_ps(acc[0][n], acc[1][n]); \
+        if (LDC == 1 && nr_col == 1) {                    \
+            _mm256_storeu_ps(C, sum);                     \
+        } else {                                          \
+            _mm256_storeu_ps(tmp, sum);                   \
+            for (size_t i = 0; i < 8; ++i) {              \
+                C[i * LDC + n] = tmp[i];                  \
+            }                                             \
+        }                                                 \
+    }
+    UNROLL_CALL_RAW(4, cb);
+#undef cb
+}
+
+void dispatch_cols(
+        const BlockRow& row, const float* B, size_t stride_k, size_t stride_n,
+        float* C, size_t LDC, size_t N) {
+    for (size_t n = 0; n < N; n += MAX_COLS) {
+        const float* b = B + n * stride_n;
+        switch (std::min(N - n, MAX_COLS)) {
+#define cb(nr_col)                                                 \
+    case nr_col:                                                   \
+        kern_cols<nr_col>(row, b, stride_k, stride_n, C + n, LDC); \
+        break;
+            cb(1);
+            cb(2);
+            cb(3);
+            cb(4);
+#undef cb
+            default:
+                megdnn_assert_internal(0);
+        }
+    }
+}
+
+}  // anonymous namespace
+
+void x86::matmul::gemm_bsr_8x1_avx2(
+        const dt_byte* A, size_t LDA, const float* B, size_t LDB, float* C,
+        size_t LDC, size_t M, size_t N, bool trB) {
+    size_t max_nr_blocks =
+            (LDA - MatrixMul::bsr_8x1_row_bytes(0)) / MatrixMul::bsr_8x1_block_bytes();
+    auto get_row = [&](size_t r) { return BlockRow(A + r * LDA, max_nr_blocks); };
+    if (trB) {
+        for (size_t r = 0; r < M / 8; ++r) {
+            dispatch_cols(get_row(r), B, 1, LDB, C + r * 8 * LDC, LDC, N);
+        }
+        return;
+    }
+    //! the columns of B are the outer loop, so that the rows of B used by a
+    //! tile stay in cache while all the block rows visit them
+    size_t n = 0;
+    for (; n + 16 <= N; n += 16) {
+        for (size_t r = 0; r < M / 8; ++r) {
+            kern_rows<2>(get_row(r), B + n, LDB, C + r * 8 * LDC + n, LDC);
+        }
+    }
+    for (; n + 8 <= N; n += 8) {
+        for (size_t r = 0; r < M / 8; ++r) {
+            kern_rows<1>(get_row(r), B + n, LDB, C + r * 8 * LDC + n, LDC);
+        }
+    }
+    if (n < N) {
+        for (size_t r = 0; r < M / 8; ++r) {
+            dispatch_cols(get_row(r), B + n, LDB, 1, C + r * 8 * LDC + n, LDC, N - n);
+        }
+    }
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,39 @@
+/**
+ * \file dnn/src/x86/matrix_mul/f32/gemm_bsr_8x1.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "megdnn/dtype.h"
+
+#include <cstddef>
+
+namespace megdnn {
+namespace x86 {
+namespace matmul {
+
+/*!
+ * C(M, N) = A * B, where A is a (M, K) matrix packed in
+ * param::MatrixMul::Format::BSR_8X1 with block rows of LDA bytes, and B is
+ * (K, N), or (N, K) if trB.
+ *
+ * Only the non-zero blocks are visited: each one is a column of 8 rows of A,
+ * so it updates 8 rows of C with one row of B, or one column of C with one
+ * element of each row of B if trB.
+ */
+void gemm_bsr_8x1_avx2(
+        const dt_byte* A, size_t LDA, const float* B, size_t LDB, float* C,
+        size_t LDC, size_t M, size_t N, bool trB);
+
+}  // namespace matmul
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,195 @@
+/**
+ * \file dnn/src/x86/matrix_mul/f32/gemm_w4_g32.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#include "src/x86/matrix_mul/f32/gemm_w4_g32.h"
+
+#include "megdnn/oprs/linalg.h"
+#include "src/common/unroll_macro.h"
+#include "src/common/utils.h"
+#include "src/fallback/matrix_mul/gemm_impl.h"
+#include "src/x86/matrix_mul/f32/strategy.h"
+
+#include <immintrin.h>
+#ifdef WIN32
+#include <avx2intrin.h>
+#include <avxintrin.h>
+#include <fmaintrin.h>
+#endif
+
+#include <cstring>
+
+using namespace megdnn;
+using namespace x86;
+
+namespace {
+
+constexpr size_t GROUP = 32;
+constexpr size_t GROUP_BYTES = MatrixMul::w4_g32_group_bytes();
+//! rows of A sharing one in-register dequantization of a group
+constexpr size_t MAX_FUSED_M = 4;
+//! below this M, dequantizing B once per 4 rows is cheaper than a float gemm
+constexpr size_t GEMM_MIN_M = 16;
+//! columns of B dequantized at once before calling the float gemm
+constexpr size_t PANEL_N = 128;
+
+inline float group_scale(const dt_byte* group) {
+    float scale;
+    memcpy(&scale, group, sizeof(float));
+    return scale;
+}
+
+//! decode the 32 signed nibbles of a group to floats, without the scale
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+inline void decode_group(
+        const dt_byte* group, __m256& q0, __m256& q1, __m256& q2, __m256& q3) {
+    const __m128i mask = _mm_set1_epi8(0x0F), bias = _mm_set1_epi8(8);
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group + 4));
+    //! (x ^ 8) - 8 sign-extends a nibble; flip both nibbles at once
+    bytes = _mm_xor_si128(bytes, _mm_set1_epi8(static_cast<char>(0x88)));
+    __m128i lo = _mm_sub_epi8(_mm_and_si128(bytes, mask), bias);
+    __m128i hi = _mm_sub_epi8(_mm_and_si128(_mm_srli_epi16(bytes, 4), mask), bias);
+    q0 = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(lo));
+    q1 = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_unpackhi_epi64(lo, lo)));
+    q2 = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(hi));
+    q3 = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_unpackhi_epi64(hi, hi)));
+}
+
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+inline float reduce_sum(__m256 v) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    sum = _mm_hadd_ps(sum, sum);
+    sum = _mm_hadd_ps(sum, sum);
+    return _mm_cvtss_f32(sum);
+}
+
+//! C[0:nr_m, :] = A[0:nr_m, :] * B; each group is decoded once for all rows
+template <size_t nr_m>
+MEGDNN_ATTRIBUTE_TARGET("avx2,fma")
+void gemv_like_w4_g32(
+        const float* A, size_t LDA, const dt_byte* B, float* C, size_t LDC, size_t N,
+        size_t K) {
+    size_t nr_groups = K / GROUP;
+    const dt_byte* group = B;
+    for (size_t n = 0; n < N; ++n) {
+        __m256 acc[MAX_FUSED_M];
+#define cb(m)                         \
+    if (m < nr_m) {                   \
+        acc[m] = _mm256_setzero_ps(); \
+    }
+        UNROLL_CALL_RAW(4, cb);
+#undef cb
+        const float* a = A;
+        for (size_t g = 0; g < nr_groups; ++g) {
+            __m256 q0, q1, q2, q3;
+            decode_group(group, q0, q1, q2, q3);
+            __m256 scale = _mm256_set1_ps(group_scale(group));
+#define cb(m)                                                 \
+    if (m < nr_m) {                                           \
+        const float* am = a + m * LDA;                        \
+        __m256 t = _mm256_mul_ps(_mm256_loadu_ps(am), q0);    \
+        t = _mm256_fmadd_ps(_mm256_loadu_ps(am + 8), q1, t);  \
+        t = _mm256_fmadd_ps(_mm256_loadu_ps(am + 16), q2, t); \
+        t = _mm256_fmadd_ps(_mm256_loadu_ps(am + 24), q3, t); \
+        acc[m] = _mm256_fmadd_ps(t, scale, acc[m]);           \
+    }
+            UNROLL_CALL_RAW(4, cb);
+#undef cb
+            a += GROUP;
+            group += GROUP_BYTES;
+        }
+#define cb(m)                                \
+    if (m < nr_m) {                          \
+        C[m * LDC + n] = reduce_sum(acc[m]); \
+    }
+        UNROLL_CALL_RAW(4, cb);
+#undef cb
+    }
+}
+
+//! dequantize nr_cols rows of B into panel, which is B^T of shape (nr_cols, K)
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+void dequant_panel(const dt_byte* B, float* panel, size_t nr_cols, size_t K) {
+    size_t nr_groups = nr_cols * (K / GROUP);
+    for (size_t g = 0; g < nr_groups; ++g) {
+        __m256 q0, q1, q2, q3;
+        decode_group(B, q0, q1, q2, q3);
+        __m256 scale = _mm256_set1_ps(group_scale(B));
+        _mm256_storeu_ps(panel, _mm256_mul_ps(q0, scale));
+        _mm256_storeu_ps(panel + 8, _mm256_mul_ps(q1, scale));
+        _mm256_storeu_ps(panel + 16, _mm256_mul_ps(q2, scale));
+        _mm256_storeu_ps(panel + 24, _mm256_mul_ps(q3, scale));
+        B += GROUP_BYTES;
+        panel += GROUP;
+    }
+}
+
+using Strategy = x86::matmul::sgemm_pack_6x16_avx2;
+constexpr int cacheline = 64;
+
+WorkspaceBundle get_bundle(size_t M, size_t N, size_t K) {
+    size_t panel_n = std::min(N, PANEL_N);
+    Strategy strategy(
+            M, panel_n, K, dtype::Float32(), dtype::Float32(), dtype::Float32());
+    size_t gemm_size = megdnn::matmul::GemmInterleaved<Strategy>(
+                               M, panel_n, K, false, true, strategy, cacheline)
+                               .get_workspace_size();
+    return {nullptr, {panel_n * K * sizeof(float), gemm_size}};
+}
+
+}  // anonymous namespace
+
+size_t x86::matmul::gemm_w4_g32_avx2_workspace(size_t M, size_t N, size_t K) {
+    if (M < GEMM_MIN_M) {
+        return 0;
+    }
+    return get_bundle(M, N, K).total_size_in_bytes();
+}
+
+void x86::matmul::gemm_w4_g32_avx2(
+        const float* A, size_t LDA, const dt_byte* B, float* C, size_t LDC,
+        size_t M, size_t N, size_t K, void* workspace) {
+    if (M < GEMM_MIN_M) {
+        for (size_t m = 0; m < M; m += MAX_FUSED_M) {
+            const float* a = A + m * LDA;
+            float* c = C + m * LDC;
+            switch (std::min(M - m, MAX_FUSED_M)) {
+#define cb(nr_m)                                         \
+    case nr_m:                                           \
+        gemv_like_w4_g32<nr_m>(a, LDA, B, c, LDC, N, K); \
+        break;
+                cb(1);
+                cb(2);
+                cb(3);
+                cb(4);
+#undef cb
+                default:
+                    megdnn_assert_internal(0);
+            }
+        }
+        return;
+    }
+
+    auto bundle = get_bundle(M, N, K);
+    bundle.set(workspace);
+    float* panel = static_cast<float*>(bundle.get(0));
+    size_t col_bytes = K / GROUP * GROUP_BYTES;
+    for (size_t n = 0; n < N; n += PANEL_N) {
+        size_t panel_n = std::min(N - n, PANEL_N);
+        dequant_panel(B + n * col_bytes, panel, panel_n, K);
+        Strategy strategy(
+                M, panel_n, K, dtype::Float32(), dtype::Float32(), dtype::Float32());
+        megdnn::matmul::GemmInterleaved<Strategy>(
+                M, panel_n, K, false, true, strategy, cacheline)
+                .execute(A, LDA, panel, K, C + n, LDC, bundle.get(1));
+    }
+}
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,40 @@
+/**
+ * \file dnn/src/x86/matrix_mul/f32/gemm_w4_g32.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied.
+ */
+#pragma once
+
+#include "megdnn/dtype.h"
+
+#include <cstddef>
+
+namespace megdnn {
+namespace x86 {
+namespace matmul {
+
+/*!
+ * C(M, N) = A(M, K) * B, where B is a weight packed in
+ * param::MatrixMul::Format::W4_G32.
+ *
+ * For small M the nibbles are dequantized in registers and consumed right
+ * away, so B is streamed from memory only once; for larger M a panel of B is
+ * dequantized to float32 in the workspace and fed to the 6x16 sgemm.
+ */
+size_t gemm_w4_g32_avx2_workspace(size_t M, size_t N, size_t K);
+
+void gemm_w4_g32_avx2(
+        const float* A, size_t LDA, const dt_byte* B, float* C, size_t LDC,
+        size_t M, size_t N, size_t K, void* workspace);
+
+}  // namespace matmul
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
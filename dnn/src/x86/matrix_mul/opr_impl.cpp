@@ -35,6 +35,8 @@ class MatrixMulImpl::AlgoPack : NonCopyableObj {
     AlgoInt8x8x16SSE algoint8x8x16sse_m4n8k2;
     AlgoF32MK8_8x8 algof32mk8_8x8;
     AlgoFloatAVX2M6N16 algof32_6x16;
+    AlgoF32W4G32 algof32_w4_g32;
+    AlgoF32BSR8x1 algof32_bsr_8x1;
 
     SmallVector<fallback::MatrixMulImpl::AlgoBase*> m_all_algos;
     fallback::MatrixMulImpl::AlgoBase::Mapper m_all_algos_map;
@@ -53,6 +55,8 @@ public:
         m_all_algos.emplace_back(&algoint8x8x16sse_m4n8k2);
         m_all_algos.emplace_back(&algof32mk8_8x8);
         m_all_algos.emplace_back(&algof32_6x16);
+        m_all_algos.emplace_back(&algof32_w4_g32);
+        m_all_algos.emplace_back(&algof32_bsr_8x1);
 #if MEGDNN_X86_WITH_MKL_DNN
         m_all_algos.emplace_back(&algoint8x8x32mkldnn);
 #endif
@@ -68,6 +68,8 @@ private:
     class AlgoPack;
     class AlgoF32MK8_8x8;
     class AlgoFloatAVX2M6N16;
+    class AlgoF32W4G32;
+    class AlgoF32BSR8x1;
 
 public:
     static const AlgoPack& algo_pack();
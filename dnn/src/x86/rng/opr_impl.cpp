@@ -0,0 +1,188 @@
+/**
+ * \file dnn/src/x86/rng/opr_impl.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "src/x86/rng/opr_impl.h"
+#include "src/fallback/rng/rng_helper.h"
+
+#include "src/common/utils.h"
+#include "src/x86/handle.h"
+#include "src/x86/utils.h"
+
+#include <immintrin.h>
+#ifdef WIN32
+#include <avx2intrin.h>
+#include <avxintrin.h>
+#endif
+
+#include "midout.h"
+
+MIDOUT_DECL(megdnn_x86_rng)
+
+namespace {
+
+using namespace megdnn;
+using namespace fallback::rng;
+
+//! low and high 32 bits of the products of the 8 lanes of \p a and \p m
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+inline void mulhilo_avx2(__m256i a, __m256i m, __m256i& lo, __m256i& hi) {
+    __m256i even = _mm256_mul_epu32(a, m),
+            odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+    lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+    hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+}
+
+/*!
+ * \brief run Philox on the 8 consecutive blocks starting at \p block of
+ *      subsequence 0
+ * \param[out] c word i of the 8 outputs, i.e. in SoA layout
+ */
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+inline void philox8_avx2(const Philox4x32& philox, uint64_t block, __m256i* c) {
+    alignas(32) uint32_t lo[8], hi[8];
+    for (int i = 0; i < 8; ++i) {
+        lo[i] = static_cast<uint32_t>(block + i);
+        hi[i] = static_cast<uint32_t>((block + i) >> 32);
+    }
+    c[0] = _mm256_load_si256(reinterpret_cast<const __m256i*>(lo));
+    c[1] = _mm256_load_si256(reinterpret_cast<const __m256i*>(hi));
+    c[2] = c[3] = _mm256_setzero_si256();
+    __m256i k0 = _mm256_set1_epi32(philox.key(0)),
+            k1 = _mm256_set1_epi32(philox.key(1)),
+            m0 = _mm256_set1_epi32(PHILOX_M4x32_0),
+            m1 = _mm256_set1_epi32(PHILOX_M4x32_1),
+            w0 = _mm256_set1_epi32(PHILOX_W32_0), w1 = _mm256_set1_epi32(PHILOX_W32_1);
+    for (int r = 0; r < 10; ++r) {
+        __m256i lo0, hi0, lo1, hi1;
+        mulhilo_avx2(c[0], m0, lo0, hi0);
+        mulhilo_avx2(c[2], m1, lo1, hi1);
+        c[0] = _mm256_xor_si256(_mm256_xor_si256(hi1, c[1]), k0);
+        c[1] = lo1;
+        c[2] = _mm256_xor_si256(_mm256_xor_si256(hi0, c[3]), k1);
+        c[3] = lo0;
+        k0 = _mm256_add_epi32(k0, w0);
+        k1 = _mm256_add_epi32(k1, w1);
+    }
+}
+
+/*!
+ * \brief convert uint32 lanes to float with round-to-nearest, the same as
+ *      static_cast<float>(uint32_t)
+ *
+ * Both halves are exact in float, so the sum is rounded only once.
+ */
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+inline __m256 cvt_u32_ps_avx2(__m256i x) {
+    __m256 hi = _mm256_cvtepi32_ps(_mm256_srli_epi32(x, 16)),
+           lo = _mm256_cvtepi32_ps(_mm256_and_si256(x, _mm256_set1_epi32(0xffff)));
+    return _mm256_add_ps(_mm256_mul_ps(hi, _mm256_set1_ps(65536.f)), lo);
+}
+
+//! vectorized uint2float() and uint2angle(); mul and add are not fused
+MEGDNN_ATTRIBUTE_TARGET("avx2")
+inline __m256 scale_ps_avx2(__m256i x, float scale) {
+    return _mm256_add_ps(
+            _mm256_mul_ps(cvt_u32_ps_avx2(x), _mm256_set1_ps(scale)),
+            _mm256_set1_ps(scale / 2.f));
+}
+
+/*!
+ * \brief Philox kernels computing 8 blocks in the lanes of avx2 registers
+ *
+ * The results are bitwise identical to ScalarPhiloxKern. The transcendental
+ * functions of the gaussian kernel are still computed by libm for this reason.
+ */
+struct PhiloxKernAVX2 {
+    using Scalar = ScalarPhiloxKern;
+
+    MEGDNN_ATTRIBUTE_TARGET("avx2")
+    static void uniform(
+            const Philox4x32& philox, uint64_t block, float* dst, size_t n) {
+        __m256i c[4];
+        for (; n >= 32; n -= 32, block += 8, dst += 32) {
+            philox8_avx2(philox, block, c);
+            __m256 f0 = scale_ps_avx2(c[0], TWO_POW32_INV),
+                   f1 = scale_ps_avx2(c[1], TWO_POW32_INV),
+                   f2 = scale_ps_avx2(c[2], TWO_POW32_INV),
+                   f3 = scale_ps_avx2(c[3], TWO_POW32_INV);
+            //! transpose 4x8 to the order of blocks
+            __m256 t0 = _mm256_unpacklo_ps(f0, f1), t1 = _mm256_unpackhi_ps(f0, f1),
+                   t2 = _mm256_unpacklo_ps(f2, f3), t3 = _mm256_unpackhi_ps(f2, f3);
+            __m256 b0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)),
+                   b1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2)),
+                   b2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)),
+                   b3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+            _mm256_storeu_ps(dst, _mm256_permute2f128_ps(b0, b1, 0x20));
+            _mm256_storeu_ps(dst + 8, _mm256_permute2f128_ps(b2, b3, 0x20));
+            _mm256_storeu_ps(dst + 16, _mm256_permute2f128_ps(b0, b1, 0x31));
+            _mm256_storeu_ps(dst + 24, _mm256_permute2f128_ps(b2, b3, 0x31));
+        }
+        Scalar::uniform(philox, block, dst, n);
+    }
+
+    MEGDNN_ATTRIBUTE_TARGET("avx2")
+    static void gaussian(
+            const Philox4x32& philox, uint64_t block, float* dst, size_t n,
+            float mean, float stddev) {
+        __m256i c[4];
+        alignas(32) float u[2][8], v[2][8];
+        for (; n >= 32; n -= 32, block += 8, dst += 32) {
+            philox8_avx2(philox, block, c);
+            _mm256_store_ps(u[0], scale_ps_avx2(c[0], TWO_POW32_INV));
+            _mm256_store_ps(v[0], scale_ps_avx2(c[1], TWO_POW32_INV_2PI));
+            _mm256_store_ps(u[1], scale_ps_avx2(c[2], TWO_POW32_INV));
+            _mm256_store_ps(v[1], scale_ps_avx2(c[3], TWO_POW32_INV_2PI));
+            for (int i = 0; i < 8; ++i) {
+                box_muller(u[0][i], v[0][i], mean, stddev, dst + i * 4);
+                box_muller(u[1][i], v[1][i], mean, stddev, dst + i * 4 + 2);
+            }
+        }
+        Scalar::gaussian(philox, block, dst, n, mean, stddev);
+    }
+};
+
+}  // anonymous namespace
+
+namespace megdnn {
+namespace x86 {
+
+void UniformRNGImpl::exec(_megdnn_tensor_inout dst, _megdnn_workspace workspace) {
+    if (dst.layout.dtype == dtype::Float32() && is_supported(SIMDType::AVX2)) {
+        check_exec(dst.layout, workspace.size);
+        MIDOUT_BEGIN(megdnn_x86_rng, midout_iv(0)) {
+            exec_uniform<PhiloxKernAVX2>(
+                    static_cast<naive::HandleImpl*>(handle()), dst,
+                    m_philox_ctr.ensure_seed(m_param.seed));
+            return;
+        }
+        MIDOUT_END();
+    }
+    fallback::UniformRNGImpl::exec(dst, workspace);
+}
+
+void GaussianRNGImpl::exec(_megdnn_tensor_inout dst, _megdnn_workspace workspace) {
+    if (dst.layout.dtype == dtype::Float32() && is_supported(SIMDType::AVX2)) {
+        check_exec(dst.layout, workspace.size);
+        MIDOUT_BEGIN(megdnn_x86_rng, midout_iv(1)) {
+            exec_gaussian<PhiloxKernAVX2>(
+                    static_cast<naive::HandleImpl*>(handle()), dst,
+                    m_philox_ctr.ensure_seed(m_param.seed), m_param.mean,
+                    m_param.std);
+            return;
+        }
+        MIDOUT_END();
+    }
+    fallback::GaussianRNGImpl::exec(dst, workspace);
+}
+
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,32 @@
+/**
+ * \file dnn/src/x86/rng/opr_impl.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+#include "src/fallback/rng/opr_impl.h"
+
+namespace megdnn {
+namespace x86 {
+
+class UniformRNGImpl : public fallback::UniformRNGImpl {
+public:
+    using fallback::UniformRNGImpl::UniformRNGImpl;
+    void exec(_megdnn_tensor_inout dst, _megdnn_workspace workspace) override;
+};
+
+class GaussianRNGImpl : public fallback::GaussianRNGImpl {
+public:
+    using fallback::GaussianRNGImpl::GaussianRNGImpl;
+    void exec(_megdnn_tensor_inout dst, _megdnn_workspace workspace) override;
+};
+
+}  // namespace x86
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
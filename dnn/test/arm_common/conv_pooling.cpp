@@ -0,0 +1,36 @@
+/**
+ * \file dnn/test/arm_common/conv_pooling.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test/arm_common/fixture.h"
+
+#include "test/common/conv_pooling.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(ARM_COMMON, CONV_POOLING) {
+    conv_pooling::run_conv_pooling_test(handle());
+}
+
+TEST_F(ARM_COMMON_MULTI_THREADS, CONV_POOLING) {
+    conv_pooling::run_conv_pooling_test(handle());
+}
+
+#if MEGDNN_WITH_BENCHMARK
+TEST_F(ARM_COMMON, BENCHMARK_CONV_POOLING) {
+    conv_pooling::benchmark_with_contrast(handle());
+}
+
+TEST_F(ARM_COMMON_MULTI_THREADS, BENCHMARK_CONV_POOLING) {
+    conv_pooling::benchmark_with_contrast(handle());
+}
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,26 @@
+/**
+ * \file dnn/test/arm_common/image_preprocess.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test/arm_common/fixture.h"
+
+#include "test/common/image_preprocess.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(ARM_COMMON, IMAGE_PREPROCESS) {
+    image_preprocess::run_image_preprocess_test(handle(), true);
+}
+
+TEST_F(ARM_COMMON_MULTI_THREADS, IMAGE_PREPROCESS) {
+    image_preprocess::run_image_preprocess_test(handle(), true);
+}
+
+// vim: syntax=cpp.doxygen
@@ -310,6 +310,10 @@ TEST_F(ARM_COMMON, FP32_GEMV_MK4) {
             run(M, K);
 }
 
+TEST_F(ARM_COMMON, MATRIX_MUL_F32_BSR_8X1) {
+    matrix_mul::check_matrix_mul_bsr_8x1(handle(), "ARM_COMMON_F32_BSR_8X1");
+}
+
 TEST_F(ARM_COMMON, MATRIX_MUL_RECORD) {
     TaskRecordChecker<MatrixMul> checker(0);
     checker.set_epsilon(1e-2);
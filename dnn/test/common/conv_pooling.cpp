@@ -9,6 +9,9 @@
  * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
  */
 #include "test/common/conv_pooling.h"
+#include "test/common/benchmarker.h"
+#include "test/common/checker.h"
+#include "test/common/rng.h"
 
 namespace megdnn {
 namespace test {
@@ -107,6 +110,107 @@ std::vector<TestArg> get_args() {
     return args;
 }
 
+void run_conv_pooling_test(Handle* handle) {
+    using Param = param::ConvPooling;
+    Checker<ConvPoolingForward> checker(handle);
+    NormalRNG rng;
+    checker.set_rng(0, &rng).set_rng(1, &rng).set_rng(2, &rng).set_epsilon(1e-3);
+    for (auto&& arg : conv_pooling::get_args()) {
+        checker.set_param(arg.param).execs({arg.src, arg.filter, arg.bias, {}});
+    }
+
+    //! padded conv and pooling, strided conv and overlapping windows
+    Param param;
+    for (auto pool_mode : {Param::PoolMode::MAX, Param::PoolMode::AVERAGE})
+        for (auto nonline_mode :
+             {Param::NonlineMode::IDENTITY, Param::NonlineMode::RELU,
+              Param::NonlineMode::SIGMOID})
+            for (size_t conv_stride : {1, 2}) {
+                param.poolMode = pool_mode;
+                param.nonlineMode = nonline_mode;
+                param.conv_stride_h = param.conv_stride_w = conv_stride;
+                param.conv_pad_h = param.conv_pad_w = 1;
+
+                param.pool_shape_h = param.pool_shape_w = 3;
+                param.pool_stride_h = param.pool_stride_w = 2;
+                param.pool_pad_h = param.pool_pad_w = 1;
+                checker.set_param(param).execs(
+                        {{2, 3, 17, 19}, {8, 3, 3, 3}, {1, 8, 1, 1}, {}});
+
+                param.pool_shape_h = param.pool_shape_w = 2;
+                param.pool_pad_h = param.pool_pad_w = 0;
+                checker.set_param(param).execs(
+                        {{1, 5, 16, 23}, {4, 5, 1, 3}, {1, 4, 1, 1}, {}});
+
+                //! wide rows, with border columns on both sides of the
+                //! vectorized ones
+                param.conv_pad_h = param.conv_pad_w = 3;
+                checker.set_param(param).execs(
+                        {{1, 3, 12, 100}, {4, 3, 7, 7}, {1, 4, 1, 1}, {}});
+                param.conv_pad_h = param.conv_pad_w = 0;
+                checker.set_param(param).execs(
+                        {{2, 3, 9, 77}, {2, 3, 3, 3}, {1, 2, 1, 1}, {}});
+            }
+}
+
+#if MEGDNN_WITH_BENCHMARK
+void benchmark_with_contrast(Handle* handle) {
+    constexpr size_t RUNS = 10;
+    using Param = param::ConvPooling;
+    Benchmarker<ConvPoolingForward> bencher(handle);
+    Benchmarker<ConvBias> bencher_conv(handle);
+    Benchmarker<Pooling> bencher_pool(handle);
+    bencher.set_times(RUNS).set_display(false);
+    bencher_conv.set_times(RUNS).set_display(false);
+    bencher_pool.set_times(RUNS).set_display(false);
+    auto run = [&](size_t N, size_t IC, size_t OC, size_t H, size_t W, size_t FH,
+                   Param::PoolMode pool_mode, size_t window, size_t pool_pad) {
+        Param param;
+        param.poolMode = pool_mode;
+        param.nonlineMode = Param::NonlineMode::RELU;
+        param.conv_pad_h = param.conv_pad_w = FH / 2;
+        param.pool_shape_h = param.pool_shape_w = window;
+        param.pool_stride_h = param.pool_stride_w = 2;
+        param.pool_pad_h = param.pool_pad_w = pool_pad;
+
+        param::ConvBias conv_param;
+        conv_param.nonlineMode = param::ConvBias::NonlineMode::RELU;
+        conv_param.pad_h = conv_param.pad_w = FH / 2;
+        param::Pooling pool_param;
+        pool_param.mode = pool_mode == Param::PoolMode::MAX
+                                ? param::Pooling::Mode::MAX
+                                : param::Pooling::Mode::AVERAGE;
+        pool_param.window_h = pool_param.window_w = window;
+        pool_param.stride_h = pool_param.stride_w = 2;
+        pool_param.pad_h = pool_param.pad_w = pool_pad;
+
+        TensorShape src{N, IC, H, W}, filter{OC, IC, FH, FH}, bias{1, OC, 1, 1};
+        auto t = bencher.set_param(param).execs({src, filter, bias, {}}) / RUNS;
+        auto t_conv = bencher_conv.set_param(conv_param)
+                              .execs({src, filter, bias, {}, {}}) /
+                      RUNS;
+        auto t_pool = bencher_pool.set_param(pool_param).execs({{N, OC, H, W}, {}}) /
+                      RUNS;
+        printf("conv_pooling N=%zu IC=%zu OC=%zu %zux%zu filter=%zu pool=%zu: "
+               "fused=%.3fms conv_bias+pooling=%.3fms speedup=%.2f\n",
+               N, IC, OC, H, W, FH, window, t, t_conv + t_pool,
+               (t_conv + t_pool) / t);
+    };
+    for (auto mode : {Param::PoolMode::MAX, Param::PoolMode::AVERAGE}) {
+        // first layers on images, which FuseConvBiasPoolingPass fuses
+        run(1, 3, 16, 224, 224, 3, mode, 2, 0);
+        run(1, 3, 32, 224, 224, 3, mode, 3, 1);
+        run(1, 3, 32, 224, 224, 7, mode, 3, 1);
+        run(8, 1, 16, 64, 64, 5, mode, 2, 0);
+        // around its limit of 147 input elements per output
+        run(1, 16, 32, 112, 112, 3, mode, 2, 0);
+        run(1, 4, 32, 112, 112, 7, mode, 2, 0);
+        // deeper layers, which it leaves alone
+        run(4, 32, 32, 56, 56, 3, mode, 3, 1);
+    }
+}
+#endif
+
 }  // namespace conv_pooling
 }  // namespace test
 }  // namespace megdnn
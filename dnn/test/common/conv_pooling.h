@@ -10,6 +10,7 @@
  */
 #pragma once
 #include "megdnn/basic_types.h"
+#include "megdnn/handle.h"
 #include "megdnn/opr_param_defs.h"
 
 namespace megdnn {
@@ -26,6 +27,15 @@ struct TestArg {
 
 std::vector<TestArg> get_args();
 
+//! check ConvPooling on the handle against naive, including rows wide enough
+//! for the vectorized kernels
+void run_conv_pooling_test(Handle* handle);
+
+#if MEGDNN_WITH_BENCHMARK
+//! benchmark ConvPooling against ConvBias followed by Pooling on the handle
+void benchmark_with_contrast(Handle* handle);
+#endif
+
 }  // namespace conv_pooling
 }  // namespace test
 }  // namespace megdnn
@@ -0,0 +1,59 @@
+/**
+ * \file dnn/test/common/image_preprocess.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test/common/image_preprocess.h"
+#include "test/common/checker.h"
+#include "test/common/rng.h"
+
+namespace megdnn {
+namespace test {
+namespace image_preprocess {
+
+void run_image_preprocess_test(Handle* handle, bool cv_resize) {
+    using Param = ImagePreprocess::Param;
+    Checker<ImagePreprocess> checker(handle);
+    UniformIntRNG src_rng{0, 255};
+    UniformFloatRNG scale_rng{0.005f, 0.02f}, bias_rng{-2.f, 2.f};
+    checker.set_dtype(0, dtype::Uint8())
+            .set_dtype(1, dtype::Float32())
+            .set_dtype(2, dtype::Float32())
+            .set_rng(0, &src_rng)
+            .set_rng(1, &scale_rng)
+            .set_rng(2, &bias_rng);
+    //! one uint8 level times the largest scale, or one quantized level
+    float epsilon = cv_resize ? 0.02f + 1e-4f : 1e-4f,
+          epsilon_q8 = cv_resize ? 1.f : 1e-4f;
+    Param param;
+    for (auto imode : {Param::InterpolationMode::LINEAR,
+                       Param::InterpolationMode::NEAREST})
+        for (auto format : {Param::Format::NCHW, Param::Format::NCHW88})
+            for (size_t C : {1, 3, 4}) {
+                param.imode = imode;
+                param.format = format;
+                param.color_mode = C == 3 ? Param::ColorMode::SWAP_RB
+                                          : Param::ColorMode::NONE;
+                for (auto out_hw : {std::make_pair(0u, 0u), std::make_pair(13u, 29u),
+                                    std::make_pair(64u, 5u)}) {
+                    param.out_h = out_hw.first;
+                    param.out_w = out_hw.second;
+                    checker.set_dtype(3, dtype::Float32()).set_epsilon(epsilon);
+                    checker.set_param(param).execs({{2, 37, 23, C}, {C}, {C}, {}});
+                    checker.set_dtype(3, dtype::QuantizedS8(0.05f))
+                            .set_epsilon(epsilon_q8);
+                    checker.set_param(param).execs({{1, 8, 31, C}, {C}, {C}, {}});
+                }
+            }
+}
+
+}  // namespace image_preprocess
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
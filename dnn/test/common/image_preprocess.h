@@ -0,0 +1,29 @@
+/**
+ * \file dnn/test/common/image_preprocess.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#pragma once
+#include "megdnn/handle.h"
+
+namespace megdnn {
+namespace test {
+namespace image_preprocess {
+
+/*!
+ * \brief check ImagePreprocess on the handle against naive
+ * \param cv_resize whether Resize of the handle uses resize_cv, whose LINEAR
+ *      result may be one uint8 level below that of naive
+ */
+void run_image_preprocess_test(Handle* handle, bool cv_resize);
+
+}  // namespace image_preprocess
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
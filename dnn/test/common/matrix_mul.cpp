@@ -14,6 +14,10 @@
 #include "test/common/benchmarker.h"
 #include "test/common/checker.h"
 
+#include <algorithm>
+#include <numeric>
+#include <random>
+
 using namespace megdnn;
 using namespace test;
 
@@ -313,6 +317,109 @@ void matrix_mul::check_batched_matrix_mul(
             8, eps, std::forward<decltype(args)>(args), force_deduce_dst);
 }
 
+void matrix_mul::check_matrix_mul_w4_g32(
+        Handle* handle, const ExecutionPolicyAlgoName& algo, float eps) {
+    Checker<MatrixMul> checker(handle);
+    checker.set_force_deduce_dst(false);
+    if (!algo.name.empty()) {
+        checker.set_before_exec_callback(AlgoChecker<MatrixMul>(algo));
+    }
+    checker.set_epsilon(eps);
+    constexpr size_t group_bytes = MatrixMul::w4_g32_group_bytes();
+    checker.set_tensors_constraint([](TensorNDArray& tensors) {
+        auto&& B = tensors[1];
+        auto ptr = static_cast<uint8_t*>(B.raw_ptr());
+        size_t nr_groups = B.layout.total_nr_elems() / group_bytes;
+        std::mt19937 gen(nr_groups);
+        std::uniform_real_distribution<float> scale_dist(0.01f, 0.1f);
+        std::uniform_int_distribution<int> nibble_dist(0, 255);
+        for (size_t g = 0; g < nr_groups; ++g, ptr += group_bytes) {
+            float scale = scale_dist(gen);
+            memcpy(ptr, &scale, sizeof(float));
+            for (size_t i = 4; i < group_bytes; ++i) {
+                ptr[i] = nibble_dist(gen);
+            }
+        }
+    });
+
+    MatrixMul::Param param;
+    param.format = param::MatrixMul::Format::W4_G32;
+    checker.set_param(param)
+            .set_dtype(0, dtype::Float32())
+            .set_dtype(1, dtype::Byte())
+            .set_dtype(2, dtype::Float32());
+    for (size_t m : {1, 2, 3, 4, 5, 7, 8, 15, 16, 17, 33})
+        for (size_t n : {1, 3, 8, 16, 130})
+            for (size_t k : {32, 64, 320}) {
+                size_t b1 = k / 32 * group_bytes;
+                checker.execs({{m, k}, {n, b1}, {}});
+                //! strided A and C
+                TensorLayout A{{m, k}, {ptrdiff_t(k + 5), 1}, dtype::Float32()},
+                        B{{n, b1}, dtype::Byte()},
+                        C{{m, n}, {ptrdiff_t(n + 3), 1}, dtype::Float32()};
+                checker.execl({A, B, C});
+            }
+}
+
+void matrix_mul::check_matrix_mul_bsr_8x1(
+        Handle* handle, const ExecutionPolicyAlgoName& algo, float eps) {
+    Checker<MatrixMul> checker(handle);
+    checker.set_force_deduce_dst(false);
+    if (!algo.name.empty()) {
+        checker.set_before_exec_callback(AlgoChecker<MatrixMul>(algo));
+    }
+    checker.set_epsilon(eps);
+    MatrixMul::Param param;
+    param.format = param::MatrixMul::Format::BSR_8X1;
+    //! fill a random number of blocks in random distinct columns; the padding
+    //! blocks keep their random values, which must be ignored
+    auto fill_blocks = [&param](TensorNDArray& tensors) {
+        auto&& A = tensors[0];
+        size_t K = tensors[1].layout.shape[param.transposeB ? 1 : 0];
+        size_t row_bytes = A.layout.shape[1];
+        size_t max_nr_blocks = (row_bytes - MatrixMul::bsr_8x1_row_bytes(0)) /
+                               MatrixMul::bsr_8x1_block_bytes();
+        std::mt19937 gen(A.layout.total_nr_elems());
+        std::uniform_real_distribution<float> val_dist(-1.f, 1.f);
+        std::vector<int32_t> cols(K);
+        for (size_t r = 0; r < A.layout.shape[0]; ++r) {
+            auto row = reinterpret_cast<uint8_t*>(A.raw_ptr()) + r * row_bytes;
+            std::iota(cols.begin(), cols.end(), 0);
+            std::shuffle(cols.begin(), cols.end(), gen);
+            int32_t nr_blocks = std::min(max_nr_blocks, K) == 0
+                                      ? 0
+                                      : gen() % (std::min(max_nr_blocks, K) + 1);
+            std::sort(cols.begin(), cols.begin() + nr_blocks);
+            memcpy(row, &nr_blocks, sizeof(int32_t));
+            memcpy(row + 4, cols.data(), sizeof(int32_t) * nr_blocks);
+            auto vals = reinterpret_cast<float*>(row + 4 + 4 * max_nr_blocks);
+            for (size_t i = 0; i < max_nr_blocks * 8; ++i) {
+                vals[i] = val_dist(gen);
+            }
+        }
+    };
+    checker.set_tensors_constraint(fill_blocks);
+    checker.set_dtype(0, dtype::Byte())
+            .set_dtype(1, dtype::Float32())
+            .set_dtype(2, dtype::Float32());
+    for (bool trB : {false, true})
+        for (size_t m : {8, 16, 64})
+            for (size_t n : {1, 3, 4, 8, 17, 50})
+                for (size_t k : {1, 7, 64})
+                    for (size_t nr_blocks : {1, 5, 64}) {
+                        param.transposeB = trB;
+                        checker.set_param(param);
+                        size_t a1 = MatrixMul::bsr_8x1_row_bytes(nr_blocks);
+                        TensorShape B = trB ? TensorShape{n, k} : TensorShape{k, n};
+                        checker.execs({{m / 8, a1}, B, {}});
+                        //! strided B and C
+                        TensorLayout A_ly{{m / 8, a1}, dtype::Byte()},
+                                B_ly{B, {ptrdiff_t(B[1] + 3), 1}, dtype::Float32()},
+                                C_ly{{m, n}, {ptrdiff_t(n + 5), 1}, dtype::Float32()};
+                        checker.execl({A_ly, B_ly, C_ly});
+                    }
+}
+
 void matrix_mul::check_matrix_mul(
         DType A_dtype, DType B_dtype, DType C_dtype, Handle* handle,
         const ExecutionPolicyAlgoName& algo, param::MatrixMul::Format format,
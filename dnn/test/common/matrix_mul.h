@@ -83,6 +83,18 @@ void check_batched_matrix_mul(
         const ExecutionPolicyAlgoName& algo = {"", {}}, float eps = 1e-3,
         std::vector<TestArg>&& args = {}, bool force_deduce_dst = true);
 
+//! check float32 x int4 weight matmul in Format::W4_G32; B is filled with
+//! random nibbles and positive scales
+void check_matrix_mul_w4_g32(
+        Handle* handle, const ExecutionPolicyAlgoName& algo = {"", {}},
+        float eps = 1e-3);
+
+//! check block sparse matmul in Format::BSR_8X1; each block row of A gets a
+//! random number of blocks in random columns
+void check_matrix_mul_bsr_8x1(
+        Handle* handle, const ExecutionPolicyAlgoName& algo = {"", {}},
+        float eps = 1e-3);
+
 #if MEGDNN_WITH_BENCHMARK
 std::vector<TestArg> get_benchmark_matmul_args();
 std::vector<TestArg> get_benchmark_matmul_mk_packed_args(size_t nbase);
@@ -11,6 +11,7 @@
 #include "test/naive/rng.h"
 #include "megdnn/oprs.h"
 #include "test/common/tensor.h"
+#include "test/common/utils.h"
 #include "test/cuda/fixture.h"
 
 namespace megdnn {
@@ -193,6 +194,32 @@ void run_shuffle(Handle* handle, bool bwd_flag) {
     run({6, 3});
 }
 
+/*!
+ * run the cuda opr and the fallback opr with the same param twice, and check
+ * that they give the same Philox stream; \p eps covers the difference of the
+ * transcendental functions between cuda and libm
+ */
+template <typename Opr>
+void run_same_as_cpu(Handle* handle, const typename Opr::Param& param, float eps) {
+    auto cpu_handle = create_cpu_handle(1);
+    auto opr = handle->create_operator<Opr>();
+    auto cpu_opr = cpu_handle->create_operator<Opr>();
+    opr->param() = param;
+    cpu_opr->param() = param;
+    for (size_t size : {1, 6, 200001, 200001}) {
+        TensorLayout ly{{size}, dtype::Float32()};
+        SyncedTensor<> t(handle, ly);
+        std::vector<dt_float32> expect(size);
+        opr->exec(t.tensornd_dev(), {});
+        cpu_opr->exec({expect.data(), ly}, {});
+        auto ptr = t.ptr_mutable_host();
+        for (size_t i = 0; i < size; ++i) {
+            ASSERT_LE(std::abs(ptr[i] - expect[i]), eps * (1 + std::abs(expect[i])))
+                    << "size=" << size << " i=" << i;
+        }
+    }
+}
+
 }  // anonymous namespace
 
 TEST_F(CUDA, UNIFORM_RNG_F32) {
@@ -230,6 +257,20 @@ TEST_F(CUDA, GAUSSIAN_RNG_F32) {
     }
 }
 
+TEST_F(CUDA, UNIFORM_RNG_F32_SAME_AS_CPU) {
+    UniformRNG::Param param;
+    param.seed = 0x1234567890abcdefULL;
+    run_same_as_cpu<UniformRNG>(handle_cuda(), param, 1e-7);
+}
+
+TEST_F(CUDA, GAUSSIAN_RNG_F32_SAME_AS_CPU) {
+    GaussianRNG::Param param;
+    param.seed = 0x1234567890abcdefULL;
+    param.mean = 0.8;
+    param.std = 2.3;
+    run_same_as_cpu<GaussianRNG>(handle_cuda(), param, 1e-5);
+}
+
 TEST_F(CUDA, GAMMA_RNG_F32) {
     run_gamma<dtype::Float32>(handle_cuda());
 }
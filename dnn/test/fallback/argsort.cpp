@@ -0,0 +1,178 @@
+/**
+ * \file dnn/test/fallback/argsort.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test/fallback/fixture.h"
+
+#include "test/common/benchmarker.h"
+#include "test/common/checker.h"
+#include "test/common/rng.h"
+#include "test/common/task_record_check.h"
+#include "test/common/tensor.h"
+
+using namespace megdnn;
+using namespace test;
+
+namespace {
+class ArgsortRNG final : public RNG {
+    bool m_rev_order = false;
+    DType m_dtype;
+
+    template <typename T>
+    void fill(T* ptr, int n) {
+        if (m_rev_order) {
+            for (int i = 0; i < n; ++i)
+                ptr[i] = static_cast<T>(n / 2 - i);
+        } else {
+            for (int i = 0; i < n; ++i)
+                ptr[i] = static_cast<T>(i - n / 2);
+            COMPAT_RANDOM(ptr, ptr + n);
+        }
+    }
+
+    void gen(const TensorND& tensor) override {
+        auto n = tensor.layout.total_nr_elems();
+        if (m_dtype == dtype::Float32{}) {
+            fill(tensor.ptr<dt_float32>(), n);
+        } else {
+            megdnn_assert(m_dtype == dtype::Int32{});
+            fill(tensor.ptr<dt_int32>(), n);
+        }
+    }
+
+public:
+    ArgsortRNG(DType dt) : m_dtype{dt} {}
+
+    void set_rev_order(bool flag) { m_rev_order = flag; }
+};
+
+template <typename Checker>
+void run_forward_test(Checker& checker, DType dtype) {
+    using Param = Argsort::Param;
+    using Order = Param::Order;
+    ArgsortRNG rng{dtype};
+    checker.set_dtype(2, dtype::Int32());
+    checker.set_dtype(0, dtype).set_rng(0, &rng);
+    for (size_t i = 3; i < 10240; i *= 2) {
+        Param param;
+
+        param.order = Order::ASCENDING;
+        checker.set_param(param).execs({{3, i + 1}, {}, {}});
+        param.order = Order::DESCENDING;
+        checker.set_param(param).execs({{3, i - 1}, {}, {}});
+        checker.set_param(param).execs({{13, i + 3}, {}, {}});
+    }
+    {
+        // reverse sort large array
+        constexpr size_t N = 200003;
+        rng.set_rev_order(true);
+        Param param;
+        param.order = Order::ASCENDING;
+        checker.set_param(param).execs({{1, N}, {}, {}});
+    }
+}
+
+//! values with many duplicates; ties must be ordered as in the naive impl
+template <typename Checker>
+void run_forward_tie_test(Checker& checker, DType dtype) {
+    using Param = Argsort::Param;
+    using Order = Param::Order;
+    UniformIntRNG rng{-5, 5};
+    checker.set_dtype(2, dtype::Int32());
+    checker.set_dtype(0, dtype).set_rng(0, &rng);
+    for (auto order : {Order::ASCENDING, Order::DESCENDING}) {
+        Param param;
+        param.order = order;
+        for (size_t n : {7, 32, 33, 1000, 4099}) {
+            checker.set_param(param).execs({{5, n}, {}, {}});
+        }
+    }
+}
+
+//! an empty batch is valid input and must not split rows into zero tasks
+void run_forward_empty_test(Handle* handle) {
+    auto opr = handle->create_operator<ArgsortForward>();
+    float dummy[1];
+    int32_t dummy_idx[1];
+    for (auto order :
+         {Argsort::Param::Order::ASCENDING, Argsort::Param::Order::DESCENDING}) {
+        opr->param().order = order;
+        TensorLayout src{{0, 10}, dtype::Float32()}, dst, indices;
+        opr->deduce_layout(src, dst, indices);
+        std::vector<dt_byte> workspace(opr->get_workspace_in_bytes(src, dst, indices));
+        opr->exec(
+                {dummy, src}, {dummy, dst}, {dummy_idx, indices},
+                {workspace.data(), workspace.size()});
+    }
+}
+}  // anonymous namespace
+
+TEST_F(FALLBACK, ARGSORT_FORWARD) {
+    Checker<ArgsortForward> checker(handle());
+    for (auto dtype : {DType{dtype::Float32{}}, DType{dtype::Int32{}}}) {
+        run_forward_test(checker, dtype);
+        run_forward_tie_test(checker, dtype);
+    }
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, ARGSORT_FORWARD) {
+    Checker<ArgsortForward> checker(handle());
+    for (auto dtype : {DType{dtype::Float32{}}, DType{dtype::Int32{}}}) {
+        run_forward_test(checker, dtype);
+        run_forward_tie_test(checker, dtype);
+    }
+}
+
+TEST_F(FALLBACK, ARGSORT_FORWARD_EMPTY) {
+    run_forward_empty_test(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, ARGSORT_FORWARD_EMPTY) {
+    run_forward_empty_test(handle());
+}
+
+TEST_F(FALLBACK, ARGSORT_FORWARD_RECORD) {
+    TaskRecordChecker<ArgsortForward> checker(1);
+    run_forward_test(checker, dtype::Float32{});
+}
+
+#if MEGDNN_WITH_BENCHMARK
+namespace {
+void benchmark_argsort(Handle* handle) {
+    constexpr size_t RUNS = 10;
+    auto naive_handle = create_cpu_handle(2);
+    Benchmarker<ArgsortForward> bencher(handle), bencher_naive(naive_handle.get());
+    bencher.set_times(RUNS).set_display(false).set_dtype(2, dtype::Int32());
+    bencher_naive.set_times(RUNS).set_display(false).set_dtype(2, dtype::Int32());
+    auto run = [&](size_t m, size_t n) {
+        TensorShapeArray shapes{{m, n}, {}, {}};
+        auto t = bencher.execs(shapes) / RUNS,
+             t_naive = bencher_naive.execs(shapes) / RUNS;
+        printf("argsort m=%zu n=%zu: fallback=%.3fms naive=%.3fms speedup=%.2f\n", m,
+               n, t, t_naive, t_naive / t);
+    };
+    run(100000, 8);
+    run(100000, 32);
+    run(10000, 256);
+    run(1000, 2048);
+    run(16, 100000);
+    run(1, 1000000);
+}
+}  // namespace
+
+TEST_F(FALLBACK, BENCHMARK_ARGSORT) {
+    benchmark_argsort(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, BENCHMARK_ARGSORT) {
+    benchmark_argsort(handle());
+}
+#endif
+
+// vim: syntax=cpp.doxygen
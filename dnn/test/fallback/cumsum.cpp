@@ -0,0 +1,80 @@
+/**
+ * \file dnn/test/fallback/cumsum.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test/fallback/fixture.h"
+
+#include "megdnn/oprs.h"
+#include "test/common/checker.h"
+#include "test/common/task_record_check.h"
+
+namespace megdnn {
+namespace test {
+
+namespace {
+template <typename Checker>
+void run_cumsum_test(Checker& checker) {
+    struct TestArg {
+        param::Cumsum param;
+        TensorShape shape;
+        TestArg(param::Cumsum param, TensorShape shape) : param(param), shape(shape) {}
+    };
+    std::vector<TestArg> args;
+    for (auto shape : TensorShapeArray{
+                 {10000},
+                 {33000, 33},
+                 {100, 100, 100},
+                 {30, 30, 30, 30},
+                 {3, 300, 7}}) {
+        for (size_t axis = 0; axis < shape.ndim; ++axis) {
+            args.emplace_back(param::Cumsum(axis, true, true), shape);
+            args.emplace_back(param::Cumsum(axis, true, false), shape);
+            args.emplace_back(param::Cumsum(axis, false, true), shape);
+            args.emplace_back(param::Cumsum(axis, false, false), shape);
+        }
+    }
+    //! long axes use the two-pass blocked scan
+    for (auto shape :
+         TensorShapeArray{{1}, {15}, {16384}, {16385}, {100000}, {3, 50001}}) {
+        size_t axis = shape.ndim - 1;
+        args.emplace_back(param::Cumsum(axis, true, true), shape);
+        args.emplace_back(param::Cumsum(axis, true, false), shape);
+        args.emplace_back(param::Cumsum(axis, false, true), shape);
+        args.emplace_back(param::Cumsum(axis, false, false), shape);
+    }
+    UniformIntRNG rng{-3, 3};
+    checker.set_rng(0, &rng);
+    for (auto arg : args) {
+        checker.set_param(arg.param);
+        checker.set_epsilon(1e-2);
+        checker.set_dtype(0, dtype::Float32()).execs({{arg.shape}, {}});
+        checker.set_dtype(0, dtype::Int32()).execs({{arg.shape}, {}});
+    }
+}
+}  // namespace
+
+TEST_F(FALLBACK, CUMSUM) {
+    Checker<Cumsum> checker(handle());
+    run_cumsum_test(checker);
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, CUMSUM) {
+    Checker<Cumsum> checker(handle());
+    run_cumsum_test(checker);
+}
+
+TEST_F(FALLBACK, CUMSUM_RECORD) {
+    TaskRecordChecker<Cumsum> checker(1);
+    run_cumsum_test(checker);
+}
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -38,6 +38,64 @@ TEST_F(FALLBACK, ELEMWISE_RECORD) {
     checker.set_rng(2, &rng);
     checker.execs({{10, 10, 32}, {10, 10, 32}, {}});
 }
+
+namespace {
+void run_broadcast_patterns(Handle* handle) {
+    using Mode = Elemwise::Mode;
+    Checker<Elemwise> checker(handle);
+    UniformFloatRNG rng{-3.f, 3.f};
+    for (int i = 0; i < 3; ++i) {
+        checker.set_rng(i, &rng);
+    }
+    //! binary: nhwc channel, nchw channel, multi-axis and strided operands
+    for (auto mode : {Mode::ADD, Mode::SUB, Mode::FUSE_ADD_RELU, Mode::MAX}) {
+        checker.set_param(mode);
+        checker.execs({{2, 7, 9, 24}, {1, 1, 1, 24}, {}});
+        checker.execs({{1, 1, 1, 24}, {2, 7, 9, 24}, {}});
+        checker.execs({{2, 24, 7, 9}, {1, 24, 1, 1}, {}});
+        checker.execs({{8, 1, 6, 1}, {1, 7, 1, 5}, {}});
+        checker.execs({{3, 1, 5, 1, 2}, {3, 4, 1, 6, 2}, {}});
+        checker.execs({{1}, {130, 257}, {}});
+        checker.execs({{130, 257}, {130, 257}, {}});
+        checker.execl(
+                {{{5, 6, 7}, {84, 7, 1}, dtype::Float32()},
+                 {{5, 6, 7}, {1, 35, 5}, dtype::Float32()},
+                 {{5, 6, 7}, dtype::Float32()}});
+    }
+    //! ternary with two broadcast operands
+    for (auto mode : {Mode::FUSE_MUL_ADD3, Mode::COND_LEQ_MOV}) {
+        checker.set_param(mode);
+        checker.execs({{2, 16, 9, 9}, {1, 16, 1, 1}, {1, 16, 1, 1}, {}});
+        checker.execs({{2, 9, 9, 16}, {1, 1, 1, 16}, {1, 1, 1, 16}, {}});
+        checker.execs({{2, 9, 9, 16}, {1}, {2, 9, 9, 16}, {}});
+        checker.execs({{1, 9, 1, 16}, {2, 1, 9, 1}, {2, 9, 9, 16}, {}});
+    }
+    //! integer operands
+    UniformIntRNG int_rng{-100, 100};
+    checker.set_param(Mode::FUSE_MUL_ADD3);
+    for (auto dtype : std::vector<DType>{dtype::Int32(), dtype::Int16()}) {
+        for (int i = 0; i < 3; ++i) {
+            checker.set_dtype(i, dtype).set_rng(i, &int_rng);
+        }
+        checker.execs({{2, 9, 9, 16}, {1, 1, 1, 16}, {2, 9, 9, 1}, {}});
+    }
+}
+}  // namespace
+
+TEST_F(FALLBACK, ELEMWISE_BROADCAST_PATTERNS) {
+    run_broadcast_patterns(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, ELEMWISE_BROADCAST_PATTERNS) {
+    run_broadcast_patterns(handle());
+    //! large enough to be split into tasks
+    Checker<Elemwise> checker(handle());
+    checker.set_param(Elemwise::Mode::FUSE_MUL_ADD3);
+    checker.execs({{4, 67, 71, 16}, {1, 1, 1, 16}, {4, 1, 71, 16}, {}});
+    checker.set_param(Elemwise::Mode::SUB);
+    checker.execs({{4, 16, 67, 71}, {1, 16, 1, 71}, {}});
+}
+
 #if MEGDNN_WITH_BENCHMARK
 TEST_F(FALLBACK, BENCHMARK_ELEMWISE) {
     auto naive_handle = create_cpu_handle(2);
@@ -78,7 +136,9 @@ TEST_F(FALLBACK, BENCHMARK_ELEMWISE) {
     // bcast 10
     run({4096 * 4, 1024}, {1, 1024});
 
-    // non-contig, fallback to naive
+    // bcast nhwc channel
+    run({64, 56, 56, 64}, {1, 1, 1, 64});
+    // multi-axis bcast
     run({1024, 1024, 32}, {1024, 1, 32});
 }
 #endif
@@ -0,0 +1,78 @@
+/**
+ * \file dnn/test/fallback/image_preprocess.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test/fallback/fixture.h"
+
+#include "test/common/benchmarker.h"
+#include "test/common/image_preprocess.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(FALLBACK, IMAGE_PREPROCESS) {
+    image_preprocess::run_image_preprocess_test(handle(), false);
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, IMAGE_PREPROCESS) {
+    image_preprocess::run_image_preprocess_test(handle(), false);
+}
+
+#if MEGDNN_WITH_BENCHMARK
+TEST_F(FALLBACK_MULTI_THREADS, BENCHMARK_IMAGE_PREPROCESS) {
+    constexpr size_t RUNS = 10;
+    ImagePreprocess::Param param;
+    param.color_mode = ImagePreprocess::Param::ColorMode::SWAP_RB;
+    param.out_h = param.out_w = 224;
+    Benchmarker<ImagePreprocess> bencher(handle());
+    bencher.set_times(RUNS)
+            .set_display(false)
+            .set_dtype(0, dtype::Uint8())
+            .set_param(param);
+
+    param::Resize resize_param;
+    resize_param.format = param::Resize::Format::NHWC;
+    Benchmarker<Resize> bencher_resize(handle());
+    Benchmarker<CvtColor> bencher_cvt(handle());
+    Benchmarker<TypeCvt> bencher_typecvt(handle());
+    Benchmarker<Relayout> bencher_relayout(handle());
+    Benchmarker<ElemwiseForward> bencher_elemwise(handle());
+    bencher_resize.set_times(RUNS).set_display(false).set_param(resize_param);
+    bencher_resize.set_dtype(0, dtype::Uint8()).set_dtype(1, dtype::Uint8());
+    bencher_cvt.set_times(RUNS).set_display(false).set_dtype(0, dtype::Uint8());
+    bencher_cvt.set_param({param::CvtColor::Mode::BGR2RGB});
+    bencher_typecvt.set_times(RUNS).set_display(false).set_dtype(0, dtype::Uint8());
+    bencher_typecvt.set_dtype(1, dtype::Float32());
+    bencher_relayout.set_times(RUNS).set_display(false);
+    bencher_elemwise.set_times(RUNS).set_display(false).set_param(
+            {param::Elemwise::Mode::FUSE_MUL_ADD3});
+    auto run = [&](size_t N, size_t IH, size_t IW) {
+        size_t OH = param.out_h, OW = param.out_w;
+        auto t = bencher.execs({{N, IH, IW, 3}, {3}, {3}, {}}) / RUNS;
+        auto t_chain =
+                bencher_resize.execs({{N, IH, IW, 3}, {N, OH, OW, 3}}) +
+                bencher_cvt.execs({{N, OH, OW, 3}, {}}) +
+                bencher_typecvt.execs({{N, OH, OW, 3}, {N, OH, OW, 3}});
+        TensorLayout nhwc{{N, OH, OW, 3}, dtype::Float32()};
+        t_chain += bencher_relayout.execl(
+                {nhwc.dimshuffle({0, 3, 1, 2}), {{N, 3, OH, OW}, dtype::Float32()}});
+        t_chain += bencher_elemwise.execs(
+                {{N, 3, OH, OW}, {1, 3, 1, 1}, {1, 3, 1, 1}, {}});
+        t_chain /= RUNS;
+        printf("image_preprocess N=%zu %zux%zu->%zux%zu: fused=%.3fms "
+               "separate=%.3fms speedup=%.2f\n",
+               N, IH, IW, OH, OW, t, t_chain, t_chain / t);
+    };
+    run(1, 1080, 1920);
+    run(1, 480, 640);
+    run(8, 256, 256);
+}
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,193 @@
+/**
+ * \file dnn/test/fallback/indexing_multi_axis_vec.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test/fallback/fixture.h"
+
+#include "megdnn/oprs.h"
+#include "test/common/benchmarker.h"
+#include "test/common/checker.h"
+#include "test/common/index.h"
+#include "test/common/indexing_multi_axis_vec.h"
+#include "test/common/task_record_check.h"
+
+namespace megdnn {
+namespace test {
+
+namespace {
+template <class Opr, typename Checker>
+void run_indexing_test(Checker& checker) {
+    size_t idx_size0, idx_size1;
+    UniformIntRNG rng_inp{-100, 100};
+    IndexRNG rng0{idx_size0, 2}, rng1{idx_size1, 3};
+    checker.set_dtype(0, dtype::Float32())
+            .set_dtype(1, dtype::Float32())
+            .set_dtype(2, dtype::Int32())
+            .set_dtype(3, dtype::Int32())
+            .set_rng(0, &rng_inp)
+            .set_rng(1, &rng_inp)
+            .set_rng(2, &rng0)
+            .set_rng(3, &rng1);
+
+    // gather rows of embedding tables; rows are duplicated
+    idx_size0 = 23;
+    checker.set_proxy({{0}})
+            .execs({{23}, {100}, {100}})
+            .execs({{23, 5}, {100, 5}, {100}})
+            .execs({{23, 1000}, {100, 1000}, {100}})
+            .execs({{23, 3, 4}, {5000, 3, 4}, {5000}});
+
+    // index on inner axes
+    idx_size0 = 2;
+    idx_size1 = 3;
+    checker.set_proxy({{0, 1}})
+            .execs({{2, 3}, {10}, {10}, {10}})
+            .execs({{2, 3, 5}, {10, 5}, {10}, {10}})
+            .execs({{2, 3, 5}, {10, 5}, {1}, {10}});
+    idx_size0 = 4;
+    idx_size1 = 5;
+    checker.set_proxy({{2, 3}})
+            .execs({{2, 3, 4, 5, 6, 7}, {2, 3, 10, 6, 7}, {10}, {10}})
+            .execs({{20, 30, 4, 5}, {20, 30, 100}, {100}, {100}});
+    idx_size0 = 4;
+    checker.set_proxy({{1}}).execs({{1, 4}, {1, 100000}, {100000}});
+
+    // non-contiguous data
+    idx_size0 = 4;
+    idx_size1 = 6;
+    TensorLayout inp_layout{{3, 4, 5, 6}, dtype::Float32()};
+    inp_layout.stride[0] *= 8;
+    inp_layout.stride[1] *= 2;
+    checker.set_proxy({{1, 3}}).execl({
+            inp_layout,
+            {{7, 3, 5}, dtype::Float32()},
+            {{7}, dtype::Int32()},
+            {{1}, dtype::Int32()},
+    });
+    checker.set_proxy({{1}}).execl({
+            inp_layout,
+            {{3, 700, 5, 6}, dtype::Float32()},
+            {{700}, dtype::Int32()},
+    });
+
+    // index with negative stride
+    idx_size0 = 20;
+    checker.set_proxy({{0}}).execl(
+            {TensorLayout{{20, 3}, dtype::Float32()},
+             TensorLayout{{9, 3}, dtype::Float32()},
+             TensorLayout{TensorShape{9}, {-1}, dtype::Int32()}});
+
+    // multi-dim index goes to the naive impl
+    idx_size0 = 5;
+    checker.set_proxy({{1}}).execs({{3, 5, 7}, {3, 4, 6, 7}, {4, 6}});
+
+    if (std::is_same<Opr, IndexingIncrMultiAxisVec>::value) {
+        idx_size0 = 4;
+        TensorLayout val_layout{{23}, dtype::Float32()};
+        val_layout.stride[0] = 0;
+        checker.set_proxy({{0}}).execl(
+                {{{4}, dtype::Float32()}, val_layout, {{23}, dtype::Int32()}});
+    }
+
+    // other dtypes
+    idx_size0 = 100;
+    checker.set_dtype(0, dtype::Int32())
+            .set_dtype(1, dtype::Int32())
+            .set_proxy({{0}})
+            .execs({{100, 16}, {3000, 16}, {3000}});
+    checker.set_dtype(0, dtype::Int8())
+            .set_dtype(1, dtype::Int8())
+            .execs({{100, 3}, {3000, 3}, {3000}});
+}
+
+template <class Opr>
+void run_indexing_test(Handle* handle) {
+    Checker<Opr> checker(handle);
+    run_indexing_test<Opr>(checker);
+}
+}  // namespace
+
+TEST_F(FALLBACK, INDEXING_MULTI_AXIS_VEC) {
+    run_indexing_test<IndexingMultiAxisVec>(handle());
+}
+
+TEST_F(FALLBACK, INDEXING_SET_MULTI_AXIS_VEC) {
+    run_indexing_test<IndexingSetMultiAxisVec>(handle());
+}
+
+TEST_F(FALLBACK, INDEXING_INCR_MULTI_AXIS_VEC) {
+    run_indexing_test<IndexingIncrMultiAxisVec>(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, INDEXING_MULTI_AXIS_VEC) {
+    run_indexing_test<IndexingMultiAxisVec>(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, INDEXING_SET_MULTI_AXIS_VEC) {
+    run_indexing_test<IndexingSetMultiAxisVec>(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, INDEXING_INCR_MULTI_AXIS_VEC) {
+    run_indexing_test<IndexingIncrMultiAxisVec>(handle());
+}
+
+TEST_F(FALLBACK, INDEXING_INCR_MULTI_AXIS_VEC_RECORD) {
+    TaskRecordChecker<IndexingIncrMultiAxisVec> checker(1);
+    run_indexing_test<IndexingIncrMultiAxisVec>(checker);
+}
+
+#if MEGDNN_WITH_BENCHMARK
+namespace {
+template <class Opr>
+void benchmark_embedding(Handle* handle, const char* name) {
+    constexpr size_t RUNS = 10;
+    auto naive_handle = create_cpu_handle(2);
+    auto run = [&](size_t nr_rows, size_t dim, size_t nr_idx) {
+        size_t idx_size = nr_rows;
+        IndexRNG rng{idx_size, 0};
+        Benchmarker<Opr> bencher(handle), bencher_naive(naive_handle.get());
+        std::unique_ptr<OprProxy<Opr>> proxy{new OprProxy<Opr>{{0}}},
+                proxy_naive{new OprProxy<Opr>{{0}}};
+        for (auto b : {&bencher, &bencher_naive}) {
+            b->set_dtype(2, dtype::Int32()).set_rng(2, &rng);
+            b->set_times(RUNS).set_display(false);
+        }
+        bencher.set_proxy(proxy);
+        bencher_naive.set_proxy(proxy_naive);
+        TensorShapeArray shapes{{nr_rows, dim}, {nr_idx, dim}, {nr_idx}};
+        auto t = bencher.execs(shapes) / RUNS,
+             t_naive = bencher_naive.execs(shapes) / RUNS;
+        printf("%s table=(%zu, %zu) nr_idx=%zu: fallback=%.3fms naive=%.3fms "
+               "speedup=%.2f bandwidth=%.2fGB/s\n",
+               name, nr_rows, dim, nr_idx, t, t_naive, t_naive / t,
+               nr_idx * dim * sizeof(float) / t / 1e6);
+    };
+    run(100000, 64, 4096);
+    run(100000, 128, 16384);
+    run(1000000, 16, 65536);
+    run(30000, 1024, 512);
+    run(1000, 4, 100000);
+}
+}  // namespace
+
+TEST_F(FALLBACK, BENCHMARK_INDEXING_MULTI_AXIS_VEC) {
+    benchmark_embedding<IndexingMultiAxisVec>(handle(), "gather");
+    benchmark_embedding<IndexingIncrMultiAxisVec>(handle(), "scatter_add");
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, BENCHMARK_INDEXING_MULTI_AXIS_VEC) {
+    benchmark_embedding<IndexingMultiAxisVec>(handle(), "gather");
+    benchmark_embedding<IndexingIncrMultiAxisVec>(handle(), "scatter_add");
+}
+#endif
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
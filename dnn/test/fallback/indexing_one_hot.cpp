@@ -0,0 +1,98 @@
+/**
+ * \file dnn/test/fallback/indexing_one_hot.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test/fallback/fixture.h"
+
+#include "megdnn/oprs.h"
+#include "test/common/benchmarker.h"
+#include "test/common/checker.h"
+#include "test/common/indexing_one_hot.h"
+
+namespace megdnn {
+namespace test {
+
+namespace {
+template <class Opr>
+void run_one_hot_test(Handle* handle) {
+    Checker<Opr> checker(handle);
+    for (auto dtype : std::vector<DType>{dtype::Float32(), dtype::Int16()}) {
+        checker.set_dtype(0, dtype).set_dtype(1, dtype::Int32()).set_dtype(2, dtype);
+        // classification losses, where index is the label of each sample
+        UniformIntRNG rng_idx{0, 999};
+        checker.set_param({1}).set_rng(1, &rng_idx);
+        checker.execs({{256, 1000}, {256}, {256, 1}});
+        checker.execs({{3, 1000, 5}, {3, 5}, {3, 1, 5}});
+        checker.execs({{16, 1000, 1024}, {16, 1024}, {16, 1, 1024}});
+        rng_idx = {0, 7};
+        checker.set_param({0}).execs({{8, 3000}, {3000}, {1, 3000}});
+        checker.set_param({2}).execs({{10, 4, 8, 9}, {10, 4, 9}, {10, 4, 1, 9}});
+    }
+}
+}  // namespace
+
+TEST_F(FALLBACK, INDEXING_ONE_HOT) {
+    run_indexing_one_hot_test(handle());
+    run_one_hot_test<IndexingOneHot>(handle());
+}
+
+TEST_F(FALLBACK, INDEXING_SET_ONE_HOT) {
+    run_indexing_set_one_hot_test(handle());
+    run_one_hot_test<IndexingSetOneHot>(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, INDEXING_ONE_HOT) {
+    run_indexing_one_hot_test(handle());
+    run_one_hot_test<IndexingOneHot>(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, INDEXING_SET_ONE_HOT) {
+    run_indexing_set_one_hot_test(handle());
+    run_one_hot_test<IndexingSetOneHot>(handle());
+}
+
+#if MEGDNN_WITH_BENCHMARK
+namespace {
+void benchmark_one_hot(Handle* handle) {
+    constexpr size_t RUNS = 10;
+    auto naive_handle = create_cpu_handle(2);
+    auto run = [&](size_t A, size_t M, size_t C) {
+        UniformIntRNG rng_idx{0, static_cast<int>(M) - 1};
+        Benchmarker<IndexingOneHot> bencher(handle), bencher_naive(naive_handle.get());
+        for (auto b : {&bencher, &bencher_naive}) {
+            b->set_param({1}).set_dtype(1, dtype::Int32()).set_rng(1, &rng_idx);
+            b->set_times(RUNS).set_display(false);
+        }
+        TensorShapeArray shapes{{A, M, C}, {A, C}, {}};
+        auto t = bencher.execs(shapes) / RUNS,
+             t_naive = bencher_naive.execs(shapes) / RUNS;
+        printf("one_hot A=%zu M=%zu C=%zu: fallback=%.3fms naive=%.3fms "
+               "speedup=%.2f\n",
+               A, M, C, t, t_naive, t_naive / t);
+    };
+    run(4096, 1000, 1);
+    run(256, 30000, 1);
+    run(32, 100, 1024);
+    run(4, 21, 256 * 256);
+}
+}  // namespace
+
+TEST_F(FALLBACK, BENCHMARK_INDEXING_ONE_HOT) {
+    benchmark_one_hot(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, BENCHMARK_INDEXING_ONE_HOT) {
+    benchmark_one_hot(handle());
+}
+#endif
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -93,6 +93,14 @@ TEST_F(FALLBACK, MATRIX_MUL_NAIVE_MK4_DOT) {
             param::MatrixMul::Format::MK4_DOT, 1);
 }
 
+TEST_F(FALLBACK, MATRIX_MUL_F32_W4_G32) {
+    matrix_mul::check_matrix_mul_w4_g32(handle(), "FB_F32_W4_G32");
+}
+
+TEST_F(FALLBACK, MATRIX_MUL_F32_BSR_8X1) {
+    matrix_mul::check_matrix_mul_bsr_8x1(handle(), "FB_F32_BSR_8X1");
+}
+
 TEST_F(FALLBACK, MATRIX_MUL_NAIVE) {
     Checker<MatrixMul> checker(handle());
     checker.set_before_exec_callback(AlgoChecker<MatrixMul>("FB_NAIVE"));
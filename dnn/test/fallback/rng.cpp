@@ -0,0 +1,229 @@
+/**
+ * \file dnn/test/fallback/rng.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test/fallback/fixture.h"
+
+#include "megdnn/oprs.h"
+#include "test/common/tensor.h"
+#include "test/common/timer.h"
+#include "test/common/utils.h"
+#include "test/naive/rng.h"
+
+namespace megdnn {
+namespace test {
+
+namespace {
+
+//! run the opr on \p handle twice with the given seed and return the results
+template <class Opr, class Init>
+std::vector<std::vector<float>> run_rng(
+        Handle* handle, uint64_t seed, size_t size, Init init) {
+    auto opr = handle->create_operator<Opr>();
+    init(opr->param());
+    opr->param().seed = seed;
+    std::vector<std::vector<float>> ret;
+    for (int i = 0; i < 2; ++i) {
+        Tensor<float> t(handle, {TensorShape{size}, dtype::Float32()});
+        opr->exec(t.tensornd(), {});
+        ret.emplace_back(t.ptr(), t.ptr() + size);
+    }
+    return ret;
+}
+
+/*!
+ * \brief check the statistics, and that the results are reproducible and do not
+ *      depend on the handle, i.e. the number of threads or the SIMD kernels
+ */
+template <class Opr, class Init, class CheckStat>
+void check_rng(Handle* handle, Init init, CheckStat check_stat) {
+    auto single_thread_handle = create_cpu_handle(1);
+    for (size_t size : {1, 7, 33, 16384 * 4 + 5, 200001}) {
+        for (uint64_t seed : {0, 2333}) {
+            auto res = run_rng<Opr>(handle, seed, size, init),
+                 expect = run_rng<Opr>(single_thread_handle.get(), seed, size, init);
+            ASSERT_EQ(expect, res) << "size=" << size << " seed=" << seed;
+            if (size > 100000) {
+                check_stat(res[0].data(), size);
+                check_stat(res[1].data(), size);
+                ASSERT_NE(res[0], res[1]);
+            }
+        }
+    }
+}
+
+void run_uniform(Handle* handle) {
+    check_rng<UniformRNG>(
+            handle, [](param::UniformRNG&) {},
+            [](const float* ptr, size_t size) {
+                assert_uniform_correct(ptr, size);
+            });
+}
+
+void run_gaussian(Handle* handle) {
+    check_rng<GaussianRNG>(
+            handle,
+            [](param::GaussianRNG& p) {
+                p.mean = 0.8;
+                p.std = 2.3;
+            },
+            [](const float* ptr, size_t size) {
+                for (size_t i = 0; i < size; ++i) {
+                    ASSERT_LE(std::abs(ptr[i] - 0.8), 15.f);
+                }
+                auto stat = get_mean_var(ptr, size, 0.8f);
+                ASSERT_LE(std::abs(stat.first - 0.8), 1e-2);
+                ASSERT_LE(std::abs(stat.second - 2.3 * 2.3), 5e-2);
+            });
+}
+
+void run_gamma(Handle* handle) {
+    constexpr size_t N = 200000;
+    auto opr = handle->create_operator<GammaRNG>();
+    TensorLayout ly{TensorShape{N * 5}, dtype::Float32()};
+    Tensor<float> out(handle, ly), shape(handle, ly), scale(handle, ly);
+    for (size_t i = 0; i < 5; ++i) {
+        std::fill_n(shape.ptr() + i * N, N, 2 * 0.3f * i + 0.5f);
+        std::fill_n(scale.ptr() + i * N, N, i * 0.2f + 0.1f);
+    }
+    opr->exec(shape.tensornd(), scale.tensornd(), out.tensornd(), {});
+    for (size_t i = 0; i < 5; ++i) {
+        float a = 2 * 0.3f * i + 0.5f, b = i * 0.2f + 0.1f;
+        auto stat = get_mean_var(out.ptr() + i * N, N, a * b);
+        ASSERT_LE(std::abs(stat.first - a * b), 0.01);
+        ASSERT_LE(std::abs(stat.second - a * b * b), 0.01);
+    }
+}
+
+void run_poisson(Handle* handle) {
+    constexpr size_t N = 200000;
+    auto opr = handle->create_operator<PoissonRNG>();
+    TensorLayout ly{TensorShape{N * 5}, dtype::Float32()};
+    Tensor<float> out(handle, ly), lam(handle, ly);
+    for (size_t i = 0; i < 5; ++i) {
+        std::fill_n(lam.ptr() + i * N, N, float(i + 1));
+    }
+    opr->exec(lam.tensornd(), out.tensornd(), {});
+    for (size_t i = 0; i < 5; ++i) {
+        auto stat = get_mean_var(out.ptr() + i * N, N, float(i + 1));
+        ASSERT_LE(std::abs(stat.first - (i + 1)), 0.01);
+        ASSERT_LE(std::abs(stat.second - (i + 1)), 0.05);
+    }
+}
+
+void run_beta(Handle* handle) {
+    constexpr size_t N = 200000;
+    auto opr = handle->create_operator<BetaRNG>();
+    TensorLayout ly{TensorShape{N * 5}, dtype::Float32()};
+    Tensor<float> out(handle, ly), alpha(handle, ly), beta(handle, ly);
+    for (size_t i = 0; i < 5; ++i) {
+        std::fill_n(alpha.ptr() + i * N, N, 0.3f * i + 0.1f);
+        std::fill_n(beta.ptr() + i * N, N, 2 * i * 0.3f + 0.1f);
+    }
+    opr->exec(alpha.tensornd(), beta.tensornd(), out.tensornd(), {});
+    for (size_t i = 0; i < 5; ++i) {
+        float a = 0.3f * i + 0.1f, b = 2 * i * 0.3f + 0.1f;
+        float mean = a / (a + b), var = a * b / ((a + b) * (a + b) * (a + b + 1));
+        auto stat = get_mean_var(out.ptr() + i * N, N, mean);
+        ASSERT_LE(std::abs(stat.first - mean), 0.01);
+        ASSERT_LE(std::abs(stat.second - var), 0.01);
+    }
+}
+
+}  // namespace
+
+TEST_F(FALLBACK, UNIFORM_RNG) {
+    run_uniform(handle());
+}
+
+TEST_F(FALLBACK, GAUSSIAN_RNG) {
+    run_gaussian(handle());
+}
+
+TEST_F(FALLBACK, GAMMA_RNG) {
+    run_gamma(handle());
+}
+
+TEST_F(FALLBACK, POISSON_RNG) {
+    run_poisson(handle());
+}
+
+TEST_F(FALLBACK, BETA_RNG) {
+    run_beta(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, UNIFORM_RNG) {
+    run_uniform(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, GAUSSIAN_RNG) {
+    run_gaussian(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, GAMMA_RNG) {
+    run_gamma(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, POISSON_RNG) {
+    run_poisson(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, BETA_RNG) {
+    run_beta(handle());
+}
+
+#if MEGDNN_WITH_BENCHMARK
+namespace {
+void benchmark_rng(Handle* handle) {
+    constexpr size_t RUNS = 10;
+    auto naive_handle = create_cpu_handle(2);
+    //! the RNG oprs can not be run by Benchmarker, which deduces the layouts
+    auto time_ms = [&](Handle* h, auto&& opr_creator, size_t size) {
+        auto opr = opr_creator(h);
+        Tensor<float> t(h, {TensorShape{size}, dtype::Float32()});
+        opr->exec(t.tensornd(), {});
+        Timer timer;
+        timer.start();
+        for (size_t i = 0; i < RUNS; ++i) {
+            opr->exec(t.tensornd(), {});
+        }
+        timer.stop();
+        return timer.get_time_in_us() / 1e3 / RUNS;
+    };
+    auto uniform = [](Handle* h) { return h->create_operator<UniformRNG>(); };
+    auto gaussian = [](Handle* h) { return h->create_operator<GaussianRNG>(); };
+    auto run = [&](size_t size) {
+        auto t_u = time_ms(handle, uniform, size),
+             t_u_naive = time_ms(naive_handle.get(), uniform, size),
+             t_g = time_ms(handle, gaussian, size),
+             t_g_naive = time_ms(naive_handle.get(), gaussian, size);
+        printf("rng size=%zu: uniform=%.3fms(naive %.3fms, speedup=%.2f) "
+               "gaussian=%.3fms(naive %.3fms, speedup=%.2f)\n",
+               size, t_u, t_u_naive, t_u_naive / t_u, t_g, t_g_naive,
+               t_g_naive / t_g);
+    };
+    run(10000);
+    run(1000000);
+    run(16000000);
+}
+}  // namespace
+
+TEST_F(FALLBACK, BENCHMARK_RNG) {
+    benchmark_rng(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, BENCHMARK_RNG) {
+    benchmark_rng(handle());
+}
+#endif
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,163 @@
+/**
+ * \file dnn/test/fallback/topk.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "test/common/topk.h"
+#include "test/common/benchmarker.h"
+#include "test/common/checker.h"
+#include "test/common/tensor.h"
+#include "test/fallback/fixture.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+using namespace megdnn;
+using namespace test;
+
+namespace {
+//! rows with many equal values must select the same indices on every path
+void run_topk_tie_test(Handle* handle) {
+    auto opr = handle->create_operator<TopK>();
+    opr->param().mode = TopK::Param::Mode::VALUE_IDX_SORTED;
+    std::mt19937 rng{23};
+    // (n, |k|) handled by heap select, radix select and nth_element
+    std::pair<size_t, int> cases[] = {{8192, 64}, {8192, 200}, {2048, 200}};
+    for (auto&& c : cases) {
+        for (int k : {c.second, -c.second}) {
+            size_t n = c.first, kk = c.second;
+            Tensor<float> data(handle, {TensorShape{1, n}, dtype::Float32()}),
+                    values(handle, {TensorShape{1, kk}, dtype::Float32()});
+            Tensor<dt_int32> indices(handle, {TensorShape{1, kk}, dtype::Int32()});
+            for (size_t i = 0; i < n; ++i) {
+                data.ptr()[i] = static_cast<float>(rng() % 4);
+            }
+            std::vector<dt_byte> workspace(opr->get_workspace_in_bytes(
+                    k, data.layout(), values.layout(), indices.layout()));
+            opr->exec(
+                    k, data.tensornd(), values.tensornd(), indices.tensornd(),
+                    {workspace.data(), workspace.size()});
+
+            // order by value and then by index; both are reversed for k < 0
+            std::vector<int> expect(n);
+            std::iota(expect.begin(), expect.end(), 0);
+            auto ptr = data.ptr();
+            std::sort(expect.begin(), expect.end(), [&](int a, int b) {
+                auto ka = std::make_pair(ptr[a], a), kb = std::make_pair(ptr[b], b);
+                return k > 0 ? ka < kb : kb < ka;
+            });
+            for (size_t i = 0; i < kk; ++i) {
+                ASSERT_EQ(expect[i], indices.ptr()[i])
+                        << "n=" << n << " k=" << k << " i=" << i;
+                ASSERT_EQ(ptr[expect[i]], values.ptr()[i]);
+            }
+        }
+    }
+}
+
+//! an empty batch is valid input and must not split rows into zero tasks
+void run_topk_empty_test(Handle* handle) {
+    auto opr = handle->create_operator<TopK>();
+    float dummy[1];
+    int32_t dummy_idx[1];
+    for (auto mode :
+         {TopK::Param::Mode::KTH_ONLY, TopK::Param::Mode::VALUE_IDX_NOSORT,
+          TopK::Param::Mode::VALUE_IDX_SORTED}) {
+        opr->param().mode = mode;
+        for (int k : {3, -3}) {
+            TensorLayout data{{0, 10}, dtype::Float32()}, values, indices;
+            opr->deduce_layout(k, data, values, indices);
+            std::vector<dt_byte> workspace(
+                    opr->get_workspace_in_bytes(k, data, values, indices));
+            opr->exec(
+                    k, {dummy, data}, {dummy, values},
+                    {mode == TopK::Param::Mode::KTH_ONLY ? nullptr : dummy_idx,
+                     indices},
+                    {workspace.data(), workspace.size()});
+        }
+    }
+}
+}  // namespace
+
+TEST_F(FALLBACK, TOP_K) {
+    run_topk_test<dtype::Float32>(handle());
+}
+TEST_F(FALLBACK, TOP_K_I32) {
+    run_topk_test<dtype::Int32>(handle());
+}
+TEST_F(FALLBACK, TOP_K_TIE) {
+    run_topk_tie_test(handle());
+}
+TEST_F(FALLBACK_MULTI_THREADS, TOP_K) {
+    run_topk_test<dtype::Float32>(handle());
+}
+TEST_F(FALLBACK_MULTI_THREADS, TOP_K_I32) {
+    run_topk_test<dtype::Int32>(handle());
+}
+TEST_F(FALLBACK_MULTI_THREADS, TOP_K_TIE) {
+    run_topk_tie_test(handle());
+}
+TEST_F(FALLBACK, TOP_K_EMPTY) {
+    run_topk_empty_test(handle());
+}
+TEST_F(FALLBACK_MULTI_THREADS, TOP_K_EMPTY) {
+    run_topk_empty_test(handle());
+}
+
+#if MEGDNN_WITH_BENCHMARK
+namespace {
+void benchmark_topk(Handle* handle) {
+    using Mode = TopK::Param::Mode;
+    constexpr size_t RUNS = 10;
+    auto naive_handle = create_cpu_handle(2);
+    auto run = [&](int k, size_t m, size_t n, Mode mode) {
+        Benchmarker<TopK> bencher(handle), bencher_naive(naive_handle.get());
+        std::unique_ptr<OprProxy<TopK>> proxy{new OprProxy<TopK>{k}},
+                proxy_naive{new OprProxy<TopK>{k}};
+        bencher.set_proxy(proxy).set_param(mode).set_times(RUNS).set_display(false);
+        bencher_naive.set_proxy(proxy_naive)
+                .set_param(mode)
+                .set_times(RUNS)
+                .set_display(false);
+        TensorShapeArray shapes{{m, n}, {}};
+        if (mode != Mode::KTH_ONLY) {
+            shapes.push_back({});
+        }
+        auto t = bencher.execs(shapes) / RUNS,
+             t_naive = bencher_naive.execs(shapes) / RUNS;
+        printf("topk m=%zu n=%zu k=%d mode=%d: fallback=%.3fms naive=%.3fms "
+               "speedup=%.2f\n",
+               m, n, k, static_cast<int>(mode), t, t_naive, t_naive / t);
+    };
+    for (auto mode : {Mode::KTH_ONLY, Mode::VALUE_IDX_NOSORT, Mode::VALUE_IDX_SORTED}) {
+        // short rows
+        run(5, 100000, 16, mode);
+        // small k/N ratio, e.g. beam search and detection post-processing
+        run(1, 1000, 1000, mode);
+        run(-10, 1000, 1000, mode);
+        run(-100, 32, 100000, mode);
+        // large k/N ratio
+        run(500, 1000, 1000, mode);
+        run(-50000, 32, 100000, mode);
+        run(-1000, 4, 1000000, mode);
+    }
+}
+}  // namespace
+
+TEST_F(FALLBACK, BENCHMARK_TOP_K) {
+    benchmark_topk(handle());
+}
+
+TEST_F(FALLBACK_MULTI_THREADS, BENCHMARK_TOP_K) {
+    benchmark_topk(handle());
+}
+#endif
+
+// vim: syntax=cpp.doxygen
@@ -0,0 +1,109 @@
+/**
+ * \file dnn/test/x86/batched_matrix_mul.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test/x86/fixture.h"
+
+#include "src/x86/utils.h"
+#include "test/common/benchmarker.h"
+#include "test/common/checker.h"
+#include "test/common/matrix_mul.h"
+
+using namespace megdnn;
+using namespace test;
+
+namespace {
+std::vector<matrix_mul::TestArg> get_f32_args() {
+    auto args = matrix_mul::get_batched_matmul_args();
+    for (auto&& arg : matrix_mul::get_batched_matmul_broadcast_args()) {
+        args.emplace_back(arg);
+    }
+    for (size_t mask = 0; mask < 4; ++mask) {
+        //! B shared by all the batches, which is only packed once
+        for (auto arg : matrix_mul::get_batched_matmul_args_mask(mask)) {
+            arg.B_batch_stride = 0;
+            args.emplace_back(arg);
+        }
+        //! attention-like shapes and tails of the micro kernels
+        for (size_t b : {1, 7, 16}) {
+            for (auto arg : std::vector<matrix_mul::TestArg>{
+                         {128, 128, 64, mask},
+                         {128, 64, 128, mask},
+                         {49, 9, 17, mask},
+                         {5, 130, 3, mask}}) {
+                arg.b = b;
+                args.emplace_back(arg);
+            }
+        }
+    }
+    return args;
+}
+
+void run_f32_test(Handle* handle) {
+    if (!x86::is_supported(x86::SIMDType::AVX2) ||
+        !x86::is_supported(x86::SIMDType::FMA)) {
+        return;
+    }
+    matrix_mul::check_batched_matrix_mul(
+            dtype::Float32{}, dtype::Float32{}, {}, handle, "X86_BATCHED_F32_6x16",
+            1e-3, get_f32_args());
+}
+}  // namespace
+
+TEST_F(X86, BATCHED_MATRIX_MUL_F32) {
+    run_f32_test(handle());
+}
+
+TEST_F(X86_MULTI_THREADS, BATCHED_MATRIX_MUL_F32) {
+    run_f32_test(handle());
+}
+
+#if MEGDNN_WITH_BENCHMARK
+namespace {
+void benchmark_batched_matmul(Handle* handle) {
+    constexpr size_t RUNS = 20;
+    Benchmarker<BatchedMatrixMul> bencher(handle), bencher_default(handle);
+    bencher.set_times(RUNS).set_display(false);
+    bencher.set_before_exec_callback(
+            AlgoChecker<BatchedMatrixMul>("X86_BATCHED_F32_6x16"));
+    bencher_default.set_times(RUNS).set_display(false);
+    bencher_default.set_before_exec_callback(AlgoChecker<BatchedMatrixMul>("DEFAULT"));
+    auto run = [&](size_t B, size_t M, size_t K, size_t N, bool trB) {
+        BatchedMatrixMul::Param param;
+        param.transposeB = trB;
+        bencher.set_param(param);
+        bencher_default.set_param(param);
+        TensorShapeArray shapes{
+                {B, M, K}, trB ? TensorShape{B, N, K} : TensorShape{B, K, N}, {}};
+        auto t = bencher.execs(shapes) / RUNS,
+             t_default = bencher_default.execs(shapes) / RUNS;
+        double computation = 2.0 * B * M * N * K * 1e-6;
+        printf("batch=%zu M=%zu K=%zu N=%zu trB=%d: default=%.3fms(%.2fGflops) "
+               "x86=%.3fms(%.2fGflops) speedup=%.2f\n",
+               B, M, K, N, trB, t_default, computation / t_default, t,
+               computation / t, t_default / t);
+    };
+    run(64, 128, 64, 128, true);
+    run(64, 128, 128, 64, false);
+    run(256, 16, 16, 16, false);
+    run(1024, 4, 8, 4, false);
+    run(8, 512, 512, 512, false);
+}
+}  // namespace
+
+TEST_F(X86, BENCHMARK_BATCHED_MATRIX_MUL_F32) {
+    benchmark_batched_matmul(handle());
+}
+
+TEST_F(X86_MULTI_THREADS, BENCHMARK_BATCHED_MATRIX_MUL_F32) {
+    benchmark_batched_matmul(handle());
+}
+#endif
+
+// vim: syntax=cpp.doxygen
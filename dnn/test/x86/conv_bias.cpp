@@ -293,6 +293,86 @@ TEST_F(X86_MULTI_THREADS, AVX2_CHANWISE_DIRECT_STRIDE2_QuantizedS8x8x8) {
             handle(), 2, "X86_CONV_BIAS_CHANWISE_AVX2_INT8_STRIDE2");
 }
 
+static void avx2_chanwise_direct_fp32(Handle* handle, bool nchw88, const char* algo) {
+    if (!x86::is_supported(x86::SIMDType::AVX2) ||
+        !x86::is_supported(x86::SIMDType::FMA)) {
+        return;
+    }
+    using namespace conv_bias;
+    std::vector<TestArg> args;
+    size_t pack = nchw88 ? 8 : 1;
+    auto shape = [&](size_t n, size_t c, size_t h, size_t w) {
+        return nchw88 ? TensorShape{n, c / pack, h, w, pack} : TensorShape{n, c, h, w};
+    };
+
+    auto run = [&](size_t group, size_t h, size_t w, size_t kernel, size_t stride,
+                   size_t p, NonlineMode nonline_mode) {
+        if (w + 2 * p < kernel || h + 2 * p < kernel)
+            return;
+        param::ConvBias param;
+        param.stride_h = stride;
+        param.stride_w = stride;
+        param.pad_h = p;
+        param.pad_w = p;
+        param.nonlineMode = nonline_mode;
+        param.sparse = param::ConvBias::Sparse::GROUP;
+        param.format = nchw88 ? param::ConvBias::Format::NCHW88
+                              : param::ConvBias::Format::NCHW;
+        TensorShape filter{group, 1, 1, kernel, kernel};
+        if (nchw88) {
+            filter = TensorShape{group / pack, 1, 1, kernel, kernel, pack};
+        }
+        size_t oh = (h + 2 * p - kernel) / stride + 1,
+               ow = (w + 2 * p - kernel) / stride + 1;
+
+        //! no bias
+        args.emplace_back(param, shape(1, group, h, w), filter, TensorShape{});
+        //! bias channel
+        args.emplace_back(
+                param, shape(2, group, h, w), filter, shape(1, group, 1, 1));
+        //! bias
+        args.emplace_back(
+                param, shape(2, group, h, w), filter, shape(2, group, oh, ow));
+    };
+
+    for (size_t kernel : {3, 5, 7})
+        for (size_t stride : {1, 2})
+            for (size_t p : {0_z, 1_z, kernel / 2})
+                for (size_t group : {8, 16})
+                    for (size_t size : {7, 20, 33})
+                        for (NonlineMode nonline_mode :
+                             {NonlineMode::IDENTITY, NonlineMode::RELU,
+                              NonlineMode::SIGMOID, NonlineMode::H_SWISH}) {
+                            run(group, size, size + 3, kernel, stride, p,
+                                nonline_mode);
+                        }
+
+    Checker<ConvBias> checker(handle);
+    checker.set_before_exec_callback(
+            conv_bias::ConvBiasAlgoChecker<ConvBiasForward>(algo));
+    for (auto&& arg : args) {
+        checker.set_param(arg.param).exec({arg.src, arg.filter, arg.bias, {}, {}});
+    }
+}
+
+TEST_F(X86_MULTI_THREADS, AVX2_CHANWISE_DIRECT_FP32_NCHW) {
+    avx2_chanwise_direct_fp32(handle(), false, "X86_CONV_BIAS_CHANWISE_AVX2_F32_NCHW");
+}
+
+TEST_F(X86_MULTI_THREADS, AVX2_CHANWISE_DIRECT_FP32_NCHW88) {
+    avx2_chanwise_direct_fp32(
+            handle(), true, "X86_CONV_BIAS_CHANWISE_AVX2_F32_NCHW88");
+}
+
+TEST_F(X86, AVX2_CHANWISE_DIRECT_FP32_NCHW) {
+    avx2_chanwise_direct_fp32(handle(), false, "X86_CONV_BIAS_CHANWISE_AVX2_F32_NCHW");
+}
+
+TEST_F(X86, AVX2_CHANWISE_DIRECT_FP32_NCHW88) {
+    avx2_chanwise_direct_fp32(
+            handle(), true, "X86_CONV_BIAS_CHANWISE_AVX2_F32_NCHW88");
+}
+
 TEST_F(X86_MULTI_THREADS, AVX2_CONV_BIAS_DIRECT_STRIDE1_INT8x8x32) {
     using namespace conv_bias;
     std::vector<TestArg> args;
@@ -1911,6 +1991,33 @@ TEST_F(X86_MULTI_THREADS, CONV_BIAS_WINOGRAD_NCHW88_F63_WEIGHT_PREPROCESS) {
     }
 }
 
+TEST_F(X86_MULTI_THREADS, CONV_BIAS_WINOGRAD_NCHW88_F43) {
+    using namespace conv_bias;
+    std::vector<TestArg> args = get_winograd_mk_nchw88_args();
+    Checker<ConvBiasForward> checker(handle());
+
+    checker.set_before_exec_callback(conv_bias::ConvBiasAlgoChecker<ConvBias>(
+            ssprintf("WINOGRAD:X86_F32MK8_8X8:8:4").c_str()));
+
+    for (auto&& arg : args) {
+        checker.set_param(arg.param).execs({arg.src, arg.filter, arg.bias, {}, {}});
+    }
+}
+
+TEST_F(X86_MULTI_THREADS, CONV_BIAS_WINOGRAD_NCHW88_F43_WEIGHT_PREPROCESS) {
+    using namespace conv_bias;
+    std::vector<TestArg> args = get_winograd_mk_nchw88_args();
+    Checker<ConvBiasForward, OprWeightPreprocessProxy<ConvBiasForward>> checker(
+            handle());
+
+    checker.set_before_exec_callback(conv_bias::ConvBiasAlgoChecker<ConvBias>(
+            ssprintf("WINOGRAD:X86_F32MK8_8X8:8:4").c_str()));
+
+    for (auto&& arg : args) {
+        checker.set_param(arg.param).execs({arg.src, arg.filter, arg.bias, {}, {}});
+    }
+}
+
 TEST_F(X86_MULTI_THREADS, CONV_BIAS_WINOGRAD_NCHW88_F23) {
     using namespace conv_bias;
     std::vector<TestArg> args = get_winograd_mk_nchw88_args();
@@ -2417,6 +2524,55 @@ TEST_F(X86_BENCHMARK_MULTI_THREADS, BENCHMARK_CONVBIAS_CHANWISE_AVX2_INT8_S2) {
             2, "X86_CONV_BIAS_CHANWISE_AVX2_INT8_STRIDE2");
 }
 
+TEST_F(X86_BENCHMARK_MULTI_THREADS, BENCHMARK_CONVBIAS_CHANWISE_AVX2_F32) {
+    constexpr size_t RUNS = 50;
+    std::vector<DType> data_type = {
+            dtype::Float32(), dtype::Float32(), dtype::Float32(), dtype::Float32()};
+    for (size_t stride : {1, 2})
+        for (bool nchw88 : {false, true}) {
+            param::ConvBias param;
+            param.stride_h = stride;
+            param.stride_w = stride;
+            param.sparse = param::ConvBias::Sparse::GROUP;
+            param.format = nchw88 ? param::ConvBias::Format::NCHW88
+                                  : param::ConvBias::Format::NCHW;
+            std::vector<std::pair<SmallVector<TensorShape>, float>>
+                    shapes_and_computation;
+            auto bench_case = [&](size_t N, size_t IC, size_t H, size_t W,
+                                  size_t FS) {
+                param.pad_h = FS / 2;
+                param.pad_w = FS / 2;
+                size_t OH = (H + 2 * param.pad_h - FS) / stride + 1,
+                       OW = (W + 2 * param.pad_w - FS) / stride + 1;
+                SmallVector<TensorShape> shapes;
+                if (nchw88) {
+                    shapes = {{N, IC / 8, H, W, 8},
+                              {IC / 8, 1, 1, FS, FS, 8},
+                              {1, IC / 8, 1, 1, 8},
+                              {},
+                              {}};
+                } else {
+                    shapes = {{N, IC, H, W}, {IC, 1, 1, FS, FS}, {1, IC, 1, 1}, {}, {}};
+                }
+                float computations = (FS * FS * N * IC * OH * OW * 2) * 1e-6;
+                shapes_and_computation.push_back(std::make_pair(shapes, computations));
+            };
+            for (size_t FS : {3, 5, 7}) {
+                bench_case(1, 32, 112, 112, FS);
+                bench_case(1, 144, 56, 56, FS);
+                bench_case(1, 192, 28, 28, FS);
+                bench_case(1, 576, 14, 14, FS);
+                bench_case(1, 960, 7, 7, FS);
+            }
+            std::string algo_name = nchw88 ? "X86_CONV_BIAS_CHANWISE_AVX2_F32_NCHW88"
+                                           : "X86_CONV_BIAS_CHANWISE_AVX2_F32_NCHW";
+            printf("Benchmark %s stride %zu\n", algo_name.c_str(), stride);
+            benchmark_impl(
+                    param, shapes_and_computation, algo_name, RUNS, {4, {4, 5, 6, 7}},
+                    {1, {4}}, data_type);
+        }
+}
+
 TEST_F(X86_BENCHMARK_MULTI_THREADS, BENCHMARK_CONVBIAS_DIRECT_AVX2_INT8) {
     constexpr size_t RUNS = 50;
     param::ConvBias param;
@@ -3118,6 +3274,10 @@ TEST_F(X86, BENCHMARK_CONVBIAS_WINOGRAD_F63_8x8) {
     benchmark_winograd("WINOGRAD:X86_F32MK8_8X8:8:6:8", handle(), 3, 8);
 }
 
+TEST_F(X86, BENCHMARK_CONVBIAS_WINOGRAD_F43_8x8) {
+    benchmark_winograd("WINOGRAD:X86_F32MK8_8X8:8:4:8", handle(), 3, 8);
+}
+
 TEST_F(X86, BENCHMARK_CONVBIAS_WINOGRAD_F23_8x8) {
     benchmark_winograd("WINOGRAD:X86_F32MK8_8X8:8:2:8", handle(), 3, 8);
 }
@@ -213,6 +213,73 @@ TEST_F(X86, DEFAULT_CONV_DIRECT_STRIDE2) {
     }
 }
 
+namespace {
+void check_conv_backward_data_f32(
+        Handle* handle, const char* algo_name, std::vector<size_t> strides,
+        bool nchw88) {
+    using Param = ConvolutionBackwardData::Param;
+    Checker<ConvolutionBackwardData> checker(handle);
+    checker.set_before_exec_callback(
+            AlgoChecker<ConvolutionBackwardData>(algo_name));
+    UniformFloatRNG rng(-1.f, 1.f);
+    checker.set_rng(0, &rng).set_rng(1, &rng).set_epsilon(1e-3);
+    auto run = [&](size_t n, size_t ic, size_t ih, size_t iw, size_t oc, size_t f,
+                   size_t stride, size_t pad, size_t group) {
+        Param param;
+        param.pad_h = param.pad_w = pad;
+        param.stride_h = param.stride_w = stride;
+        param.format = nchw88 ? Param::Format::NCHW88 : Param::Format::NCHW;
+        TensorLayout diff, filter, grad;
+        if (nchw88) {
+            diff = {{n, oc * group / 8, ih, iw, 8}, dtype::Float32()};
+            filter = {{oc / 8, ic / 8, f, f, 8, 8}, dtype::Float32()};
+            if (group > 1) {
+                filter = {{group, oc / 8, ic / 8, f, f, 8, 8}, dtype::Float32()};
+            }
+        } else {
+            diff = {{n, oc * group, ih, iw}, dtype::Float32()};
+            filter = {{oc, ic, f, f}, dtype::Float32()};
+            if (group > 1) {
+                filter = {{group, oc, ic, f, f}, dtype::Float32()};
+            }
+        }
+        param.sparse = group > 1 ? Param::Sparse::GROUP : Param::Sparse::DENSE;
+        {
+            auto opr = handle->create_operator<ConvolutionBackwardData>();
+            opr->param() = param;
+            opr->deduce_layout(filter, diff, grad);
+        }
+        checker.set_param(param).exec(TensorLayoutArray{filter, diff, grad});
+    };
+
+    size_t c = nchw88 ? 8 : 3;
+    // clang-format off
+    for (size_t f : {1, 2, 3, 4, 5})
+    for (size_t s : strides)
+    for (size_t p = 0; p < f; ++p)
+    for (size_t ih : {1, 4, 7})
+    for (size_t iw : {1, 5, 17, 19})
+    if ((ih - 1) * s + f > 2 * p && (iw - 1) * s + f > 2 * p) {
+        run(2, c, ih, iw, c * 2, f, s, p, 1);
+    }
+    // clang-format on
+    run(1, c * 2, 9, 11, c, 3, strides.back(), 1, 2);
+    run(1, c * 4, 16, 16, c * 4, 4, strides.back(), 1, 1);
+}
+}  // namespace
+
+TEST_F(X86, CONVOLUTION_BACKWARD_DATA_F32_DIRECT_STRIDE2) {
+    check_conv_backward_data_f32(handle(), "X86_F32_DECONV_DIRECT_STRIDE2", {2}, false);
+}
+
+TEST_F(X86, CONVOLUTION_BACKWARD_DATA_F32_SUBPIXEL) {
+    check_conv_backward_data_f32(handle(), "X86_F32_DECONV_SUBPIXEL", {1, 2, 3}, false);
+}
+
+TEST_F(X86, CONVOLUTION_BACKWARD_DATA_F32_NCHW88) {
+    check_conv_backward_data_f32(handle(), "X86_F32_DECONV_NCHW88", {1, 2, 3}, true);
+}
+
 #if MEGDNN_X86_WITH_MKL_DNN
 TEST_F(X86, CONVOLUTION_FORWARD_INT8) {
     Checker<ConvolutionForward> checker(handle());
@@ -354,6 +421,57 @@ TEST_F(X86, CONVOLUTION_DIRECT_MKLDNN_C8) {
 #endif
 
 #if MEGDNN_WITH_BENCHMARK
+TEST_F(X86, BENCHMARK_CONVOLUTION_BACKWARD_DATA_F32) {
+    using Param = ConvolutionBackwardData::Param;
+    constexpr size_t RUN = 20;
+    Benchmarker<ConvolutionBackwardData> benchmark(handle());
+    benchmark.set_display(false).set_times(RUN);
+
+    auto bench = [&](const char* algo, const Param& param, const TensorLayout& filter,
+                     const TensorLayout& diff, const TensorLayout& grad) {
+        benchmark.set_before_exec_callback(AlgoChecker<ConvolutionBackwardData>(algo));
+        return benchmark.set_param(param).exec(TensorLayoutArray{filter, diff, grad}) /
+               RUN;
+    };
+    auto run = [&](size_t ic, size_t ih, size_t oc, size_t f, size_t stride,
+                   size_t pad) {
+        Param param;
+        param.pad_h = param.pad_w = pad;
+        param.stride_h = param.stride_w = stride;
+        TensorLayout diff{{1, oc, ih, ih}, dtype::Float32()},
+                filter{{oc, ic, f, f}, dtype::Float32()}, grad;
+        auto opr = handle()->create_operator<ConvolutionBackwardData>();
+        opr->param() = param;
+        opr->deduce_layout(filter, diff, grad);
+        float computations =
+                diff.total_nr_elems() * ic * f * f * 2.0 / (1024 * 1024 * 1024) * 1e3;
+        float used_matmul = bench("DeconvMatmul", param, filter, diff, grad);
+        const char* x86_algo = stride == 2 ? "X86_F32_DECONV_DIRECT_STRIDE2"
+                                           : "X86_F32_DECONV_SUBPIXEL";
+        float used_x86 = bench(x86_algo, param, filter, diff, grad);
+
+        param.format = Param::Format::NCHW88;
+        TensorLayout diff88{{1, oc / 8, ih, ih, 8}, dtype::Float32()},
+                filter88{{oc / 8, ic / 8, f, f, 8, 8}, dtype::Float32()}, grad88;
+        opr->param() = param;
+        opr->deduce_layout(filter88, diff88, grad88);
+        float used_nchw88 =
+                bench("X86_F32_DECONV_NCHW88", param, filter88, diff88, grad88);
+        printf("%s %s stride %zu: matmul %f ms %f Gflops, x86 %f ms %f Gflops, "
+               "nchw88 %f ms %f Gflops\n",
+               diff.to_string().c_str(), filter.to_string().c_str(), stride,
+               used_matmul, computations / used_matmul, used_x86,
+               computations / used_x86, used_nchw88, computations / used_nchw88);
+    };
+
+    run(32, 64, 32, 4, 2, 1);
+    run(64, 56, 64, 4, 2, 1);
+    run(64, 56, 64, 3, 2, 1);
+    run(16, 128, 32, 2, 2, 0);
+    run(128, 28, 128, 4, 2, 1);
+    run(64, 56, 64, 3, 1, 1);
+}
+
 TEST_F(X86, BENCHMARK_CONVOLUTION_I8x8x16) {
     using namespace convolution;
     using Param = param::Convolution;
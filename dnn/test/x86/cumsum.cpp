@@ -0,0 +1,104 @@
+/**
+ * \file dnn/test/x86/cumsum.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test/x86/fixture.h"
+
+#include "megdnn/oprs.h"
+#include "test/common/benchmarker.h"
+#include "test/common/checker.h"
+
+namespace megdnn {
+namespace test {
+
+TEST_F(X86, CUMSUM_FP32) {
+    Checker<Cumsum> checker(handle());
+    checker.set_epsilon(1e-2);
+    for (auto shape : TensorShapeArray{
+                 {1},
+                 {7},
+                 {8},
+                 {9},
+                 {1023},
+                 {16385},
+                 {100000},
+                 {33, 1000},
+                 {2, 40000}}) {
+        for (bool exclusive : {true, false}) {
+            for (bool reverse : {true, false}) {
+                checker.set_param(param::Cumsum(shape.ndim - 1, exclusive, reverse));
+                checker.execs({shape, {}});
+            }
+        }
+    }
+}
+
+TEST_F(X86_MULTI_THREADS, CUMSUM_FP32) {
+    Checker<Cumsum> checker(handle());
+    checker.set_epsilon(1e-2);
+    for (auto shape :
+         TensorShapeArray{{9}, {16385}, {1000000}, {33, 1000}, {4, 40000}}) {
+        for (bool exclusive : {true, false}) {
+            for (bool reverse : {true, false}) {
+                checker.set_param(param::Cumsum(shape.ndim - 1, exclusive, reverse));
+                checker.execs({shape, {}});
+            }
+        }
+    }
+}
+
+#if MEGDNN_WITH_BENCHMARK
+namespace {
+void benchmark_cumsum(Handle* handle) {
+    constexpr size_t RUNS = 20;
+    auto naive_handle = create_cpu_handle(2);
+    Benchmarker<Cumsum> bencher(handle), bencher_naive(naive_handle.get());
+    bencher.set_times(RUNS).set_display(false);
+    bencher_naive.set_times(RUNS).set_display(false);
+    auto run = [&](const TensorShape& shape, size_t axis, bool exclusive,
+                   bool reverse) {
+        param::Cumsum param(axis, exclusive, reverse);
+        bencher.set_param(param);
+        bencher_naive.set_param(param);
+        auto t = bencher.execs({shape, {}}) / RUNS,
+             t_naive = bencher_naive.execs({shape, {}}) / RUNS;
+        float gb = shape.total_nr_elems() * sizeof(float) * 2 / 1e9;
+        printf("cumsum %s axis=%zu exclusive=%d reverse=%d: x86=%.3fms(%.2fGB/s) "
+               "naive=%.3fms speedup=%.2f\n",
+               shape.to_string().c_str(), axis, exclusive, reverse, t, gb / t * 1e3,
+               t_naive, t_naive / t);
+    };
+    for (bool exclusive : {false, true}) {
+        for (bool reverse : {false, true}) {
+            // long sequences, e.g. CTC decoding
+            run({1 << 22}, 0, exclusive, reverse);
+            run({64, 1 << 16}, 1, exclusive, reverse);
+            // many short rows
+            run({1 << 16, 64}, 1, exclusive, reverse);
+            // middle axis
+            run({32, 1024, 256}, 1, exclusive, reverse);
+            run({1024, 32, 64}, 1, exclusive, reverse);
+        }
+    }
+}
+}  // namespace
+
+TEST_F(X86, BENCHMARK_CUMSUM) {
+    benchmark_cumsum(handle());
+}
+
+TEST_F(X86_MULTI_THREADS, BENCHMARK_CUMSUM) {
+    benchmark_cumsum(handle());
+}
+#endif
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
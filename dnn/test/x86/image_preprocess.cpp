@@ -0,0 +1,29 @@
+/**
+ * \file dnn/test/x86/image_preprocess.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "src/x86/utils.h"
+#include "test/x86/fixture.h"
+
+#include "test/common/image_preprocess.h"
+
+using namespace megdnn;
+using namespace test;
+
+TEST_F(X86, IMAGE_PREPROCESS) {
+    image_preprocess::run_image_preprocess_test(
+            handle(), x86::is_supported(x86::SIMDType::SSE4_2));
+}
+
+TEST_F(X86_MULTI_THREADS, IMAGE_PREPROCESS) {
+    image_preprocess::run_image_preprocess_test(
+            handle(), x86::is_supported(x86::SIMDType::SSE4_2));
+}
+
+// vim: syntax=cpp.doxygen
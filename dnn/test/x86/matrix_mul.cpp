@@ -118,8 +118,104 @@ TEST_F(X86, MATRIX_MUL_AVX2_6x16) {
             "X86_F32_6x16", param::MatrixMul::Format::DEFAULT, 1, 1e-3, false);
 }
 
+TEST_F(X86, MATRIX_MUL_F32_W4_G32) {
+    matrix_mul::check_matrix_mul_w4_g32(handle(), "X86_F32_W4_G32");
+}
+
+TEST_F(X86, MATRIX_MUL_F32_BSR_8X1) {
+    matrix_mul::check_matrix_mul_bsr_8x1(handle(), "X86_F32_BSR_8X1");
+}
+
 #if MEGDNN_WITH_BENCHMARK
 
+TEST_F(X86, BENCHMARK_MATRIX_MUL_F32_W4_G32) {
+    constexpr size_t RUNS = 20;
+    using Param = MatrixMul::Param;
+    Benchmarker<MatrixMul> benchmarker_w4(handle());
+    Param param;
+    param.format = param::MatrixMul::Format::W4_G32;
+    benchmarker_w4.set_param(param)
+            .set_times(RUNS)
+            .set_dtype(0, dtype::Float32())
+            .set_dtype(1, dtype::Byte())
+            .set_dtype(2, dtype::Float32())
+            .set_before_exec_callback(AlgoChecker<MatrixMul>("X86_F32_W4_G32"));
+    Benchmarker<MatrixMul> benchmarker_f32(handle());
+    benchmarker_f32.set_times(RUNS).set_before_exec_callback(
+            AlgoChecker<MatrixMul>("X86_F32_6x16"));
+
+    auto run = [&](size_t M, size_t N, size_t K) {
+        size_t B1 = K / 32 * MatrixMul::w4_g32_group_bytes();
+        auto w4_used = benchmarker_w4.exec({{M, K}, {N, B1}, {}}) / RUNS;
+        auto f32_used = benchmarker_f32.exec({{M, K}, {K, N}, {}}) / RUNS;
+        float computations = 2.f * M * N * K * 1e-6;
+        printf("M=%zu N=%zu K=%zu: f32 %.3fms %.2fGflops, w4_g32 %.3fms "
+               "%.2fGflops, weight %.2fGB/s, speedup %.2f\n",
+               M, N, K, f32_used, computations / f32_used, w4_used,
+               computations / w4_used, N * B1 * 1e-6 / w4_used,
+               f32_used / w4_used);
+    };
+    for (size_t M : {1, 4, 8, 16, 64})
+        for (size_t NK : {1024, 4096}) {
+            run(M, NK, NK);
+        }
+    run(1, 11008, 4096);
+    run(1, 4096, 11008);
+}
+
+TEST_F(X86, BENCHMARK_MATRIX_MUL_F32_BSR_8X1) {
+    constexpr size_t RUNS = 20;
+    using Param = MatrixMul::Param;
+    Benchmarker<MatrixMul> benchmarker_bsr(handle());
+    benchmarker_bsr.set_times(RUNS)
+            .set_dtype(0, dtype::Byte())
+            .set_dtype(1, dtype::Float32())
+            .set_dtype(2, dtype::Float32())
+            .set_before_exec_callback(AlgoChecker<MatrixMul>("X86_F32_BSR_8X1"));
+    Benchmarker<MatrixMul> benchmarker_f32(handle());
+    benchmarker_f32.set_times(RUNS).set_before_exec_callback(
+            AlgoChecker<MatrixMul>("X86_F32_6x16"));
+
+    //! every block row holds density * K blocks in the first columns
+    auto run = [&](size_t M, size_t N, size_t K, bool trB, float density) {
+        size_t nr_blocks = std::max<size_t>(1, K * density);
+        size_t row_bytes = MatrixMul::bsr_8x1_row_bytes(nr_blocks);
+        benchmarker_bsr.set_tensors_constraint([=](TensorNDArray& tensors) {
+            auto A = reinterpret_cast<uint8_t*>(tensors[0].raw_ptr());
+            for (size_t r = 0; r < M / 8; ++r, A += row_bytes) {
+                int32_t nr = nr_blocks;
+                memcpy(A, &nr, sizeof(int32_t));
+                for (int32_t b = 0; b < nr; ++b) {
+                    int32_t col = b * K / nr;
+                    memcpy(A + 4 + b * 4, &col, sizeof(int32_t));
+                }
+            }
+        });
+        Param param;
+        param.format = param::MatrixMul::Format::BSR_8X1;
+        param.transposeB = trB;
+        benchmarker_bsr.set_param(param);
+        TensorShape B = trB ? TensorShape{N, K} : TensorShape{K, N};
+        auto bsr_used = benchmarker_bsr.exec({{M / 8, row_bytes}, B, {}}) / RUNS;
+        auto f32_used = benchmarker_f32.exec({{M, K}, {K, N}, {}}) / RUNS;
+        float computations = 2.f * M * N * K * 1e-6;
+        printf("M=%zu N=%zu K=%zu trB=%d density=%.2f: f32 %.3fms %.2fGflops, bsr "
+               "%.3fms, speedup %.2f\n",
+               M, N, K, trB, density, f32_used, computations / f32_used, bsr_used,
+               f32_used / bsr_used);
+    };
+    for (float density : {0.3f, 0.2f, 0.1f}) {
+        //! conv1x1
+        run(64, 56 * 56, 64, false, density);
+        run(256, 14 * 14, 256, false, density);
+        run(512, 7 * 7, 512, false, density);
+        //! fc
+        run(1024, 1, 1024, true, density);
+        run(4096, 1, 4096, true, density);
+        run(4096, 16, 4096, true, density);
+    }
+}
+
 TEST_F(X86, BENCHMARK_MATRIX_MUL_AVX2_MK8_8X8) {
     auto args = matrix_mul::get_benchmark_matmul_mk_packed_args(8);
     matrix_mul::benchmark_with_contrast(
@@ -0,0 +1,52 @@
+/**
+ * \file dnn/test/x86/rng.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+#include "test/x86/fixture.h"
+
+#include "megdnn/oprs.h"
+#include "test/common/tensor.h"
+
+namespace megdnn {
+namespace test {
+
+namespace {
+//! the avx2 kernels must give the same results as the fallback ones
+template <class Opr>
+void check_same_as_fallback(Handle* handle, Handle* fallback_handle) {
+    for (size_t size : {1, 31, 32, 33, 1000, 16384 * 4 + 35}) {
+        auto opr = handle->create_operator<Opr>(),
+             opr_fallback = fallback_handle->create_operator<Opr>();
+        opr->param().seed = opr_fallback->param().seed = 42;
+        for (int i = 0; i < 3; ++i) {
+            TensorLayout layout{{size}, dtype::Float32()};
+            Tensor<float> t(handle, layout), t_fallback(fallback_handle, layout);
+            opr->exec(t.tensornd(), {});
+            opr_fallback->exec(t_fallback.tensornd(), {});
+            for (size_t j = 0; j < size; ++j) {
+                ASSERT_EQ(t_fallback.ptr()[j], t.ptr()[j])
+                        << "size=" << size << " iter=" << i << " j=" << j;
+            }
+        }
+    }
+}
+}  // namespace
+
+TEST_F(X86, UNIFORM_RNG) {
+    check_same_as_fallback<UniformRNG>(handle(), fallback_handle());
+}
+
+TEST_F(X86, GAUSSIAN_RNG) {
+    check_same_as_fallback<GaussianRNG>(handle(), fallback_handle());
+}
+
+}  // namespace test
+}  // namespace megdnn
+
+// vim: syntax=cpp.doxygen
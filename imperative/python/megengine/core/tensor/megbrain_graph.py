@@ -262,6 +262,22 @@ def optimize_for_inference(dest_vars, **kwargs):
           input for inference on nvidia backend(this optimization pass will
           result in mismatch of the precision of output of training and
           inference)
+        * enable_weight_int4: whether to quantize the constant weight of float32
+          matmul to int4 with a scale per group of 32 elements, the activation is
+          still computed in float32
+        * enable_weight_block_sparse: whether to store the constant weight of float32
+          matmul and 1x1 convolution in 8x1 block sparse format if most of its
+          blocks are zero
+        * enable_fuse_conv_bias_pooling: whether to fuse float32 conv_bias and the
+          pooling reading it on CPU, so the conv output is not written to memory
+        * enable_fold_const_shape: whether to fold shape computation into constants;
+          only useful when the graph is loaded with constant var shapes
+        * enable_horizontal_fuse: whether to fuse float conv_bias or matmul oprs
+          with constant weights that read the same input into one opr
+        * enable_batch_matmul: whether to batch independent small float matmul
+          oprs with identical shapes into one opr
+        * enable_fold_padding: whether to fold a constant padding that is symmetric
+          on each spatial dim into the pads of the convolution or pooling reading it
     """
     inference_options = GraphOptimizeOptions()
     inference_optimize_layout_transform_map = {
@@ -289,6 +305,20 @@ def optimize_for_inference(dest_vars, **kwargs):
         inference_options.fuse_conv_bias_with_z = True
     if kwargs.pop("enable_fuse_preprocess", False):
         inference_options.fuse_preprocess = True
+    if kwargs.pop("enable_weight_int4", False):
+        inference_options.weight_int4 = True
+    if kwargs.pop("enable_weight_block_sparse", False):
+        inference_options.weight_block_sparse = True
+    if kwargs.pop("enable_fuse_conv_bias_pooling", False):
+        inference_options.fuse_conv_bias_pooling = True
+    if kwargs.pop("enable_fold_const_shape", False):
+        inference_options.fold_const_shape = True
+    if kwargs.pop("enable_horizontal_fuse", False):
+        inference_options.horizontal_fuse = True
+    if kwargs.pop("enable_batch_matmul", False):
+        inference_options.batch_matmul = True
+    if kwargs.pop("enable_fold_padding", False):
+        inference_options.fold_padding = True
 
     if kwargs:
         raise ValueError("unknown options: %s" % list(kwargs))
@@ -337,6 +367,20 @@ def deserialize_infer_option(x: int) -> Dict[str, bool]:
         ret["enable_fuse_conv_bias_with_z"] = True
     if inference_options.fuse_preprocess:
         ret["enable_fuse_preprocess"] = True
+    if inference_options.weight_int4:
+        ret["enable_weight_int4"] = True
+    if inference_options.weight_block_sparse:
+        ret["enable_weight_block_sparse"] = True
+    if inference_options.fuse_conv_bias_pooling:
+        ret["enable_fuse_conv_bias_pooling"] = True
+    if inference_options.fold_const_shape:
+        ret["enable_fold_const_shape"] = True
+    if inference_options.horizontal_fuse:
+        ret["enable_horizontal_fuse"] = True
+    if inference_options.batch_matmul:
+        ret["enable_batch_matmul"] = True
+    if inference_options.fold_padding:
+        ret["enable_fold_padding"] = True
 
     return ret
 
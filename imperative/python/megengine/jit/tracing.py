@@ -1103,6 +1103,22 @@ class trace:
           inference)
         * enable_fuse_preprocess: whether to fuse astype\pad_channel\dimshuffle and
           etc opr
+        * enable_weight_int4: whether to quantize the constant weight of float32
+          matmul to int4 with a scale per group of 32 elements, the activation is
+          still computed in float32
+        * enable_weight_block_sparse: whether to store the constant weight of float32
+          matmul and 1x1 convolution in 8x1 block sparse format if most of its
+          blocks are zero
+        * enable_fuse_conv_bias_pooling: whether to fuse float32 conv_bias and the
+          pooling reading it on CPU, so the conv output is not written to memory
+        * enable_fold_const_shape: whether to fold shape computation into constants;
+          only useful when the graph is loaded with constant var shapes
+        * enable_horizontal_fuse: whether to fuse float conv_bias or matmul oprs
+          with constant weights that read the same input into one opr
+        * enable_batch_matmul: whether to batch independent small float matmul
+          oprs with identical shapes into one opr
+        * enable_fold_padding: whether to fold a constant padding that is symmetric
+          on each spatial dim into the pads of the convolution or pooling reading it
         """
         if not self._capture_as_const:
             raise ValueError(
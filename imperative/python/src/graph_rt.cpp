@@ -295,6 +295,24 @@ void init_graph_rt(py::module m) {
                     .def_readwrite(
                             "fuse_preprocess",
                             &_OptimizeForInferenceOptions::fuse_preprocess)
+                    .def_readwrite(
+                            "weight_int4", &_OptimizeForInferenceOptions::weight_int4)
+                    .def_readwrite(
+                            "weight_block_sparse",
+                            &_OptimizeForInferenceOptions::weight_block_sparse)
+                    .def_readwrite(
+                            "fuse_conv_bias_pooling",
+                            &_OptimizeForInferenceOptions::fuse_conv_bias_pooling)
+                    .def_readwrite(
+                            "fold_const_shape",
+                            &_OptimizeForInferenceOptions::fold_const_shape)
+                    .def_readwrite(
+                            "horizontal_fuse",
+                            &_OptimizeForInferenceOptions::horizontal_fuse)
+                    .def_readwrite(
+                            "batch_matmul", &_OptimizeForInferenceOptions::batch_matmul)
+                    .def_readwrite(
+                            "fold_padding", &_OptimizeForInferenceOptions::fold_padding)
                     .def_readwrite(
                             "layout_transform",
                             &_OptimizeForInferenceOptions::layout_transform);
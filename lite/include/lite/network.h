@@ -84,6 +84,9 @@ LITE_API inline LiteAlgoSelectStrategy operator|(
  * 1: dispatch async if there are more than one comp node with limited queue
  * mask 0b10: async if there are multiple comp nodes with
  * mask 0b100: always async
+ *
+ * \param fold_padding fold a constant padding that is symmetric on each
+ * spatial dim into the pads of the convolution or pooling reading it
  */
 struct LITE_API Options {
     bool weight_preprocess = false;
@@ -108,6 +111,9 @@ struct LITE_API Options {
     bool enable_nchw4 = false;
     bool enable_nchw32 = false;
     bool enable_nchw64 = false;
+
+    //! graph optimize options
+    bool fold_padding = false;
 };
 
 /*!
@@ -74,6 +74,9 @@ extern "C" {
  * 1: dispatch async if there are more than one comp node with limited queue
  * mask 0b10: async if there are multiple comp nodes with
  * mask 0b100: always async
+ *
+ * \param fold_padding fold a constant padding that is symmetric on each
+ * spatial dim into the pads of the convolution or pooling reading it
  */
 typedef struct Options {
     int weight_preprocess;
@@ -98,6 +101,9 @@ typedef struct Options {
     int enable_nchw4;
     int enable_nchw32;
     int enable_nchw64;
+
+    //! graph optimize options
+    int fold_padding;
 } LiteOptions;
 
 //! define a default Options
@@ -43,6 +43,8 @@ const LiteOptions default_option = {
         .enable_nchw4 = 0,
         .enable_nchw32 = 0,
         .enable_nchw64 = 0,
+        //! graph optimize options
+        .fold_padding = 0,
 
 };
 
@@ -144,6 +146,8 @@ lite::Config convert_to_lite_config(const LiteConfig c_config) {
     lite_config.options.enable_nchw32 = c_config.options.enable_nchw32;
     lite_config.options.enable_nchw64 = c_config.options.enable_nchw64;
 
+    lite_config.options.fold_padding = c_config.options.fold_padding;
+
     return lite_config;
 }
 
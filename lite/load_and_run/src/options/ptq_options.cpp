@@ -0,0 +1,128 @@
+/**
+ * \file lite/load_and_run/src/options/ptq_options.cpp
+ *
+ * This file is part of MegEngine, a deep learning framework developed by
+ * Megvii.
+ *
+ * \copyright Copyright (c) 2020-2021 Megvii Inc. All rights reserved.
+ */
+#include "ptq_options.h"
+#include <gflags/gflags.h>
+#include "helpers/data_parser.h"
+#include "megbrain/serialization/serializer.h"
+#include "megbrain/utils/timer.h"
+#include "misc.h"
+#include "models/model_lite.h"
+#include "models/model_mdl.h"
+namespace lar {
+
+template <>
+void PTQOption::config_model_internel<ModelLite>(
+        RuntimeParam& runtime_param, std::shared_ptr<ModelLite> /* model */) {
+    if (runtime_param.stage == RunStage::BEFORE_MODEL_LOAD) {
+        LITE_THROW("lite model don't support post-training quantization");
+    }
+}
+
+template <>
+void PTQOption::config_model_internel<ModelMdl>(
+        RuntimeParam& runtime_param, std::shared_ptr<ModelMdl> model) {
+    //! quantize before the global optimizations, which change the graph
+    if (runtime_param.stage == RunStage::AFTER_MODEL_LOAD) {
+        std::vector<mgb::gopt::CalibrationBatch> dataset;
+        for (auto&& batch : calib_batches) {
+            DataParser parser;
+            size_t start = 0, end;
+            while ((end = batch.find(";", start)) != std::string::npos) {
+                parser.feed(batch.substr(start, end - start));
+                start = end + 1;
+            }
+            parser.feed(batch.substr(start));
+            dataset.emplace_back(std::move(parser.inputs));
+        }
+
+        mgb::RealTimer timer;
+        auto&& load_result = model->get_mdl_load_result();
+        load_result.output_var_list = mgb::gopt::quantize_int8(
+                load_result.output_var_list, dataset, calib_options);
+        printf("post-training quantization on %zu batches: %.3fms\n", dataset.size(),
+               timer.get_msecs());
+
+        if (!dump_file.empty()) {
+            auto out_file =
+                    mgb::serialization::OutputFile::make_fs(dump_file.c_str(), 'w');
+            using DumpConfig = mgb::serialization::GraphDumper::DumpConfig;
+            DumpConfig config{1, false, false};
+            auto dumper = model->get_dumper(std::move(out_file));
+            dumper->dump(load_result.output_var_list, config);
+        }
+    }
+}
+
+}  // namespace lar
+
+using namespace lar;
+
+PTQOption::PTQOption() {
+    m_option_name = "ptq";
+    size_t start = 0, end;
+    while ((end = FLAGS_ptq_calib_data.find("|", start)) != std::string::npos) {
+        calib_batches.emplace_back(FLAGS_ptq_calib_data.substr(start, end - start));
+        start = end + 1;
+    }
+    calib_batches.emplace_back(FLAGS_ptq_calib_data.substr(start));
+
+    using Method = mgb::gopt::CalibrationOptions::Method;
+    if (FLAGS_ptq_method == "minmax") {
+        calib_options.method = Method::MINMAX;
+    } else if (FLAGS_ptq_method == "percentile") {
+        calib_options.method = Method::PERCENTILE;
+    } else if (FLAGS_ptq_method == "kl") {
+        calib_options.method = Method::KL;
+    } else {
+        mgb_assert(
+                false, "unsupported calibration method(got:%s) for --ptq_method",
+                FLAGS_ptq_method.c_str());
+    }
+    calib_options.percentile = FLAGS_ptq_percentile;
+    dump_file = FLAGS_ptq_dump;
+}
+
+bool PTQOption::is_valid() {
+    return !FLAGS_ptq_calib_data.empty();
+}
+
+std::shared_ptr<OptionBase> PTQOption::create_option() {
+    static std::shared_ptr<PTQOption> option(new PTQOption);
+    if (PTQOption::is_valid()) {
+        return std::static_pointer_cast<OptionBase>(option);
+    } else {
+        return nullptr;
+    }
+}
+
+void PTQOption::config_model(
+        RuntimeParam& runtime_param, std::shared_ptr<ModelBase> model) {
+    CONFIG_MODEL_FUN;
+}
+
+DEFINE_string(
+        ptq_calib_data, "",
+        "Enable post-training int8 quantization, calibrated on the given data. "
+        "Batches are separated by '|', and each batch is given in the format of "
+        "--input, e.g. \"data:0.npy|data:1.npy\". The dense ConvBias, MatrixMul and "
+        "Elemwise ADD/RELU oprs in NCHW float32 graph are converted to QuantizedS8.");
+DEFINE_string(
+        ptq_method, "minmax",
+        "Method to compute the quantization scales of activations for "
+        "--ptq_calib_data: minmax, percentile or kl.");
+DEFINE_double(
+        ptq_percentile, 99.99,
+        "Percentile of absolute values used as the clipping threshold when "
+        "--ptq_method is percentile.");
+DEFINE_string(
+        ptq_dump, "",
+        "The quantized computing graph will be dumped to the given file path, "
+        "without the testcases of the original model.");
+
+REGIST_OPTION_CREATOR(ptq, lar::PTQOption::create_option);
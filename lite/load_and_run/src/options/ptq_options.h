@@ -0,0 +1,47 @@
+/**
+ * \file lite/load_and_run/src/options/ptq_options.h
+ *
+ * This file is part of MegEngine, a deep learning framework developed by
+ * Megvii.
+ *
+ * \copyright Copyright (c) 2020-2021 Megvii Inc. All rights reserved.
+ */
+
+#pragma once
+
+#include <gflags/gflags.h>
+#include "megbrain/gopt/quantization.h"
+#include "models/model.h"
+#include "option_base.h"
+DECLARE_string(ptq_calib_data);
+DECLARE_string(ptq_method);
+DECLARE_double(ptq_percentile);
+DECLARE_string(ptq_dump);
+
+namespace lar {
+/*!
+ * \brief post-training int8 quantization of the loaded model, which is
+ * calibrated on the data given by --ptq_calib_data
+ */
+class PTQOption final : public OptionBase {
+public:
+    static bool is_valid();
+
+    static std::shared_ptr<OptionBase> create_option();
+
+    void config_model(
+            RuntimeParam& runtime_param, std::shared_ptr<ModelBase> model) override;
+
+    std::string option_name() const override { return m_option_name; }
+
+private:
+    PTQOption();
+    template <typename ModelImpl>
+    void config_model_internel(RuntimeParam&, std::shared_ptr<ModelImpl>) {}
+    std::string m_option_name;
+    //! each batch is given in the format of --input
+    std::vector<std::string> calib_batches;
+    mgb::gopt::CalibrationOptions calib_options;
+    std::string dump_file;
+};
+}  // namespace lar
@@ -43,6 +43,8 @@ class LiteOptions(Structure):
         ("enable_nchw4", c_int),
         ("enable_nchw32", c_int),
         ("enable_nchw64", c_int),
+        # graph optimize options
+        ("fold_padding", c_int),
     ]
 
     def __init__(self):
@@ -59,6 +61,7 @@ class LiteOptions(Structure):
         self.comp_node_seq_record_level = 0
         self.graph_opt_level = 2
         self.async_exec_level = 1
+        self.fold_padding = False
 
     def __repr__(self):
         data = {
@@ -75,6 +78,7 @@ class LiteOptions(Structure):
             "comp_node_seq_record_level": self.comp_node_seq_record_level,
             "graph_opt_level": self.graph_opt_level,
             "async_exec_level": self.async_exec_level,
+            "fold_padding": bool(self.fold_padding),
         }
         return data.__repr__()
 
@@ -82,6 +82,7 @@ void NetworkImplDft::application_config() {
     ConfigOption(fake_next_exec, fake_next_exec);
     ConfigOption(var_sanity_check_first_run, var_sanity_check_first_run);
     m_load_config.const_var_shape = m_user_config->options.const_shape;
+    ConfigOption(graph_opt.fold_const_shape, const_shape);
     ConfigOption(force_dynamic_alloc, force_dynamic_alloc);
     ConfigOption(force_output_dynamic_alloc, force_output_dynamic_alloc);
     ConfigOption(
@@ -97,6 +98,7 @@ void NetworkImplDft::application_config() {
     ConfigOption(comp_node_seq_record_level, comp_node_seq_record_level);
     ConfigOption(graph_opt_level, graph_opt_level);
     ConfigOption(async_exec_level, async_exec_level);
+    ConfigOption(graph_opt.fold_padding, fold_padding);
 
 #undef ConfigOption
 #define ConfigOptionLayoutTransform(name) \
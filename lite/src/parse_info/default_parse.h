@@ -126,6 +126,8 @@ bool default_parse_info(
             config.options.graph_opt_level = options["graph_opt_level"];
         if (options.contains("async_exec_level"))
             config.options.async_exec_level = options["async_exec_level"];
+        if (options.contains("fold_padding"))
+            config.options.fold_padding = options["fold_padding"];
     }
     //! IO
     auto get_io_type = [](std::string type) -> LiteIOType {
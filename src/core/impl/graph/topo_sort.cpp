@@ -15,12 +15,307 @@
 #include "megbrain/graph/helper.h"
 #include "megbrain/utils/arith_helper.h"
 
+#include <algorithm>
+#include <numeric>
 #include <queue>
 #include <tuple>
 
 using namespace mgb;
 using namespace cg;
 
+namespace {
+
+/*!
+ * \brief memory model of an opr sequence for TopoSorter::reorder_seq()
+ *
+ * The memory of a var is allocated when its owner opr starts and released
+ * after its last reader finishes; oprs and vars are referred to by indices.
+ */
+class MemAwareScheduler {
+public:
+    struct Opr {
+        int priority = 0;
+        //! total size of outputs
+        size_t alloc = 0;
+        std::vector<size_t> inputs, outputs, receivers;
+    };
+
+    struct Var {
+        size_t size = 0, owner = 0, nr_reader = 0;
+        //! whether the var is kept until the end, like dest vars
+        bool persistent = false;
+    };
+
+    std::vector<Opr> oprs;
+    std::vector<Var> vars;
+
+    //! peak memory of executing oprs in given order
+    size_t peak(const std::vector<size_t>& order) const;
+
+    /*!
+     * \brief order oprs by DFS from the sinks, where inputs that need more
+     *      memory to compute are visited first (as in the optimal order for
+     *      trees); return rank of each opr
+     */
+    std::vector<size_t> dfs_rank() const;
+
+    //! topological order that prefers smaller (priority, rank)
+    std::vector<size_t> list_schedule(const std::vector<size_t>& rank) const;
+
+    /*!
+     * \brief topological order that prefers oprs reading the most recently
+     *      produced var no larger than \p cache_size, and then smaller rank
+     *
+     * This is a depth-first order along producer-consumer chains, where
+     * large vars are not expected to stay in cache.
+     */
+    std::vector<size_t> locality_schedule(
+            const std::vector<size_t>& rank, size_t cache_size) const;
+
+    /*!
+     * \brief swap adjacent oprs with the same priority as long as the peak
+     *      memory of the two steps decreases
+     */
+    void local_search(std::vector<size_t>& order) const;
+
+private:
+    static constexpr size_t MAX_SWEEP = 16;
+
+    //! position of the last step that uses each var
+    std::vector<size_t> last_use(const std::vector<size_t>& order) const;
+
+    bool reads(size_t opr, size_t var) const {
+        auto&& inp = oprs[opr].inputs;
+        return std::find(inp.begin(), inp.end(), var) != inp.end();
+    }
+};
+
+size_t MemAwareScheduler::peak(const std::vector<size_t>& order) const {
+    auto last = last_use(order);
+    std::vector<size_t> release(order.size());
+    for (size_t i = 0; i < vars.size(); ++i) {
+        if (!vars[i].persistent) {
+            release[last[i]] += vars[i].size;
+        }
+    }
+    size_t cur = 0, ret = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        cur += oprs[order[i]].alloc;
+        ret = std::max(ret, cur);
+        cur -= release[i];
+    }
+    return ret;
+}
+
+std::vector<size_t> MemAwareScheduler::last_use(
+        const std::vector<size_t>& order) const {
+    std::vector<size_t> last(vars.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        auto&& opr = oprs[order[i]];
+        for (auto v : opr.outputs) {
+            last[v] = i;
+        }
+        for (auto v : opr.inputs) {
+            last[v] = i;
+        }
+    }
+    return last;
+}
+
+std::vector<size_t> MemAwareScheduler::dfs_rank() const {
+    // oprs are indexed in a topological order
+    size_t nr_opr = oprs.size();
+    std::vector<std::vector<size_t>> preds(nr_opr);
+    for (size_t i = 0; i < nr_opr; ++i) {
+        for (auto j : oprs[i].receivers) {
+            auto&& p = preds[j];
+            if (std::find(p.begin(), p.end(), i) == p.end()) {
+                p.push_back(i);
+            }
+        }
+    }
+    std::vector<size_t> need(nr_opr);
+    auto extra = [&](size_t i) { return need[i] - oprs[i].alloc; };
+    for (size_t i = 0; i < nr_opr; ++i) {
+        auto&& p = preds[i];
+        std::stable_sort(p.begin(), p.end(), [&](size_t a, size_t b) {
+            return extra(a) > extra(b);
+        });
+        size_t done = 0, cur_need = 0;
+        for (auto j : p) {
+            cur_need = std::max(cur_need, done + need[j]);
+            done += oprs[j].alloc;
+        }
+        need[i] = std::max(cur_need, done + oprs[i].alloc);
+    }
+
+    const size_t NPOS = SIZE_MAX;
+    std::vector<size_t> rank(nr_opr, NPOS);
+    std::vector<std::pair<size_t, size_t>> stack;
+    size_t cur_rank = 0;
+    for (size_t root = nr_opr; root--;) {
+        if (rank[root] != NPOS || !oprs[root].receivers.empty())
+            continue;
+        stack.emplace_back(root, 0);
+        while (!stack.empty()) {
+            auto&& top = stack.back();
+            auto&& p = preds[top.first];
+            if (top.second < p.size()) {
+                // a pred can not be in the stack since the graph is acyclic
+                auto next = p[top.second++];
+                if (rank[next] == NPOS) {
+                    stack.emplace_back(next, 0);
+                }
+            } else {
+                rank[top.first] = cur_rank++;
+                stack.pop_back();
+            }
+        }
+    }
+    mgb_assert(cur_rank == nr_opr);
+    return rank;
+}
+
+std::vector<size_t> MemAwareScheduler::list_schedule(
+        const std::vector<size_t>& rank) const {
+    using Item = std::tuple<int, size_t, size_t>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> ready;
+    std::vector<size_t> nr_unresolved(oprs.size()), order;
+    for (auto&& i : oprs) {
+        for (auto j : i.receivers) {
+            ++nr_unresolved[j];
+        }
+    }
+    for (size_t i = 0; i < oprs.size(); ++i) {
+        if (!nr_unresolved[i]) {
+            ready.emplace(oprs[i].priority, rank[i], i);
+        }
+    }
+    while (!ready.empty()) {
+        auto cur = std::get<2>(ready.top());
+        ready.pop();
+        order.push_back(cur);
+        for (auto i : oprs[cur].receivers) {
+            if (!--nr_unresolved[i]) {
+                ready.emplace(oprs[i].priority, rank[i], i);
+            }
+        }
+    }
+    mgb_assert(order.size() == oprs.size());
+    return order;
+}
+
+std::vector<size_t> MemAwareScheduler::locality_schedule(
+        const std::vector<size_t>& rank, size_t cache_size) const {
+    // (priority, negated step after the latest cached input is produced,
+    // rank, opr)
+    using Item = std::tuple<int, ptrdiff_t, size_t, size_t>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> ready;
+    std::vector<size_t> nr_unresolved(oprs.size()), produced(vars.size()), order;
+    for (auto&& i : oprs) {
+        for (auto j : i.receivers) {
+            ++nr_unresolved[j];
+        }
+    }
+    auto push = [&](size_t opr) {
+        size_t fresh = 0;
+        for (auto v : oprs[opr].inputs) {
+            if (vars[v].size && vars[v].size <= cache_size)
+                fresh = std::max(fresh, produced[v]);
+        }
+        ready.emplace(
+                oprs[opr].priority, -static_cast<ptrdiff_t>(fresh), rank[opr], opr);
+    };
+    for (size_t i = 0; i < oprs.size(); ++i) {
+        if (!nr_unresolved[i]) {
+            push(i);
+        }
+    }
+    while (!ready.empty()) {
+        auto cur = std::get<3>(ready.top());
+        ready.pop();
+        order.push_back(cur);
+        for (auto v : oprs[cur].outputs) {
+            produced[v] = order.size();
+        }
+        for (auto i : oprs[cur].receivers) {
+            if (!--nr_unresolved[i]) {
+                push(i);
+            }
+        }
+    }
+    mgb_assert(order.size() == oprs.size());
+    return order;
+}
+
+void MemAwareScheduler::local_search(std::vector<size_t>& order) const {
+    size_t nr_step = order.size();
+    if (nr_step < 2)
+        return;
+    auto last = last_use(order);
+
+    // memory released after step i if opr x is executed at step i followed by
+    // opr y; last uses of vars read by x and y are taken from current order,
+    // where x and y occupy step i and i + 1
+    auto released = [&](size_t x, size_t y, size_t i) {
+        size_t ret = 0;
+        for (auto v : oprs[x].outputs) {
+            if (!vars[v].persistent && !vars[v].nr_reader)
+                ret += vars[v].size;
+        }
+        for (auto v : oprs[x].inputs) {
+            if (!vars[v].persistent && (last[v] == i || last[v] == i + 1) &&
+                !reads(y, v))
+                ret += vars[v].size;
+        }
+        return ret;
+    };
+
+    // memory in use before each step
+    std::vector<size_t> before(nr_step);
+    for (size_t i = 0; i + 1 < nr_step; ++i) {
+        before[i + 1] = before[i] + oprs[order[i]].alloc -
+                        released(order[i], order[i + 1], i);
+    }
+
+    bool changed = true;
+    for (size_t sweep = 0; sweep < MAX_SWEEP && changed; ++sweep) {
+        changed = false;
+        for (size_t i = 0; i + 1 < nr_step; ++i) {
+            auto a = order[i], b = order[i + 1];
+            auto&& recv = oprs[a].receivers;
+            if (oprs[a].priority != oprs[b].priority ||
+                std::find(recv.begin(), recv.end(), b) != recv.end())
+                continue;
+            size_t old_peak = std::max(
+                    before[i] + oprs[a].alloc, before[i + 1] + oprs[b].alloc);
+            size_t mid = before[i] + oprs[b].alloc - released(b, a, i),
+                   new_peak =
+                           std::max(before[i] + oprs[b].alloc, mid + oprs[a].alloc);
+            if (new_peak >= old_peak)
+                continue;
+
+            // vars last used by the pair are now last used by a if a reads
+            // them (a moves to step i + 1), and by b otherwise
+            for (auto opr : {a, b}) {
+                for (auto v : oprs[opr].inputs) {
+                    if (last[v] == i || last[v] == i + 1)
+                        last[v] = reads(a, v) ? i + 1 : i;
+                }
+                for (auto v : oprs[opr].outputs) {
+                    if (!vars[v].nr_reader)
+                        last[v] = opr == a ? i + 1 : i;
+                }
+            }
+            std::swap(order[i], order[i + 1]);
+            before[i + 1] = mid;
+            changed = true;
+        }
+    }
+}
+
+}  // anonymous namespace
+
 TopoSorter::TopoSorter(ComputingGraphImpl* graph) : m_owner_graph{graph} {}
 
 TopoSorter::~TopoSorter() noexcept = default;
@@ -441,6 +736,10 @@ const OprNodeArray* TopoSorter::get_comp_seq(
     }
 
     bfs_make_seq();
+    auto&& seq_opt = m_owner_graph->options().seq_opt;
+    if (seq_opt.enable_mem_aware_topo_sort || seq_opt.enable_cache_aware_topo_sort) {
+        reorder_seq(dest);
+    }
 
     m_cur_extra_info = nullptr;
     m_state = nullptr;
@@ -549,6 +848,105 @@ void TopoSorter::bfs_make_seq() {
     }
 }
 
+void TopoSorter::reorder_seq(const VarNodeArray& dest) {
+    auto&& infer_mgr = m_owner_graph->static_infer_manager();
+    auto state = m_state;
+    size_t nr_opr = m_seq.size();
+    MemAwareScheduler sched;
+    sched.oprs.resize(nr_opr);
+    ThinHashMap<VarNode*, size_t> var2idx;
+    for (size_t i = 0; i < nr_opr; ++i) {
+        auto opr = m_seq[i];
+        auto&& trait = state->opr_trait.at(opr);
+        auto&& sopr = sched.oprs[i];
+        sopr.priority = trait.priority;
+        for (auto var : opr->output()) {
+            size_t size = 0;
+            if (!var->contain_flag(VarNode::Flag::NO_SYS_MEM_ALLOC)) {
+                // vars with dynamic shapes are ignored
+                if (auto shp = infer_mgr.infer_shape_fallible(var)) {
+                    size = var->dtype().size(shp->total_nr_elems());
+                }
+            }
+            var2idx[var] = sched.vars.size();
+            sopr.outputs.push_back(sched.vars.size());
+            sopr.alloc += size;
+            sched.vars.emplace_back();
+            sched.vars.back().size = size;
+            sched.vars.back().owner = i;
+        }
+        for (auto&& dep : opr->node_prop().dep_map()) {
+            if (OprNodeProp::is_device_value_dep(dep.second)) {
+                auto var = var2idx.at(dep.first);
+                sopr.inputs.push_back(var);
+                ++sched.vars[var].nr_reader;
+            }
+        }
+        for (auto recv : trait.receivers) {
+            sopr.receivers.push_back(state->opr_trait.at(recv).pos);
+        }
+    }
+    for (auto var : dest) {
+        sched.vars[var2idx.at(var)].persistent = true;
+    }
+
+    auto&& seq_opt = m_owner_graph->options().seq_opt;
+    std::vector<size_t> orig_order(nr_opr);
+    std::iota(orig_order.begin(), orig_order.end(), 0);
+    auto orig_peak = sched.peak(orig_order), best_peak = orig_peak;
+    std::vector<size_t> best_order;
+    if (seq_opt.enable_mem_aware_topo_sort) {
+        auto try_order = [&](std::vector<size_t> order) {
+            sched.local_search(order);
+            auto peak = sched.peak(order);
+            if (peak < best_peak) {
+                best_peak = peak;
+                best_order = std::move(order);
+            }
+        };
+        try_order(sched.list_schedule(sched.dfs_rank()));
+        try_order(orig_order);
+    }
+
+    bool on_cpu = true;
+    for (auto opr : m_seq) {
+        auto type = opr->output(0)->comp_node().device_type();
+        if (type != CompNode::DeviceType::CPU &&
+            type != CompNode::DeviceType::MULTITHREAD) {
+            on_cpu = false;
+            break;
+        }
+    }
+    if (seq_opt.enable_cache_aware_topo_sort && on_cpu) {
+        // keep the current order among oprs without cached inputs
+        auto&& cur_order = best_order.empty() ? orig_order : best_order;
+        std::vector<size_t> rank(nr_opr);
+        for (size_t i = 0; i < nr_opr; ++i) {
+            rank[cur_order[i]] = i;
+        }
+        auto order = sched.locality_schedule(
+                rank, seq_opt.cache_aware_topo_sort_cache_size);
+        auto peak = sched.peak(order);
+        if (peak <= best_peak) {
+            best_peak = peak;
+            best_order = std::move(order);
+        }
+    }
+
+    mgb_log_debug(
+            "reorder topo sort of %zu oprs: estimated peak memory "
+            "%.3fMiB => %.3fMiB",
+            nr_opr, orig_peak / 1024.0 / 1024, best_peak / 1024.0 / 1024);
+    if (best_order.empty())
+        return;
+    OprNodeArray seq(nr_opr);
+    for (size_t i = 0; i < nr_opr; ++i) {
+        seq[i] = m_seq[best_order[i]];
+        state->opr_trait.at(seq[i]).pos = i;
+    }
+    m_seq = std::move(seq);
+}
+
 void TopoSorter::add_extra_comp_order_dep(OperatorNodeBase* opr, VarNode* var) {
     auto&& node_prop = const_cast<OprNodeProp&>(opr->node_prop());
     auto&& dep_map = node_prop.dep_map();
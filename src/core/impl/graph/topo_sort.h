@@ -78,6 +78,15 @@ private:
      */
     void bfs_make_seq();
 
+    /*!
+     * \brief reorder m_seq for seq_opt.enable_mem_aware_topo_sort and
+     *      seq_opt.enable_cache_aware_topo_sort
+     *
+     * Oprs are only reordered relative to other oprs with the same priority,
+     * and the estimated peak memory before and after are logged.
+     */
+    void reorder_seq(const VarNodeArray& dest);
+
     /*!
      * \brief add computing order requriment on opr that var must finish
      *      before it
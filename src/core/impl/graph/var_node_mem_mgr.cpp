@@ -1237,6 +1237,60 @@ void VarNodeMemManager::fwd_in2out_writable_force(VarNode* src, VarNode* dest) {
     dest_spec.force_update_src = src;
 }
 
+bool VarNodeMemManager::fwd_out2in(
+        VarNode* output, const SubTensorSpec& sub, VarNode* input) {
+    /*
+     * out2in forward is implemented by moving input into the chunk of output,
+     * as if input were readonly forwarded from it; static allocation then
+     * starts the life of that chunk when input is produced
+     */
+
+    mgb_assert(input != output);
+    assert_in_mem_opt_phase(SeqMemOptimizer::Status::ALLOW_FWD_OUT2IN);
+
+    if (!m_owner_graph->options().seq_opt.enable_mem_plan_opt)
+        return false;
+
+    if (!m_sys_alloc_static_vars.count(input) ||
+        !m_sys_alloc_static_vars.count(output)) {
+        return false;
+    }
+    mgb_assert(
+            input->m_mem_plan.valid() && output->m_mem_plan.valid() &&
+            input->m_mem_plan.layout().eq_shape(sub.layout()));
+
+    if (input->comp_node() != output->comp_node() ||
+        input->m_mem_plan.layout().is_empty() ||
+        !input->format().is_default() ||
+        !sub.layout().is_contiguous()) {
+        return false;
+    }
+
+    auto&& ispec = m_node_mem_trait.at(input);
+    auto&& ospec = m_node_mem_trait.at(output);
+    auto&& iplan = input->m_mem_plan;
+    auto&& ichk = iplan.chunk();
+    auto&& ochk = output->m_mem_plan.chunk();
+    // input must own its memory exclusively: vars forwarded from it would
+    // have to move together with it, and force updates expect the chunk to
+    // live no longer than the input
+    if (&ichk == &ochk || ichk.owner_var != input ||
+        !ichk.mem_alloc_status.is_invalid() || iplan.next_readonly_fwd_reader() ||
+        ispec.readonly_src || ispec.force_update_src || ispec.seq_force_update_dest ||
+        ospec.readonly_src || ospec.force_update_src || ospec.seq_force_update_dest ||
+        !ochk.mem_alloc_status.is_invalid()) {
+        return false;
+    }
+
+    if (!ispec.check_layout(sub.layout()))
+        return false;
+
+    m_seq_mem_opt.remove_writable_fwd_mem_plan(&iplan);
+    iplan.assign_for_forward(output->m_mem_plan, sub);
+    m_seq_mem_opt.add_out2in_fwd_chunk(&ochk);
+    return true;
+}
+
 void VarNodeMemManager::add_layout_constraint(
         VarNode* dest, VarNode::LayoutConstraintCallback callback) {
     auto&& trait = m_node_mem_trait[dest].layout_constraint;
@@ -288,6 +288,11 @@ public:
      */
     void fwd_in2out_writable_force(VarNode* src, VarNode* dest);
 
+    /*!
+     * \brief see VarNode::set_fwd_out2in
+     */
+    bool fwd_out2in(VarNode* output, const SubTensorSpec& sub, VarNode* input);
+
     void add_layout_constraint(
             VarNode* dest, VarNode::LayoutConstraintCallback callback);
 
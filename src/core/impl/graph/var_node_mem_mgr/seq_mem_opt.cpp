@@ -88,6 +88,7 @@ void SeqMemOptimizer::optimize_mem_plan() {
     OperatorNodeBase* opr = nullptr;
     MGB_TRY {
         m_writable_fwd_mem_plans.clear();
+        m_out2in_fwd_chunks.clear();
         m_status = Status::ALLOW_FWD_IN2OUT_READONLY;
         OprNodeArray oprs_to_run;
         for (auto i : *m_cur_seq_sys_alloc) {
@@ -106,6 +107,17 @@ void SeqMemOptimizer::optimize_mem_plan() {
             opr = i;
             opr->mem_plan_fwd_in2out_writable();
         }
+        opr = nullptr;
+        if (m_graph->options().seq_opt.enable_mem_fwd_out2in) {
+            // reverse order, so an output that is itself placed in a later
+            // output could pass that memory further to its own inputs
+            m_status = Status::ALLOW_FWD_OUT2IN;
+            for (auto iter = oprs_to_run.rbegin(); iter != oprs_to_run.rend();
+                 ++iter) {
+                opr = *iter;
+                opr->mem_plan_fwd_out2in();
+            }
+        }
         m_status = 0;
     }
     MGB_CATCH(MegBrainError & exc, {
@@ -202,12 +214,16 @@ bool SeqMemOptimizer::run_static_mem_alloc() {
                     dest.begin = idx;
                     dest.chunk = cur_chk;
                     dest.comp_node = i->comp_node();
-                    mgb_assert(cur_chk->owner_var == i);
+                    mgb_assert(
+                            cur_chk->owner_var == i ||
+                            m_out2in_fwd_chunks.count(cur_chk));
                 } else {
-                    // forwarded from another var
+                    // forwarded from another var, or the owner of a chunk
+                    // that has been forwarded to its inputs
                     mgb_assert(
                             i->comp_node() == dest.comp_node &&
-                            cur_chk->owner_var != i);
+                            (cur_chk->owner_var != i ||
+                             m_out2in_fwd_chunks.count(cur_chk)));
                 }
 
                 if (i->contain_flag(VarNode::Flag::NO_MEM_RECLAIM)) {
@@ -379,4 +395,15 @@ void SeqMemOptimizer::add_writable_fwd_mem_plan_pair(
     m_writable_fwd_mem_plans.emplace_back(from, to);
 }
 
+void SeqMemOptimizer::remove_writable_fwd_mem_plan(MemAllocPlan* plan) {
+    auto&& pairs = m_writable_fwd_mem_plans;
+    pairs.erase(
+            std::remove_if(
+                    pairs.begin(), pairs.end(),
+                    [plan](const std::pair<MemAllocPlan*, MemAllocPlan*>& i) {
+                        return i.first == plan || i.second == plan;
+                    }),
+            pairs.end());
+}
+
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -46,6 +46,10 @@ class SeqMemOptimizer {
     size_t m_status = 0;
     std::vector<std::pair<MemAllocPlan*, MemAllocPlan*>> m_writable_fwd_mem_plans;
 
+    //! chunks that some inputs have been placed in by out2in forwarding;
+    //! their life begins at the first such input rather than the owner var
+    ThinHashSet<MemAllocPlan::Chunk*> m_out2in_fwd_chunks;
+
     bool should_static_alloc_var(VarNode* var);
 
     bool in_sys_alloc(OperatorNodeBase* opr) const {
@@ -84,9 +88,22 @@ public:
      */
     void add_writable_fwd_mem_plan_pair(MemAllocPlan* from, MemAllocPlan* to);
 
+    /*!
+     * \brief remove all writable forward pairs that involve a MemAllocPlan
+     *
+     * this is used when the plan is moved into another chunk by out2in
+     * forwarding
+     */
+    void remove_writable_fwd_mem_plan(MemAllocPlan* plan);
+
+    //! record a chunk that has been given to an input by out2in forwarding
+    void add_out2in_fwd_chunk(MemAllocPlan::Chunk* chunk) {
+        m_out2in_fwd_chunks.insert(chunk);
+    }
+
     /*!
      * \brief optimize mem_plan for var nodes by performing
-     *      readonly/writable forwarding
+     *      readonly/writable forwarding, and out2in forwarding if enabled
      */
     void optimize_mem_plan();
 
@@ -116,12 +133,13 @@ public:
      */
     struct Status {
         static constexpr size_t ALLOW_FWD_IN2OUT_READONLY = 1,
-                                ALLOW_FWD_IN2OUT_WRITABLE = 2;
+                                ALLOW_FWD_IN2OUT_WRITABLE = 2,
+                                ALLOW_FWD_OUT2IN = 4;
     };
 
     /*!
      * \brief get current allocation status, to determine whether
-     *      mem_plan_fwd_in2out_* calls are legal
+     *      mem_plan_fwd_* calls are legal
      */
     size_t status() const { return m_status; }
 };
@@ -102,6 +102,25 @@ struct GraphCommonOptimizeOptions {
     bool weight_preprocess = false;
     //! fuse preprocess patten, like astype + pad_channel + dimshuffle
     bool fuse_preprocess = false;
+    //! whether to quantize the constant weight of float32 MatrixMul to int4
+    //! with per-group scales; the activation is still computed in float32
+    bool weight_int4 = false;
+    //! whether to store the constant weight of float32 MatrixMul and 1x1
+    //! conv in a block sparse format if most of its blocks are zero
+    bool weight_block_sparse = false;
+    //! whether to fuse float32 ConvBias and the Pooling reading it into
+    //! ConvPooling on CPU
+    bool fuse_conv_bias_pooling = false;
+    //! whether to fold shape computation into constants; only useful when
+    //! var shapes are constant, see GraphLoadConfig::const_var_shape
+    bool fold_const_shape = false;
+    //! whether to fuse sibling ConvBias or MatrixMul oprs sharing an input
+    bool horizontal_fuse = false;
+    //! whether to batch independent small MatrixMul oprs with identical shapes
+    bool batch_matmul = false;
+    //! whether to fold a symmetric constant Padding into the pads of the
+    //! Convolution, ConvBias or Pooling reading it
+    bool fold_padding = false;
     enum LayoutTransform : uint32_t {
         DEFAULT,
         NCHW4,       ///< compute using NCHW4 tensor format
@@ -135,6 +154,13 @@ struct GraphCommonOptimizeOptions {
     SET(fuse_conv_bias_with_z);
     SET(fuse_preprocess);
     SET(weight_preprocess);
+    SET(weight_int4);
+    SET(weight_block_sparse);
+    SET(fuse_conv_bias_pooling);
+    SET(fold_const_shape);
+    SET(horizontal_fuse);
+    SET(batch_matmul);
+    SET(fold_padding);
 #undef SET
 #define SET(_trans, _trans_capital)                                 \
     GraphCommonOptimizeOptions& enable_##_trans() {                 \
@@ -326,6 +352,25 @@ public:
             //! whether to enable comp node optimization (e.g. using copy
             //! stream for I/O operators)
             bool enable_seq_comp_node_opt = true;
+
+            //! whether to allow oprs like Concat to place their inputs in
+            //! the memory of their outputs, so the producers write the
+            //! result in place (see OperatorNodeBase::mem_plan_fwd_out2in)
+            bool enable_mem_fwd_out2in = false;
+
+            //! whether to reorder oprs with the same priority after topo
+            //! sort to reduce the peak memory, which is estimated from the
+            //! statically inferred var shapes
+            bool enable_mem_aware_topo_sort = false;
+
+            //! whether to reorder oprs on CPU so consumers run right after
+            //! their producers while the values are still in cache, if the
+            //! estimated peak memory is not increased
+            bool enable_cache_aware_topo_sort = false;
+
+            //! values larger than this (in bytes) are not expected to stay
+            //! in cache for enable_cache_aware_topo_sort
+            size_t cache_aware_topo_sort_cache_size = 1024 * 1024;
         } seq_opt;
 
         //! graph optimization options
@@ -610,6 +610,16 @@ public:
      */
     virtual void mem_plan_fwd_in2out_writable() {}
 
+    /*!
+     * \brief called by graph compiler to place inputs inside the memory of
+     *      an output, so producers write there directly
+     *
+     * This is only called when ComputingGraph::Options::SeqOpt::
+     * enable_mem_fwd_out2in is set, after all the in2out forwarding has been
+     * done; oprs are visited in reverse topological order.
+     */
+    virtual void mem_plan_fwd_out2in() {}
+
     /* ===================== event callbacks ===================== */
     struct OprEventCallback;
 
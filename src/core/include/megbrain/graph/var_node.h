@@ -315,6 +315,18 @@ public:
      */
     MGE_WIN_DECLSPEC_FUC VarNode& set_fwd_in2out_writable_force(VarNode* input);
 
+    /*!
+     * \brief request that this var be placed in a sub tensor of an output of
+     *      the opr reading it, so no copy is needed to produce that output
+     *
+     * Note that this function must be called from
+     *      OperatorNodeBase::mem_plan_fwd_out2in.
+     *
+     * \return whether this request could be satisfied
+     */
+    MGB_WARN_UNUSED_RESULT MGE_WIN_DECLSPEC_FUC bool set_fwd_out2in(
+            VarNode* output, const SubTensorSpec& sub);
+
     /* ===================== getter and setters =====================  */
 
     OperatorNodeBase* owner_opr() const { return m_owner; }
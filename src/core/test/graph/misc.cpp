@@ -20,6 +20,7 @@
 #include "megbrain/opr/basic_arith_wrapper.h"
 #include "megbrain/opr/blas.h"
 #include "megbrain/opr/dnn/convolution.h"
+#include "megbrain/opr/dnn/pooling.h"
 #include "megbrain/opr/indexing.h"
 #include "megbrain/opr/io.h"
 #include "megbrain/opr/tensor_manip.h"
@@ -36,6 +37,13 @@
 #include <chrono>
 #include <memory>
 
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 using namespace mgb;
 
 namespace mgb {
@@ -1748,6 +1756,147 @@ TEST(TestGraph, UpdateStaticAllocPlan) {
     func->execute();
 }
 
+TEST(TestGraph, MemAwareTopoSort) {
+    HostTensorGenerator<> gen;
+    auto host_x = gen({1});
+    constexpr size_t SIZE = 1 << 16;
+    auto run = [&](bool mem_aware, size_t& mem, HostTensorND& host_y) {
+        auto graph = ComputingGraph::make();
+        graph->options().graph_opt_level = 0;
+        graph->options().seq_opt.enable_seq_comp_node_opt = false;
+        graph->options().seq_opt.enable_mem_aware_topo_sort = mem_aware;
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x);
+        // b is created before a, so the default order computes a first and
+        // keeps it alive while computing b
+        auto b = x.broadcast({SIZE * 4}) * 2.f,
+             t = opr::reduce_sum(b, x.make_scalar(1));
+        auto a = x.broadcast({SIZE}) + 1.f, y = a + t;
+        auto func = graph->compile({make_callback_copy(y, host_y)});
+        cg::OprNodeArray seq;
+        func->iter_opr_seq([&](cg::OperatorNodeBase* opr) {
+            seq.push_back(opr);
+            return true;
+        });
+        auto pos = [&](SymbolVar var) {
+            return std::find(seq.begin(), seq.end(), var.node()->owner_opr()) -
+                   seq.begin();
+        };
+        ASSERT_EQ(mem_aware, pos(t) < pos(a));
+        mem = func->update_static_alloc_plan_and_get_size().at(x.node()->comp_node());
+        func->execute();
+    };
+    size_t mem_default, mem_aware;
+    HostTensorND host_y_default, host_y_aware;
+    run(false, mem_default, host_y_default);
+    run(true, mem_aware, host_y_aware);
+    ASSERT_LT(mem_aware, mem_default);
+    MGB_ASSERT_TENSOR_EQ(host_y_default, host_y_aware);
+}
+
+TEST(TestGraph, CacheAwareTopoSort) {
+    HostTensorGenerator<> gen;
+    auto host_x = gen({1});
+    auto run = [&](bool cache_aware, size_t& mem, HostTensorND& host_y,
+                   HostTensorND& host_z) {
+        auto graph = ComputingGraph::make();
+        graph->options().graph_opt_level = 0;
+        graph->options().seq_opt.enable_seq_comp_node_opt = false;
+        graph->options().seq_opt.enable_cache_aware_topo_sort = cache_aware;
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x), s = x + 1.f;
+        // z is created before the broadcast, so by default the large values
+        // are computed and reduced first, and s is read by z after them
+        auto z = s * 3.f, b = s.broadcast({1 << 20}) * 2.f,
+             y = opr::reduce_sum(b, x.make_scalar(1));
+        auto func = graph->compile(
+                {make_callback_copy(y, host_y), make_callback_copy(z, host_z)});
+        cg::OprNodeArray seq;
+        func->iter_opr_seq([&](cg::OperatorNodeBase* opr) {
+            seq.push_back(opr);
+            return true;
+        });
+        auto pos = [&](SymbolVar var) {
+            return std::find(seq.begin(), seq.end(), var.node()->owner_opr()) -
+                   seq.begin();
+        };
+        ASSERT_EQ(cache_aware, pos(z) < pos(b));
+        mem = func->update_static_alloc_plan_and_get_size().at(x.node()->comp_node());
+        func->execute();
+    };
+    size_t mem_default, mem_aware;
+    HostTensorND host_y_default, host_z_default, host_y_aware, host_z_aware;
+    run(false, mem_default, host_y_default, host_z_default);
+    run(true, mem_aware, host_y_aware, host_z_aware);
+    ASSERT_LE(mem_aware, mem_default);
+    MGB_ASSERT_TENSOR_EQ(host_y_default, host_y_aware);
+    MGB_ASSERT_TENSOR_EQ(host_z_default, host_z_aware);
+}
+
+#if defined(__linux__)
+TEST(TestGraph, BENCHMARK_CacheAwareTopoSort) {
+    // perf has no generic L2 event, so last level cache read misses are
+    // counted as a proxy for the L2 misses the sort tries to avoid
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // the default cpu comp node runs kernels in the caller thread
+    int fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    if (fd < 0) {
+        printf("skip benchmark: perf events are not available\n");
+        return;
+    }
+
+    auto cn = CompNode::default_cpu();
+    HostTensorGenerator<> gen;
+    auto host_x = gen({1, 16, 64, 64}, cn);
+    auto run = [&](bool cache_aware) {
+        auto graph = ComputingGraph::make();
+        graph->options().graph_opt_level = 0;
+        graph->options().seq_opt.enable_cache_aware_topo_sort = cache_aware;
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x);
+        opr::Convolution::Param conv_param;
+        conv_param.pad_h = conv_param.pad_w = 1;
+        opr::Pooling::Param pool_param;
+        pool_param.window_h = pool_param.window_w = 2;
+        pool_param.stride_h = pool_param.stride_w = 2;
+        SymbolVar sum;
+        for (int i = 0; i < 8; ++i) {
+            auto w = opr::SharedDeviceTensor::make(*graph, *gen({16, 16, 3, 3}, cn));
+            auto y = opr::relu(x * static_cast<float>(i + 1));
+            y = opr::Convolution::make(y, w, conv_param);
+            y = opr::Pooling::make(opr::relu(y + 1.f), pool_param);
+            y = opr::relu(y) * 2.f;
+            sum = i ? sum + y : y;
+        }
+        HostTensorND host_y;
+        auto func = graph->compile({make_callback_copy(sum, host_y)});
+        func->execute();
+        constexpr int RUNS = 20;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        RealTimer timer;
+        for (int i = 0; i < RUNS; ++i) {
+            func->execute();
+        }
+        auto time = timer.get_msecs() / RUNS;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t nr_miss = 0;
+        ASSERT_EQ(static_cast<ssize_t>(sizeof(nr_miss)),
+                  read(fd, &nr_miss, sizeof(nr_miss)));
+        printf("cache_aware=%d: %.3fms/iter, %.1fK LL read misses/iter\n",
+               cache_aware, time, nr_miss / 1e3 / RUNS);
+    };
+    run(false);
+    run(true);
+    close(fd);
+}
+#endif
+
 TEST(TestGraph, CPUGPUHybrid) {
     REQUIRE_GPU(1);
     auto cn_gpu = CompNode::load("gpu0");
@@ -729,9 +729,12 @@ const GraphOptimizer& GraphOptimizer::add_passes_for_optimize_options(
         }                                \
     }
 
+    // fold paddings before any layout transform changes the pad dims
+    cb(fold_padding, { add_pass<FoldPaddingPass>(); });
     cb(fuse_preprocess, {
         add_pass(FuseNCHW4Int8Preprocess::make());
         add_pass<FuseWarpPerspectiveDimshufflePass>();
+        add_pass<FuseImagePreprocessPass>();
     });
     cb(f16_io_comp, { add_pass(ConvertF32ToF16Pass::make(false)); });
     cb(f16_io_f32_comp, { add_pass(ConvertF32ToF16Pass::make(true)); });
@@ -802,6 +805,24 @@ const GraphOptimizer& GraphOptimizer::add_passes_for_optimize_options(
         add_pass<FuseConvBiasNonlinPass>();
         add_pass<FuseConvBiasZPass>();
     });
+    cb(weight_int4, {
+        add_pass<ParamFusePass>();
+        add_pass<ConvertMatMulWeightToInt4Pass>();
+    });
+    cb(weight_block_sparse, {
+        add_pass<ParamFusePass>();
+        add_pass<ConvertWeightToBlockSparsePass>();
+    });
+    cb(fuse_conv_bias_pooling, {
+        add_pass<FuseConvBiasNonlinPass>();
+        add_pass<FuseConvBiasPoolingPass>();
+    });
+    cb(fold_const_shape, { add_pass<FoldConstShapePass>(); });
+    cb(horizontal_fuse, {
+        add_pass<FuseConvBiasNonlinPass>();
+        add_pass<HorizontalFusePass>();
+    });
+    cb(batch_matmul, { add_pass<BatchMatrixMulPass>(); });
 
 #undef cb
 
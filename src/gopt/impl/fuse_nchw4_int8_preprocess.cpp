@@ -13,6 +13,7 @@
 #include "megbrain/gopt/inference.h"
 #include "megbrain/gopt/misc.h"
 #include "megbrain/graph/grad_impl.h"
+#include "megbrain/opr/basic_arith.h"
 #include "megbrain/opr/cond.h"
 #include "megbrain/opr/imgproc.h"
 #include "megbrain/opr/io.h"
@@ -747,3 +748,243 @@ void FuseWarpPerspectiveDimshufflePass::apply(OptState& opt) const {
     rewriter.apply_inplace();
     MIDOUT_E
 }
+
+/* ======================= FuseImagePreprocessPass ======================== */
+const char* FuseImagePreprocessPass::name() const {
+    return mgb_cstr_log("fuse_image_preprocess");
+}
+
+void FuseImagePreprocessPass::apply(OptState& opt) const {
+    MIDOUT_B("FuseImagePreprocessPass::apply")
+    using Param = opr::ImagePreprocess::Param;
+    using Mode = opr::Elemwise::Mode;
+    using CvtMode = opr::CvtColor::Param::Mode;
+    auto rewriter = opt.graph().make_rewriter();
+    auto uniq_reader_check = UniqReaderCheck{opt.graph()};
+
+    //! var is only read by the opr being fused, so it can be dropped
+    auto is_inner = [&](VarNode* var) {
+        return uniq_reader_check(var) && !opt.graph().endpoint_contain(var);
+    };
+
+    //! the float32 NCHW ImagePreprocess that replaced var, if var is inner
+    auto get_preprocess = [&](VarNode* var) -> opr::ImagePreprocess* {
+        if (!is_inner(var))
+            return nullptr;
+        auto ip = try_cast_as_op<opr::ImagePreprocess>(
+                rewriter.get_var(var)->owner_opr());
+        if (!ip || ip->param().format != Param::Format::NCHW ||
+            ip->output(0)->dtype() != dtype::Float32())
+            return nullptr;
+        return ip;
+    };
+
+    //! read a constant float32 var holding one value or one value per channel
+    auto get_channel_const = [](VarNode* var, size_t C, std::vector<float>& val) {
+        size_t nr_elems = var->shape().total_nr_elems();
+        if (var->dtype() != dtype::Float32() || (nr_elems != 1 && nr_elems != C))
+            return false;
+        HostTensorND host;
+        auto opr = var->owner_opr();
+        if (auto sdt = try_cast_as_op<opr::SharedDeviceTensor>(opr)) {
+            host.copy_from(sdt->get_dev_tensor()).sync();
+        } else if (auto imm = try_cast_as_op<opr::ImmutableTensor>(opr)) {
+            host.copy_from(imm->value()).sync();
+        } else {
+            return false;
+        }
+        auto ptr = host.ptr<float>();
+        val.resize(C);
+        for (size_t c = 0; c < C; ++c) {
+            val[c] = ptr[nr_elems == 1 ? 0 : c];
+        }
+        return true;
+    };
+
+    auto make_preprocess = [](VarNode* src, const std::vector<float>& scale,
+                              const std::vector<float>& bias, const Param& param,
+                              const OperatorNodeConfig& config) {
+        auto cn = src->comp_node();
+        auto make_const = [&](const std::vector<float>& val) {
+            HostTensorND host{cn, {val.size()}, dtype::Float32()};
+            memcpy(host.raw_ptr(), val.data(), val.size() * sizeof(float));
+            return opr::ImmutableTensor::make(*src->owner_graph(), host, {cn});
+        };
+        return opr::ImagePreprocess::make(
+                       src, make_const(scale), make_const(bias), param, config)
+                .node();
+    };
+
+    auto is_nhwc2nchw = [](OperatorNodeBase* opr) {
+        auto shuffle = try_cast_as_op<opr::Dimshuffle>(opr);
+        if (!shuffle)
+            return false;
+        auto&& param = shuffle->param();
+        return param.pattern_len == 4 && param.pattern[0] == 0 &&
+               param.pattern[1] == 3 && param.pattern[2] == 1 &&
+               param.pattern[3] == 2;
+    };
+    auto is_to_f32 = [](OperatorNodeBase* opr) {
+        return opr->same_type<opr::TypeCvt>() &&
+               opr->output(0)->dtype() == dtype::Float32();
+    };
+
+    //! dimshuffle(typecvt(x)) or typecvt(dimshuffle(x)), where x may be
+    //! resize(cvt_color(img)) or cvt_color(resize(img)) or either of them
+    auto try_fuse_chain = [&](OperatorNodeBase* opr) -> VarNode* {
+        bool outer_shuffle = is_nhwc2nchw(opr);
+        if ((!outer_shuffle && !is_to_f32(opr)) ||
+            opr->output(0)->comp_node().device_type() != CompNode::DeviceType::CPU)
+            return nullptr;
+        auto mid = opr->input(0);
+        if (!is_inner(mid) || (outer_shuffle ? !is_to_f32(mid->owner_opr())
+                                             : !is_nhwc2nchw(mid->owner_opr())))
+            return nullptr;
+        auto var = mid->owner_opr()->input(0);
+        if (var->dtype() != dtype::Uint8() || var->shape().ndim != 4)
+            return nullptr;
+
+        Param param;
+        param.format = Param::Format::NCHW;
+        bool has_resize = false, has_cvt_color = false;
+        while (is_inner(var)) {
+            auto src_opr = var->owner_opr();
+            if (auto resize = try_cast_as_op<opr::Resize>(src_opr)) {
+                auto&& rparam = resize->param();
+                if (has_resize || rparam.format != opr::Resize::Param::Format::NHWC ||
+                    (rparam.imode != Param::InterpolationMode::LINEAR &&
+                     rparam.imode != Param::InterpolationMode::NEAREST) ||
+                    !cg::is_static_var_shape(var))
+                    break;
+                has_resize = true;
+                param.imode = rparam.imode;
+                param.out_h = var->shape()[1];
+                param.out_w = var->shape()[2];
+                var = resize->input(0);
+            } else if (auto cvt = try_cast_as_op<opr::CvtColor>(src_opr)) {
+                auto mode = cvt->param().mode;
+                if (has_cvt_color ||
+                    (mode != CvtMode::RGB2BGR && mode != CvtMode::BGR2RGB) ||
+                    var->shape()[3] != 3)
+                    break;
+                has_cvt_color = true;
+                param.color_mode = Param::ColorMode::SWAP_RB;
+                var = cvt->input(0);
+            } else {
+                break;
+            }
+        }
+        if (var->dtype() != dtype::Uint8() || var->shape().ndim != 4)
+            return nullptr;
+        size_t C = var->shape()[3];
+        return make_preprocess(
+                rewriter.get_var(var), std::vector<float>(C, 1.f),
+                std::vector<float>(C, 0.f), param, opr->config());
+    };
+
+    //! y = x * s + b for x from an ImagePreprocess and constant s and b
+    auto try_fuse_affine = [&](OperatorNodeBase* opr) -> VarNode* {
+        auto elem = try_cast_as_op<opr::Elemwise>(opr);
+        if (!elem || elem->output(0)->dtype() != dtype::Float32())
+            return nullptr;
+        auto mode = elem->param().mode;
+        if (mode != Mode::ADD && mode != Mode::SUB && mode != Mode::MUL &&
+            mode != Mode::TRUE_DIV && mode != Mode::FUSE_MUL_ADD3)
+            return nullptr;
+        auto&& inp = elem->input();
+        size_t idx = 0;
+        opr::ImagePreprocess* ip = nullptr;
+        for (; idx < inp.size() && !ip; ++idx) {
+            ip = get_preprocess(inp[idx]);
+        }
+        if (!ip || !elem->output(0)->shape().eq_shape(inp[--idx]->shape()))
+            return nullptr;
+        size_t C = ip->input(0)->shape()[3];
+        std::vector<float> scale, bias, val[3];
+        if (!get_channel_const(ip->input(1), C, scale) ||
+            !get_channel_const(ip->input(2), C, bias))
+            return nullptr;
+        for (size_t i = 0; i < inp.size(); ++i) {
+            if (i == idx)
+                continue;
+            //! the operand must broadcast along the channel dim of NCHW
+            auto&& shp = inp[i]->shape();
+            bool per_channel = shp.total_nr_elems() == 1 ||
+                               (shp.ndim == 4 && shp[0] == 1 && shp[1] == C) ||
+                               (shp.ndim == 3 && shp[0] == C);
+            if (!per_channel ||
+                !get_channel_const(rewriter.get_var(inp[i]), C, val[i]))
+                return nullptr;
+        }
+        for (size_t c = 0; c < C; ++c) {
+            float& s = scale[c];
+            float& b = bias[c];
+            switch (mode) {
+                case Mode::ADD:
+                    b += val[1 - idx][c];
+                    break;
+                case Mode::SUB:
+                    if (idx == 0) {
+                        b -= val[1][c];
+                    } else {
+                        s = -s;
+                        b = val[0][c] - b;
+                    }
+                    break;
+                case Mode::MUL:
+                    s *= val[1 - idx][c];
+                    b *= val[1 - idx][c];
+                    break;
+                case Mode::TRUE_DIV:
+                    if (idx != 0)
+                        return nullptr;
+                    s /= val[1][c];
+                    b /= val[1][c];
+                    break;
+                default:
+                    if (idx == 2) {
+                        b += val[0][c] * val[1][c];
+                    } else {
+                        s *= val[1 - idx][c];
+                        b = b * val[1 - idx][c] + val[2][c];
+                    }
+                    break;
+            }
+        }
+        return make_preprocess(ip->input(0), scale, bias, ip->param(), ip->config());
+    };
+
+    //! typecvt(x, QuantizedS8) for x from an ImagePreprocess
+    auto try_fuse_quantize = [&](OperatorNodeBase* opr) -> VarNode* {
+        auto typecvt = try_cast_as_op<opr::TypeCvt>(opr);
+        if (!typecvt ||
+            typecvt->output(0)->dtype().enumv() != DTypeEnum::QuantizedS8)
+            return nullptr;
+        auto ip = get_preprocess(typecvt->input(0));
+        if (!ip)
+            return nullptr;
+        OperatorNodeConfig config = ip->config();
+        config.output_dtype(typecvt->output(0)->dtype());
+        return opr::ImagePreprocess::make(
+                       ip->input(0), ip->input(1), ip->input(2), ip->param(), config)
+                .node();
+    };
+
+    opt.graph().iter([&](OperatorNodeBase* opr) {
+        VarNode* new_var = try_fuse_chain(opr);
+        if (!new_var)
+            new_var = try_fuse_affine(opr);
+        if (!new_var)
+            new_var = try_fuse_quantize(opr);
+        if (new_var) {
+            rewriter.replace_var(
+                    opr->output(0), new_var,
+                    mgb_cstr_log("fuse image preprocessing into image_preprocess"));
+            return;
+        }
+        auto repl = rewriter.auto_replace_outputs(opr);
+        uniq_reader_check.update_on_opr_auto_replace(opr, repl);
+    });
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
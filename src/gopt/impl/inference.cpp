@@ -2170,6 +2170,1085 @@ void FuseDeconvCvtPass::apply(OptState& state) const {
     MIDOUT_E
 }
 
+/* ================ ConvertMatMulWeightToInt4Pass ================ */
+namespace {
+//! copy the value of a SharedDeviceTensor or ImmutableTensor var to host
+bool get_const_weight(VarNode* var, HostTensorND& weight) {
+    auto opr = var->owner_opr();
+    if (auto sdt = try_cast_as_op<opr::SharedDeviceTensor>(opr)) {
+        weight.copy_from(sdt->get_dev_tensor()).sync();
+    } else if (auto imm = try_cast_as_op<opr::ImmutableTensor>(opr)) {
+        weight.copy_from(imm->value()).sync();
+    } else {
+        return false;
+    }
+    return true;
+}
+}  // namespace
+
+const char* ConvertMatMulWeightToInt4Pass::name() const {
+    return mgb_cstr_log("convert_matmul_weight_to_int4");
+}
+
+void ConvertMatMulWeightToInt4Pass::apply(OptState& state) const {
+    MIDOUT_B("ConvertMatMulWeightToInt4Pass::apply")
+    using Format = megdnn::param::MatrixMul::Format;
+    constexpr size_t GROUP = 32;
+    constexpr size_t GROUP_BYTES = megdnn::MatrixMul::w4_g32_group_bytes();
+
+    //! weight is (K, N), or (N, K) if transpose; the result is (N, K / 32 * 20)
+    auto pack = [](const HostTensorND& weight, bool transpose) {
+        size_t K = weight.shape(transpose), N = weight.shape(!transpose);
+        ptrdiff_t stride_k = weight.layout().stride[transpose],
+                  stride_n = weight.layout().stride[!transpose];
+        HostTensorND packed{
+                weight.comp_node(), {N, K / GROUP * GROUP_BYTES}, dtype::Byte()};
+        auto src = weight.ptr<dt_float32>();
+        auto dst = reinterpret_cast<uint8_t*>(packed.raw_ptr());
+        for (size_t n = 0; n < N; ++n) {
+            for (size_t k0 = 0; k0 < K; k0 += GROUP, dst += GROUP_BYTES) {
+                auto w = [&](size_t i) {
+                    return src[n * stride_n + (k0 + i) * stride_k];
+                };
+                float absmax = 0.f;
+                for (size_t i = 0; i < GROUP; ++i) {
+                    absmax = std::max(absmax, std::abs(w(i)));
+                }
+                float scale = absmax / 7.f, inv_scale = scale > 0.f ? 1.f / scale : 0.f;
+                auto quantize = [&](size_t i) {
+                    int q = static_cast<int>(std::round(w(i) * inv_scale));
+                    return static_cast<uint8_t>(std::min(std::max(q, -8), 7) & 0xF);
+                };
+                memcpy(dst, &scale, sizeof(float));
+                for (size_t j = 0; j < GROUP / 2; ++j) {
+                    dst[sizeof(float) + j] = quantize(j) | quantize(j + GROUP / 2) << 4;
+                }
+            }
+        }
+        return packed;
+    };
+
+    auto rewriter = state.graph().make_rewriter();
+    //! packed weights indexed by transposeB, as a weight may have many readers
+    ThinHashMap<VarNode*, VarNode*> packed_weights[2];
+    auto try_convert = [&](opr::MatrixMul* matmul) -> VarNode* {
+        auto&& param = matmul->param();
+        auto a = rewriter.get_var(matmul->input(0)),
+             b = rewriter.get_var(matmul->input(1));
+        if (matmul->output(0)->comp_node().device_type() !=
+                    CompNode::DeviceType::CPU ||
+            param.format != Format::DEFAULT || param.transposeA ||
+            param.compute_mode != megdnn::param::MatrixMul::ComputeMode::DEFAULT ||
+            a->dtype() != dtype::Float32() || b->dtype() != dtype::Float32() ||
+            b->shape().ndim != 2 || !b->shape().total_nr_elems() ||
+            b->shape()[param.transposeB] % GROUP) {
+            return nullptr;
+        }
+        auto&& packed_cache = packed_weights[param.transposeB];
+        auto iter = packed_cache.find(b);
+        if (iter == packed_cache.end()) {
+            HostTensorND weight;
+            if (!get_const_weight(b, weight)) {
+                return nullptr;
+            }
+            auto packed = opr::SharedDeviceTensor::make_const(
+                    *b->owner_graph(), pack(weight, param.transposeB),
+                    OperatorNodeConfig{ssprintf("%s:w4_g32", b->cname())});
+            iter = packed_cache.emplace(b, packed.node()).first;
+        }
+        auto new_param = param;
+        new_param.format = Format::W4_G32;
+        new_param.transposeB = false;
+        return opr::MatrixMul::make(
+                       a, iter->second, new_param, matmul->execution_policy(),
+                       matmul->config())
+                .node();
+    };
+
+    state.graph().iter([&](OperatorNodeBase* opr) {
+        if (auto matmul = try_cast_as_op<opr::MatrixMul>(opr)) {
+            if (auto new_var = try_convert(matmul)) {
+                rewriter.replace_var(
+                        opr->output(0), new_var,
+                        mgb_cstr_log("replace matmul(x, w) -> matmul(x, int4(w))"));
+                return;
+            }
+        }
+        rewriter.auto_replace_outputs(opr);
+    });
+
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
+/* ================ ConvertWeightToBlockSparsePass ================ */
+const char* ConvertWeightToBlockSparsePass::name() const {
+    return mgb_cstr_log("convert_weight_to_block_sparse");
+}
+
+void ConvertWeightToBlockSparsePass::apply(OptState& state) const {
+    MIDOUT_B("ConvertWeightToBlockSparsePass::apply")
+    using MatMulParam = megdnn::param::MatrixMul;
+    using NonlineMode = opr::ConvBias::Param::NonlineMode;
+    using ElemMode = opr::Elemwise::Mode;
+
+    //! pack the (R, K) matrix whose element (r, k) is at
+    //! weight[r * stride_r + k * stride_k]; the result is empty if the matrix
+    //! is not sparse enough
+    auto pack = [this](const HostTensorND& weight, size_t R, size_t K,
+                       ptrdiff_t stride_r, ptrdiff_t stride_k) {
+        HostTensorND packed;
+        if (R % 8 || !K) {
+            return packed;
+        }
+        auto src = weight.ptr<dt_float32>();
+        auto w = [&](size_t r, size_t k) { return src[r * stride_r + k * stride_k]; };
+        std::vector<std::vector<int32_t>> cols(R / 8);
+        size_t nr_nonzero = 0, max_nr_blocks = 0;
+        for (size_t r = 0; r < R / 8; ++r) {
+            for (size_t k = 0; k < K; ++k) {
+                for (size_t i = 0; i < 8; ++i) {
+                    if (w(r * 8 + i, k) != 0.f) {
+                        cols[r].push_back(k);
+                        break;
+                    }
+                }
+            }
+            nr_nonzero += cols[r].size();
+            max_nr_blocks = std::max(max_nr_blocks, cols[r].size());
+        }
+        size_t nr_blocks = R / 8 * K,
+               row_bytes = megdnn::MatrixMul::bsr_8x1_row_bytes(max_nr_blocks);
+        if (nr_blocks - nr_nonzero < m_sparsity_threshold * nr_blocks ||
+            R / 8 * row_bytes >= R * K * sizeof(dt_float32)) {
+            return packed;
+        }
+        packed = {weight.comp_node(), {R / 8, row_bytes}, dtype::Byte()};
+        auto dst = reinterpret_cast<uint8_t*>(packed.raw_ptr());
+        memset(dst, 0, R / 8 * row_bytes);
+        for (size_t r = 0; r < R / 8; ++r, dst += row_bytes) {
+            int32_t nr = cols[r].size();
+            memcpy(dst, &nr, sizeof(int32_t));
+            memcpy(dst + 4, cols[r].data(), nr * sizeof(int32_t));
+            auto vals = reinterpret_cast<dt_float32*>(dst + 4 + 4 * max_nr_blocks);
+            for (int32_t b = 0; b < nr; ++b) {
+                for (size_t i = 0; i < 8; ++i) {
+                    vals[b * 8 + i] = w(r * 8 + i, cols[r][b]);
+                }
+            }
+        }
+        return packed;
+    };
+
+    auto rewriter = state.graph().make_rewriter();
+    //! packed weights indexed by the axis of the weight that becomes the rows
+    //! of the sparse matrix; nullptr if the weight stays dense
+    ThinHashMap<VarNode*, VarNode*> packed_weights[2];
+    auto get_packed = [&](VarNode* weight_var, size_t row_axis) -> VarNode* {
+        auto&& packed_cache = packed_weights[row_axis];
+        auto iter = packed_cache.find(weight_var);
+        if (iter != packed_cache.end()) {
+            return iter->second;
+        }
+        VarNode* ret = nullptr;
+        HostTensorND weight;
+        if (weight_var->dtype() == dtype::Float32() &&
+            get_const_weight(weight_var, weight)) {
+            auto&& layout = weight.layout();
+            auto packed =
+                    pack(weight, layout[row_axis], layout[1 - row_axis],
+                         layout.stride[row_axis], layout.stride[1 - row_axis]);
+            if (packed.shape().ndim) {
+                ret = opr::SharedDeviceTensor::make_const(
+                              *weight_var->owner_graph(), packed,
+                              OperatorNodeConfig{
+                                      ssprintf("%s:bsr_8x1", weight_var->cname())})
+                              .node();
+            }
+        }
+        packed_cache[weight_var] = ret;
+        return ret;
+    };
+
+    //! y(M, N) = x(M, K) * w(K, N) is computed as w^T * x^T
+    auto try_convert_matmul = [&](opr::MatrixMul* matmul) -> VarNode* {
+        auto&& param = matmul->param();
+        auto x = rewriter.get_var(matmul->input(0)),
+             w = rewriter.get_var(matmul->input(1));
+        if (param.format != MatMulParam::Format::DEFAULT ||
+            param.compute_mode != MatMulParam::ComputeMode::DEFAULT ||
+            x->dtype() != dtype::Float32() || w->shape().ndim != 2) {
+            return nullptr;
+        }
+        auto packed = get_packed(w, param.transposeB ? 0 : 1);
+        if (!packed) {
+            return nullptr;
+        }
+        MatMulParam new_param;
+        new_param.format = MatMulParam::Format::BSR_8X1;
+        new_param.transposeB = !param.transposeA;
+        auto y_t = opr::MatrixMul::make(
+                packed, x, new_param, matmul->execution_policy());
+        return opr::Dimshuffle::make(y_t, {1, 0}).node();
+    };
+
+    //! y(N, OC, H, W) = w(OC, IC) * x(N, IC, H, W) is computed on x viewed as
+    //! (IC, N * H * W), which needs no copy if N is 1
+    auto is_dense_conv1x1 = [](const auto& param, VarNode* x, VarNode* w) {
+        using Param = std::decay_t<decltype(param)>;
+        return param.format == Param::Format::NCHW &&
+               param.sparse == Param::Sparse::DENSE && param.stride_h == 1 &&
+               param.stride_w == 1 && param.pad_h == 0 && param.pad_w == 0 &&
+               param.dilate_h == 1 && param.dilate_w == 1 &&
+               param.compute_mode == Param::ComputeMode::DEFAULT &&
+               x->dtype() == dtype::Float32() && w->shape().ndim == 4 &&
+               w->shape()[2] == 1 && w->shape()[3] == 1;
+    };
+    auto make_conv1x1 = [&](VarNode* packed, VarNode* x_var, VarNode* w) {
+        SymbolVar x{x_var};
+        auto cv = [&x](int v) { return x.make_scalar(v); };
+        auto shp = opr::GetVarShape::make(x);
+        auto sub = [&shp, &cv](int idx) {
+            return opr::IndexAt::make(shp, {{0, cv(idx)}});
+        };
+        auto x_mat = opr::Reshape::make(
+                opr::Dimshuffle::make(x, {1, 0, 2, 3}), TensorShape{w->shape()[1], 1},
+                1);
+        MatMulParam param;
+        param.format = MatMulParam::Format::BSR_8X1;
+        auto y_mat = opr::MatrixMul::make(packed, x_mat, param);
+        auto y = opr::Reshape::make(
+                y_mat,
+                opr::Concat::make(
+                        {cv(static_cast<int>(w->shape()[0])), sub(0), sub(2), sub(3)},
+                        0));
+        return opr::Dimshuffle::make(y, {1, 0, 2, 3});
+    };
+    auto try_convert_conv_bias = [&](opr::ConvBias* conv) -> VarNode* {
+        auto x = rewriter.get_var(conv->input(0)),
+             w = rewriter.get_var(conv->input(1));
+        if (conv->input().size() > 3 || !is_dense_conv1x1(conv->param(), x, w) ||
+            conv->output(0)->dtype() != dtype::Float32()) {
+            return nullptr;
+        }
+        bool has_bias = conv->input().size() == 3;
+        //! no elemwise is needed for identity without bias
+        bool need_elemwise = true;
+        ElemMode mode = ElemMode::ADD;
+        switch (conv->param().nonlineMode) {
+            case NonlineMode::IDENTITY:
+                need_elemwise = has_bias;
+                break;
+            case NonlineMode::RELU:
+                mode = has_bias ? ElemMode::FUSE_ADD_RELU : ElemMode::RELU;
+                break;
+            case NonlineMode::SIGMOID:
+                mode = has_bias ? ElemMode::FUSE_ADD_SIGMOID : ElemMode::SIGMOID;
+                break;
+            case NonlineMode::H_SWISH:
+                mode = has_bias ? ElemMode::FUSE_ADD_H_SWISH : ElemMode::H_SWISH;
+                break;
+            default:
+                return nullptr;
+        }
+        auto packed = get_packed(w, 0);
+        if (!packed) {
+            return nullptr;
+        }
+        auto y = make_conv1x1(packed, x, w);
+        if (has_bias) {
+            y = opr::Elemwise::make({y, rewriter.get_var(conv->input(2))}, mode);
+        } else if (need_elemwise) {
+            y = opr::Elemwise::make({y}, mode);
+        }
+        return y.node();
+    };
+    auto try_convert_conv = [&](opr::Convolution* conv) -> VarNode* {
+        auto x = rewriter.get_var(conv->input(0)),
+             w = rewriter.get_var(conv->input(1));
+        if (!is_dense_conv1x1(conv->param(), x, w)) {
+            return nullptr;
+        }
+        auto packed = get_packed(w, 0);
+        return packed ? make_conv1x1(packed, x, w).node() : nullptr;
+    };
+
+    state.graph().iter([&](OperatorNodeBase* opr) {
+        VarNode* new_var = nullptr;
+        //! BSR_8X1 only has cpu kernels
+        if (opr->output(0)->comp_node().device_type() != CompNode::DeviceType::CPU) {
+            rewriter.auto_replace_outputs(opr);
+            return;
+        }
+        if (auto matmul = try_cast_as_op<opr::MatrixMul>(opr)) {
+            new_var = try_convert_matmul(matmul);
+        } else if (auto conv_bias = try_cast_as_op<opr::ConvBias>(opr)) {
+            new_var = try_convert_conv_bias(conv_bias);
+        } else if (auto conv = try_cast_as_op<opr::Convolution>(opr)) {
+            new_var = try_convert_conv(conv);
+        }
+        if (new_var) {
+            rewriter.replace_var(
+                    opr->output(0), new_var,
+                    mgb_cstr_log("replace dense weight by block sparse weight"));
+            return;
+        }
+        rewriter.auto_replace_outputs(opr);
+    });
+
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
+/* ================ FoldPaddingPass ================ */
+const char* FoldPaddingPass::name() const {
+    return mgb_cstr_log("fold_padding");
+}
+
+void FoldPaddingPass::apply(OptState& state) const {
+    MIDOUT_B("FoldPaddingPass::apply")
+    using Format = megdnn::param::Convolution::Format;
+    using PaddingMode = opr::Padding::Param::PaddingMode;
+    using PoolingMode = opr::Pooling::Param::Mode;
+
+    //! return the symmetric pads (pad_h, pad_w) of a padding on an input in
+    //! format, or None if it pads any other dim or is asymmetric
+    auto get_pads = [](const opr::Padding::Param& param, Format format,
+                       size_t ndim) -> Maybe<std::pair<uint32_t, uint32_t>> {
+        size_t dim_h;
+        switch (format) {
+            case Format::NCHW:
+            case Format::NCHW4:
+            case Format::NCHW8:
+            case Format::NCHW32:
+            case Format::NCHW64:
+            case Format::NCHW88:
+            case Format::NCHW44:
+            case Format::NCHW44_DOT:
+                dim_h = 2;
+                break;
+            case Format::NHWC:
+            case Format::CHWN4:
+                dim_h = 1;
+                break;
+            default:
+                return None;
+        }
+        const uint32_t front[] = {param.front_offset_dim0, param.front_offset_dim1,
+                                  param.front_offset_dim2, param.front_offset_dim3,
+                                  param.front_offset_dim4, param.front_offset_dim5,
+                                  param.front_offset_dim6},
+                       back[] = {param.back_offset_dim0, param.back_offset_dim1,
+                                 param.back_offset_dim2, param.back_offset_dim3,
+                                 param.back_offset_dim4, param.back_offset_dim5,
+                                 param.back_offset_dim6};
+        for (size_t i = 0; i < 7; ++i) {
+            bool spatial = i == dim_h || i == dim_h + 1;
+            if ((!spatial || i >= ndim) && (front[i] || back[i])) {
+                return None;
+            }
+            if (spatial && front[i] != back[i]) {
+                return None;
+            }
+        }
+        return std::make_pair(front[dim_h], front[dim_h + 1]);
+    };
+
+    auto rewriter = state.graph().make_rewriter();
+
+    //! the Padding whose constant is the given value, or nullptr
+    auto get_padding = [&](VarNode* var, bool neg_inf) -> opr::Padding* {
+        auto padding = try_cast_as_op<opr::Padding>(var->owner_opr());
+        if (!padding || padding->param().padding_mode != PaddingMode::CONSTANT) {
+            return nullptr;
+        }
+        auto val = padding->param().padding_val;
+        if (neg_inf ? !(std::isinf(val) && val < 0 &&
+                        var->dtype().category() == DTypeCategory::FLOAT)
+                    : val != 0.f) {
+            return nullptr;
+        }
+        // the pad of conv is the zero point for asymmetric quantized dtypes,
+        // while Padding fills a raw zero
+        auto dt = var->dtype().enumv();
+        if (dt == DTypeEnum::Quantized8Asymm || dt == DTypeEnum::Quantized4Asymm) {
+            return nullptr;
+        }
+        return padding;
+    };
+
+    auto try_fold = [&](OperatorNodeBase* opr) -> VarNode* {
+        auto src = rewriter.get_var(opr->input(0));
+        VarNodeArray new_inp;
+        for (auto i : opr->input()) {
+            new_inp.push_back(rewriter.get_var(i));
+        }
+        if (auto conv = try_cast_as_op<opr::ConvBias>(opr)) {
+            auto padding = get_padding(src, false);
+            if (!padding)
+                return nullptr;
+            auto pads = get_pads(
+                    padding->param(), conv->param().format, src->shape().ndim);
+            if (!pads.valid())
+                return nullptr;
+            auto param = conv->param();
+            param.pad_h += pads->first;
+            param.pad_w += pads->second;
+            new_inp[0] = padding->input(0);
+            auto&& policy = conv->execution_policy();
+            auto&& config = conv->config();
+            if (new_inp.size() == 2) {
+                return opr::ConvBias::make(
+                               new_inp[0], new_inp[1], param, policy, config)
+                        .node();
+            } else if (new_inp.size() == 3) {
+                return opr::ConvBias::make(
+                               new_inp[0], new_inp[1], new_inp[2], param, policy,
+                               config)
+                        .node();
+            }
+            mgb_assert(new_inp.size() == 4);
+            return opr::ConvBias::make(
+                           new_inp[0], new_inp[1], new_inp[2], new_inp[3], param,
+                           policy, config)
+                    .node();
+        }
+        if (auto conv = try_cast_as_op<opr::Convolution>(opr)) {
+            auto padding = get_padding(src, false);
+            if (!padding)
+                return nullptr;
+            auto pads = get_pads(
+                    padding->param(), conv->param().format, src->shape().ndim);
+            if (!pads.valid())
+                return nullptr;
+            auto param = conv->param();
+            param.pad_h += pads->first;
+            param.pad_w += pads->second;
+            return opr::Convolution::make(
+                           padding->input(0), new_inp[1], param,
+                           conv->execution_policy(), conv->config())
+                    .node();
+        }
+        if (auto pooling = try_cast_as_op<opr::Pooling>(opr)) {
+            auto mode = pooling->param().mode;
+            // pads of AVERAGE_COUNT_EXCLUDE_PADDING are not counted, and pads
+            // of MAX never win, so only -inf is equivalent for MAX
+            if (mode == PoolingMode::AVERAGE_COUNT_EXCLUDE_PADDING)
+                return nullptr;
+            auto padding = get_padding(src, mode == PoolingMode::MAX);
+            if (!padding)
+                return nullptr;
+            auto pads = get_pads(
+                    padding->param(), pooling->param().format, src->shape().ndim);
+            if (!pads.valid())
+                return nullptr;
+            auto param = pooling->param();
+            param.pad_h += pads->first;
+            param.pad_w += pads->second;
+            // each window must still cover some input
+            if (param.pad_h >= param.window_h || param.pad_w >= param.window_w)
+                return nullptr;
+            return opr::Pooling::make(
+                           padding->input(0), param, pooling->config(),
+                           pooling->execution_policy())
+                    .node();
+        }
+        return nullptr;
+    };
+
+    state.graph().iter([&](OperatorNodeBase* opr) {
+        if (auto new_var = try_fold(opr)) {
+            rewriter.replace_var(
+                    opr->output(0), new_var,
+                    mgb_cstr_log("replace op(padding(x)) -> op(x) with larger pads"));
+            return;
+        }
+        rewriter.auto_replace_outputs(opr);
+    });
+
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
+/* ================ FuseConvBiasPoolingPass ================ */
+const char* FuseConvBiasPoolingPass::name() const {
+    return mgb_cstr_log("fuse_conv_bias_pooling");
+}
+
+void FuseConvBiasPoolingPass::apply(OptState& state) const {
+    MIDOUT_B("FuseConvBiasPoolingPass::apply")
+    using ConvParam = opr::ConvBias::Param;
+    using PoolingMode = opr::Pooling::Param::Mode;
+    using ConvPoolingParam = opr::ConvPooling::Param;
+
+    //! ConvPooling computes the conv directly, with about one load per
+    //! multiply-add in its x86 and arm kernels, while im2col + matmul reuses
+    //! each load for several outputs. The fusion only pays off when the conv
+    //! output it keeps in cache costs about as much as the conv, i.e. for few
+    //! input channels, as for the first conv (up to 7x7) on an image
+    constexpr size_t MAX_FILTER_SIZE = 3 * 7 * 7;
+
+    auto rewriter = state.graph().make_rewriter();
+    UniqReaderCheck uniq_reader_check{state.graph()};
+
+    auto get_conv_bias = [&](VarNode* var) -> opr::ConvBias* {
+        auto conv = try_cast_as_op<opr::ConvBias>(var->owner_opr());
+        if (!conv || conv->output(0) != var || !uniq_reader_check(var) ||
+            state.graph().endpoint_contain(var) ||
+            var->comp_node().device_type() != CompNode::DeviceType::CPU)
+            return nullptr;
+        auto&& param = conv->param();
+        if (param.format != ConvParam::Format::NCHW ||
+            param.sparse != ConvParam::Sparse::DENSE || param.dilate_h != 1 ||
+            param.dilate_w != 1 ||
+            param.compute_mode != ConvParam::ComputeMode::DEFAULT)
+            return nullptr;
+        if (param.nonlineMode != ConvParam::NonlineMode::IDENTITY &&
+            param.nonlineMode != ConvParam::NonlineMode::RELU &&
+            param.nonlineMode != ConvParam::NonlineMode::SIGMOID)
+            return nullptr;
+        if (conv->input().size() > 3)
+            return nullptr;
+        for (auto i : conv->input()) {
+            if (i->dtype() != dtype::Float32())
+                return nullptr;
+        }
+        auto&& filter = conv->input(1)->shape();
+        if (var->dtype() != dtype::Float32() || filter.ndim != 4 ||
+            filter[1] * filter[2] * filter[3] > MAX_FILTER_SIZE)
+            return nullptr;
+        // ConvPooling only takes a bias per output channel
+        if (conv->input().size() == 3) {
+            auto&& bias = conv->input(2)->shape();
+            if (bias.ndim != 4 || bias[0] != 1 || bias[1] != filter[0] ||
+                bias[2] != 1 || bias[3] != 1)
+                return nullptr;
+        }
+        return conv;
+    };
+
+    auto try_fuse = [&](OperatorNodeBase* opr) -> VarNode* {
+        auto pooling = try_cast_as_op<opr::Pooling>(opr);
+        if (!pooling)
+            return nullptr;
+        auto&& pparam = pooling->param();
+        if (pparam.format != opr::Pooling::Param::Format::NCHW ||
+            (pparam.mode != PoolingMode::MAX && pparam.mode != PoolingMode::AVERAGE) ||
+            pparam.pad_h >= pparam.window_h || pparam.pad_w >= pparam.window_w)
+            return nullptr;
+        auto conv = get_conv_bias(pooling->input(0));
+        if (!conv)
+            return nullptr;
+        auto&& cparam = conv->param();
+
+        ConvPoolingParam param;
+        param.convMode = cparam.mode == ConvParam::Mode::CONVOLUTION
+                               ? ConvPoolingParam::ConvMode::CONVOLUTION
+                               : ConvPoolingParam::ConvMode::CROSS_CORRELATION;
+        param.poolMode = pparam.mode == PoolingMode::MAX
+                               ? ConvPoolingParam::PoolMode::MAX
+                               : ConvPoolingParam::PoolMode::AVERAGE;
+        switch (cparam.nonlineMode) {
+            case ConvParam::NonlineMode::RELU:
+                param.nonlineMode = ConvPoolingParam::NonlineMode::RELU;
+                break;
+            case ConvParam::NonlineMode::SIGMOID:
+                param.nonlineMode = ConvPoolingParam::NonlineMode::SIGMOID;
+                break;
+            default:
+                param.nonlineMode = ConvPoolingParam::NonlineMode::IDENTITY;
+                break;
+        }
+        param.pool_shape_h = pparam.window_h;
+        param.pool_shape_w = pparam.window_w;
+        param.pool_stride_h = pparam.stride_h;
+        param.pool_stride_w = pparam.stride_w;
+        param.pool_pad_h = pparam.pad_h;
+        param.pool_pad_w = pparam.pad_w;
+        param.conv_stride_h = cparam.stride_h;
+        param.conv_stride_w = cparam.stride_w;
+        param.conv_pad_h = cparam.pad_h;
+        param.conv_pad_w = cparam.pad_w;
+
+        auto src = rewriter.get_var(conv->input(0)),
+             filter = rewriter.get_var(conv->input(1));
+        VarNode* bias;
+        if (conv->input().size() == 3) {
+            bias = rewriter.get_var(conv->input(2));
+        } else {
+            auto cn = conv->output(0)->comp_node();
+            HostTensorND zero{cn, {1, filter->shape()[0], 1, 1}, dtype::Float32()};
+            memset(zero.raw_ptr(), 0, zero.layout().span().dist_byte());
+            bias = opr::ImmutableTensor::make(*src->owner_graph(), zero, {cn}).node();
+        }
+        return opr::ConvPooling::make(src, filter, bias, param, pooling->config())
+                .node();
+    };
+
+    state.graph().iter([&](OperatorNodeBase* opr) {
+        if (auto new_var = try_fuse(opr)) {
+            rewriter.replace_var(
+                    opr->output(0), new_var,
+                    mgb_cstr_log("replace pooling(conv_bias(x)) -> conv_pooling(x)"));
+            return;
+        }
+        auto repl = rewriter.auto_replace_outputs(opr);
+        uniq_reader_check.update_on_opr_auto_replace(opr, repl);
+    });
+
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
+/* ================ FoldConstShapePass ================ */
+const char* FoldConstShapePass::name() const {
+    return mgb_cstr_log("fold_const_shape");
+}
+
+void FoldConstShapePass::apply(OptState& state) const {
+    MIDOUT_B("FoldConstShapePass::apply")
+    auto rewriter = state.graph().make_rewriter();
+    auto&& mgr = state.graph().comp_graph()->static_infer_manager();
+
+    // shape values are small; larger constants are left to ParamFusePass
+    ThinHashSet<VarNode*> foldable;
+    auto check_foldable = [&](OperatorNodeBase* opr) {
+        if (opr->input().empty() || opr->same_type<opr::ImmutableTensor>()) {
+            return;
+        }
+        for (auto var : opr->output()) {
+            if (!var->contain_flag(VarNode::Flag::VOLATILE_CONTENT) &&
+                cg::is_const_var_value(var) &&
+                mgr.infer_shape(var).total_nr_elems() <= TensorShape::MAX_NDIM) {
+                foldable.insert(var);
+            }
+        }
+    };
+
+    ThinHashSet<VarNode*> folded;
+    auto fold = [&](VarNode* var) {
+        if (!folded.insert(var).second) {
+            return;
+        }
+        HostTensorND hv;
+        hv.copy_from(mgr.infer_value(var)).sync();
+        auto new_var = opr::ImmutableTensor::make(
+                *var->owner_graph(), hv,
+                OperatorNodeConfig{var->comp_node()}.name(var->name()));
+        rewriter.replace_var(var, new_var.node(), mgb_cstr_log("const shape value"));
+    };
+
+    state.graph().iter([&](OperatorNodeBase* opr) {
+        check_foldable(opr);
+        bool all_foldable = true;
+        for (auto var : opr->output()) {
+            all_foldable &= foldable.count(var) ||
+                            var->contain_flag(VarNode::Flag::VOLATILE_CONTENT);
+        }
+        // values are folded where they are read by oprs that are kept
+        if (!all_foldable) {
+            for (auto inp : opr->input()) {
+                if (foldable.count(inp)) {
+                    state.call_with_opr(inp->owner_opr(), [&] { fold(inp); });
+                }
+            }
+        }
+        rewriter.auto_replace_outputs(opr);
+        for (auto var : opr->output()) {
+            if (foldable.count(var) && state.graph().endpoint_contain(var)) {
+                state.call_with_opr(opr, [&] { fold(var); });
+            }
+        }
+    });
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
+/* ================ HorizontalFusePass ================ */
+const char* HorizontalFusePass::name() const {
+    return mgb_cstr_log("horizontal_fuse");
+}
+
+void HorizontalFusePass::apply(OptState& state) const {
+    MIDOUT_B("HorizontalFusePass::apply")
+    using ConvParam = opr::ConvBias::Param;
+    using MatMulFormat = opr::MatrixMul::Param::Format;
+    //! siblings with more output channels already make good use of the input
+    constexpr size_t MAX_SIBLING_CHANNELS = 256, MAX_FUSED_CHANNELS = 1024;
+
+    auto rewriter = state.graph().make_rewriter();
+    ConstVarPropogate cvprop{ConstVarType::IMMUTABLE_AND_PARAM};
+    ThinHashMap<OperatorNodeBase*, size_t> opr_idx;
+
+    // number of output channels if opr can be fused, or 0
+    auto get_channels = [&](OperatorNodeBase* opr) -> size_t {
+        auto out = opr->output(0);
+        if (out->dtype().category() != DTypeCategory::FLOAT ||
+            opr->input(0)->shape().ndim == 0 || cvprop.is_const(opr->input(0)))
+            return 0;
+        for (size_t i = 1; i < opr->input().size(); ++i) {
+            if (!cvprop.is_const(opr->input(i)) ||
+                opr->input(i)->dtype() != out->dtype())
+                return 0;
+        }
+        size_t channels = 0;
+        if (auto conv = try_cast_as_op<opr::ConvBias>(opr)) {
+            auto&& param = conv->param();
+            auto&& filter = conv->input(1)->shape();
+            if (conv->input().size() > 3 || param.format != ConvParam::Format::NCHW ||
+                param.sparse != ConvParam::Sparse::DENSE || filter.ndim != 4)
+                return 0;
+            if (conv->input().size() == 3) {
+                auto&& bias = conv->input(2)->shape();
+                if (bias.ndim != 4 || bias[0] != 1 || bias[1] != filter[0] ||
+                    bias[2] != 1 || bias[3] != 1)
+                    return 0;
+            }
+            channels = filter[0];
+        } else if (auto matmul = try_cast_as_op<opr::MatrixMul>(opr)) {
+            auto&& param = matmul->param();
+            auto&& b = matmul->input(1)->shape();
+            if (param.format != MatMulFormat::DEFAULT || b.ndim != 2)
+                return 0;
+            channels = b[!param.transposeB];
+        }
+        return channels <= MAX_SIBLING_CHANNELS ? channels : 0;
+    };
+
+    auto is_same_param = [](OperatorNodeBase* a, OperatorNodeBase* b) {
+        if (a->dyn_typeinfo() != b->dyn_typeinfo() ||
+            a->output(0)->dtype() != b->output(0)->dtype() ||
+            a->output(0)->comp_node() != b->output(0)->comp_node())
+            return false;
+        if (a->same_type<opr::ConvBias>()) {
+            auto&& pa = a->cast_final<opr::ConvBias>().param();
+            auto&& pb = b->cast_final<opr::ConvBias>().param();
+            auto&& fa = a->input(1)->shape();
+            auto&& fb = b->input(1)->shape();
+            return pa.nonlineMode == pb.nonlineMode && pa.mode == pb.mode &&
+                   pa.pad_h == pb.pad_h && pa.pad_w == pb.pad_w &&
+                   pa.stride_h == pb.stride_h && pa.stride_w == pb.stride_w &&
+                   pa.dilate_h == pb.dilate_h && pa.dilate_w == pb.dilate_w &&
+                   pa.compute_mode == pb.compute_mode && fa[2] == fb[2] &&
+                   fa[3] == fb[3];
+        }
+        auto&& pa = a->cast_final<opr::MatrixMul>().param();
+        auto&& pb = b->cast_final<opr::MatrixMul>().param();
+        return pa.transposeA == pb.transposeA && pa.transposeB == pb.transposeB &&
+               pa.compute_mode == pb.compute_mode;
+    };
+
+    struct Group {
+        SmallVector<OperatorNodeBase*> oprs;
+        SmallVector<size_t> channels;
+        size_t nr_channels = 0;
+    };
+    // shared input => groups of its readers, in topological order
+    ThinHashMap<VarNode*, std::vector<Group>> input2groups;
+    VarNodeArray shared_inputs;
+
+    state.graph().iter([&](OperatorNodeBase* opr) {
+        cvprop.add_opr(opr);
+        size_t idx = opr_idx.size();
+        opr_idx[opr] = idx;
+        if (!opr->same_type<opr::ConvBias>() && !opr->same_type<opr::MatrixMul>())
+            return;
+        auto channels = get_channels(opr);
+        if (!channels)
+            return;
+        auto inp = opr->input(0);
+        auto&& groups = input2groups[inp];
+        if (groups.empty()) {
+            shared_inputs.push_back(inp);
+        }
+        for (auto&& group : groups) {
+            // the fused opr is created in place of the first opr in the group,
+            // so the weights of the others must be computed before it
+            auto leader = group.oprs[0];
+            bool ok = is_same_param(leader, opr) &&
+                      group.nr_channels + channels <= MAX_FUSED_CHANNELS;
+            for (size_t i = 1; ok && i < opr->input().size(); ++i) {
+                ok = opr_idx.at(opr->input(i)->owner_opr()) < opr_idx.at(leader);
+            }
+            if (ok) {
+                group.oprs.push_back(opr);
+                group.channels.push_back(channels);
+                group.nr_channels += channels;
+                return;
+            }
+        }
+        groups.emplace_back();
+        groups.back().oprs.push_back(opr);
+        groups.back().channels.push_back(channels);
+        groups.back().nr_channels = channels;
+    });
+
+    // cost check: the input is read and packed (nr_oprs - 1) times less, while
+    // readers of views that are not contiguous may have to copy them
+    ThinHashMap<OperatorNodeBase*, const Group*> leader2group;
+    ThinHashSet<OperatorNodeBase*> fused_oprs;
+    for (auto inp : shared_inputs) {
+        for (auto&& group : input2groups.at(inp)) {
+            if (group.oprs.size() < 2)
+                continue;
+            auto&& oshp = group.oprs[0]->output(0)->shape();
+            size_t saved = (group.oprs.size() - 1) * inp->shape().total_nr_elems(),
+                   extra = 0;
+            if (oshp.ndim && oshp[0] != 1) {
+                for (auto opr : group.oprs) {
+                    extra += opr->output(0)->shape().total_nr_elems();
+                }
+            }
+            if (!oshp.ndim || saved <= extra)
+                continue;
+            leader2group[group.oprs[0]] = &group;
+            for (auto opr : group.oprs) {
+                fused_oprs.insert(opr);
+            }
+        }
+    }
+
+    auto fuse = [&](const Group& group) {
+        auto leader = group.oprs[0];
+        auto src = rewriter.get_var(leader->input(0));
+        VarNodeArray weights;
+        for (auto opr : group.oprs) {
+            weights.push_back(rewriter.get_var(opr->input(1)));
+        }
+        VarNode* fused;
+        if (auto conv = try_cast_as_op<opr::ConvBias>(leader)) {
+            bool has_bias = false;
+            for (auto opr : group.oprs) {
+                has_bias |= opr->input().size() == 3;
+            }
+            auto filter = opr::Concat::make(weights, 0);
+            if (has_bias) {
+                VarNodeArray biases;
+                auto cn = leader->output(0)->comp_node();
+                auto dtype = leader->output(0)->dtype();
+                for (size_t i = 0; i < group.oprs.size(); ++i) {
+                    auto opr = group.oprs[i];
+                    if (opr->input().size() == 3) {
+                        biases.push_back(rewriter.get_var(opr->input(2)));
+                        continue;
+                    }
+                    HostTensorND zero{cn, {1, group.channels[i], 1, 1}, dtype};
+                    memset(zero.raw_ptr(), 0, zero.layout().span().dist_byte());
+                    biases.push_back(
+                            opr::ImmutableTensor::make(*src->owner_graph(), zero, {cn})
+                                    .node());
+                }
+                fused = opr::ConvBias::make(
+                                src, filter, opr::Concat::make(biases, 1),
+                                conv->param(), conv->execution_policy(),
+                                conv->config())
+                                .node();
+            } else {
+                fused = opr::ConvBias::make(
+                                src, filter, conv->param(), conv->execution_policy(),
+                                conv->config())
+                                .node();
+            }
+        } else {
+            auto&& matmul = leader->cast_final<opr::MatrixMul>();
+            auto weight = opr::Concat::make(weights, !matmul.param().transposeB);
+            fused = opr::MatrixMul::make(
+                            src, weight, matmul.param(), matmul.execution_policy(),
+                            matmul.config())
+                            .node();
+        }
+
+        using AIdx = opr::Subtensor::AxisIndexer;
+        auto cv = [fused](size_t v) {
+            return SymbolVar{fused}.make_scalar(static_cast<int>(v));
+        };
+        size_t begin = 0;
+        for (size_t i = 0; i < group.oprs.size(); ++i) {
+            size_t end = begin + group.channels[i];
+            auto sub = opr::Subtensor::make(
+                    fused, {AIdx::make_interval(1, cv(begin), cv(end), None)});
+            rewriter.replace_var(
+                    group.oprs[i]->output(0), sub.node(),
+                    mgb_cstr_log("replace sibling oprs by a horizontally fused "
+                                 "opr"));
+            begin = end;
+        }
+    };
+
+    state.graph().iter([&](OperatorNodeBase* opr) {
+        auto iter = leader2group.find(opr);
+        if (iter != leader2group.end()) {
+            fuse(*iter->second);
+            return;
+        }
+        if (!fused_oprs.count(opr)) {
+            rewriter.auto_replace_outputs(opr);
+        }
+    });
+
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
+/* ================ BatchMatrixMulPass ================ */
+const char* BatchMatrixMulPass::name() const {
+    return mgb_cstr_log("batch_matmul");
+}
+
+void BatchMatrixMulPass::apply(OptState& state) const {
+    MIDOUT_B("BatchMatrixMulPass::apply")
+    using Format = opr::MatrixMul::Param::Format;
+    //! only matmuls with at most so many multiply-adds are batched
+    constexpr size_t MAX_MATMUL_MACS = 1 << 18;
+    //! estimated dispatch overhead of an opr, in number of elements copied
+    constexpr size_t OPR_OVERHEAD_ELEMS = 4096;
+
+    auto rewriter = state.graph().make_rewriter();
+    ConstVarPropogate cvprop{ConstVarType::IMMUTABLE_AND_PARAM};
+    // length of the longest path from a source opr; oprs at the same depth
+    // are independent of each other
+    ThinHashMap<OperatorNodeBase*, size_t> opr_depth;
+    std::vector<OperatorNodeBase*> oprs;
+    state.graph().iter([&](OperatorNodeBase* opr) {
+        cvprop.add_opr(opr);
+        size_t depth = 0;
+        for (auto inp : opr->input()) {
+            depth = std::max(depth, opr_depth.at(inp->owner_opr()) + 1);
+        }
+        opr_depth[opr] = depth;
+        oprs.push_back(opr);
+    });
+    // still a topological order, in which the operands of all the matmuls at
+    // a depth are computed before any of them
+    std::stable_sort(
+            oprs.begin(), oprs.end(),
+            [&](OperatorNodeBase* a, OperatorNodeBase* b) {
+                return opr_depth.at(a) < opr_depth.at(b);
+            });
+
+    // key of matmuls that can be batched together, or empty
+    auto get_key = [&](opr::MatrixMul* opr) -> std::string {
+        auto&& param = opr->param();
+        auto&& a = opr->input(0)->shape();
+        auto&& b = opr->input(1)->shape();
+        auto&& c = opr->output(0)->shape();
+        if (param.format != Format::DEFAULT || cvprop.is_const(opr) ||
+            opr->output(0)->dtype().category() != DTypeCategory::FLOAT ||
+            a.ndim != 2 || b.ndim != 2 || c.ndim != 2 ||
+            c.total_nr_elems() * a[!param.transposeA] > MAX_MATMUL_MACS)
+            return {};
+        return ssprintf(
+                "%zu;%s;%s;%s;%s;%s;%d;%d;%d;%s", opr_depth.at(opr),
+                a.to_string().c_str(), b.to_string().c_str(),
+                opr->input(0)->dtype().name(), opr->input(1)->dtype().name(),
+                opr->output(0)->dtype().name(), param.transposeA, param.transposeB,
+                static_cast<int>(param.compute_mode),
+                opr->output(0)->comp_node().to_string().c_str());
+    };
+
+    struct Group {
+        SmallVector<OperatorNodeBase*> oprs;
+        //! whether all the matmuls share the right operand
+        bool share_b = true;
+    };
+    std::vector<Group> groups;
+    std::unordered_map<std::string, size_t> key2group;
+    for (auto opr : oprs) {
+        auto matmul = try_cast_as_op<opr::MatrixMul>(opr);
+        if (!matmul)
+            continue;
+        auto key = get_key(matmul);
+        if (key.empty())
+            continue;
+        auto ins = key2group.insert({key, groups.size()});
+        if (ins.second) {
+            groups.emplace_back();
+        }
+        auto&& group = groups[ins.first->second];
+        group.oprs.push_back(opr);
+        group.share_b &= opr->input(1) == group.oprs[0]->input(1);
+    }
+
+    // cost check: operands that are not constant have to be copied to be
+    // stacked, while the outputs are contiguous views
+    ThinHashMap<OperatorNodeBase*, const Group*> leader2group;
+    ThinHashSet<OperatorNodeBase*> batched_oprs;
+    for (auto&& group : groups) {
+        size_t nr = group.oprs.size();
+        if (nr < 2)
+            continue;
+        auto leader = group.oprs[0];
+        bool concat_rows = group.share_b &&
+                           !leader->cast_final<opr::MatrixMul>().param().transposeA;
+        size_t copy = 0;
+        for (auto opr : group.oprs) {
+            for (size_t i = 0; i < (concat_rows ? 1 : 2); ++i) {
+                if (!cvprop.is_const(opr->input(i))) {
+                    copy += opr->input(i)->shape().total_nr_elems();
+                }
+            }
+        }
+        if (copy >= (nr - 1) * OPR_OVERHEAD_ELEMS)
+            continue;
+        leader2group[leader] = &group;
+        for (auto opr : group.oprs) {
+            batched_oprs.insert(opr);
+        }
+    }
+
+    auto batch = [&](const Group& group) {
+        auto&& leader = group.oprs[0]->cast_final<opr::MatrixMul>();
+        auto stack = [&](size_t inp_idx, bool add_axis) {
+            VarNodeArray vars;
+            for (auto opr : group.oprs) {
+                SymbolVar var = rewriter.get_var(opr->input(inp_idx));
+                vars.push_back(add_axis ? var.add_axis(0).node() : var.node());
+            }
+            return opr::Concat::make(vars, 0);
+        };
+        bool concat_rows = group.share_b && !leader.param().transposeA;
+        SymbolVar batched;
+        if (concat_rows) {
+            batched = opr::MatrixMul::make(
+                    stack(0, false), rewriter.get_var(leader.input(1)), leader.param(),
+                    leader.execution_policy(), leader.config());
+        } else {
+            batched = opr::BatchedMatrixMul::make(
+                    stack(0, true), stack(1, true), leader.param(),
+                    leader.execution_policy(), leader.config());
+        }
+
+        using AIdx = opr::Subtensor::AxisIndexer;
+        auto cv = [&batched](size_t v) {
+            return batched.make_scalar(static_cast<int>(v));
+        };
+        size_t m = leader.output(0)->shape()[0];
+        for (size_t i = 0; i < group.oprs.size(); ++i) {
+            auto idx = concat_rows
+                             ? AIdx::make_interval(0, cv(i * m), cv((i + 1) * m), None)
+                             : AIdx::make_index(0, cv(i));
+            rewriter.replace_var(
+                    group.oprs[i]->output(0),
+                    opr::Subtensor::make(batched, {idx}).node(),
+                    mgb_cstr_log("replace small matmuls by a batched one"));
+        }
+    };
+
+    for (auto opr : oprs) {
+        state.call_with_opr(opr, [&] {
+            auto iter = leader2group.find(opr);
+            if (iter != leader2group.end()) {
+                batch(*iter->second);
+            } else if (!batched_oprs.count(opr)) {
+                rewriter.auto_replace_outputs(opr);
+            }
+        });
+    }
+
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
 /* ================ ParamMergePass ================ */
 const char* ParamMergePass::name() const {
     return mgb_cstr_log("param_merge");
@@ -0,0 +1,387 @@
+/**
+ * \file src/gopt/impl/quantization.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "megbrain/gopt/quantization.h"
+#include "megbrain/gopt/inference.h"
+#include "megbrain/opr/basic_arith.h"
+#include "megbrain/opr/blas.h"
+#include "megbrain/opr/dnn/convolution.h"
+#include "megbrain/opr/io.h"
+#include "megbrain/opr/nn_int.h"
+
+#include "megbrain/utils/hash_ct.h"
+#include "midout.h"
+
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+MIDOUT_DECL(megbrain_quantization)
+#define MIDOUT_B(tag) \
+    MIDOUT_BEGIN(megbrain_quantization, midout_iv(MGB_HASH_STR(tag))) {
+#define MIDOUT_E \
+    }            \
+    MIDOUT_END();
+
+using namespace mgb;
+using namespace gopt;
+
+namespace {
+
+using ElemMode = opr::Elemwise::Mode;
+using NonlineMode = opr::ConvBias::Param::NonlineMode;
+using Method = CalibrationOptions::Method;
+
+constexpr size_t NR_BINS = 2048, NR_QUANT_LEVELS = 128;
+//! probability given to empty bins of the quantized distribution
+constexpr double KL_EPS = 1e-4;
+constexpr float QMAX = 127.f;
+
+//! whether opr is converted by QuantizeInt8Pass
+bool is_quantizable(OperatorNodeBase* opr) {
+    for (auto i : opr->input()) {
+        if (i->dtype() != dtype::Float32())
+            return false;
+    }
+    if (opr->output(0)->dtype() != dtype::Float32())
+        return false;
+    if (auto conv = try_cast_as_op<opr::ConvBias>(opr)) {
+        auto&& param = conv->param();
+        return conv->input().size() <= 3 &&
+               param.format == opr::ConvBias::Param::Format::NCHW &&
+               (param.nonlineMode == NonlineMode::IDENTITY ||
+                param.nonlineMode == NonlineMode::RELU ||
+                param.nonlineMode == NonlineMode::H_SWISH);
+    }
+    if (auto matmul = try_cast_as_op<opr::MatrixMul>(opr)) {
+        return matmul->param().format == opr::MatrixMul::Param::Format::DEFAULT;
+    }
+    if (auto elem = try_cast_as_op<opr::Elemwise>(opr)) {
+        auto mode = elem->param().mode;
+        return mode == ElemMode::ADD || mode == ElemMode::FUSE_ADD_RELU ||
+               mode == ElemMode::RELU;
+    }
+    return false;
+}
+
+//! vars of a quantizable opr that need scales; the bias of ConvBias is
+//! quantized with the scales of input and weight
+VarNodeArray vars_need_scale(OperatorNodeBase* opr) {
+    VarNodeArray ret{opr->input().begin(), opr->input().end()};
+    if (opr->same_type<opr::ConvBias>()) {
+        ret.resize(2);
+    }
+    ret.push_back(opr->output(0));
+    return ret;
+}
+
+//! statistics of absolute values of a var
+struct VarStat {
+    float abs_max = 0;
+    std::vector<double> hist;
+
+    void update_range(const HostTensorND& val) {
+        auto ptr = val.ptr<float>();
+        for (size_t i = 0, it = val.shape().total_nr_elems(); i < it; ++i) {
+            abs_max = std::max(abs_max, std::abs(ptr[i]));
+        }
+    }
+
+    //! must be called after the range of all the data is known
+    void update_hist(const HostTensorND& val) {
+        hist.resize(NR_BINS);
+        if (!(abs_max > 0))
+            return;
+        auto ptr = val.ptr<float>();
+        float scale = NR_BINS / abs_max;
+        for (size_t i = 0, it = val.shape().total_nr_elems(); i < it; ++i) {
+            auto bin = static_cast<size_t>(std::abs(ptr[i]) * scale);
+            hist[std::min(bin, NR_BINS - 1)] += 1;
+        }
+    }
+
+    float percentile_threshold(float percentile) const {
+        double target = std::accumulate(hist.begin(), hist.end(), 0.) *
+                        percentile / 100,
+               sum = 0;
+        for (size_t i = 0; i < NR_BINS; ++i) {
+            sum += hist[i];
+            if (sum >= target) {
+                return (i + 1) * abs_max / NR_BINS;
+            }
+        }
+        return abs_max;
+    }
+
+    /*!
+     * find the threshold minimizing KL divergence between the clipped
+     * distribution and its quantization to NR_QUANT_LEVELS levels, as
+     * TensorRT entropy calibration does
+     *
+     * Values beyond the threshold are folded into the last bin of the
+     * reference distribution p only; the quantized distribution q is built
+     * from the raw bins below the threshold, so clipping them is penalized.
+     */
+    float kl_threshold() const {
+        std::vector<double> outliers(NR_BINS + 1), p(NR_BINS), q(NR_BINS);
+        for (size_t i = NR_BINS; i; --i) {
+            outliers[i - 1] = outliers[i] + hist[i - 1];
+        }
+        double best_kl = std::numeric_limits<double>::infinity();
+        size_t best_nr_bins = NR_BINS;
+        for (size_t nr_bins = NR_QUANT_LEVELS; nr_bins <= NR_BINS; ++nr_bins) {
+            std::copy(hist.begin(), hist.begin() + nr_bins, p.begin());
+            p[nr_bins - 1] += outliers[nr_bins];
+            double bins_per_level = static_cast<double>(nr_bins) / NR_QUANT_LEVELS;
+            for (size_t j = 0; j < NR_QUANT_LEVELS; ++j) {
+                size_t begin = j * bins_per_level,
+                       end = j + 1 == NR_QUANT_LEVELS ? nr_bins
+                                                      : (j + 1) * bins_per_level;
+                double sum = 0;
+                size_t nr_nonzero = 0;
+                for (size_t k = begin; k < end; ++k) {
+                    sum += hist[k];
+                    nr_nonzero += p[k] != 0;
+                }
+                for (size_t k = begin; k < end; ++k) {
+                    q[k] = p[k] != 0 ? sum / nr_nonzero : 0;
+                }
+            }
+            double sum_p = std::accumulate(p.begin(), p.begin() + nr_bins, 0.),
+                   sum_q = std::accumulate(q.begin(), q.begin() + nr_bins, 0.), kl = 0;
+            if (!(sum_q > 0))
+                continue;
+            for (size_t k = 0; k < nr_bins; ++k) {
+                if (p[k] != 0) {
+                    //! a bin of p missed by q, e.g. one only holding the
+                    //! outliers, is smoothed to keep the divergence finite
+                    double pk = p[k] / sum_p, qk = std::max(q[k] / sum_q, KL_EPS);
+                    kl += pk * std::log(pk / qk);
+                }
+            }
+            if (kl < best_kl) {
+                best_kl = kl;
+                best_nr_bins = nr_bins;
+            }
+        }
+        return (best_nr_bins + 0.5f) * abs_max / NR_BINS;
+    }
+};
+
+}  // anonymous namespace
+
+/* ================ calibrate_int8 ================ */
+
+ThinHashMap<VarNode*, float> gopt::calibrate_int8(
+        const SymbolVarArray& dest_vars, const std::vector<CalibrationBatch>& dataset,
+        const CalibrationOptions& options) {
+    mgb_assert(!dest_vars.empty() && !dataset.empty());
+    mgb_assert(
+            options.method != Method::PERCENTILE ||
+                    (options.percentile > 0 && options.percentile <= 100),
+            "bad percentile: %g", options.percentile);
+    auto graph = dest_vars[0].node()->owner_graph();
+
+    ConstVarPropogate cvprop{ConstVarType::IMMUTABLE_AND_PARAM};
+    std::unordered_map<std::string, std::shared_ptr<HostTensorND>> inputs;
+    VarNodeArray vars;
+    ThinHashSet<VarNode*> var_set;
+    cg::DepOprIter dep_iter{[&](OperatorNodeBase* opr) {
+        cvprop.add_opr(opr);
+        if (auto h2d = try_cast_as_op<opr::Host2DeviceCopy>(opr)) {
+            inputs[h2d->name()] = h2d->host_data();
+        }
+        if (!is_quantizable(opr))
+            return;
+        for (auto var : vars_need_scale(opr)) {
+            if (var_set.insert(var).second) {
+                vars.push_back(var);
+            }
+        }
+    }};
+    for (auto&& var : dest_vars) {
+        dep_iter.add(var);
+    }
+
+    std::unordered_map<std::string, HostTensorND> orig_inputs;
+    for (auto&& i : inputs) {
+        if (!i.second->empty()) {
+            orig_inputs[i.first].copy_from(*i.second);
+        }
+    }
+
+    std::vector<VarStat> stats(vars.size());
+    // constant vars use the max absolute value and are not observed in the
+    // histogram pass
+    auto run = [&](bool update_hist) {
+        ComputingGraph::OutputSpec out_spec;
+        for (size_t i = 0; i < vars.size(); ++i) {
+            if (update_hist && cvprop.is_const(vars[i]))
+                continue;
+            auto cb = [&stat = stats[i], update_hist](DeviceTensorND& dv) {
+                HostTensorND hv;
+                hv.copy_from(dv).sync();
+                if (update_hist) {
+                    stat.update_hist(hv);
+                } else {
+                    stat.update_range(hv);
+                }
+            };
+            out_spec.push_back({vars[i], cb});
+        }
+        if (out_spec.empty())
+            return;
+        auto func = graph->compile(out_spec);
+        for (auto&& batch : dataset) {
+            for (auto&& i : batch) {
+                auto iter = inputs.find(i.first);
+                mgb_assert(
+                        iter != inputs.end(), "unknown calibration input %s",
+                        i.first.c_str());
+                iter->second->copy_from(i.second);
+            }
+            func->execute().wait();
+        }
+    };
+
+    bool use_hist = options.method != Method::MINMAX;
+    run(false);
+    if (use_hist) {
+        run(true);
+    }
+    for (auto&& i : orig_inputs) {
+        inputs.at(i.first)->copy_from(i.second);
+    }
+
+    ThinHashMap<VarNode*, float> scales;
+    for (size_t i = 0; i < vars.size(); ++i) {
+        auto&& stat = stats[i];
+        float threshold = stat.abs_max;
+        if (use_hist && !cvprop.is_const(vars[i])) {
+            threshold = options.method == Method::PERCENTILE
+                              ? stat.percentile_threshold(options.percentile)
+                              : stat.kl_threshold();
+        }
+        scales[vars[i]] = threshold > 0 ? threshold / QMAX : 1.f;
+    }
+    return scales;
+}
+
+/* ================ QuantizeInt8Pass ================ */
+
+const char* QuantizeInt8Pass::name() const {
+    return mgb_cstr_log("quantize_int8");
+}
+
+void QuantizeInt8Pass::apply(OptState& opt) const {
+    MIDOUT_B("QuantizeInt8Pass::apply")
+    auto rewriter = opt.graph().make_rewriter();
+    // float var in the original graph => QuantizedS8 var
+    ThinHashMap<VarNode*, VarNode*> var2q;
+    auto get_q = [&](VarNode* var) {
+        auto&& q = var2q[var];
+        if (!q) {
+            q = opr::TypeCvt::make(
+                        rewriter.get_var(var), dtype::QuantizedS8(m_scales.at(var)))
+                        .node();
+        }
+        return q;
+    };
+    auto has_scales = [&](OperatorNodeBase* opr) {
+        if (!is_quantizable(opr))
+            return false;
+        for (auto var : vars_need_scale(opr)) {
+            if (!m_scales.count(var))
+                return false;
+        }
+        return true;
+    };
+
+    opt.graph().iter([&](OperatorNodeBase* opr) {
+        if (!has_scales(opr)) {
+            rewriter.auto_replace_outputs(opr);
+            return;
+        }
+        auto out = opr->output(0);
+        OperatorNodeConfig config{dtype::QuantizedS8(m_scales.at(out))};
+        config.name(opr->name());
+        SymbolVar q_out, f_out;
+        if (auto conv = try_cast_as_op<opr::ConvBias>(opr)) {
+            auto param = conv->param();
+            param.compute_mode = opr::ConvBias::Param::ComputeMode::DEFAULT;
+            float scale_x = m_scales.at(conv->input(0)),
+                  scale_w = m_scales.at(conv->input(1));
+            auto x = get_q(conv->input(0));
+            auto w = opr::TypeCvt::make(
+                    rewriter.get_var(conv->input(1)), dtype::QuantizedS8(scale_w));
+            if (conv->input().size() == 3) {
+                auto b = opr::TypeCvt::make(
+                        rewriter.get_var(conv->input(2)),
+                        dtype::QuantizedS32(scale_x * scale_w));
+                q_out = opr::ConvBias::make(
+                        x, w, b, param, conv->execution_policy(), config);
+            } else {
+                q_out = opr::ConvBias::make(
+                        x, w, param, conv->execution_policy(), config);
+            }
+            f_out = opr::TypeCvt::make(q_out, dtype::Float32());
+        } else if (auto matmul = try_cast_as_op<opr::MatrixMul>(opr)) {
+            auto param = matmul->param();
+            param.compute_mode = opr::MatrixMul::Param::ComputeMode::DEFAULT;
+            auto scale = m_scales.at(matmul->input(0)) * m_scales.at(matmul->input(1));
+            auto c = opr::MatrixMul::make(
+                    get_q(matmul->input(0)), get_q(matmul->input(1)), param,
+                    matmul->execution_policy(),
+                    OperatorNodeConfig{dtype::QuantizedS32(scale)});
+            q_out = opr::TypeCvt::make(c, config.output_dtype());
+            f_out = opr::TypeCvt::make(c, dtype::Float32());
+        } else {
+            using QMode = opr::ElemwiseMultiType::Mode;
+            QMode mode;
+            switch (opr->cast_final<opr::Elemwise>().param().mode) {
+                case ElemMode::ADD:
+                    mode = QMode::QADD;
+                    break;
+                case ElemMode::FUSE_ADD_RELU:
+                    mode = QMode::QFUSE_ADD_RELU;
+                    break;
+                default:
+                    mode = QMode::QRELU;
+                    break;
+            }
+            VarNodeArray inps;
+            for (auto i : opr->input()) {
+                inps.push_back(get_q(i));
+            }
+            q_out = opr::ElemwiseMultiType::make(inps, {mode}, config);
+            f_out = opr::TypeCvt::make(q_out, dtype::Float32());
+        }
+        var2q[out] = q_out.node();
+        rewriter.replace_var(out, f_out.node(), mgb_cstr_log("quantize to int8"));
+    });
+
+    rewriter.apply_inplace();
+    MIDOUT_E
+}
+
+/* ================ quantize_int8 ================ */
+
+SymbolVarArray gopt::quantize_int8(
+        const SymbolVarArray& dest_vars, const std::vector<CalibrationBatch>& dataset,
+        const CalibrationOptions& options) {
+    return GraphOptimizer{}
+            .add_pass<QuantizeInt8Pass>(calibrate_int8(dest_vars, dataset, options))
+            .add_pass<ParamFusePass>()
+            .apply(dest_vars)
+            .endpoint_vars();
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
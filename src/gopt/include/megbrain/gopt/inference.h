@@ -181,6 +181,25 @@ public:
     void apply(OptState& opt) const override;
 };
 
+/*!
+ * \brief fuse the preprocessing of NHWC uint8 images on CPU into an
+ *      ImagePreprocess
+ *
+ * Dimshuffle from NHWC to NCHW and TypeCvt to float32 in either order, over an
+ * optional NHWC LINEAR or NEAREST Resize with static output shape and an
+ * optional RGB2BGR or BGR2RGB CvtColor, are replaced by one ImagePreprocess.
+ * Following per-tensor or per-channel affine Elemwise with constant operands
+ * and a TypeCvt to QuantizedS8 are then absorbed into it. The resized image is
+ * rounded to uint8 as Resize does, so the chain with at most one multiply or
+ * add is reproduced exactly; longer affine chains are folded into a single
+ * multiply-add and may differ in the last float bits.
+ */
+class FuseImagePreprocessPass final : public Pass {
+public:
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+};
+
 /*!
  * \brief fuse deconv and typecvt to a deconv opr
  */
@@ -190,6 +209,134 @@ public:
     void apply(OptState& opt) const override;
 };
 
+/*!
+ * \brief quantize the constant float32 weight of MatrixMul to int4 with one
+ *      float32 scale per group of 32, see param::MatrixMul::Format::W4_G32
+ *
+ * Only the weight is quantized, symmetrically with scale = absmax / 7; the
+ * activation and the output stay in float32. The weight must be a
+ * SharedDeviceTensor or ImmutableTensor, so this pass is usually used after
+ * ParamFusePass. Oprs on non-cpu comp nodes are kept, as W4_G32 only has cpu
+ * kernels.
+ */
+class ConvertMatMulWeightToInt4Pass final : public Pass {
+public:
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+};
+
+/*!
+ * \brief convert the constant float32 weight of MatrixMul and of 1x1 dense
+ *      NCHW ConvBias/Convolution to param::MatrixMul::Format::BSR_8X1, if
+ *      enough of its blocks of 8 output channels are zero
+ *
+ * The sparse weight is the left operand of the new MatrixMul, so MatrixMul
+ * computes the transposed output and conv computes (OC, N * H * W), which
+ * are shuffled back; bias and nonlinearity of ConvBias become an Elemwise.
+ * The weight must be a SharedDeviceTensor or ImmutableTensor, so this pass is
+ * usually used after ParamFusePass. Oprs on non-cpu comp nodes are kept, as
+ * BSR_8X1 only has cpu kernels.
+ */
+class ConvertWeightToBlockSparsePass final : public Pass {
+    float m_sparsity_threshold;
+
+public:
+    //! weights with less than this fraction of zero blocks are kept dense
+    explicit ConvertWeightToBlockSparsePass(float sparsity_threshold = 0.7f)
+            : m_sparsity_threshold{sparsity_threshold} {}
+
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+};
+
+/*!
+ * \brief fold Padding into the pads of the ConvBias, Convolution or Pooling
+ *      reading it, so the padded tensor is not materialized
+ *
+ * Only constant padding of the spatial dims that is symmetric on each dim is
+ * folded: with zero for convolution and AVERAGE pooling, and with -inf for
+ * MAX pooling. Other paddings are kept since the kernels only take a single
+ * zero pad per dim.
+ *
+ * \note asymmetric pads and the REPLICATE/REFLECT modes still materialize
+ *      the padded tensor; folding them needs per-side pads and a pad mode in
+ *      the ConvBias/Pooling params and in their border handling, which do
+ *      not exist yet.
+ */
+class FoldPaddingPass final : public Pass {
+public:
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+};
+
+/*!
+ * \brief fuse a float32 NCHW ConvBias on CPU and the MAX or AVERAGE Pooling
+ *      that is its only reader into a ConvPooling
+ *
+ * ConvPooling pools the rows of conv output while they are still in cache,
+ * so the conv output is not written to memory. The ConvBias must be dense,
+ * without dilation and z, with a per-channel bias if any, and with an
+ * IDENTITY, RELU or SIGMOID nonlinearity. As ConvPooling computes the conv
+ * directly, only convs reading at most 147 input elements per output
+ * (e.g. 7x7 on 3 channels) are fused.
+ */
+class FuseConvBiasPoolingPass final : public Pass {
+public:
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+};
+
+/*!
+ * \brief fold shape computation into constants when var shapes are constant
+ *
+ * When input shapes are known to be constant (e.g. loaded with
+ * GraphLoadConfig::const_var_shape), the values of shape computation like
+ * GetVarShape and the arithmetic on it can be statically inferred as
+ * constant. Such values read by other oprs are replaced by ImmutableTensor,
+ * so shape subgraphs are not executed at runtime and targets of Reshape and
+ * Broadcast become constant; the folded oprs are then removed from the graph.
+ */
+class FoldConstShapePass final : public Pass {
+public:
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+};
+
+/*!
+ * \brief fuse sibling float ConvBias or MatrixMul oprs that read the same input
+ *      with constant weights
+ *
+ * The weights (and biases) of the siblings are concatenated along the output
+ * channel, so the shared input is read and packed only once by the fused
+ * opr; each original output is replaced by a Subtensor view of the fused
+ * output. A group is fused only if the input traffic saved exceeds the
+ * output elements that may have to be copied when the views are not
+ * contiguous (i.e. batch size or M is not 1).
+ */
+class HorizontalFusePass final : public Pass {
+public:
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+};
+
+/*!
+ * \brief batch small MatrixMul oprs with identical shapes at the same
+ *      topological depth, which are independent of each other
+ *
+ * If the matmuls share the same right operand and the left operands are not
+ * transposed, the left operands are concatenated along rows into a single
+ * MatrixMul; otherwise the operands are stacked into a BatchedMatrixMul.
+ * The outputs are taken back as Subtensor views, which are contiguous and
+ * forwarded without copying. Constant operands are stacked once by
+ * ParamFusePass; a group is batched only if stacking the other operands
+ * copies fewer elements than the estimated dispatch overhead saved.
+ */
+class BatchMatrixMulPass final : public Pass {
+public:
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+};
+
 /*!
  * \brief merge all the SharedDeviceTensor oprs into one
  *      MultipleDeviceTensorHolder
@@ -329,6 +476,20 @@ struct OptimizeForInferenceOptions : cg::GraphCommonOptimizeOptions {
             ret |= 1u << 4;
         if (fuse_preprocess)
             ret |= 1u << 5;
+        if (weight_int4)
+            ret |= 1u << 6;
+        if (weight_block_sparse)
+            ret |= 1u << 7;
+        if (fuse_conv_bias_pooling)
+            ret |= 1u << 8;
+        if (fold_const_shape)
+            ret |= 1u << 9;
+        if (horizontal_fuse)
+            ret |= 1u << 10;
+        if (batch_matmul)
+            ret |= 1u << 11;
+        if (fold_padding)
+            ret |= 1u << 12;
         return ret;
     }
 
@@ -340,6 +501,13 @@ struct OptimizeForInferenceOptions : cg::GraphCommonOptimizeOptions {
         ret.fuse_conv_bias_with_z = buf & 1u << 3;
         ret.weight_preprocess = buf & 1u << 4;
         ret.fuse_preprocess = buf & 1u << 5;
+        ret.weight_int4 = buf & 1u << 6;
+        ret.weight_block_sparse = buf & 1u << 7;
+        ret.fuse_conv_bias_pooling = buf & 1u << 8;
+        ret.fold_const_shape = buf & 1u << 9;
+        ret.horizontal_fuse = buf & 1u << 10;
+        ret.batch_matmul = buf & 1u << 11;
+        ret.fold_padding = buf & 1u << 12;
         ret.layout_transform = (LayoutTransform)(buf >> 32);
         return ret;
     }
@@ -0,0 +1,90 @@
+/**
+ * \file src/gopt/include/megbrain/gopt/quantization.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "megbrain/gopt/framework.h"
+
+namespace mgb {
+namespace gopt {
+
+//! a batch of calibration data: name of Host2DeviceCopy opr => input value
+using CalibrationBatch = std::unordered_map<std::string, HostTensorND>;
+
+struct CalibrationOptions {
+    //! how to compute the clipping threshold of an activation
+    enum class Method : uint32_t {
+        MINMAX,      //!< max absolute value
+        PERCENTILE,  //!< given percentile of absolute values
+        KL,          //!< minimize KL divergence between int8 and float values
+    };
+    Method method = Method::MINMAX;
+    //! percentile in (0, 100] used by Method::PERCENTILE
+    float percentile = 99.99f;
+};
+
+/*!
+ * \brief compute the QuantizedS8 scales of the float vars read or written by
+ *      the oprs that QuantizeInt8Pass converts
+ *
+ * The graph of \p dest_vars is executed on each batch, and the values of the
+ * vars are collected by output callbacks. Constant vars such as weights
+ * always use Method::MINMAX; the histogram based methods run the dataset a
+ * second time. Values of the Host2DeviceCopy inputs are restored after
+ * calibration.
+ *
+ * \return var => scale, where var belongs to the graph of \p dest_vars
+ */
+MGE_WIN_DECLSPEC_FUC ThinHashMap<VarNode*, float> calibrate_int8(
+        const SymbolVarArray& dest_vars, const std::vector<CalibrationBatch>& dataset,
+        const CalibrationOptions& options = {});
+
+/*!
+ * \brief convert float32 oprs with calibrated scales to QuantizedS8
+ *
+ * ConvBias (NCHW, with IDENTITY, RELU or H_SWISH), MatrixMul and Elemwise
+ * ADD, FUSE_ADD_RELU and RELU are converted. ConvBias writes QuantizedS8
+ * directly, so requantization is fused into the conv kernels; MatrixMul
+ * computes QuantizedS32 which is converted to QuantizedS8 for quantized
+ * readers. Adjacent quantized oprs pass QuantizedS8 values to each other,
+ * and TypeCvt to float32 is only inserted for other readers. Weights and
+ * biases are quantized by TypeCvt, which ParamFusePass folds.
+ *
+ * The scales are keyed by vars of the original graph (see calibrate_int8()),
+ * so this pass should be applied before any other pass.
+ */
+class QuantizeInt8Pass final : public Pass {
+    ThinHashMap<VarNode*, float> m_scales;
+
+public:
+    explicit QuantizeInt8Pass(ThinHashMap<VarNode*, float> scales)
+            : m_scales{std::move(scales)} {}
+
+    const char* name() const override;
+    void apply(OptState& opt) const override;
+};
+
+/*!
+ * \brief post-training quantization: calibrate on \p dataset, convert the
+ *      graph by QuantizeInt8Pass and fold the quantized weights
+ */
+MGE_WIN_DECLSPEC_FUC SymbolVarArray quantize_int8(
+        const SymbolVarArray& dest_vars, const std::vector<CalibrationBatch>& dataset,
+        const CalibrationOptions& options = {});
+
+}  // namespace gopt
+}  // namespace mgb
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
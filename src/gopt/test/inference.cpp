@@ -28,6 +28,7 @@
 #include "megbrain/opr/tensor_gen.h"
 #include "megbrain/opr/tensor_manip.h"
 #include "megbrain/opr/utility.h"
+#include "megbrain/serialization/serializer.h"
 
 #include "./helper.h"
 #include "megbrain/comp_node_env.h"
@@ -1685,6 +1686,548 @@ TEST(TestGoptInference, ConvertBatchNormPass) {
     }
 }
 
+TEST(TestGoptInference, ConvertMatMulWeightToInt4) {
+    auto cn = CompNode::load("cpu0");
+    HostTensorGenerator<> gen;
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkvar = [&](const char* name, const TensorShape& shp) {
+        return opr::Host2DeviceCopy::make(*graph, gen(shp, cn)).rename(name);
+    };
+    //! every group of 32 along K holds both -7 * 0.125 and 7 * 0.125, so the
+    //! weight is exactly representable in int4 with scale 0.125
+    auto mkcvar = [&](const char* name, size_t N, size_t K, bool transpose) {
+        TensorShape shp = transpose ? TensorShape{N, K} : TensorShape{K, N};
+        HostTensorND host_w{cn, shp, dtype::Float32()};
+        auto ptr = host_w.ptr<float>();
+        for (size_t k = 0; k < K; ++k) {
+            for (size_t n = 0; n < N; ++n) {
+                float val = (static_cast<int>((k * 3 + n) % 15) - 7) * 0.125f;
+                ptr[transpose ? n * K + k : k * N + n] = val;
+            }
+        }
+        return opr::SharedDeviceTensor::make(*graph, host_w).rename(name);
+    };
+    using Param = opr::MatrixMul::Param;
+    auto x = mkvar("x", {5, 64}), w = mkcvar("w", 48, 64, false),
+         wt = mkcvar("wt", 48, 64, true), w_odd = mkcvar("w_odd", 48, 40, false),
+         x_odd = mkvar("x_odd", {5, 40});
+    auto y0 = opr::MatrixMul::make(x, w), y1 = opr::MatrixMul::make(x, w) + 1,
+         y2 = opr::MatrixMul::make(x, wt, Param{false, true}),
+         y3 = opr::MatrixMul::make(x_odd, w_odd);
+
+    auto options = gopt::OptimizeForInferenceOptions{};
+    options.enable_weight_int4();
+    SymbolVar y0_opt, y1_opt, y2_opt, y3_opt;
+    unpack_vector(
+            gopt::optimize_for_inference({y0, y1, y2, y3}, options), y0_opt, y1_opt,
+            y2_opt, y3_opt);
+    ASSERT_EQ(
+            Param::Format::W4_G32, find_opr<opr::MatrixMul>(y0_opt).param().format);
+    ASSERT_EQ(
+            Param::Format::W4_G32, find_opr<opr::MatrixMul>(y2_opt).param().format);
+    ASSERT_FALSE(find_opr<opr::MatrixMul>(y2_opt).param().transposeB);
+    ASSERT_EQ(
+            Param::Format::DEFAULT, find_opr<opr::MatrixMul>(y3_opt).param().format);
+    //! the packed weight is shared by the readers of w
+    ASSERT_EQ(
+            find_opr<opr::MatrixMul>(y0_opt).input(1),
+            find_opr<opr::MatrixMul>(y1_opt).input(1));
+    ASSERT_EQ(
+            dtype::Byte(), find_opr<opr::MatrixMul>(y0_opt).input(1)->dtype());
+
+    HostTensorND host_y0, host_y0_opt, host_y1, host_y1_opt, host_y2, host_y2_opt,
+            host_y3, host_y3_opt;
+    auto func = graph->compile(
+            {make_callback_copy(y0, host_y0), make_callback_copy(y0_opt, host_y0_opt),
+             make_callback_copy(y1, host_y1), make_callback_copy(y1_opt, host_y1_opt),
+             make_callback_copy(y2, host_y2), make_callback_copy(y2_opt, host_y2_opt),
+             make_callback_copy(y3, host_y3),
+             make_callback_copy(y3_opt, host_y3_opt)});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_y0, host_y0_opt, 1e-4);
+    MGB_ASSERT_TENSOR_NEAR(host_y1, host_y1_opt, 1e-4);
+    MGB_ASSERT_TENSOR_NEAR(host_y2, host_y2_opt, 1e-4);
+    MGB_ASSERT_TENSOR_EQ(host_y3, host_y3_opt);
+}
+
+TEST(TestGoptInference, ConvertWeightToBlockSparse) {
+    auto cn = CompNode::load("cpu0");
+    HostTensorGenerator<> gen;
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkvar = [&](const char* name, const TensorShape& shp) {
+        return opr::Host2DeviceCopy::make(*graph, gen(shp, cn)).rename(name);
+    };
+    //! element (r, k) of the (R, K) weight is nonzero only in one of every
+    //! four 8x1 blocks unless dense is set
+    auto mkcvar = [&](const char* name, const TensorShape& shp, size_t R, size_t K,
+                      bool transpose, bool dense = false) {
+        HostTensorND host_w{cn, shp, dtype::Float32()};
+        auto ptr = host_w.ptr<float>();
+        for (size_t r = 0; r < R; ++r) {
+            for (size_t k = 0; k < K; ++k) {
+                bool zero = !dense && (r / 8 + k) % 4;
+                float val = zero ? 0.f : static_cast<int>((r * 5 + k) % 7) - 3.f;
+                ptr[transpose ? k * R + r : r * K + k] = val;
+            }
+        }
+        return opr::SharedDeviceTensor::make(*graph, host_w).rename(name);
+    };
+    using Param = opr::MatrixMul::Param;
+    auto x = mkvar("x", {5, 64}), w = mkcvar("w", {64, 48}, 48, 64, true),
+         wt = mkcvar("wt", {48, 64}, 48, 64, false),
+         w_dense = mkcvar("w_dense", {64, 48}, 48, 64, true, true);
+    auto y0 = opr::MatrixMul::make(x, w),
+         y1 = opr::MatrixMul::make(x, wt, Param{false, true}),
+         y2 = opr::MatrixMul::make(x, w_dense);
+
+    auto feat = mkvar("feat", {2, 32, 5, 7}),
+         filter = mkcvar("filter", {16, 32, 1, 1}, 16, 32, false),
+         bias = mkcvar("bias", {1, 16, 1, 1}, 1, 16, false, true);
+    opr::ConvBias::Param conv_param;
+    conv_param.nonlineMode = opr::ConvBias::Param::NonlineMode::RELU;
+    auto y3 = opr::ConvBias::make(feat, filter, bias, conv_param);
+
+    auto options = gopt::OptimizeForInferenceOptions{};
+    options.enable_weight_block_sparse();
+    SymbolVar y0_opt, y1_opt, y2_opt, y3_opt;
+    unpack_vector(
+            gopt::optimize_for_inference({y0, y1, y2, y3}, options), y0_opt, y1_opt,
+            y2_opt, y3_opt);
+    ASSERT_EQ(
+            Param::Format::BSR_8X1, find_opr<opr::MatrixMul>(y0_opt).param().format);
+    ASSERT_EQ(
+            Param::Format::BSR_8X1, find_opr<opr::MatrixMul>(y1_opt).param().format);
+    ASSERT_EQ(
+            Param::Format::DEFAULT, find_opr<opr::MatrixMul>(y2_opt).param().format);
+    ASSERT_EQ(
+            Param::Format::BSR_8X1, find_opr<opr::MatrixMul>(y3_opt).param().format);
+    ASSERT_EQ(0u, find_opr_num<opr::ConvBias>(y3_opt));
+
+    HostTensorND host_y0, host_y0_opt, host_y1, host_y1_opt, host_y2, host_y2_opt,
+            host_y3, host_y3_opt;
+    auto func = graph->compile(
+            {make_callback_copy(y0, host_y0), make_callback_copy(y0_opt, host_y0_opt),
+             make_callback_copy(y1, host_y1), make_callback_copy(y1_opt, host_y1_opt),
+             make_callback_copy(y2, host_y2), make_callback_copy(y2_opt, host_y2_opt),
+             make_callback_copy(y3, host_y3),
+             make_callback_copy(y3_opt, host_y3_opt)});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_y0, host_y0_opt, 1e-4);
+    MGB_ASSERT_TENSOR_NEAR(host_y1, host_y1_opt, 1e-4);
+    MGB_ASSERT_TENSOR_EQ(host_y2, host_y2_opt);
+    MGB_ASSERT_TENSOR_NEAR(host_y3, host_y3_opt, 1e-4);
+}
+
+TEST(TestGoptInference, ConvertWeightFormatSkipGPU) {
+    REQUIRE_GPU(1);
+    auto cn = CompNode::load("gpu0");
+    HostTensorGenerator<> gen;
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    //! a sparse weight that both passes would convert on cpu
+    HostTensorND host_w{cn, {64, 48}, dtype::Float32()};
+    auto ptr = host_w.ptr<float>();
+    for (size_t k = 0; k < 64; ++k) {
+        for (size_t n = 0; n < 48; ++n) {
+            ptr[k * 48 + n] = (n / 8 + k) % 4 ? 0.f : 1.f;
+        }
+    }
+    auto x = opr::Host2DeviceCopy::make(*graph, gen({5, 64}, cn)),
+         w = opr::SharedDeviceTensor::make(*graph, host_w);
+    auto y = opr::MatrixMul::make(x, w);
+
+    auto options = gopt::OptimizeForInferenceOptions{};
+    options.enable_weight_int4();
+    options.enable_weight_block_sparse();
+    auto y_opt = gopt::optimize_for_inference({y}, options)[0];
+    ASSERT_EQ(
+            opr::MatrixMul::Param::Format::DEFAULT,
+            find_opr<opr::MatrixMul>(y_opt).param().format);
+}
+
+TEST(TestGoptInference, FoldPadding) {
+    auto cn = CompNode::load("cpu0");
+    HostTensorGenerator<> gen;
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkvar = [&](const char* name, const TensorShape& shp) {
+        return opr::Host2DeviceCopy::make(*graph, gen(shp, cn)).rename(name);
+    };
+    auto mkcvar = [&](const char* name, const TensorShape& shp) {
+        return opr::SharedDeviceTensor::make(*graph, *gen(shp, cn)).rename(name);
+    };
+    auto pad = [](SymbolVar x, uint32_t top, uint32_t bottom, uint32_t left,
+                  uint32_t right, float val = 0.f) {
+        opr::Padding::Param param;
+        param.front_offset_dim2 = top;
+        param.back_offset_dim2 = bottom;
+        param.front_offset_dim3 = left;
+        param.back_offset_dim3 = right;
+        param.padding_val = val;
+        return opr::Padding::make(x, param);
+    };
+    auto x = mkvar("x", {2, 4, 9, 11}), w = mkcvar("w", {8, 4, 3, 3}),
+         b = mkcvar("b", {1, 8, 1, 1});
+    opr::ConvBias::Param conv_param;
+    conv_param.pad_h = conv_param.pad_w = 1;
+    conv_param.stride_h = conv_param.stride_w = 2;
+    using PoolingMode = opr::Pooling::Param::Mode;
+    opr::Pooling::Param pool_param{PoolingMode::AVERAGE, 0, 0, 2, 2, 3, 3};
+    auto y0 = opr::ConvBias::make(pad(x, 2, 2, 1, 1), w, b, conv_param),
+         // asymmetric
+         y1 = opr::ConvBias::make(pad(x, 0, 1, 0, 1), w, b, conv_param),
+         y2 = opr::Convolution::make(pad(x, 1, 1, 2, 2), w),
+         y3 = opr::Pooling::make(pad(x, 1, 1, 1, 1), pool_param);
+    pool_param.mode = PoolingMode::MAX;
+    constexpr float inf = std::numeric_limits<float>::infinity();
+    auto y4 = opr::Pooling::make(pad(x, 1, 1, 1, 1, -inf), pool_param),
+         // zero is not neutral for max
+         y5 = opr::Pooling::make(pad(x, 1, 1, 1, 1), pool_param);
+
+    SymbolVarArray ys{y0, y1, y2, y3, y4, y5};
+    auto ys_opt = gopt::GraphOptimizer{}
+                          .add_pass<gopt::FoldPaddingPass>()
+                          .apply(ys)
+                          .endpoint_vars();
+    size_t expect_nr_padding[] = {0, 1, 0, 0, 0, 1};
+    ComputingGraph::OutputSpec out_spec;
+    std::vector<HostTensorND> host_ys(ys.size()), host_ys_opt(ys.size());
+    for (size_t i = 0; i < ys.size(); ++i) {
+        ASSERT_EQ(expect_nr_padding[i], find_opr_num<opr::Padding>(ys_opt[i]));
+        out_spec.push_back(make_callback_copy(ys[i], host_ys[i]));
+        out_spec.push_back(make_callback_copy(ys_opt[i], host_ys_opt[i]));
+    }
+    ASSERT_EQ(3u, find_opr<opr::ConvBias>(ys_opt[0]).param().pad_h);
+    ASSERT_EQ(2u, find_opr<opr::ConvBias>(ys_opt[0]).param().pad_w);
+    ASSERT_EQ(2u, find_opr<opr::Convolution>(ys_opt[2]).param().pad_w);
+
+    auto func = graph->compile(out_spec);
+    func->execute();
+    for (size_t i = 0; i < ys.size(); ++i) {
+        MGB_ASSERT_TENSOR_NEAR(host_ys[i], host_ys_opt[i], 1e-5);
+    }
+
+    // optimize_for_inference only folds paddings if fold_padding is set
+    gopt::OptimizeForInferenceOptions options;
+    SymbolVar y_opt;
+    unpack_vector(gopt::optimize_for_inference({y0}, options), y_opt);
+    ASSERT_EQ(1u, find_opr_num<opr::Padding>(y_opt));
+    options.enable_fold_padding();
+    unpack_vector(gopt::optimize_for_inference({y0}, options), y_opt);
+    ASSERT_EQ(0u, find_opr_num<opr::Padding>(y_opt));
+}
+
+TEST(TestGoptInference, FuseConvBiasPooling) {
+    auto cn = CompNode::load("cpu0");
+    HostTensorGenerator<> gen;
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkvar = [&](const char* name, const TensorShape& shp) {
+        return opr::Host2DeviceCopy::make(*graph, gen(shp, cn)).rename(name);
+    };
+    auto mkcvar = [&](const char* name, const TensorShape& shp) {
+        return opr::SharedDeviceTensor::make(*graph, *gen(shp, cn)).rename(name);
+    };
+    auto x = mkvar("x", {2, 3, 17, 19}), w = mkcvar("w", {8, 3, 3, 3}),
+         b = mkcvar("b", {1, 8, 1, 1});
+    opr::ConvBias::Param conv_param;
+    conv_param.pad_h = conv_param.pad_w = 1;
+    conv_param.nonlineMode = opr::ConvBias::Param::NonlineMode::RELU;
+    using PoolingMode = opr::Pooling::Param::Mode;
+    opr::Pooling::Param pool_param{PoolingMode::MAX, 1, 1, 2, 2, 3, 3};
+    // too many input channels, the conv is faster with im2col
+    auto y4 = opr::Pooling::make(
+            opr::ConvBias::make(
+                    mkvar("x4", {2, 32, 17, 19}), mkcvar("w4", {8, 32, 3, 3}),
+                    conv_param),
+            pool_param);
+    auto y0 = opr::Pooling::make(opr::ConvBias::make(x, w, b, conv_param), pool_param);
+    conv_param.stride_h = conv_param.stride_w = 2;
+    conv_param.nonlineMode = opr::ConvBias::Param::NonlineMode::SIGMOID;
+    pool_param = {PoolingMode::AVERAGE, 0, 0, 2, 2, 2, 2};
+    auto y1 = opr::Pooling::make(opr::ConvBias::make(x, w, conv_param), pool_param);
+    // the conv output is also read by another opr
+    auto conv = opr::ConvBias::make(x, w, b, conv_param),
+         y2 = opr::Pooling::make(conv, pool_param), y3 = conv * 2.f;
+
+    SymbolVarArray ys{y0, y1, y2, y3, y4};
+    auto ys_opt = gopt::GraphOptimizer{}
+                          .add_pass<gopt::FuseConvBiasPoolingPass>()
+                          .apply(ys)
+                          .endpoint_vars();
+    size_t expect_nr_conv_pooling[] = {1, 1, 0, 0, 0};
+    ComputingGraph::OutputSpec out_spec;
+    std::vector<HostTensorND> host_ys(ys.size()), host_ys_opt(ys.size());
+    for (size_t i = 0; i < ys.size(); ++i) {
+        ASSERT_EQ(expect_nr_conv_pooling[i], find_opr_num<opr::ConvPooling>(ys_opt[i]));
+        out_spec.push_back(make_callback_copy(ys[i], host_ys[i]));
+        out_spec.push_back(make_callback_copy(ys_opt[i], host_ys_opt[i]));
+    }
+
+    auto func = graph->compile(out_spec);
+    func->execute();
+    for (size_t i = 0; i < ys.size(); ++i) {
+        MGB_ASSERT_TENSOR_NEAR(host_ys[i], host_ys_opt[i], 1e-5);
+    }
+
+    gopt::OptimizeForInferenceOptions options;
+    options.enable_fuse_conv_bias_pooling();
+    SymbolVar y_opt;
+    unpack_vector(gopt::optimize_for_inference({y0}, options), y_opt);
+    ASSERT_EQ(1u, find_opr_num<opr::ConvPooling>(y_opt));
+}
+
+TEST(TestGoptInference, HorizontalFuse) {
+    auto cn = CompNode::load("cpu0");
+    HostTensorGenerator<> gen;
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkvar = [&](const char* name, const TensorShape& shp) {
+        return opr::Host2DeviceCopy::make(*graph, gen(shp, cn)).rename(name);
+    };
+    auto mkcvar = [&](const char* name, const TensorShape& shp) {
+        return opr::SharedDeviceTensor::make(*graph, *gen(shp, cn)).rename(name);
+    };
+    auto x = mkvar("x", {1, 8, 12, 12});
+    opr::ConvBias::Param conv_param;
+    conv_param.pad_h = conv_param.pad_w = 1;
+    conv_param.nonlineMode = opr::ConvBias::Param::NonlineMode::RELU;
+    auto y0 = opr::ConvBias::make(
+                 x, mkcvar("w0", {4, 8, 3, 3}), mkcvar("b0", {1, 4, 1, 1}),
+                 conv_param),
+         y1 = opr::ConvBias::make(x, mkcvar("w1", {6, 8, 3, 3}), conv_param);
+    // different stride, not fused
+    conv_param.stride_h = conv_param.stride_w = 2;
+    auto y2 = opr::ConvBias::make(x, mkcvar("w2", {4, 8, 3, 3}), conv_param);
+
+    auto a = mkvar("a", {1, 16}), a1 = mkvar("a1", {3, 16});
+    opr::MatrixMul::Param mm_param;
+    auto y3 = opr::MatrixMul::make(a, mkcvar("w3", {16, 5}), mm_param);
+    mm_param.transposeB = true;
+    auto y4 = opr::MatrixMul::make(a, mkcvar("w4", {7, 16}), mm_param),
+         y5 = opr::MatrixMul::make(a, mkcvar("w5", {9, 16}), mm_param);
+    // views of outputs with 3 rows are not contiguous, which may cost more
+    // than reading the small input twice
+    auto y6 = opr::MatrixMul::make(a1, mkcvar("w6", {7, 16}), mm_param),
+         y7 = opr::MatrixMul::make(a1, mkcvar("w7", {9, 16}), mm_param);
+
+    SymbolVarArray ys{y0, y1, y2, y3, y4, y5, y6 + y7};
+    auto ys_opt = gopt::GraphOptimizer{}
+                          .add_pass<gopt::HorizontalFusePass>()
+                          .apply(ys)
+                          .endpoint_vars();
+    auto nr_conv = [](const SymbolVarArray& vars) {
+        ThinHashSet<cg::OperatorNodeBase*> oprs;
+        cg::DepOprIter iter{[&](cg::OperatorNodeBase* opr) {
+            if (opr->same_type<opr::ConvBias>() ||
+                opr->same_type<opr::MatrixMul>()) {
+                oprs.insert(opr);
+            }
+        }};
+        for (auto&& var : vars) {
+            iter.add(var);
+        }
+        return oprs.size();
+    };
+    ASSERT_EQ(8u, nr_conv(ys));
+    // y0 and y1, y4 and y5 are fused
+    ASSERT_EQ(6u, nr_conv(ys_opt));
+    ASSERT_EQ(1u, find_opr_num<opr::Subtensor>(ys_opt[0]));
+    ASSERT_EQ(1u, find_opr_num<opr::Subtensor>(ys_opt[5]));
+    ASSERT_EQ(0u, find_opr_num<opr::Subtensor>(ys_opt[6]));
+
+    ComputingGraph::OutputSpec out_spec;
+    std::vector<HostTensorND> host_ys(ys.size()), host_ys_opt(ys.size());
+    for (size_t i = 0; i < ys.size(); ++i) {
+        out_spec.push_back(make_callback_copy(ys[i], host_ys[i]));
+        out_spec.push_back(make_callback_copy(ys_opt[i], host_ys_opt[i]));
+    }
+    auto func = graph->compile(out_spec);
+    func->execute();
+    for (size_t i = 0; i < ys.size(); ++i) {
+        MGB_ASSERT_TENSOR_NEAR(host_ys[i], host_ys_opt[i], 1e-5);
+    }
+}
+
+TEST(TestGoptInference, BatchMatrixMul) {
+    auto cn = CompNode::load("cpu0");
+    HostTensorGenerator<> gen;
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto mkvar = [&](const char* name, const TensorShape& shp) {
+        return opr::Host2DeviceCopy::make(*graph, gen(shp, cn)).rename(name);
+    };
+    auto mkcvar = [&](const char* name, const TensorShape& shp) {
+        return opr::SharedDeviceTensor::make(*graph, *gen(shp, cn)).rename(name);
+    };
+    opr::MatrixMul::Param param;
+    SymbolVarArray ys;
+    // different right operands: batched into BatchedMatrixMul
+    for (int i = 0; i < 3; ++i) {
+        auto a = mkvar(ssprintf("a%d", i).c_str(), {4, 8});
+        auto b = mkcvar(ssprintf("b%d", i).c_str(), {8, 6});
+        ys.push_back(opr::MatrixMul::make(a, b, param));
+    }
+    // shared right operand: rows of the left operands are concatenated
+    param.transposeB = true;
+    auto w = mkcvar("w", {6, 8});
+    for (int i = 0; i < 2; ++i) {
+        auto x = mkvar(ssprintf("x%d", i).c_str(), {2, 8});
+        ys.push_back(opr::MatrixMul::make(x, w, param) * 2.f);
+    }
+    // stacking the large non-const operands costs too much
+    param.transposeB = false;
+    for (int i = 0; i < 2; ++i) {
+        auto p = mkvar(ssprintf("p%d", i).c_str(), {32, 128});
+        auto q = mkvar(ssprintf("q%d", i).c_str(), {128, 32});
+        ys.push_back(opr::MatrixMul::make(p, q, param));
+    }
+
+    auto ys_opt = gopt::GraphOptimizer{}
+                          .add_pass<gopt::BatchMatrixMulPass>()
+                          .apply(ys)
+                          .endpoint_vars();
+    size_t expect_nr_batched[] = {1, 1, 1, 0, 0, 0, 0},
+           expect_nr_subtensor[] = {1, 1, 1, 1, 1, 0, 0};
+    ComputingGraph::OutputSpec out_spec;
+    std::vector<HostTensorND> host_ys(ys.size()), host_ys_opt(ys.size());
+    for (size_t i = 0; i < ys.size(); ++i) {
+        ASSERT_EQ(expect_nr_batched[i], find_opr_num<opr::BatchedMatrixMul>(ys_opt[i]));
+        ASSERT_EQ(expect_nr_subtensor[i], find_opr_num<opr::Subtensor>(ys_opt[i]));
+        out_spec.push_back(make_callback_copy(ys[i], host_ys[i]));
+        out_spec.push_back(make_callback_copy(ys_opt[i], host_ys_opt[i]));
+    }
+    ASSERT_EQ(
+            ys_opt[3].node()->owner_opr()->input(0)->owner_opr()->input(0),
+            ys_opt[4].node()->owner_opr()->input(0)->owner_opr()->input(0));
+
+    auto func = graph->compile(out_spec);
+    func->execute();
+    for (size_t i = 0; i < ys.size(); ++i) {
+        MGB_ASSERT_TENSOR_NEAR(host_ys[i], host_ys_opt[i], 1e-5);
+    }
+}
+
+TEST(TestGoptInference, FuseImagePreprocess) {
+    auto cn = CompNode::load("cpu0");
+    HostTensorGenerator<dtype::Uint8, RandomDistribution::UNIFORM> gen(0, 255);
+    HostTensorGenerator<> gen_f32;
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto x = opr::Host2DeviceCopy::make(*graph, gen({2, 20, 30, 3}, cn)).rename("x");
+    auto mkcvar = [&](const char* name, const TensorShape& shp) {
+        return opr::SharedDeviceTensor::make(*graph, *gen_f32(shp, cn)).rename(name);
+    };
+    auto mean = mkcvar("mean", {1, 3, 1, 1}), scale = mkcvar("scale", {1, 3, 1, 1});
+    auto to_nchw = [](SymbolVar var) {
+        return opr::Dimshuffle::make(var, {0, 3, 1, 2});
+    };
+
+    // NEAREST resize has no rounding, so the fused result matches exactly
+    opr::Resize::Param resize_param;
+    resize_param.format = opr::Resize::Param::Format::NHWC;
+    resize_param.imode = opr::Resize::Param::InterpolationMode::NEAREST;
+    auto resized = opr::Resize::make(
+            opr::CvtColor::make(x, {opr::CvtColor::Param::Mode::BGR2RGB}), {16, 24},
+            resize_param);
+    auto y0 = (opr::TypeCvt::make(to_nchw(resized), dtype::Float32()) - mean) / 2.f *
+              scale;
+    auto y1 = opr::TypeCvt::make(
+            opr::TypeCvt::make(
+                    to_nchw(opr::TypeCvt::make(x, dtype::Float32())) * 0.5f - 60.f,
+                    dtype::QuantizedS8(1.f)),
+            dtype::Float32());
+    // the resized image is also an endpoint, so only the later oprs are fused
+    resize_param.imode = opr::Resize::Param::InterpolationMode::LINEAR;
+    auto y3 = opr::Resize::make(x, {13, 40}, resize_param);
+    auto y2 = opr::TypeCvt::make(to_nchw(y3), dtype::Float32()) + mean;
+
+    SymbolVarArray ys{y0, y1, y2, y3};
+    auto ys_opt = gopt::GraphOptimizer{}
+                          .add_pass<gopt::FuseImagePreprocessPass>()
+                          .apply(ys)
+                          .endpoint_vars();
+    ASSERT_EQ(1u, find_opr_num<opr::ImagePreprocess>(ys_opt[0]));
+    ASSERT_EQ(0u, find_opr_num<opr::Resize>(ys_opt[0]));
+    ASSERT_EQ(0u, find_opr_num<opr::CvtColor>(ys_opt[0]));
+    ASSERT_EQ(0u, find_opr_num<opr::Elemwise>(ys_opt[0]));
+    ASSERT_EQ(1u, find_opr_num<opr::ImagePreprocess>(ys_opt[1]));
+    ASSERT_EQ(1u, find_opr_num<opr::TypeCvt>(ys_opt[1]));
+    ASSERT_EQ(1u, find_opr_num<opr::Resize>(ys_opt[2]));
+    ASSERT_EQ(0u, find_opr_num<opr::Elemwise>(ys_opt[2]));
+
+    ComputingGraph::OutputSpec out_spec;
+    std::vector<HostTensorND> host_ys(ys.size()), host_ys_opt(ys.size());
+    for (size_t i = 0; i < ys.size(); ++i) {
+        out_spec.push_back(make_callback_copy(ys[i], host_ys[i]));
+        out_spec.push_back(make_callback_copy(ys_opt[i], host_ys_opt[i]));
+    }
+    auto func = graph->compile(out_spec);
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_ys[0], host_ys_opt[0], 1e-4);
+    // x * 0.5 - 60 may round either way at a tie
+    MGB_ASSERT_TENSOR_NEAR(host_ys[1], host_ys_opt[1], 1.f);
+    MGB_ASSERT_TENSOR_NEAR(host_ys[2], host_ys_opt[2], 1e-4);
+    MGB_ASSERT_TENSOR_EQ(host_ys[3], host_ys_opt[3]);
+}
+
+TEST(TestGoptInference, FuseImagePreprocessBitExact) {
+    // the resized image is rounded to uint8 as Resize does on the same handle,
+    // so a chain whose affine part is a single multiply or add is bit-exact
+    auto cn = CompNode::load("cpu0");
+    HostTensorGenerator<dtype::Uint8, RandomDistribution::UNIFORM> gen(0, 255);
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    using IMode = opr::Resize::Param::InterpolationMode;
+    //! each endpoint gets its own chain so that every one of them is fused
+    auto make_resized = [&](const std::shared_ptr<HostTensorND>& host, IMode imode,
+                            const TensorShape& out_hw) {
+        SymbolVar x = opr::Host2DeviceCopy::make(*graph, host);
+        if (host->shape(3) == 3) {
+            x = opr::CvtColor::make(x, {opr::CvtColor::Param::Mode::BGR2RGB});
+        }
+        opr::Resize::Param resize_param;
+        resize_param.format = opr::Resize::Param::Format::NHWC;
+        resize_param.imode = imode;
+        return opr::TypeCvt::make(
+                opr::Dimshuffle::make(
+                        opr::Resize::make(x, out_hw, resize_param), {0, 3, 1, 2}),
+                dtype::Float32());
+    };
+    SymbolVarArray ys;
+    for (size_t C : {1, 3}) {
+        auto host_x = gen({2, 21, 33, C}, cn);
+        for (auto imode : {IMode::LINEAR, IMode::NEAREST}) {
+            for (auto out_hw : {TensorShape{16, 24}, TensorShape{45, 50}}) {
+                ys.push_back(make_resized(host_x, imode, out_hw));
+                ys.push_back(make_resized(host_x, imode, out_hw) * 0.017f);
+                ys.push_back(make_resized(host_x, imode, out_hw) + (-123.5f));
+            }
+        }
+    }
+
+    auto ys_opt = gopt::GraphOptimizer{}
+                          .add_pass<gopt::FuseImagePreprocessPass>()
+                          .apply(ys)
+                          .endpoint_vars();
+    ComputingGraph::OutputSpec out_spec;
+    std::vector<HostTensorND> host_ys(ys.size()), host_ys_opt(ys.size());
+    for (size_t i = 0; i < ys.size(); ++i) {
+        ASSERT_EQ(1u, find_opr_num<opr::ImagePreprocess>(ys_opt[i]));
+        ASSERT_EQ(0u, find_opr_num<opr::Resize>(ys_opt[i]));
+        ASSERT_EQ(0u, find_opr_num<opr::Elemwise>(ys_opt[i]));
+        out_spec.push_back(make_callback_copy(ys[i], host_ys[i]));
+        out_spec.push_back(make_callback_copy(ys_opt[i], host_ys_opt[i]));
+    }
+    auto func = graph->compile(out_spec);
+    func->execute();
+    for (size_t i = 0; i < ys.size(); ++i) {
+        MGB_ASSERT_TENSOR_EQ(host_ys[i], host_ys_opt[i]);
+    }
+}
+
 TEST(TestGoptInference, ConvBiasNonlinearityFusePass) {
     // hwcd4 is only supported in naive handle
     NaiveMegDNNHandleScope naive_megdnn_handle;
@@ -1805,6 +2348,52 @@ TEST(TestGoptInference, ParamMerge) {
     MGB_ASSERT_TENSOR_EQ(y_expected_val, y_got_val);
 }
 
+TEST(TestGoptInference, FoldConstShape) {
+    HostTensorGenerator<> gen;
+    auto host_x = gen({6, 4});
+    std::vector<uint8_t> buf;
+    {
+        auto graph = ComputingGraph::make();
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x, {"x"});
+        // outputs of multi-output oprs are not folded when being inserted
+        auto shp = opr::Split::make(
+                opr::GetVarShape::make(x), opr::Split::Options::make_average(0, 2));
+        auto y = x.reshape(opr::Concat::make({shp[1], shp[0]}, 0)) * 2.f;
+        auto dumper = serialization::GraphDumper::make(
+                serialization::OutputFile::make_vector_proxy(&buf));
+        dumper->dump({y, shp[0]});
+    }
+
+    auto loader = serialization::GraphLoader::make(
+            serialization::InputFile::make_mem_proxy(buf.data(), buf.size()));
+    serialization::GraphLoadConfig config;
+    config.const_var_shape = true;
+    auto rst = loader->load(config);
+    rst.tensor_map.at("x")->copy_from(*host_x);
+    SymbolVar y = rst.output_var_list[0], s = rst.output_var_list[1], y1, s1;
+    unpack_vector(
+            gopt::GraphOptimizer{}
+                    .add_pass<gopt::FoldConstShapePass>()
+                    .apply({{y, s}})
+                    .endpoint_vars(),
+            y1, s1);
+
+    ASSERT_TRUE(s1.node()->owner_opr()->same_type<opr::ImmutableTensor>());
+    cg::DepOprIter{[](cg::OperatorNodeBase* opr) {
+        ASSERT_FALSE(opr->same_type<opr::Split>());
+        ASSERT_FALSE(opr->same_type<opr::GetVarShape>());
+    }}.add(y1.node()->owner_opr());
+
+    HostTensorND host_y, host_y1, host_s1;
+    auto func = rst.graph->compile(
+            {make_callback_copy(y, host_y), make_callback_copy(y1, host_y1),
+             make_callback_copy(s1, host_s1)});
+    func->execute();
+    MGB_ASSERT_TENSOR_EQ(host_y, host_y1);
+    ASSERT_EQ(TensorShape({4, 6}), host_y1.shape());
+    ASSERT_EQ(6, host_s1.ptr<int>()[0]);
+}
+
 TEST(TestGoptInference, ParamMergeFormat) {
     auto cns = load_multiple_xpus(2);
 
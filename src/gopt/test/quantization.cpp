@@ -0,0 +1,114 @@
+/**
+ * \file src/gopt/test/quantization.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "./helper.h"
+
+#include "megbrain/gopt/quantization.h"
+#include "megbrain/opr/basic_arith_wrapper.h"
+#include "megbrain/opr/blas.h"
+#include "megbrain/opr/dnn/convolution.h"
+#include "megbrain/opr/io.h"
+#include "megbrain/opr/nn_int.h"
+#include "megbrain/opr/tensor_manip.h"
+
+using namespace mgb;
+
+TEST(TestGoptQuantization, QuantizeInt8) {
+    auto cn = CompNode::load("cpu0");
+    HostTensorGenerator<> gen;
+    auto graph = ComputingGraph::make();
+    graph->options().graph_opt_level = 0;
+    auto host_x = gen({2, 4, 8, 8}, cn);
+    auto x = opr::Host2DeviceCopy::make(*graph, host_x).rename("x");
+    auto mkcvar = [&](const char* name, const TensorShape& shp) {
+        return opr::SharedDeviceTensor::make(*graph, *gen(shp, cn)).rename(name);
+    };
+
+    opr::ConvBias::Param param;
+    param.pad_h = param.pad_w = 1;
+    param.nonlineMode = opr::ConvBias::Param::NonlineMode::RELU;
+    auto y0 = opr::ConvBias::make(
+            x, mkcvar("w0", {8, 4, 3, 3}), mkcvar("b0", {1, 8, 1, 1}), param);
+    param.nonlineMode = opr::ConvBias::Param::NonlineMode::IDENTITY;
+    auto y1 = opr::ConvBias::make(y0, mkcvar("w1", {8, 8, 3, 3}), param);
+    auto y2 = opr::Elemwise::make({y0, y1}, opr::Elemwise::Mode::FUSE_ADD_RELU);
+    auto y3 = opr::Reshape::make(y2, TensorShape{2, 512});
+    auto y = opr::MatrixMul::make(y3, mkcvar("w2", {512, 10}));
+
+    std::vector<gopt::CalibrationBatch> dataset(4);
+    for (auto&& batch : dataset) {
+        batch["x"] = *gen({2, 4, 8, 8}, cn);
+    }
+    auto x_val = *host_x;
+    auto y_q = gopt::quantize_int8({y}, dataset)[0];
+    MGB_ASSERT_TENSOR_EQ(x_val, *host_x);
+
+    size_t nr_conv = 0, nr_matmul = 0, nr_elem_multi_type = 0, nr_elem = 0;
+    cg::DepOprIter{[&](cg::OperatorNodeBase* opr) {
+        if (opr->same_type<opr::ConvBias>()) {
+            ++nr_conv;
+            ASSERT_EQ(DTypeEnum::QuantizedS8, opr->input(1)->dtype().enumv());
+            ASSERT_EQ(DTypeEnum::QuantizedS8, opr->output(0)->dtype().enumv());
+        }
+        if (opr->same_type<opr::MatrixMul>()) {
+            ++nr_matmul;
+            ASSERT_EQ(DTypeEnum::QuantizedS32, opr->output(0)->dtype().enumv());
+        }
+        nr_elem_multi_type += opr->same_type<opr::ElemwiseMultiType>();
+        nr_elem += opr->same_type<opr::Elemwise>();
+    }}.add(y_q);
+    ASSERT_EQ(2u, nr_conv);
+    ASSERT_EQ(1u, nr_matmul);
+    ASSERT_EQ(1u, nr_elem_multi_type);
+    ASSERT_EQ(0u, nr_elem);
+    ASSERT_EQ(dtype::Float32(), y_q.dtype());
+
+    HostTensorND host_y, host_y_q;
+    auto func = graph->compile(
+            {make_callback_copy(y, host_y), make_callback_copy(y_q, host_y_q)});
+    func->execute();
+    float max_abs = 0, max_err = 0;
+    for (size_t i = 0; i < host_y.shape().total_nr_elems(); ++i) {
+        auto expect = host_y.ptr<float>()[i], get = host_y_q.ptr<float>()[i];
+        max_abs = std::max(max_abs, std::abs(expect));
+        max_err = std::max(max_err, std::abs(expect - get));
+    }
+    ASSERT_LT(max_err, max_abs * 0.1f);
+}
+
+TEST(TestGoptQuantization, CalibrateMethods) {
+    auto cn = CompNode::load("cpu0");
+    HostTensorGenerator<> gen;
+    auto graph = ComputingGraph::make();
+    auto x = opr::Host2DeviceCopy::make(*graph, gen({1000}, cn)).rename("x");
+    auto y = opr::Elemwise::make({x}, opr::Elemwise::Mode::RELU);
+
+    std::vector<gopt::CalibrationBatch> dataset(2);
+    for (auto&& batch : dataset) {
+        batch["x"] = *gen({1000}, cn);
+    }
+    dataset[0]["x"].ptr<float>()[0] = 100.f;
+
+    using Method = gopt::CalibrationOptions::Method;
+    auto get_scale = [&](Method method) {
+        gopt::CalibrationOptions options;
+        options.method = method;
+        options.percentile = 99.9f;
+        auto scales = gopt::calibrate_int8({y}, dataset, options);
+        return scales.at(x.node());
+    };
+    auto minmax = get_scale(Method::MINMAX);
+    ASSERT_FLOAT_EQ(100.f / 127, minmax);
+    ASSERT_LT(get_scale(Method::PERCENTILE), minmax * 0.2f);
+    ASSERT_LT(get_scale(Method::KL), minmax * 0.2f);
+}
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -11,6 +11,7 @@
 
 #include "./mlir/compiler.h"
 #include "./halide/compiler_cuda.h"
+#include "./host_c/compiler_c.h"
 #include "./nvrtc/compiler_cuda.h"
 
 #include "megbrain/jit/compiler.h"
@@ -111,6 +112,12 @@ Compiler* Compiler::get(ComputingGraph& graph, CompNode comp_node) {
                     break;
                 }
 #endif
+                //! HOST_C runs the system C compiler at runtime, so it is
+                //! only used when requested explicitly
+                if (backend && !strcmp(backend, "HOST_C")) {
+                    compiler = std::make_unique<HostCCompiler>();
+                    break;
+                }
                 mgb_throw(InternalError, "No compiler support for cpu");
                 break;
             default:
@@ -376,7 +376,20 @@ bool JITFusionPass::Impl::can_be_fused(cg::OperatorNodeBase* opr) const {
                elem->output(0)->dtype().category() == DTypeCategory::FLOAT;
     }
 
+    //! whether the compiler of the fused opr supports the feature; the jit
+    //! level may enable features that the backend can not generate code for
+    auto compiler_has = [opr](JITFeatureBits bits) {
+        auto&& compiler =
+                Compiler::get(*opr->owner_graph(), opr->output(0)->comp_node());
+        return static_cast<bool>(compiler->property().feature_bits & bits);
+    };
+
     if (strcmp(backend, "MLIR")) {
+        // the CUDA compilers (NVRTC and Halide) fuse reduce and dimshuffle by
+        // the jit level alone, while CPU compilers must report them
+        bool check_compiler = opr->output(0)->comp_node().device_type() ==
+                              CompNode::DeviceType::CPU;
+
         if (opr->same_type<opr::PowC>()) {
             return true;
         }
@@ -392,16 +405,40 @@ bool JITFusionPass::Impl::can_be_fused(cg::OperatorNodeBase* opr) const {
         // float reduce
         if ((m_feature_bits & JITFeatureBits::REDUCE) &&
             opr->same_type<opr::Reduce>()) {
+            if (check_compiler && !compiler_has(JITFeatureBits::REDUCE))
+                return false;
             return opr->output(0)->dtype().category() == DTypeCategory::FLOAT;
         }
 
         // dimshuffle
         if ((m_feature_bits & JITFeatureBits::DIMSHUFFLE) &&
             opr->same_type<opr::Dimshuffle>()) {
+            if (check_compiler && !compiler_has(JITFeatureBits::DIMSHUFFLE))
+                return false;
+            auto param = opr->cast_final_safe<opr::Dimshuffle>().param();
+            return param.pattern_len <= 4;
+        }
+    }
+#if MGB_JIT_MLIR
+    else {
+        // float reduce along an axis, as target shapes are host values
+        if ((m_feature_bits & JITFeatureBits::REDUCE) &&
+            opr->same_type<opr::Reduce>() && compiler_has(JITFeatureBits::REDUCE)) {
+            auto&& reduce = opr->cast_final<opr::Reduce>();
+            return reduce.input().size() == 1 &&
+                   reduce.param().data_type == opr::Reduce::Param::DataType::DEFAULT &&
+                   reduce.output(0)->dtype() == dtype::Float32();
+        }
+
+        // dimshuffle
+        if ((m_feature_bits & JITFeatureBits::DIMSHUFFLE) &&
+            opr->same_type<opr::Dimshuffle>() &&
+            compiler_has(JITFeatureBits::DIMSHUFFLE)) {
             auto param = opr->cast_final_safe<opr::Dimshuffle>().param();
             return param.pattern_len <= 4;
         }
     }
+#endif  // MGB_JIT_MLIR
 
     // existing JITExecutor
     if (opr->same_type<JITExecutor>())
@@ -0,0 +1,283 @@
+/**
+ * \file src/jit/impl/host_c/codegen_c.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "./codegen_c.h"
+
+#include "megbrain/common.h"
+#include "megbrain/jit/ast_c.h"
+#include "megbrain/jit/placeholder_opr.h"
+#include "megbrain/jit/utils.h"
+#include "megbrain/opr/tensor_manip.h"
+#include "megbrain/utils/hash.h"
+
+#include <cinttypes>
+
+#if MGB_JIT
+
+using namespace mgb;
+using namespace jit;
+using namespace ast_c;
+
+namespace {
+
+using VarNode2AST = ThinHashMap<VarNode*, ASTPtr>;
+
+//! storage type of a tensor element in the generated code
+const char* dtype_to_cstr(DType dtype) {
+    if (dtype == dtype::Float32())
+        return "float";
+#if !MEGDNN_DISABLE_FLOAT16
+    if (dtype == dtype::Float16())
+        return "uint16_t";
+#endif
+    mgb_throw(
+            GraphError, "unsupported dtype %s in host C JIT fusion", dtype.name());
+}
+
+//! convert a float value \p val to be stored as \p dtype
+std::string gen_store(DType dtype, const std::string& val) {
+    if (dtype == dtype::Float32())
+        return val;
+    return "mgb_f2h(" + val + ")";
+}
+
+//! convert a value loaded from storage of \p dtype to float
+std::string gen_load(DType dtype, const std::string& val) {
+    if (dtype == dtype::Float32())
+        return val;
+    return "mgb_h2f(" + val + ")";
+}
+
+ASTPtr gen_opr_ast(cg::OperatorNodeBase* opr, const VarNode2AST& var2ast) {
+    ASTPtrArray cur_inputs;
+    for (auto inp_node : opr->input()) {
+        cur_inputs.push_back(var2ast.at(inp_node));
+    }
+    if (opr->same_type<opr::Dimshuffle>()) {
+        // dimshuffle has been applied to the input layouts by JITExecutor
+        return {cur_inputs[0]};
+    }
+
+    return opr2AST(opr, cur_inputs).at(0);
+}
+
+const char* const C_PRELUDE = R"(
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* same as the MAX and MIN elemwise kernels of megdnn; unlike fmaxf and fminf
+ * they can be vectorized without -ffast-math */
+static inline float mgb_fmaxf(float x, float y) {
+    return x > y ? x : y;
+}
+#define fmaxf mgb_fmaxf
+
+static inline float mgb_fminf(float x, float y) {
+    return x < y ? x : y;
+}
+#define fminf mgb_fminf
+
+static inline float mgb_log_sum_exp(float x, float y) {
+    float a = x < y ? x : y, b = x < y ? y : x;
+    return b + log1pf(expf(a - b));
+}
+
+static inline float rsqrtf(float x) {
+    return 1.f / sqrtf(x);
+}
+
+static inline float rcbrtf(float x) {
+    return 1.f / cbrtf(x);
+}
+
+static inline float mgb_h2f(uint16_t h) {
+    uint32_t sign = (uint32_t)(h & 0x8000u) << 16, exp = (h >> 10) & 0x1fu,
+             mant = h & 0x3ffu, bits;
+    if (exp == 0x1fu) {
+        bits = sign | 0x7f800000u | (mant << 13);
+    } else if (exp) {
+        bits = sign | ((exp + 112u) << 23) | (mant << 13);
+    } else if (!mant) {
+        bits = sign;
+    } else {
+        exp = 113u;
+        while (!(mant & 0x400u)) {
+            mant <<= 1;
+            --exp;
+        }
+        bits = sign | (exp << 23) | ((mant & 0x3ffu) << 13);
+    }
+    float ret;
+    memcpy(&ret, &bits, sizeof(ret));
+    return ret;
+}
+
+static inline uint16_t mgb_f2h(float f) {
+    uint32_t bits, sign, abs_bits, ret, rem;
+    memcpy(&bits, &f, sizeof(bits));
+    sign = (bits >> 16) & 0x8000u;
+    abs_bits = bits & 0x7fffffffu;
+    if (abs_bits >= 0x7f800000u)
+        return sign | 0x7c00u | (abs_bits > 0x7f800000u ? 0x200u : 0u);
+    if (abs_bits >= 0x477ff000u)
+        return sign | 0x7c00u;
+    if (abs_bits < 0x38800000u) {
+        uint32_t shift, mant, half;
+        if (abs_bits < 0x33000000u)
+            return sign;
+        shift = 126u - (abs_bits >> 23);
+        mant = (abs_bits & 0x7fffffu) | 0x800000u;
+        ret = mant >> shift;
+        rem = mant & ((1u << shift) - 1u);
+        half = 1u << (shift - 1u);
+        ret += rem > half || (rem == half && (ret & 1u));
+        return sign | ret;
+    }
+    abs_bits -= 0x38000000u;
+    ret = abs_bits >> 13;
+    rem = abs_bits & 0x1fffu;
+    ret += rem > 0x1000u || (rem == 0x1000u && (ret & 1u));
+    return sign | ret;
+}
+)";
+
+}  // anonymous namespace
+
+std::string mgb::jit::codegen_c(
+        const InternalGraph& internal_graph, const JITExecutor::Args& args) {
+    std::string source = C_PRELUDE;
+    source += R"(
+{{INPUT_ACCESS}}
+
+void {{KERNEL_NAME}}(void* const* inputs, const ptrdiff_t* strides,
+        const size_t* shape, void* output, size_t begin, size_t end) {
+    const size_t width = shape[{{NDIM}} - 1];
+    {{DECL_INNER_STRIDES}}
+    size_t pos = begin;
+    while (pos < end) {
+        size_t row = pos / width, col_begin = pos % width, col_end = width,
+               idx = row;
+        {{DECL_OFFSETS}}
+        int d;
+        if (col_end - col_begin > end - pos) {
+            col_end = col_begin + (end - pos);
+        }
+        for (d = {{NDIM}} - 2; d >= 0; --d) {
+            ptrdiff_t cur = idx % shape[d];
+            idx /= shape[d];
+            {{UPDATE_OFFSETS}}
+        }
+        {
+            /* an input may share memory with the output if it has been
+             * forwarded in place, so the pointers are not restrict; element j
+             * is read before it is written */
+            {{DECL_INPUT_PTRS}}
+            {{OUTPUT_DTYPE}}* dst = ({{OUTPUT_DTYPE}}*)output + row * width;
+            size_t j;
+            for (j = col_begin; j < col_end; ++j) {
+                {{ASSIGN_EXPRS}}
+                {{INTERNAL_EXPRS}}
+                dst[j] = {{STORE_EXP}};
+            }
+        }
+        pos += col_end - col_begin;
+    }
+}
+)";
+
+    VarNode2AST var2ast;
+    std::string decl_inner_strides, decl_offsets, update_offsets, decl_input_ptrs,
+            assign_exprs;
+    auto&& placeholders = internal_graph.placeholders();
+    size_t ndim = args.outputs[0].layout.ndim;
+    for (size_t i = 0; i < args.inputs.size(); i++) {
+        auto&& inp = args.inputs[i];
+        mgb_assert(inp.layout.ndim == ndim);
+        auto dtype = dtype_to_cstr(inp.layout.dtype);
+        decl_inner_strides += ssprintf(
+                "const ptrdiff_t s%zu = strides[%zu];\n", i, i * ndim + ndim - 1);
+        decl_offsets += ssprintf("ptrdiff_t off%zu = 0;\n", i);
+        update_offsets +=
+                ssprintf("off%zu += cur * strides[%zu + d];\n", i, i * ndim);
+        decl_input_ptrs += ssprintf(
+                "const %s* in%zu = (const %s*)inputs[%zu] + off%zu;\n",
+                dtype, i, dtype, i, i);
+
+        ASTPtr elem_var = ASTPtr::make<VariableAST>("x" + std::to_string(i));
+        assign_exprs +=
+                "const float " + elem_var->code_gen() + " = " +
+                gen_load(inp.layout.dtype, ssprintf("MGB_LOAD_%zu(j)", i)) + ";\n";
+        var2ast[placeholders[inp.idx]->output(0)] = elem_var;
+    }
+
+    std::string internal_exprs;
+    size_t cur_opr_cnt = 0;
+    cg::DepOprIter{[&](cg::OperatorNodeBase* opr) {
+        ++cur_opr_cnt;
+        if (opr->same_type<JITPlaceholder>()) {
+            return;
+        }
+        ASTPtr elem_var = ASTPtr::make<VariableAST>("y" + std::to_string(cur_opr_cnt));
+        ASTPtr elem_val = gen_opr_ast(opr, var2ast);
+        internal_exprs += "const float " + elem_var->code_gen() + " = " +
+                          elem_val->code_gen() + ";\n";
+        var2ast[opr->output(0)] = elem_var;
+    }}.add(internal_graph.output());
+
+    auto out_dtype = args.outputs[0].layout.dtype;
+    str_util::replace_all_pairs_inplace(
+            source,
+            {{"{{NDIM}}", std::to_string(ndim)},
+             {"{{DECL_INNER_STRIDES}}", decl_inner_strides},
+             {"{{DECL_OFFSETS}}", decl_offsets},
+             {"{{UPDATE_OFFSETS}}", update_offsets},
+             {"{{DECL_INPUT_PTRS}}", decl_input_ptrs},
+             {"{{ASSIGN_EXPRS}}", assign_exprs},
+             {"{{INTERNAL_EXPRS}}", internal_exprs},
+             {"{{STORE_EXP}}",
+              gen_store(out_dtype, var2ast.at(internal_graph.output())->code_gen())},
+             {"{{OUTPUT_DTYPE}}", dtype_to_cstr(out_dtype)}});
+    return source;
+}
+
+std::pair<std::string, std::string> mgb::jit::instantiate_c_kernel(
+        const std::string& source_template, const SmallVector<CInputAccess>& access) {
+    std::string input_access;
+    for (size_t i = 0; i < access.size(); ++i) {
+        switch (access[i]) {
+            case CInputAccess::CONTIG:
+                input_access += ssprintf("#define MGB_LOAD_%zu(j) in%zu[j]\n", i, i);
+                break;
+            case CInputAccess::BROADCAST:
+                input_access += ssprintf("#define MGB_LOAD_%zu(j) in%zu[0]\n", i, i);
+                break;
+            case CInputAccess::STRIDED:
+                input_access += ssprintf(
+                        "#define MGB_LOAD_%zu(j) in%zu[(ptrdiff_t)(j) * s%zu]\n", i,
+                        i, i);
+                break;
+        }
+    }
+    auto source = source_template;
+    str_util::replace_all_pairs_inplace(source, {{"{{INPUT_ACCESS}}", input_access}});
+
+    auto kernel_name = ssprintf(
+            "jit_host_c_%" PRIx64,
+            XXHash{}.update(source.data(), source.size()).digest());
+    str_util::replace_all_pairs_inplace(source, {{"{{KERNEL_NAME}}", kernel_name}});
+    return {kernel_name, source};
+}
+
+#endif  // MGB_JIT
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
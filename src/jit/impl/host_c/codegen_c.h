@@ -0,0 +1,59 @@
+/**
+ * \file src/jit/impl/host_c/codegen_c.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "megbrain_build_config.h"
+
+#if MGB_JIT
+
+#include "megbrain/jit/executor_opr.h"
+
+namespace mgb {
+namespace jit {
+
+/*!
+ * \brief kinds of the innermost stride of an input, which decide how the
+ *      input is loaded in the vectorized inner loop
+ */
+enum class CInputAccess : char {
+    CONTIG = 'c',     //!< stride 1
+    BROADCAST = 'b',  //!< stride 0, loop invariant
+    STRIDED = 's',    //!< any other stride
+};
+
+/*!
+ * \brief generate C source code template for a fused elemwise kernel
+ *
+ * The kernel has signature
+ * `void (void* const* inputs, const ptrdiff_t* strides, const size_t* shape,
+ * void* output, size_t begin, size_t end)` and computes the output elements
+ * in [begin, end) in row-major order. The template contains placeholders
+ * for the kernel name and the input access, which are filled by
+ * instantiate_c_kernel().
+ */
+std::string codegen_c(
+        const InternalGraph& internal_graph, const JITExecutor::Args& args);
+
+/*!
+ * \brief instantiate a template from codegen_c() for given input access
+ * \return (kernel name, kernel source)
+ */
+std::pair<std::string, std::string> instantiate_c_kernel(
+        const std::string& source_template,
+        const SmallVector<CInputAccess>& access);
+
+}  // namespace jit
+}  // namespace mgb
+
+#endif  // MGB_JIT
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -0,0 +1,141 @@
+/**
+ * \file src/jit/impl/host_c/compiler_c.cpp
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "./compiler_c.h"
+
+#include "megbrain/comp_node_env.h"
+#include "megbrain/jit/utils.h"
+#include "megbrain/utils/persistent_cache.h"
+#include "megbrain/utils/timer.h"
+
+#if MGB_JIT
+
+using namespace mgb;
+using namespace jit;
+
+namespace {
+//! minimal number of output elements computed by a task
+constexpr size_t MIN_ELEMS_PER_TASK = 32768;
+}  // anonymous namespace
+
+/* =================== HostCExecutable ==================== */
+
+HostCExecutable::HostCExecutable(std::string source_template, std::string name)
+        : m_source_template{std::move(source_template)}, m_name{std::move(name)} {}
+
+HostCExecutable::Kernel HostCExecutable::get_kernel(
+        CompNode cn, const SmallVector<CInputAccess>& access) {
+    MGB_LOCK_GUARD(m_mtx);
+    auto&& kern = m_kernels[std::string(
+            reinterpret_cast<const char*>(access.data()), access.size())];
+    if (kern) {
+        return kern;
+    }
+
+    RealTimer timer;
+    std::string kernel_name, source;
+    std::tie(kernel_name, source) = instantiate_c_kernel(m_source_template, access);
+    auto&& helper = ExecutableHelper::get();
+    auto&& cache = PersistentCache::inst();
+    auto category = ssprintf(
+            "jit:host_c:%s;%s",
+            PersistentCache::make_category_from_comp_node(cn).c_str(),
+            helper.c_compiler_signature().c_str());
+    PersistentCache::Blob key{source.data(), source.size()};
+    // libraries loaded by dlopen() are identified by path, so each load needs
+    // a unique file
+    auto lib_name = kernel_name + "-" + next_kernel_name();
+    std::string lib;
+    auto lib_cache = cache.get(category, key);
+    if (lib_cache.valid()) {
+        lib.assign(static_cast<const char*>(lib_cache->ptr), lib_cache->size);
+        lib_name += ".so";
+        helper.write_file(lib_name, lib);
+    } else {
+        if (ExecutableHelper::keep_interm()) {
+            helper.write_file(
+                    kernel_name + ".c", "/* " + m_name + " */\n" + source);
+        }
+        lib_name = helper.compile_c_source_shared(source, lib_name);
+        lib = helper.read_file(lib_name);
+        cache.put(category, key, {lib.data(), lib.size()});
+    }
+    auto handle = helper.load_lib(lib_name);
+    m_lib_handles.push_back(handle);
+    helper.resolve_func(kern, handle, kernel_name);
+    helper.remove_interm(lib_name);
+    mgb_log("host C JIT: compile %s for %s: source_len=%zu lib_len=%zu "
+            "cached=%d time=%.3fms",
+            m_name.c_str(), kernel_name.c_str(), source.size(), lib.size(),
+            lib_cache.valid(), timer.get_msecs());
+    return kern;
+}
+
+void HostCExecutable::execute(JITExecutor* fusion_opr) {
+    auto&& args = fusion_opr->args();
+    auto&& dest = args.outputs[0].layout;
+    mgb_assert(dest.is_contiguous());
+    size_t nr_elements = dest.total_nr_elems();
+    if (!nr_elements) {
+        return;
+    }
+
+    size_t nr_inps = args.inputs.size(), ndim = dest.ndim;
+    SmallVector<void*> inputs(nr_inps);
+    SmallVector<ptrdiff_t> strides(nr_inps * ndim);
+    SmallVector<size_t> shape(dest.shape, dest.shape + ndim);
+    SmallVector<CInputAccess> access(nr_inps);
+    for (size_t i = 0; i < nr_inps; ++i) {
+        auto&& layout = args.inputs[i].layout;
+        mgb_assert(layout.ndim == ndim);
+        inputs[i] = args.inputs[i].from->dev_tensor().raw_ptr();
+        std::copy(layout.stride, layout.stride + ndim, strides.begin() + i * ndim);
+        auto inner = layout.stride[ndim - 1];
+        access[i] = inner == 1   ? CInputAccess::CONTIG
+                    : inner == 0 ? CInputAccess::BROADCAST
+                                 : CInputAccess::STRIDED;
+    }
+    void* output = args.outputs[0].from->dev_tensor().raw_ptr();
+    auto kernel = get_kernel(fusion_opr->comp_node(), access);
+
+    auto&& env = CompNodeEnv::from_comp_node(fusion_opr->comp_node()).cpu_env();
+    size_t nr_tasks = std::min(
+            env.dispatcher->nr_threads(),
+            std::max<size_t>(nr_elements / MIN_ELEMS_PER_TASK, 1));
+    size_t chunk = (nr_elements + nr_tasks - 1) / nr_tasks;
+    nr_tasks = (nr_elements + chunk - 1) / chunk;
+    auto kern = [kernel, inputs = std::move(inputs), strides = std::move(strides),
+                 shape = std::move(shape), output, chunk,
+                 nr_elements](size_t task_id, size_t) {
+        size_t begin = task_id * chunk,
+               end = std::min(nr_elements, (task_id + 1) * chunk);
+        kernel(inputs.data(), strides.data(), shape.data(), output, begin, end);
+    };
+    env.dispatch(std::move(kern), nr_tasks);
+}
+
+HostCExecutable::~HostCExecutable() {
+    for (auto handle : m_lib_handles) {
+        ExecutableHelper::get().unload_lib(handle);
+    }
+}
+
+/* ==================== HostCCompiler ===================== */
+
+std::unique_ptr<Executable> HostCCompiler::do_compile(
+        const InternalGraph& graph, const JITExecutor::Args& args) {
+    return std::make_unique<HostCExecutable>(
+            codegen_c(graph, args), next_kernel_name());
+}
+
+#endif  // MGB_JIT
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
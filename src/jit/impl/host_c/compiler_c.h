@@ -0,0 +1,90 @@
+/**
+ * \file src/jit/impl/host_c/compiler_c.h
+ * MegEngine is Licensed under the Apache License, Version 2.0 (the "License")
+ *
+ * Copyright (c) 2014-2021 Megvii Inc. All rights reserved.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT ARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include "megbrain_build_config.h"
+
+#if MGB_JIT
+
+#include "./codegen_c.h"
+#include "megbrain/jit/compiler.h"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace mgb {
+namespace jit {
+
+/*!
+ * \brief Executable class for kernels compiled by the host C compiler
+ *
+ * A kernel is compiled for each combination of innermost input strides
+ * (see CInputAccess) on first use, so the inner loop can be vectorized by the
+ * C compiler. The shared libraries are stored in PersistentCache.
+ */
+class HostCExecutable final : public Executable {
+public:
+    HostCExecutable(std::string source_template, std::string name);
+    ~HostCExecutable();
+
+    /*!
+     * \brief execute
+     * A executable instance can be executed by one or more fusion_opr
+     */
+    void execute(JITExecutor* fusion_opr) override final;
+
+private:
+    using Kernel = void (*)(
+            void* const* inputs, const ptrdiff_t* strides, const size_t* shape,
+            void* output, size_t begin, size_t end);
+
+    Kernel get_kernel(CompNode cn, const SmallVector<CInputAccess>& access);
+
+    const std::string m_source_template;
+    const std::string m_name;
+    std::mutex m_mtx;
+    //! input access (as chars) => kernel
+    std::unordered_map<std::string, Kernel> m_kernels;
+    SmallVector<void*> m_lib_handles;
+};
+
+/*!
+ * \brief CPU compiler generating C code from ast_c and compiling it with the
+ *      system C compiler
+ *
+ * This backend does not depend on LLVM, so elemwise fusion is available on
+ * CPU in builds without MLIR.
+ */
+class HostCCompiler final : public Compiler {
+    std::unique_ptr<Executable> do_compile(
+            const InternalGraph& graph, const JITExecutor::Args& args) override;
+
+public:
+    //! dimshuffle is supported as JITExecutor applies it to the input layouts,
+    //! while reduce is not
+    Property property() const override {
+        using F = Property::Flag;
+        return Property{
+                F::NEED_INPUT_COLLAPSE | F::BIND_NDIM, JITFeatureBits::DIMSHUFFLE, 64};
+    }
+
+    size_t get_nr_workspace_outputs(JITExecutor* opr) const override { return 0; }
+
+    void init_workspace_size_infer(JITExecutor* opr) override {}
+};
+
+}  // namespace jit
+}  // namespace mgb
+
+#endif  // MGB_JIT
+
+// vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
@@ -22,12 +22,17 @@
 #include "megbrain/comp_node_env.h"
 #include "megbrain/jit/mlir/ir/dialect.h"
 #include "megbrain/jit/mlir/ir/passes.h"
+#include "megbrain/jit/mlir/ir/utils.h"
+#include "megbrain/utils/persistent_cache.h"
 #include "megbrain/utils/timer.h"
+#include "megbrain/version.h"
 
 #include <mlir/Conversion/GPUCommon/GPUCommonPass.h>
 #include <mlir/Conversion/GPUToNVVM/GPUToNVVMPass.h>
 #include <mlir/Conversion/SCFToStandard/SCFToStandard.h>
 #include <mlir/Conversion/StandardToLLVM/ConvertStandardToLLVMPass.h>
+#include <mlir/Conversion/VectorToSCF/VectorToSCF.h>
+#include <mlir/Dialect/Affine/Passes.h>
 #include <mlir/Dialect/GPU/Passes.h>
 #include <mlir/IR/Dialect.h>
 #include <mlir/IR/MLIRContext.h>
@@ -38,9 +43,11 @@
 #include <mlir/Target/NVVMIR.h>
 #include <mlir/Transforms/Passes.h>
 
+#include <llvm/Config/llvm-config.h>
 #include <llvm/IRReader/IRReader.h>
 #include <llvm/Linker/Linker.h>
 #include <llvm/Pass.h>
+#include <llvm/Support/Host.h>
 #include <llvm/Support/TargetSelect.h>
 
 #include <dirent.h>
@@ -126,6 +133,18 @@ std::unique_ptr<llvm::Module> translate_module_to_nvvm_ir_and_link_device(
 
 #endif
 
+//! number of 32-bit lanes of the widest vector register of the host
+int64_t get_host_vector_size() {
+    llvm::StringMap<bool> features;
+    if (llvm::sys::getHostCPUFeatures(features)) {
+        if (features.lookup("avx512f"))
+            return 16;
+        if (features.lookup("avx"))
+            return 8;
+    }
+    return 4;
+}
+
 void add_cpu_lowering_pass(mlir::PassManager& manager) {
     {
         mlir::OpPassManager& opt_pm = manager.nest<mlir::FuncOp>();
@@ -139,6 +158,12 @@ void add_cpu_lowering_pass(mlir::PassManager& manager) {
         opt_pm.addPass(mlir::createCSEPass());
         opt_pm.addPass(mlir::createLoopFusionPass());
         opt_pm.addPass(mlir::createMemRefDataFlowOptPass());
+        //! vectorize the innermost loops into vector transfers and ops; loops
+        //! with accesses not contiguous along them are kept scalar
+        static const int64_t vector_size = get_host_vector_size();
+        opt_pm.addPass(mlir::createSuperVectorizePass({vector_size}));
+        opt_pm.addPass(mlir::createCanonicalizerPass());
+        opt_pm.addPass(mlir::createConvertVectorToSCFPass());
     }
     manager.addPass(create_lower_to_llvm_pass());
 }
@@ -224,12 +249,44 @@ std::unique_ptr<Executable> MLIRCompiler::do_compile(
     mgb_assert(res.second, "failed to generate module");
 
     CompNode cn = args.owner->comp_node();
-    run_lowering_pass(res.second, cn);
     switch (cn.device_type()) {
-        case CompNode::DeviceType::CPU:
-            return std::make_unique<MLIRCPUExecutable>(res.second, res.first.str());
+        case CompNode::DeviceType::CPU: {
+            //! kernels that can not be split are lowered to compute the whole
+            //! output, see LoopRange
+            bool split = can_split_cpu_kernel(
+                    res.second->getOperation(), args.outputs[0].from->layout());
+
+            //! the object code only depends on the kernel before lowering, which
+            //! contains the shapes and dtypes, the lowering passes and kernel
+            //! arguments given by the ABI version, and the host target
+            std::string kernel_name = res.first.str(),
+                        source = mlir_type_to_string(res.second.get());
+            auto version = get_version();
+            auto category = ssprintf(
+                    "jit:mlir:%s;mge=%d.%d.%d%s;abi=%d;llvm=%s;%s",
+                    PersistentCache::make_category_from_comp_node(cn).c_str(),
+                    version.major, version.minor, version.patch,
+                    version.is_dev ? "-dev" : "", MLIRCPUExecutable::ABI_VERSION,
+                    LLVM_VERSION_STRING, MLIRCPUExecutable::host_target_desc().c_str());
+            auto&& cache = PersistentCache::inst();
+            PersistentCache::Blob key{source.data(), source.size()};
+            std::string object;
+            auto cached = cache.get(category, key);
+            if (cached.valid()) {
+                object.assign(static_cast<const char*>(cached->ptr), cached->size);
+            } else {
+                run_lowering_pass(res.second, cn);
+                RealTimer timer;
+                object = MLIRCPUExecutable::compile_to_object(res.second, kernel_name);
+                mgb_log("MLIR JIT: compile %s to object used: %.3f ms",
+                        kernel_name.c_str(), timer.get_msecs());
+                cache.put(category, key, {object.data(), object.size()});
+            }
+            return std::make_unique<MLIRCPUExecutable>(object, kernel_name, split);
+        }
 #if MGB_CUDA
         case CompNode::DeviceType::CUDA:
+            run_lowering_pass(res.second, cn);
             return std::make_unique<MLIRCUDAExecutable>(res.second, res.first.str());
 #endif
         default:
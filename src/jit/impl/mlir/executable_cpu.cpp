@@ -16,118 +16,248 @@
 #include "./executable_cpu.h"
 #include "./ir/types.h"
 
+#include "megbrain/comp_node_env.h"
 #include "megbrain/jit/mlir/ir/utils.h"
 
-#include <mlir/ExecutionEngine/CRunnerUtils.h>
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <mlir/ExecutionEngine/OptUtils.h>
+#include <mlir/Target/LLVMIR.h>
 
 using namespace mgb;
 using namespace jit;
 
 namespace {
 
-template <typename T, int N>
-StridedMemRefType<T, N>* get_strided_memref_type(const megdnn::TensorND& tensor) {
-    using DescType = StridedMemRefType<T, N>;
-    DescType* desc = static_cast<DescType*>(malloc(sizeof(DescType)));
-    desc->basePtr = tensor.ptr<T>();
-    desc->data = tensor.ptr<T>();
-    desc->offset = 0;
-    for (size_t i = 0; i < tensor.layout.ndim; i++) {
-        desc->sizes[i] = tensor.layout.shape[i];
-        desc->strides[i] = tensor.layout.stride[i];
+//! minimal number of elements of the largest tensor handled by a task
+constexpr size_t MIN_ELEMS_PER_TASK = 32768;
+
+/*!
+ * \brief memref descriptor of any dtype, which has the same layout as
+ *      StridedMemRefType<T, N> whose strides follow its N sizes
+ */
+struct MemRefDesc {
+    void* base_ptr;
+    void* data;
+    int64_t offset;
+    int64_t sizes_and_strides[2 * TensorLayout::MAX_NDIM];
+
+    void set(void* ptr, const TensorLayout& layout) {
+        base_ptr = data = ptr;
+        offset = 0;
+        for (size_t i = 0; i < layout.ndim; i++) {
+            sizes_and_strides[i] = layout.shape[i];
+            sizes_and_strides[layout.ndim + i] = layout.stride[i];
+        }
+    }
+};
+
+template <typename T>
+T unwrap(llvm::Expected<T>&& val, const char* msg) {
+    if (!val) {
+        mgb_throw(
+                InternalError, "%s: %s", msg, llvm::toString(val.takeError()).c_str());
     }
-    return desc;
+    return std::move(*val);
 }
 
-template <int N>
-void* tensor2memref_dim(const megdnn::TensorND& tensor) {
-    switch (tensor.layout.dtype.enumv()) {
-#define cb(_dtype, _type)           \
-    case megdnn::DTypeEnum::_dtype: \
-        return get_strided_memref_type<_type, N>(tensor);
-        FOR_EACH_DNN_DTYPE(cb)
-#undef cb
-        default:
-            mgb_throw(
-                    InternalError, "Unsupported dtype: %s", tensor.layout.dtype.name());
+void check(llvm::Error err, const char* msg) {
+    if (err) {
+        mgb_throw(InternalError, "%s: %s", msg, llvm::toString(std::move(err)).c_str());
     }
-    return nullptr;
 }
 
-void* tensor2memref(const megdnn::TensorND& tensor) {
-    switch (tensor.layout.ndim) {
-#define cb(i) \
-    case i:   \
-        return tensor2memref_dim<i>(tensor)
-
-        cb(1);
-        cb(2);
-        cb(3);
-        cb(4);
-        cb(5);
-        default:
-            mgb_throw(InternalError, "Unsupported ndim, got %zu", tensor.layout.ndim);
-#undef cb
+llvm::orc::JITTargetMachineBuilder detect_host() {
+    return unwrap(
+            llvm::orc::JITTargetMachineBuilder::detectHost(),
+            "failed to detect the host target");
+}
+
+std::string get_packed_name(const std::string& kernel_name) {
+    return "_mlir__mlir_ciface_" + kernel_name;
+}
+
+/*!
+ * \brief add a function taking the pointers to the arguments of \p func as a
+ *      void** and calling it, like mlir::ExecutionEngine does
+ */
+void add_packed_function(llvm::Function* func, const std::string& name) {
+    auto&& ctx = func->getContext();
+    llvm::IRBuilder<> builder(ctx);
+    auto packed_type = llvm::FunctionType::get(
+            builder.getVoidTy(), builder.getInt8PtrTy()->getPointerTo(), false);
+    auto packed = llvm::Function::Create(
+            packed_type, llvm::GlobalValue::ExternalLinkage, name, func->getParent());
+    builder.SetInsertPoint(llvm::BasicBlock::Create(ctx, "entry", packed));
+
+    llvm::Value* packed_args = packed->arg_begin();
+    auto i8_ptr_type = builder.getInt8PtrTy();
+    llvm::SmallVector<llvm::Value*, 16> args;
+    for (auto&& arg : func->args()) {
+        auto arg_ptr = builder.CreateLoad(
+                i8_ptr_type,
+                builder.CreateGEP(
+                        i8_ptr_type, packed_args, builder.getInt64(arg.getArgNo())));
+        args.push_back(builder.CreateLoad(
+                arg.getType(),
+                builder.CreateBitCast(arg_ptr, arg.getType()->getPointerTo())));
     }
+    builder.CreateCall(func, args);
+    builder.CreateRetVoid();
 }
 
 }  // namespace
+
+struct MLIRCPUExecutable::MemRefDescs {
+    std::vector<MemRefDesc> descs;
+    //! pointers to descs, whose addresses are the memref arguments of the
+    //! packed kernel
+    std::vector<void*> desc_ptrs;
+
+    explicit MemRefDescs(size_t nr_args) : descs(nr_args), desc_ptrs(nr_args) {
+        for (size_t i = 0; i < nr_args; i++) {
+            desc_ptrs[i] = &descs[i];
+        }
+    }
+};
+
+std::string MLIRCPUExecutable::host_target_desc() {
+    auto tm_builder = detect_host();
+    return ssprintf(
+            "triple=%s;cpu=%s;features=%s",
+            tm_builder.getTargetTriple().str().c_str(), tm_builder.getCPU().c_str(),
+            tm_builder.getFeatures().getString().c_str());
+}
+
+std::string MLIRCPUExecutable::compile_to_object(
+        mlir::OwningModuleRef& module, const std::string& kernel_name) {
+    //! the target machine of the host lets LLVM vectorize for its vector width
+    auto tm_builder = detect_host();
+    auto target_machine = unwrap(
+            tm_builder.createTargetMachine(), "failed to create the target machine");
+
+    llvm::LLVMContext llvm_ctx;
+    auto llvm_module = mlir::translateModuleToLLVMIR(*module, llvm_ctx);
+    mgb_assert(llvm_module, "failed to translate MLIR kernel %s", kernel_name.c_str());
+    llvm_module->setDataLayout(target_machine->createDataLayout());
+    llvm_module->setTargetTriple(target_machine->getTargetTriple().getTriple());
+
+    auto ciface = llvm_module->getFunction("_mlir_ciface_" + kernel_name);
+    mgb_assert(ciface, "failed to find MLIR kernel %s", kernel_name.c_str());
+    add_packed_function(ciface, get_packed_name(kernel_name));
+
+    auto opt_pipeline = mlir::makeOptimizingTransformer(3, 0, target_machine.get());
+    check(opt_pipeline(llvm_module.get()), "failed to optimize MLIR kernel");
+
+    auto object = unwrap(
+            llvm::orc::SimpleCompiler{*target_machine}(*llvm_module),
+            "failed to compile MLIR kernel");
+    return {object->getBufferStart(), object->getBufferSize()};
+}
+
 MLIRCPUExecutable::MLIRCPUExecutable(
-        mlir::OwningModuleRef& module, const std::string& kernel_name)
-        : m_kernel_name{kernel_name} {
-    auto opt_pipeline = mlir::makeOptimizingTransformer(3, 3, 0);
-    std::vector<std::string> libs;
-    auto&& engine = mlir::ExecutionEngine::create(
-            *module, nullptr, opt_pipeline, llvm::None,
-            std::vector<llvm::StringRef>(libs.begin(), libs.end()), true, false);
-    mgb_assert(engine);
-    m_engine = std::move(*engine);
+        const std::string& object, const std::string& kernel_name, bool split)
+        : m_kernel_name{kernel_name}, m_split{split} {
+    auto tm_builder = detect_host();
+    m_jit = unwrap(
+            llvm::orc::LLJITBuilder().setJITTargetMachineBuilder(tm_builder).create(),
+            "failed to create the JIT");
+
+    //! resolve the runtime functions called by the kernel, such as malloc
+    auto&& dylib = m_jit->getMainJITDylib();
+    dylib.addGenerator(unwrap(
+            llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+                    m_jit->getDataLayout().getGlobalPrefix()),
+            "failed to load the symbols of the process"));
+    auto buffer = llvm::MemoryBuffer::getMemBufferCopy(object, kernel_name);
+    check(m_jit->addObjectFile(std::move(buffer)), "failed to load MLIR kernel");
+
+    auto kernel = unwrap(
+            m_jit->lookup(get_packed_name(kernel_name)),
+            "failed to find MLIR kernel");
+    m_kernel = reinterpret_cast<PackedKernel>(
+            static_cast<uintptr_t>(kernel.getAddress()));
 }
 
 void MLIRCPUExecutable::execute(JITExecutor* fusion_opr) {
     auto&& args = fusion_opr->args();
-    std::vector<void*> args_array(args.inputs.size() + args.outputs.size());
-    std::vector<void*> args_array_pointer(args.inputs.size() + args.outputs.size());
-    size_t idx = 0;
-    for (size_t i = 0; i < args.inputs.size(); i++) {
-        args_array[idx] = tensor2memref(
-                {args.inputs[i].from->dev_tensor().raw_ptr(), args.inputs[i].layout});
-        args_array_pointer[idx] = &args_array[idx];
-        idx++;
+    size_t nr_args = args.inputs.size() + args.outputs.size();
+    MemRefDescs* descs;
+    {
+        MGB_LOCK_GUARD(m_descs_mtx);
+        auto&& cached = m_descs[fusion_opr];
+        if (!cached) {
+            cached = std::make_unique<MemRefDescs>(nr_args);
+        }
+        descs = cached.get();
     }
-    int64_t nr_elements = 0;
+    mgb_assert(descs->descs.size() == nr_args);
+
+    SmallVector<std::pair<void*, TensorLayout>> tensors;
+    //! the work of a kernel with Reduce follows its input, not its output
+    size_t max_nr_elements = 0;
+    for (auto&& i : args.inputs) {
+        tensors.emplace_back(i.from->dev_tensor().raw_ptr(), i.layout);
+        max_nr_elements = std::max(max_nr_elements, i.layout.total_nr_elems());
+    }
+    size_t nr_elements = 0;
     for (size_t i = 0; i < args.outputs.size(); i++) {
         if (nr_elements == 0) {
             nr_elements = args.outputs[i].layout.total_nr_elems();
         } else {
             mgb_assert(
-                    static_cast<size_t>(nr_elements) ==
-                            args.outputs[i].layout.total_nr_elems(),
+                    nr_elements == args.outputs[i].layout.total_nr_elems(),
                     "The number of elements of outputs mismatch, expected: "
                     "%zu got: %zu(%s)",
-                    static_cast<size_t>(nr_elements),
-                    args.outputs[i].layout.total_nr_elems(),
+                    nr_elements, args.outputs[i].layout.total_nr_elems(),
                     args.outputs[i].layout.to_string().c_str());
         }
-        args_array[idx] = tensor2memref(
-                {args.outputs[i].from->dev_tensor().raw_ptr(), args.outputs[i].layout});
-        args_array_pointer[idx] = &args_array[idx];
-        idx++;
+        tensors.emplace_back(
+                args.outputs[i].from->dev_tensor().raw_ptr(), args.outputs[i].layout);
     }
-
-    args_array_pointer.push_back(&nr_elements);
-    std::string adapter_name = std::string("_mlir_ciface_") + m_kernel_name;
-    auto err = m_engine->invoke(
-            adapter_name, llvm::MutableArrayRef<void*>(args_array_pointer));
-    if (err) {
-        mgb_throw(
-                InternalError, "failed to run MLIR kernel %s\n", m_kernel_name.c_str());
+    for (auto&& i : tensors) {
+        mgb_assert(
+                i.second.ndim <= TensorLayout::MAX_NDIM, "Unsupported ndim, got %zu",
+                i.second.ndim);
     }
 
-    for (size_t i = 0; i < args_array.size(); i++) {
-        free(args_array[i]);
-    }
+    auto&& dest = args.outputs[0].layout;
+    int axis = m_split ? get_cpu_split_axis(dest) : -1;
+    size_t axis_size = axis < 0 ? 1 : dest[axis];
+    auto&& env = CompNodeEnv::from_comp_node(fusion_opr->comp_node()).cpu_env();
+    size_t nr_tasks = std::min(
+            {axis_size, env.dispatcher->nr_threads(),
+             std::max<size_t>(
+                     std::max(nr_elements, max_nr_elements) / MIN_ELEMS_PER_TASK,
+                     1)});
+    size_t chunk = (axis_size + nr_tasks - 1) / nr_tasks;
+    nr_tasks = (axis_size + chunk - 1) / chunk;
+
+    //! descs are updated on the computing thread, after the previous
+    //! execution of this fusion_opr finished reading them
+    auto update_descs = [descs, tensors = std::move(tensors)]() {
+        for (size_t i = 0; i < tensors.size(); i++) {
+            descs->descs[i].set(tensors[i].first, tensors[i].second);
+        }
+    };
+    auto kern = [kernel = m_kernel, descs, chunk, axis_size](
+                        size_t task_id, size_t) {
+        int64_t begin = task_id * chunk,
+                end = std::min(axis_size, (task_id + 1) * chunk);
+        size_t nr_args = descs->desc_ptrs.size();
+        SmallVector<void*, 16> packed_args(nr_args + 2);
+        for (size_t i = 0; i < nr_args; i++) {
+            packed_args[i] = &descs->desc_ptrs[i];
+        }
+        packed_args[nr_args] = &begin;
+        packed_args[nr_args + 1] = &end;
+        kernel(packed_args.data());
+    };
+    env.dispatch(update_descs);
+    env.dispatch(kern, nr_tasks);
 }
 
 MLIRCPUExecutable::~MLIRCPUExecutable() {}
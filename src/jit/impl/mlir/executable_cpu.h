@@ -16,19 +16,47 @@
 #if MGB_JIT && MGB_JIT_MLIR
 
 #include "megbrain/jit/compiler.h"
+#include "megbrain/utils/thin/hash_table.h"
 
-#include <mlir/ExecutionEngine/ExecutionEngine.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
 #include <mlir/IR/Module.h>
 
+#include <mutex>
+
 namespace mgb {
 namespace jit {
 
 /*!
  * \brief Executable class for MLIR
+ *
+ * The kernel computes the range of the axis of the output given by
+ * get_cpu_split_axis() which is passed by its last two arguments, so the
+ * output is split into ranges computed by the threads of the comp node. If
+ * \p split is false, the kernel has been lowered to compute the whole output
+ * and is run as a single task.
+ *
+ * The kernel is loaded from its object code, so the object code can be
+ * cached across processes and LLVM is skipped on cache hits.
  */
 class MLIRCPUExecutable final : public Executable {
 public:
-    MLIRCPUExecutable(mlir::OwningModuleRef& module, const std::string& kernel_name);
+    //! version of the lowering passes and of the kernel arguments; bump it
+    //! whenever either changes, so that object code cached by another build
+    //! with the same MegEngine version is not reused
+    static constexpr int ABI_VERSION = 1;
+
+    /*!
+     * \brief compile the lowered \p module into object code for the host
+     */
+    static std::string compile_to_object(
+            mlir::OwningModuleRef& module, const std::string& kernel_name);
+
+    //! target triple, CPU name and features of the host, which object code
+    //! compiled by compile_to_object() depends on
+    static std::string host_target_desc();
+
+    MLIRCPUExecutable(
+            const std::string& object, const std::string& kernel_name, bool split);
     ~MLIRCPUExecutable();
 
     /*!
@@ -38,8 +66,17 @@ public:
     void execute(JITExecutor* fusion_opr) override final;
 
 private:
-    std::unique_ptr<mlir::ExecutionEngine> m_engine;
+    struct MemRefDescs;
+    using PackedKernel = void (*)(void**);
+
+    std::unique_ptr<llvm::orc::LLJIT> m_jit;
     std::string m_kernel_name;
+    PackedKernel m_kernel;
+    bool m_split;
+
+    //! memref descriptors of each fusion_opr, reused across executions
+    std::mutex m_descs_mtx;
+    ThinHashMap<JITExecutor*, std::unique_ptr<MemRefDescs>> m_descs;
 };
 
 }  // namespace jit
@@ -27,6 +27,8 @@
 #include <mlir/Pass/Pass.h>
 #include <mlir/Transforms/DialectConversion.h>
 
+#include <limits>
+
 using namespace mgb;
 using namespace jit;
 
@@ -34,19 +36,82 @@ namespace {
 
 using LoopIterationFn = function_ref<Value(
         OpBuilder& rewriter, ValueRange memRefOperands, ValueRange loopIvs)>;
+using LoopBodyFn = function_ref<void(OpBuilder&, Location, ValueRange)>;
+
+/*!
+ * \brief the range of the split axis of the output computed by a CPU kernel,
+ *      given by its last two arguments, see MLIRCPUExecutable
+ *
+ * Loops over memrefs sharing the split axis of the output only cover
+ * [begin, end) of it, and other loops cover the whole memref. The axis is -1
+ * if the kernel computes the whole output, which is the case for kernels
+ * without the range arguments and kernels rejected by can_split_cpu_kernel.
+ */
+struct LoopRange {
+    int axis = -1;
+    megdnn::TensorLayout dest;
+    Value begin, end;
+};
+
+void build_loop_nest(
+        OpBuilder& builder, Location loc, MemRefType type, const LoopRange& range,
+        LoopBodyFn body) {
+    auto shape = type.getShape();
+    int rank = shape.size();
+    int axis = range.axis < 0 ? -1 : range.axis - (int(range.dest.ndim) - rank);
+    if (axis < 0 || shape[axis] != int64_t(range.dest[range.axis])) {
+        llvm::SmallVector<int64_t, 4> lower_bounds(rank, 0);
+        llvm::SmallVector<int64_t, 4> steps(rank, 1);
+        buildAffineLoopNest(builder, loc, lower_bounds, shape, steps, body);
+        return;
+    }
+
+    //! the axes before the split axis are 1 in the output, but not in the
+    //! input of a Reduce along them, so they are looped over entirely
+    auto build_split_loops = [&](OpBuilder& outer_builder, Location loc,
+                                 ValueRange outer_ivs) {
+        llvm::SmallVector<Value, 4> ivs(outer_ivs.begin(), outer_ivs.end());
+        auto map = outer_builder.getSymbolIdentityMap();
+        auto loop = outer_builder.create<AffineForOp>(
+                loc, ValueRange{range.begin}, map, ValueRange{range.end}, map);
+        ivs.push_back(loop.getInductionVar());
+        auto nested_builder = OpBuilder::atBlockTerminator(loop.getBody());
+        auto inner_shape = shape.drop_front(axis + 1);
+        if (inner_shape.empty()) {
+            body(nested_builder, loc, ivs);
+            return;
+        }
+        llvm::SmallVector<int64_t, 4> lower_bounds(inner_shape.size(), 0);
+        llvm::SmallVector<int64_t, 4> steps(inner_shape.size(), 1);
+        buildAffineLoopNest(
+                nested_builder, loc, lower_bounds, inner_shape, steps,
+                [&](OpBuilder& inner_builder, Location loc, ValueRange inner_ivs) {
+                    auto all_ivs = ivs;
+                    all_ivs.append(inner_ivs.begin(), inner_ivs.end());
+                    body(inner_builder, loc, all_ivs);
+                });
+    };
+    if (axis == 0) {
+        build_split_loops(builder, loc, ArrayRef<Value>());
+        return;
+    }
+    llvm::SmallVector<int64_t, 4> lower_bounds(axis, 0);
+    llvm::SmallVector<int64_t, 4> steps(axis, 1);
+    buildAffineLoopNest(
+            builder, loc, lower_bounds, shape.take_front(axis), steps,
+            build_split_loops);
+}
 
 void lower_op_to_loops(
         Operation* op, ValueRange operands, PatternRewriter& rewriter,
-        LoopIterationFn process_iteration) {
+        const LoopRange& range, LoopIterationFn process_iteration) {
     auto memref_type = (*op->result_type_begin()).cast<MemRefType>();
     auto loc = op->getLoc();
 
     auto alloc = jit::insert_alloc_and_dealloc(memref_type, loc, rewriter);
 
-    llvm::SmallVector<int64_t, 4> lower_bounds(memref_type.getRank(), 0);
-    llvm::SmallVector<int64_t, 4> steps(memref_type.getRank(), 1);
-    buildAffineLoopNest(
-            rewriter, loc, lower_bounds, memref_type.getShape(), steps,
+    build_loop_nest(
+            rewriter, loc, memref_type, range,
             [&](OpBuilder& nested_builder, Location loc, ValueRange ivs) {
                 Value value_to_store = process_iteration(nested_builder, operands, ivs);
                 nested_builder.create<AffineStoreOp>(loc, value_to_store, alloc, ivs);
@@ -57,8 +122,9 @@ void lower_op_to_loops(
 }
 
 struct ElemwiseLowering : public ConversionPattern {
-    ElemwiseLowering(MLIRContext* ctx)
-            : ConversionPattern(mgb::dialect::Elemwise::getOperationName(), 1, ctx) {}
+    ElemwiseLowering(MLIRContext* ctx, const LoopRange* range)
+            : ConversionPattern(mgb::dialect::Elemwise::getOperationName(), 1, ctx),
+              m_range{range} {}
 
     LogicalResult matchAndRewrite(
             Operation* op, ArrayRef<Value> operands,
@@ -68,7 +134,7 @@ struct ElemwiseLowering : public ConversionPattern {
         megdnn::TensorLayout dst_layout = mlir_type_to_layout(dst_memref_type);
         dst_layout.init_contiguous_stride();
         lower_op_to_loops(
-                op, operands, rewriter,
+                op, operands, rewriter, *m_range,
                 [dst_layout, loc, op](
                         OpBuilder& builder, ValueRange memref_operands,
                         ValueRange loop_ivs) {
@@ -81,18 +147,22 @@ struct ElemwiseLowering : public ConversionPattern {
                 });
         return success();
     }
+
+private:
+    const LoopRange* m_range;
 };
 
 struct TypeCvtLowering : public ConversionPattern {
-    TypeCvtLowering(MLIRContext* ctx)
-            : ConversionPattern(mgb::dialect::TypeCvt::getOperationName(), 1, ctx) {}
+    TypeCvtLowering(MLIRContext* ctx, const LoopRange* range)
+            : ConversionPattern(mgb::dialect::TypeCvt::getOperationName(), 1, ctx),
+              m_range{range} {}
 
     LogicalResult matchAndRewrite(
             Operation* op, ArrayRef<Value> operands,
             ConversionPatternRewriter& rewriter) const final {
         auto loc = op->getLoc();
         lower_op_to_loops(
-                op, operands, rewriter,
+                op, operands, rewriter, *m_range,
                 [loc, op](
                         OpBuilder& builder, ValueRange memref_operands,
                         ValueRange loop_ivs) {
@@ -102,11 +172,15 @@ struct TypeCvtLowering : public ConversionPattern {
                 });
         return success();
     }
+
+private:
+    const LoopRange* m_range;
 };
 
 struct DimshuffleLowering : public ConversionPattern {
-    DimshuffleLowering(MLIRContext* ctx)
-            : ConversionPattern(mgb::dialect::Dimshuffle::getOperationName(), 1, ctx) {}
+    DimshuffleLowering(MLIRContext* ctx, const LoopRange* range)
+            : ConversionPattern(mgb::dialect::Dimshuffle::getOperationName(), 1, ctx),
+              m_range{range} {}
 
     static mlir::AffineMap get_affinemap_from_pattern(
             const std::vector<int32_t>& pattern, mlir::MLIRContext* ctx) {
@@ -128,7 +202,7 @@ struct DimshuffleLowering : public ConversionPattern {
         auto pattern = llvm::dyn_cast<dialect::Dimshuffle>(op).pattern();
         auto map = get_affinemap_from_pattern(pattern, op->getContext());
         lower_op_to_loops(
-                op, operands, rewriter,
+                op, operands, rewriter, *m_range,
                 [loc, op, &map](
                         OpBuilder& builder, ValueRange memref_operands,
                         ValueRange loop_ivs) {
@@ -137,11 +211,103 @@ struct DimshuffleLowering : public ConversionPattern {
                 });
         return success();
     }
+
+private:
+    const LoopRange* m_range;
+};
+
+struct ReduceLowering : public ConversionPattern {
+    using Mode = megdnn::param::Reduce::Mode;
+
+    ReduceLowering(MLIRContext* ctx, const LoopRange* range)
+            : ConversionPattern(mgb::dialect::Reduce::getOperationName(), 1, ctx),
+              m_range{range} {}
+
+    static Value identity(ValueBuilderHelper& helper, Mode mode) {
+        switch (mode) {
+            case Mode::PRODUCT:
+                return helper.const_f32(1.f);
+            case Mode::MIN:
+                return helper.const_f32(std::numeric_limits<float>::infinity());
+            case Mode::MAX:
+                return helper.const_f32(-std::numeric_limits<float>::infinity());
+            default:
+                return helper.const_f32(0.f);
+        }
+    }
+
+    static Value accumulate(
+            ValueBuilderHelper& helper, Mode mode, Value acc, Value val) {
+        switch (mode) {
+            case Mode::SUM_SQR:
+                return helper.add(acc, helper.mul(val, val));
+            case Mode::PRODUCT:
+                return helper.mul(acc, val);
+            case Mode::MIN:
+                return helper.min(acc, val);
+            case Mode::MAX:
+                return helper.max(acc, val);
+            default:
+                return helper.add(acc, val);
+        }
+    }
+
+    LogicalResult matchAndRewrite(
+            Operation* op, ArrayRef<Value> operands,
+            ConversionPatternRewriter& rewriter) const final {
+        auto loc = op->getLoc();
+        auto mode = llvm::dyn_cast<dialect::Reduce>(op).mode();
+        auto src_type = operands[0].getType().cast<MemRefType>();
+        auto dst_type = (*op->result_type_begin()).cast<MemRefType>();
+        megdnn::TensorLayout src_layout = mlir_type_to_layout(src_type),
+                             dst_layout = mlir_type_to_layout(dst_type);
+        auto dst = jit::insert_alloc_and_dealloc(dst_type, loc, rewriter);
+        //! the reduced axis of dst is indexed by 0 in the loops over src
+        auto dst_map = get_affinemap(rewriter, dst, dst_layout);
+
+        build_loop_nest(
+                rewriter, loc, dst_type, *m_range,
+                [&](OpBuilder& builder, Location loc, ValueRange ivs) {
+                    ValueBuilderHelper helper(builder, loc);
+                    builder.create<AffineStoreOp>(
+                            loc, identity(helper, mode), dst, ivs);
+                });
+        build_loop_nest(
+                rewriter, loc, src_type, *m_range,
+                [&](OpBuilder& builder, Location loc, ValueRange ivs) {
+                    ValueBuilderHelper helper(builder, loc);
+                    Value val = builder.create<AffineLoadOp>(loc, operands[0], ivs);
+                    Value acc = builder.create<AffineLoadOp>(loc, dst, dst_map, ivs);
+                    builder.create<AffineStoreOp>(
+                            loc, accumulate(helper, mode, acc, val), dst, dst_map,
+                            ivs);
+                });
+        if (mode == Mode::MEAN) {
+            float scale = static_cast<float>(dst_layout.total_nr_elems()) /
+                          src_layout.total_nr_elems();
+            build_loop_nest(
+                    rewriter, loc, dst_type, *m_range,
+                    [&](OpBuilder& builder, Location loc, ValueRange ivs) {
+                        ValueBuilderHelper helper(builder, loc);
+                        Value sum = builder.create<AffineLoadOp>(loc, dst, ivs);
+                        builder.create<AffineStoreOp>(
+                                loc, helper.mul(sum, helper.const_f32(scale)), dst,
+                                ivs);
+                    });
+        }
+
+        rewriter.replaceOp(op, dst);
+        return success();
+    }
+
+private:
+    const LoopRange* m_range;
 };
 
 struct AssignOpLowering : public ConversionPattern {
-    AssignOpLowering(MLIRContext* ctx)
-            : ConversionPattern(dialect::AssignOp::getOperationName(), 1, ctx) {}
+    AssignOpLowering(MLIRContext* ctx, const LoopRange* range)
+            : ConversionPattern(dialect::AssignOp::getOperationName(), 1, ctx),
+              m_range{range} {}
 
     LogicalResult matchAndRewrite(
             Operation* op, ArrayRef<Value> operands,
@@ -150,10 +316,8 @@ struct AssignOpLowering : public ConversionPattern {
         auto memref_type = operands[0].getType().cast<MemRefType>();
         dialect::AssignOpAdaptor assign_adaptor(operands);
 
-        llvm::SmallVector<int64_t, 4> lower_bounds(memref_type.getRank(), 0);
-        llvm::SmallVector<int64_t, 4> steps(memref_type.getRank(), 1);
-        buildAffineLoopNest(
-                rewriter, loc, lower_bounds, memref_type.getShape(), steps,
+        build_loop_nest(
+                rewriter, loc, memref_type, *m_range,
                 [&](OpBuilder& nested_builder, Location loc, ValueRange ivs) {
                     auto loaded_lhs = nested_builder.create<AffineLoadOp>(
                             loc, assign_adaptor.lhs(), ivs);
@@ -164,10 +328,14 @@ struct AssignOpLowering : public ConversionPattern {
         rewriter.eraseOp(op);
         return success();
     }
+
+private:
+    const LoopRange* m_range;
 };
 
 struct ReturnOpLowering : public OpRewritePattern<dialect::ReturnOp> {
-    using OpRewritePattern<dialect::ReturnOp>::OpRewritePattern;
+    ReturnOpLowering(MLIRContext* ctx, const LoopRange*)
+            : OpRewritePattern<dialect::ReturnOp>(ctx) {}
 
     LogicalResult matchAndRewrite(
             dialect::ReturnOp op, PatternRewriter& rewriter) const final {
@@ -178,7 +346,8 @@ struct ReturnOpLowering : public OpRewritePattern<dialect::ReturnOp> {
 };
 
 struct ConstantScalarOpLowering : public OpRewritePattern<dialect::ConstantScalarOp> {
-    using OpRewritePattern<dialect::ConstantScalarOp>::OpRewritePattern;
+    ConstantScalarOpLowering(MLIRContext* ctx, const LoopRange*)
+            : OpRewritePattern<dialect::ConstantScalarOp>(ctx) {}
 
     LogicalResult matchAndRewrite(
             dialect::ConstantScalarOp op, PatternRewriter& rewriter) const final {
@@ -203,17 +372,37 @@ public:
         // target.addLegalDialect<AffineDialect>();
         target.addIllegalDialect<MgbDialect>();
 
+        LoopRange range = get_loop_range(getFunction());
         OwningRewritePatternList patterns;
         patterns
                 .insert<ElemwiseLowering, TypeCvtLowering, DimshuffleLowering,
-                        ReturnOpLowering, AssignOpLowering, ConstantScalarOpLowering>(
-                        &getContext());
+                        ReduceLowering, ReturnOpLowering, AssignOpLowering,
+                        ConstantScalarOpLowering>(&getContext(), &range);
 
         if (failed(applyPartialConversion(
                     getFunction(), target, std::move(patterns)))) {
             signalPassFailure();
         }
     }
+
+private:
+    static LoopRange get_loop_range(FuncOp func_op) {
+        LoopRange range;
+        auto nr_args = func_op.getNumArguments();
+        if (nr_args < 2 || !func_op.getArgument(nr_args - 1).getType().isIndex())
+            return range;
+        bool found = false;
+        func_op.walk([&](dialect::AssignOp assign_op) {
+            range.dest = mlir_type_to_layout(assign_op.lhs().getType());
+            found = true;
+        });
+        if (!found || !can_split_cpu_kernel(func_op.getOperation(), range.dest))
+            return range;
+        range.axis = get_cpu_split_axis(range.dest);
+        range.begin = func_op.getArgument(nr_args - 2);
+        range.end = func_op.getArgument(nr_args - 1);
+        return range;
+    }
 };
 
 }  // namespace
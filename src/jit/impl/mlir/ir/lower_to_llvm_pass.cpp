@@ -21,6 +21,7 @@
 #include <mlir/Conversion/SCFToStandard/SCFToStandard.h>
 #include <mlir/Conversion/StandardToLLVM/ConvertStandardToLLVM.h>
 #include <mlir/Conversion/StandardToLLVM/ConvertStandardToLLVMPass.h>
+#include <mlir/Conversion/VectorToLLVM/ConvertVectorToLLVM.h>
 #include <mlir/Dialect/LLVMIR/LLVMDialect.h>
 #include <mlir/Dialect/SCF/SCF.h>
 #include <mlir/Dialect/StandardOps/Transforms/Passes.h>
@@ -47,6 +48,7 @@ public:
         OwningRewritePatternList patterns;
         populateAffineToStdConversionPatterns(patterns, &getContext());
         populateLoopToStdConversionPatterns(patterns, &getContext());
+        populateVectorToLLVMConversionPatterns(typeConverter, patterns);
         populateStdToLLVMConversionPatterns(typeConverter, patterns);
         populateExpandTanhPattern(patterns, &getContext());
 
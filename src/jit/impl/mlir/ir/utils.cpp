@@ -19,6 +19,7 @@
 
 #include "megbrain/common.h"
 #include "megbrain/exception.h"
+#include "megbrain/jit/mlir/ir/dialect.h"
 #include "megdnn/basic_types.h"
 #include "megdnn/oprs/general.h"
 
@@ -89,6 +90,36 @@ mlir::MemRefType jit::layout_to_mlir_type(
     return mlir::MemRefType::get(shape, signless(type));
 }
 
+int jit::get_cpu_split_axis(const megdnn::TensorLayout& dest) {
+    for (size_t i = 0; i < dest.ndim; ++i) {
+        if (dest[i] != 1) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool jit::can_split_cpu_kernel(mlir::Operation* op, const megdnn::TensorLayout& dest) {
+    int axis = get_cpu_split_axis(dest);
+    if (axis < 0) {
+        return false;
+    }
+    bool ret = true;
+    op->walk([&](mlir::Operation* child) {
+        if (llvm::isa<dialect::Dimshuffle>(child)) {
+            ret = false;
+        } else if (auto reduce = llvm::dyn_cast<dialect::Reduce>(child)) {
+            auto itype = reduce.input().getType().cast<mlir::MemRefType>();
+            auto otype = child->getResult(0).getType().cast<mlir::MemRefType>();
+            int idx = axis - (static_cast<int>(dest.ndim) - itype.getRank());
+            if (idx >= 0 && itype.getDimSize(idx) != otype.getDimSize(idx)) {
+                ret = false;
+            }
+        }
+    });
+    return ret;
+}
+
 #endif  // MGB_JIT && MGB_JIT_MLIR
 
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
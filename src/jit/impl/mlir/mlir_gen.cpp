@@ -78,9 +78,10 @@ private:
         for (auto&& arg : args.outputs) {
             func_args.push_back(get_type(arg.from->layout()));
         }
-        //! nr_elements
+        //! nr_elements on CUDA; on CPU the begin of the range of the split
+        //! axis to compute, see MLIRCPUExecutable
         func_args.push_back(m_builder.getIndexType());
-        //! nr_threads
+        //! nr_threads on CUDA; on CPU the end of the range of the split axis
         func_args.push_back(m_builder.getIndexType());
 
         auto func_type = m_builder.getFunctionType(func_args, llvm::None);
@@ -164,6 +165,9 @@ private:
             } else if (opr->same_type<opr::TypeCvt>()) {
                 auto&& out = gen_typecvt(opr->cast_final<opr::TypeCvt>());
                 mgb_assert(mlir::succeeded(declare(opr->output(0)->name(), out)));
+            } else if (opr->same_type<opr::Reduce>()) {
+                auto&& out = gen_reduce(opr->cast_final<opr::Reduce>());
+                mgb_assert(mlir::succeeded(declare(opr->output(0)->name(), out)));
             }
         }}.add(internal_graph.output());
         m_builder.create<dialect::AssignOp>(
@@ -220,6 +224,26 @@ private:
                 m_builder.getUnknownLoc(), res_type, get(opr.input(0)), pattern);
     }
 
+    mlir::Value gen_reduce(const opr::Reduce& opr) {
+        auto itype = get(opr.input(0)).getType().dyn_cast_or_null<mlir::MemRefType>();
+        mgb_assert(itype, "the input type of Reduce must be MemRefType");
+        auto param = opr.param();
+        int64_t axis = param.axis < 0 ? param.axis + itype.getRank() : param.axis;
+        mgb_assert(
+                opr.input().size() == 1 && axis >= 0 && axis < itype.getRank(),
+                "mlir backend only supports Reduce along an axis, got axis %d of "
+                "%" PRId64 "-dim input",
+                param.axis, itype.getRank());
+
+        auto oshape = llvm::to_vector<4>(itype.getShape());
+        oshape[axis] = 1;
+        auto res_type = mlir::MemRefType::get(oshape, itype.getElementType());
+
+        return m_builder.create<dialect::Reduce>(
+                m_builder.getUnknownLoc(), res_type, get(opr.input(0)), param.mode,
+                param.axis, param.data_type);
+    }
+
     mlir::Type get_type(const TensorLayout& layout) {
         return layout_to_mlir_type(layout, m_builder);
     }
@@ -20,6 +20,7 @@
 #include "megbrain/utils/cuda_helper.h"
 #endif
 
+#include <array>
 #include <atomic>
 
 #ifdef __linux__
@@ -29,6 +30,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <cctype>
 #include <cerrno>
 #include <cstdio>
 #include <cstdlib>
@@ -64,6 +66,24 @@ bool ExecutableHelper::keep_interm() {
     return ret;
 }
 
+namespace {
+//! host C compiler given by MGB_JIT_CC
+const char* c_compiler() {
+    auto cc = MGB_GETENV("MGB_JIT_CC");
+    return cc ? cc : "cc";
+}
+}  // anonymous namespace
+
+const std::string& ExecutableHelper::c_compile_cmd() {
+    static std::string ret = []() {
+        auto cflags = MGB_GETENV("MGB_JIT_CFLAGS");
+        return ssprintf(
+                "%s -O3 -std=c99 -fPIC -shared %s", c_compiler(),
+                cflags ? cflags : "");
+    }();
+    return ret;
+}
+
 namespace {
 
 #ifdef __linux__
@@ -74,8 +94,8 @@ class ExecutableHelperImpl final : public ExecutableHelper {
     //! workdir setting, end with /
     std::string m_workdir;
 
-    //! execute command and check if exit code is zero
-    static void check_exec(const std::string& cmd) {
+    //! execute command, check if exit code is zero and return its output
+    static std::string check_exec(const std::string& cmd) {
 #if MGB_ENABLE_DEBUG_UTIL
         debug::ScopedForkWarningSupress no_fork_warning;
 #endif
@@ -95,6 +115,58 @@ class ExecutableHelperImpl final : public ExecutableHelper {
                 ret, SystemError,
                 "command %s failed: return code=%d; captured output:\n%s", cmd.c_str(),
                 ret, out.c_str());
+        return out;
+    }
+
+    //! model name and feature flags of the first processor in /proc/cpuinfo
+    static std::string host_cpu_info() {
+        static const char* const keys[] = {
+                "vendor_id",       "model name",       "flags",       "Features",
+                "CPU implementer", "CPU architecture", "CPU variant", "CPU part"};
+        std::string name, features;
+        FILE* fptr = fopen("/proc/cpuinfo", "r");
+        if (!fptr) {
+            return "unknown";
+        }
+        std::unique_ptr<FILE, int (*)(FILE*)> fptr_close{fptr, ::fclose};
+        std::array<char, 4096> buffer;
+        std::string line;
+        while (fgets(buffer.data(), buffer.size(), fptr)) {
+            line.append(buffer.data());
+            if (line.back() != '\n' && !feof(fptr)) {
+                continue;
+            }
+            auto colon = line.find(':');
+            if (colon == std::string::npos) {
+                // an empty line ends the first processor
+                if (!name.empty() || !features.empty()) {
+                    break;
+                }
+                line.clear();
+                continue;
+            }
+            auto key = line.substr(0, line.find_last_not_of(" \t", colon - 1) + 1);
+            auto val = line.substr(line.find_first_not_of(" \t", colon + 1));
+            while (!val.empty() && isspace(static_cast<unsigned char>(val.back()))) {
+                val.pop_back();
+            }
+            for (auto i : keys) {
+                if (key == i) {
+                    // the feature list is long, so only its hash is kept
+                    if (key == "flags" || key == "Features") {
+                        features = std::to_string(
+                                XXHash{}.update(val.data(), val.size()).digest());
+                    } else {
+                        name.append(val).append(",");
+                    }
+                }
+            }
+            line.clear();
+        }
+        if (!name.empty()) {
+            name.pop_back();
+        }
+        return ssprintf("%s;cpu_features=%s", name.c_str(), features.c_str());
     }
 
 public:
@@ -216,6 +288,28 @@ public:
         check_exec(cmd);
     }
 
+    const std::string& c_compiler_signature() override {
+        static std::string ret = []() {
+            auto version = check_exec(ssprintf("%s --version", c_compiler()));
+            version = version.substr(0, version.find('\n'));
+            return ssprintf(
+                    "cmd=%s;cc=%s;cpu=%s", c_compile_cmd().c_str(), version.c_str(),
+                    host_cpu_info().c_str());
+        }();
+        return ret;
+    }
+
+    std::string compile_c_source_shared(
+            const std::string& source, const std::string& out_name) override {
+        auto src_name = out_name + ".c", lib_name = out_name + ".so";
+        write_file(src_name, source);
+        check_exec(ssprintf(
+                "%s '%s' -o '%s' -lm", c_compile_cmd().c_str(),
+                realpath(src_name).c_str(), realpath(lib_name).c_str()));
+        remove_interm(src_name);
+        return lib_name;
+    }
+
     std::string realpath(const std::string& name) override {
         mgb_assert(name.find('/') == std::string::npos);
         return m_workdir + name;
@@ -250,6 +344,25 @@ void ExecutableHelper::write_file(const std::string& name, const std::string& da
     mgb_throw_if(err, SystemError, "failed to close file: %s", strerror(errno));
 }
 
+std::string ExecutableHelper::read_file(const std::string& name) {
+    auto full_name = realpath(name);
+    FILE* fptr = fopen(full_name.c_str(), "rb");
+    mgb_throw_if(
+            !fptr, SystemError, "failed to open %s: %s", full_name.c_str(),
+            strerror(errno));
+    std::unique_ptr<FILE, int (*)(FILE*)> fptr_close{fptr, ::fclose};
+    std::string data;
+    std::array<char, 4096> buffer;
+    size_t done;
+    while ((done = fread(buffer.data(), 1, buffer.size(), fptr)) > 0) {
+        data.append(buffer.data(), done);
+    }
+    mgb_throw_if(
+            ferror(fptr), SystemError, "failed to read file %s: %s",
+            full_name.c_str(), strerror(errno));
+    return data;
+}
+
 ExecutableHelper& ::ExecutableHelper::get() {
     static ExecutableHelperImpl inst;
     return inst;
@@ -71,7 +71,7 @@ private:
 class FloatAST : public AST {
 public:
     FloatAST(float val) : m_val(val) {}
-    inline std::string code_gen() override { return ssprintf("float(%.12e)", m_val); }
+    inline std::string code_gen() override { return ssprintf("((float)%.12e)", m_val); }
 
 private:
     float m_val;
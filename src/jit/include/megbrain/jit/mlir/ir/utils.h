@@ -48,6 +48,19 @@ megdnn::TensorLayout mlir_type_to_layout(mlir::Type type);
 mlir::MemRefType layout_to_mlir_type(
         const megdnn::TensorLayout& layout, mlir::Builder& builder);
 
+/**
+ * \brief the axis of the output that the CPU kernel splits among threads,
+ * which is the outermost axis whose size is not 1, or -1 if there is none
+ */
+int get_cpu_split_axis(const megdnn::TensorLayout& dest);
+
+/**
+ * \brief whether the CPU kernel in \p op computing \p dest can be split along
+ * its split axis, which fails if a Dimshuffle moves the axes or a Reduce runs
+ * along the split axis
+ */
+bool can_split_cpu_kernel(mlir::Operation* op, const megdnn::TensorLayout& dest);
+
 }  // namespace jit
 }  // namespace mgb
 
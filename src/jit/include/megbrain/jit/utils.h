@@ -96,6 +96,18 @@ public:
     virtual void link(
             const SmallVector<std::string>& inp_names, const std::string& out_name) = 0;
 
+    /*!
+     * \brief compile C source code to a shared library with the host C
+     *      compiler given by c_compile_cmd()
+     *
+     * \param out_name output filename without suffix; it should be unique
+     *      among the libraries loaded in this process
+     *
+     * \return shared library name (without dir path)
+     */
+    virtual std::string compile_c_source_shared(
+            const std::string& source, const std::string& out_name) = 0;
+
     //! remove a file in the working dir
     virtual void remove(const std::string& name) = 0;
 
@@ -125,9 +137,31 @@ public:
     //! write content to file
     void write_file(const std::string& name, const std::string& data);
 
+    //! read content of a file in the working dir
+    std::string read_file(const std::string& name);
+
     //! whether MGB_JIT_KEEP_INTERM is set
     static bool keep_interm();
 
+    /*!
+     * \brief command used to compile C sources to shared libraries
+     *
+     * The compiler is taken from MGB_JIT_CC (default: cc) and extra flags
+     * from MGB_JIT_CFLAGS (e.g. -march=native).
+     */
+    static const std::string& c_compile_cmd();
+
+    /*!
+     * \brief identify the host C compiler and CPU that the libraries built
+     *      by compile_c_source_shared() depend on
+     *
+     * It contains c_compile_cmd(), the first line of the compiler's
+     * --version output, and the CPU model and feature flags from
+     * /proc/cpuinfo, so that cached libraries are not loaded after the
+     * compiler or the CPU changes.
+     */
+    virtual const std::string& c_compiler_signature() = 0;
+
     //! get the singleton instance
     static ExecutableHelper& get();
 };
@@ -13,10 +13,12 @@
 #include "./helper.h"
 
 #include "megbrain/jit/executor_opr.h"
+#include "megbrain/jit/utils.h"
 #include "megbrain/opr/basic_arith.h"
 #include "megbrain/opr/basic_arith_wrapper.h"
 #include "megbrain/opr/tensor_manip.h"
 #include "megbrain/test/helper.h"
+#include "megbrain/utils/timer.h"
 #include "megdnn/dtype.h"
 
 #if MGB_JIT
@@ -122,6 +124,39 @@ void run<grad>(Backend backend, CompNode cn) {
 template <>
 void run<void>(Backend, CompNode) {}
 
+void run_host_c(CompNode cn, TensorShape shp, TensorShape bshp) {
+    using AIdx = opr::Subtensor::AxisIndexer;
+    set_backend(Backend::HOST_C);
+    auto graph = ComputingGraph::make();
+    HostTensorGenerator<> gen;
+    TensorShape wide_shp = shp;
+    wide_shp[shp.ndim - 1] *= 2;
+
+    auto host_x0 = gen(shp, cn), host_x1 = gen(bshp, cn), host_x2 = gen(wide_shp, cn);
+    auto a = opr::Host2DeviceCopy::make(*graph, host_x0),
+         b = opr::Host2DeviceCopy::make(*graph, host_x1),
+         c = opr::Host2DeviceCopy::make(*graph, host_x2);
+    //! strided innermost dim
+    c = opr::Subtensor::make(
+            c, {AIdx::make_interval(shp.ndim - 1, None, None, c.make_scalar(2))});
+    ASSERT_FALSE(c.node()->owner_opr()->same_type<opr::Host2DeviceCopy>());
+
+    auto y = opr::tanh(a * b + opr::exp(c)) - opr::sigmoid(b) * 0.3f;
+    auto ig_gen = std::make_unique<InternalGraphGenerator>(y.node()->owner_opr());
+    ThinHashSet<VarNode*> endpoints{a.node(), b.node(), c.node()};
+    for (auto i : get_rev_topo_order(y, endpoints)) {
+        ig_gen->add_opr(i);
+    }
+    auto igraph = ig_gen->generate();
+    auto y_jit = JITExecutor::make(igraph, ig_gen->orig_inps());
+
+    HostTensorND host_y, host_y_jit;
+    auto func = graph->compile(
+            {make_callback_copy(y, host_y), make_callback_copy(y_jit, host_y_jit)});
+    func->execute();
+    MGB_ASSERT_TENSOR_NEAR(host_y, host_y_jit, 1e-5);
+}
+
 #if MGB_JIT_MLIR
 void run_mlir(CompNode cn) {
     set_backend(Backend::MLIR);
@@ -315,6 +350,56 @@ TYPED_TEST(TestJITNvrtcCodeGen, run) {
     run<TypeParam>(Backend::NVRTC, CompNode::load("gpu0"));
 }
 
+/* ===================== TestJITHostCCodeGen ===================== */
+
+template <typename tag>
+class TestJITHostCCodeGen : public ::testing::Test {};
+TYPED_TEST_CASE(TestJITHostCCodeGen, test_types);
+TYPED_TEST(TestJITHostCCodeGen, run) {
+    run<TypeParam>(Backend::HOST_C, CompNode::load("cpu0"));
+}
+
+TEST(TestJITHostCCodeGen, Access) {
+    auto cn = CompNode::load("cpu0");
+    run_host_c(cn, {23, 42}, {23, 1});
+    run_host_c(cn, {23, 42}, {1, 42});
+    run_host_c(cn, {5, 1, 7}, {1});
+    run_host_c(cn, {2, 3, 4, 5}, {1, 3, 1, 1});
+}
+
+TEST(TestJITHostCCodeGen, MultiThread) {
+    auto cn = CompNode::load("multithread:default:4");
+    run_host_c(cn, {23, 42}, {23, 1});
+    run_host_c(cn, {16, 64, 56, 56}, {1, 64, 1, 1});
+    run_host_c(cn, {1 << 20}, {1});
+}
+
+TEST(TestJITHostCCodeGen, PersistentCache) {
+    auto cn = CompNode::load("cpu0");
+    size_t nr_get = 0, nr_hit = 0;
+    std::string last_category;
+    PersistentCacheHook hook{[&](const std::string& category, const void*, size_t,
+                                 const void*, size_t val_size) {
+        if (category.find("jit:host_c:") == 0) {
+            ++nr_get;
+            nr_hit += val_size > 0;
+            last_category = category;
+        }
+    }};
+    //! the second graph loads the libraries compiled for the first one
+    run_host_c(cn, {23, 42}, {23, 1});
+    size_t nr_get_first = nr_get, nr_hit_first = nr_hit;
+    ASSERT_GT(nr_get_first, 0u);
+    run_host_c(cn, {23, 42}, {23, 1});
+    ASSERT_EQ(nr_get_first * 2, nr_get);
+    ASSERT_EQ(nr_hit_first + nr_get_first, nr_hit);
+    //! libraries are keyed by the compiler version and the host cpu
+    auto&& signature = ExecutableHelper::get().c_compiler_signature();
+    ASSERT_NE(std::string::npos, signature.find(";cc="));
+    ASSERT_NE(std::string::npos, signature.find(";cpu_features="));
+    ASSERT_NE(std::string::npos, last_category.find(signature));
+}
+
 /* ===================== TestJITMlirCodeGen ===================== */
 
 #if MGB_JIT_MLIR
@@ -325,6 +410,37 @@ TEST(TestJITMlirCodeGen, Basic) {
     run_mlir_different_shape(cn);
 }
 
+TEST(TestJITMlirCodeGen, PersistentCache) {
+    auto cn = CompNode::load("cpu0");
+    size_t nr_get = 0, nr_hit = 0, nr_put = 0;
+    PersistentCacheHook hook{
+            [&](const std::string& category, const void*, size_t, const void*,
+                size_t val_size) {
+                if (category.find("jit:mlir:") == 0) {
+                    //! objects of other MegEngine versions or lowering ABIs
+                    //! must not be reused
+                    ASSERT_NE(std::string::npos, category.find(";mge="));
+                    ASSERT_NE(std::string::npos, category.find(";abi="));
+                    ++nr_get;
+                    nr_hit += val_size > 0;
+                }
+            },
+            [&](const std::string& category, const void*, size_t, const void*,
+                size_t val_size) {
+                if (category.find("jit:mlir:") == 0) {
+                    ASSERT_GT(val_size, 0u);
+                    ++nr_put;
+                }
+            }};
+    //! the second graph must reuse the object code compiled for the first one
+    run_mlir(cn);
+    size_t nr_hit_first = nr_hit;
+    run_mlir(cn);
+    ASSERT_EQ(2u, nr_get);
+    ASSERT_EQ(nr_hit_first + 1, nr_hit);
+    ASSERT_EQ(2u - nr_hit, nr_put);
+}
+
 TEST(TestJITMlirCodeGen, BasicGPU) {
     REQUIRE_GPU(1);
     auto cn = CompNode::load("gpu0");
@@ -610,6 +726,63 @@ TEST(TestJITMlirDimshuffle, BasicGPU) {
     run_dimshuffle_cases(CompNode::load("gpu0"));
 }
 
+/* ===================== TestJITMlirMultiThread ===================== */
+
+//! check the split kernel against unfused elemwise and compare their time
+void run_mlir_multithread(CompNode cn, TensorShape shp, TensorShape bshp) {
+    constexpr size_t RUNS = 10;
+    set_backend(Backend::MLIR);
+    auto graph = ComputingGraph::make();
+    HostTensorGenerator<> gen;
+
+    auto host_x0 = gen(shp, cn), host_x1 = gen(bshp, cn), host_x2 = gen(shp, cn);
+    auto a = opr::Host2DeviceCopy::make(*graph, host_x0),
+         b = opr::Host2DeviceCopy::make(*graph, host_x1),
+         c = opr::Host2DeviceCopy::make(*graph, host_x2);
+    auto y = opr::Elemwise::make({a * b + c}, opr::Elemwise::Mode::RELU) - 0.3f;
+
+    auto ig_gen = std::make_unique<InternalGraphGenerator>(y.node()->owner_opr());
+    for (auto i : get_rev_topo_order(y)) {
+        if (!i->same_type<opr::Host2DeviceCopy>()) {
+            ig_gen->add_opr(i);
+        }
+    }
+    auto igraph = ig_gen->generate();
+    auto y_jit = JITExecutor::make(igraph, ig_gen->orig_inps());
+
+    HostTensorND host_y, host_y_jit;
+    auto func = graph->compile(
+            {make_callback_copy(y, host_y), make_callback_copy(y_jit, host_y_jit)});
+    func->execute();
+    MGB_ASSERT_TENSOR_EQ(host_y, host_y_jit);
+
+    auto timeit = [&](SymbolVar var) {
+        auto f = graph->compile({{var, {}}});
+        f->execute().wait();
+        RealTimer timer;
+        for (size_t i = 0; i < RUNS; ++i) {
+            f->execute();
+        }
+        f->wait();
+        return timer.get_msecs() / RUNS;
+    };
+    auto t_elemwise = timeit(y), t_jit = timeit(y_jit);
+    mgb_log("mlir jit %s: elemwise=%.3fms jit=%.3fms speedup=%.2f",
+            shp.to_string().c_str(), t_elemwise, t_jit, t_elemwise / t_jit);
+}
+
+TEST(TestJITMlirMultiThread, Basic) {
+    auto cn = CompNode::load("multithread:default:4");
+    run_mlir(cn);
+    run_mlir_broadcast(cn);
+    run_mlir_different_shape(cn);
+    run_dimshuffle_cases(cn);
+    run_mlir_multithread(cn, {1, 3, 224, 224}, {1, 3, 1, 1});
+    run_mlir_multithread(cn, {2, 2, 1, 3}, {1, 2, 1, 1});
+    run_mlir_multithread(cn, {16, 64, 56, 56}, {1, 64, 1, 1});
+    run_mlir_multithread(cn, {1, 1, 1, 1 << 20}, {1, 1, 1, 1});
+}
+
 #endif  // MGB_JIT_MLIR
 
 #endif  // MGB_JIT
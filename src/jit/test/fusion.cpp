@@ -26,6 +26,7 @@
 #include "megbrain/opr/utility.h"
 #include "megbrain/test/autocheck.h"
 #include "megbrain/test/helper.h"
+#include "megbrain/utils/timer.h"
 
 #include "../../core/impl/graph/cg_impl_seq.h"
 
@@ -1643,6 +1644,38 @@ TEST(TestJITExecutor, GradBehavior) {
     }
 }
 
+TEST(TestJITHostCFusion, ReduceAndDimshuffle) {
+    set_backend(Backend::HOST_C);
+    using ReduceMode = opr::Reduce::Param::Mode;
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("cpu0");
+    auto host_x = gen({2, 3, 8, 8}, cn), host_b = gen({1, 3, 1, 1}, cn);
+    auto run = [&](bool reduce, uint8_t jit_level) {
+        auto make_dst = [&](ComputingGraph& graph) {
+            auto x = opr::Host2DeviceCopy::make(graph, host_x),
+                 b = opr::Host2DeviceCopy::make(graph, host_b);
+            auto y = opr::relu(x + b) * (x - b);
+            if (reduce) {
+                y = opr::Reduce::make(y, {ReduceMode::SUM, 2});
+            } else {
+                y = opr::Dimshuffle::make(y, {1, 2, 3, 0});
+            }
+            return y * 2.f;
+        };
+        HostTensorND host_y1, host_y2;
+        auto funcs = make_func_pair(host_y1, host_y2, make_dst, jit_level);
+        // the host C compiler has no reduce support, so reduce is kept out
+        // of the fused oprs
+        ASSERT_EQ(reduce ? 1u : 0u, find_oprs<opr::Reduce>(*funcs.second).size());
+        ASSERT_EQ(0u, find_oprs<opr::Dimshuffle>(*funcs.second).size());
+        funcs.first->execute();
+        funcs.second->execute();
+        MGB_ASSERT_TENSOR_NEAR(host_y1, host_y2, 1e-5);
+    };
+    run(true, 2);
+    run(false, 1);
+}
+
 #if MGB_JIT_MLIR
 
 void run_mlir(CompNode cn) {
@@ -1683,6 +1716,101 @@ TEST(TestJITExecutor, TestJITMlirFusionGpu) {
     run_mlir(CompNode::load("gpu0"));
 }
 
+TEST(TestJITMlirFusion, Reduce) {
+    set_backend(Backend::MLIR);
+    using Mode = opr::Reduce::Param::Mode;
+    for (auto mode :
+         {Mode::SUM, Mode::SUM_SQR, Mode::PRODUCT, Mode::MIN, Mode::MAX, Mode::MEAN})
+        for (int axis : {0, 1, -1}) {
+            FusionChecker checker{
+                    2,
+                    [mode, axis](const SymbolVarArray& inp) -> SymbolVar {
+                        auto y = inp[0] * inp[1] + 0.5f;
+                        return opr::Reduce::make(y, {mode, axis}) * 2.f + 1.f;
+                    },
+                    CompNode::load("cpu0")};
+            checker.run({TensorShape{4, 5, 6}, {1, 5, 1}});
+            checker.run({TensorShape{7, 3, 9}, {1, 3, 1}});
+        }
+}
+
+TEST(TestJITMlirFusion, ReduceMultiThread) {
+    set_backend(Backend::MLIR);
+    using Mode = opr::Reduce::Param::Mode;
+    for (int axis : {0, 1, 2}) {
+        FusionChecker checker{
+                2,
+                [axis](const SymbolVarArray& inp) -> SymbolVar {
+                    auto y = inp[0] - inp[1];
+                    return opr::Reduce::make(y * y, {Mode::MEAN, axis});
+                },
+                CompNode::load("multithread:default:4")};
+        checker.run({TensorShape{16, 32, 64}, {16, 32, 1}});
+    }
+}
+
+TEST(TestJITMlirFusion, Dimshuffle) {
+    set_backend(Backend::MLIR);
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("cpu0");
+    auto host_x = gen({2, 3, 8, 8}, cn), host_b = gen({1, 3, 1, 1}, cn);
+    auto make_dst = [&](ComputingGraph& graph) {
+        auto x = opr::Host2DeviceCopy::make(graph, host_x),
+             b = opr::Host2DeviceCopy::make(graph, host_b);
+        auto y = opr::Dimshuffle::make(opr::relu(x + b), {1, 2, 3, 0});
+        return y * 2.f;
+    };
+    HostTensorND host_y1, host_y2;
+    auto funcs = make_func_pair(host_y1, host_y2, make_dst, 1);
+
+    ASSERT_EQ(1u, find_oprs<JITExecutor>(*funcs.second).size());
+    ASSERT_EQ(0u, find_oprs<opr::Elemwise>(*funcs.second).size());
+    ASSERT_EQ(0u, find_oprs<opr::Dimshuffle>(*funcs.second).size());
+    funcs.first->execute();
+    funcs.second->execute();
+    MGB_ASSERT_TENSOR_EQ(host_y1, host_y2);
+}
+
+TEST(TestJITMlirFusion, ReduceThroughput) {
+    set_backend(Backend::MLIR);
+    constexpr size_t RUNS = 10;
+    HostTensorGenerator<> gen;
+    auto cn = CompNode::load("multithread:default:4");
+    auto run = [&](size_t N, size_t C, size_t HW) {
+        auto host_x = gen({N, C, HW}, cn), host_mean = gen({N, C, 1}, cn);
+        //! the variance of instance norm
+        auto make_dst = [&](ComputingGraph& graph) {
+            auto x = opr::Host2DeviceCopy::make(graph, host_x),
+                 mean = opr::Host2DeviceCopy::make(graph, host_mean);
+            auto d = x - mean;
+            return opr::Reduce::make(d * d, {opr::Reduce::Param::Mode::MEAN, 2}) +
+                   1e-5f;
+        };
+        HostTensorND host_y1, host_y2;
+        auto funcs = make_func_pair(host_y1, host_y2, make_dst, 2);
+        ASSERT_EQ(0u, find_oprs<opr::Reduce>(*funcs.second).size());
+        funcs.first->execute();
+        funcs.second->execute();
+        MGB_ASSERT_TENSOR_NEAR(host_y1, host_y2, 1e-4);
+
+        auto timeit = [&](cg::AsyncExecutable* func) {
+            RealTimer timer;
+            for (size_t i = 0; i < RUNS; ++i) {
+                func->execute();
+            }
+            func->wait();
+            return timer.get_msecs() / RUNS;
+        };
+        auto t_unfused = timeit(funcs.first.get()), t_jit = timeit(funcs.second.get());
+        mgb_log("mlir reduce fusion (%zu, %zu, %zu): unfused=%.3fms jit=%.3fms "
+                "speedup=%.2f",
+                N, C, HW, t_unfused, t_jit, t_unfused / t_jit);
+    };
+    run(1, 64, 112 * 112);
+    run(8, 256, 28 * 28);
+    run(32, 512, 7 * 7);
+}
+
 #endif  // MGB_JIT_MLIR
 
 #endif  // MGB_JIT
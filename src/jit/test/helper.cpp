@@ -38,6 +38,9 @@ void jit::set_backend(Backend backend) {
         case Backend::MLIR:
             setenv("MGB_JIT_BACKEND", "MLIR", 1);
             return;
+        case Backend::HOST_C:
+            setenv("MGB_JIT_BACKEND", "HOST_C", 1);
+            return;
         default:
             mgb_assert(0);
     }
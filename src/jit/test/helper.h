@@ -15,7 +15,7 @@
 
 namespace mgb {
 namespace jit {
-enum class Backend { NONE, HALIDE, NVRTC, MLIR };
+enum class Backend { NONE, HALIDE, NVRTC, MLIR, HOST_C };
 
 void set_backend(Backend backend);
 
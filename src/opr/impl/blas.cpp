@@ -78,6 +78,16 @@ bool MatrixMul::check_layout(const TensorLayout& layout, int transpose) {
 }
 
 void MatrixMul::add_input_layout_constraint() {
+    if (param().format == Param::Format::W4_G32 ||
+        param().format == Param::Format::BSR_8X1) {
+        //! the packed operand can not be transposed; neither can the other
+        //! one, as only the given transpose mode is profiled
+        bool packed_a = param().format == Param::Format::BSR_8X1;
+        input(packed_a ? 0 : 1)->add_layout_constraint_contiguous();
+        input(packed_a ? 1 : 0)->add_layout_constraint(
+                [](const TensorLayout& ly) { return check_layout(ly, 0); });
+        return;
+    }
     auto check = [](const TensorLayout& ly) {
         return check_layout(ly, 0) || check_layout(ly, 1);
     };
@@ -105,6 +115,18 @@ size_t MatrixMul::get_workspace_size_bytes(
         dst.stride[0] = dst[1];
         param ^= 1;
     };
+    if (tparam.format == Param::Format::W4_G32 ||
+        tparam.format == Param::Format::BSR_8X1) {
+        //! inputs are never transposed, see add_input_layout_constraint()
+        megdnn_opr()->execution_policy() = {};
+        a = AlgoChooser<megdnn::MatrixMul>::setup_algo(
+                {i0, i1, out}, megdnn_opr(), this);
+        const_cast<MatrixMul*>(this)
+                ->m_cadidate_execution_policies[get_mask_from_matmul(tparam)] =
+                megdnn_opr()->execution_policy();
+        megdnn_opr()->execution_policy() = {};
+        return a;
+    }
     MGB_TRY {
         megdnn_opr()->execution_policy() = {};
         a = AlgoChooser<megdnn::MatrixMul>::setup_algo(
@@ -650,6 +650,25 @@ SymbolVar MaskPropagate::make(
     return src.insert_single_output_opr<MaskPropagate>(src.node(), param, config);
 }
 
+/* ========================== ConvPoolingForward  ========================== */
+
+MGB_DYN_TYPE_OBJ_FINAL_IMPL(ConvPoolingForward);
+
+ConvPoolingForward::ConvPoolingForward(
+        VarNode* src, VarNode* filter, VarNode* bias, const Param& param,
+        const OperatorNodeConfig& config)
+        : Super(src->owner_graph(), config, "conv_pooling", {src, filter, bias}) {
+    init_megdnn_opr(*this, param);
+    add_input({src, filter, bias});
+}
+
+SymbolVar ConvPoolingForward::make(
+        SymbolVar src, SymbolVar filter, SymbolVar bias, const Param& param,
+        const OperatorNodeConfig& config) {
+    return src.insert_single_output_opr<ConvPoolingForward>(
+            src.node(), filter.node(), bias.node(), param, config);
+}
+
 /* ==================== ConvBiasForward  ==================== */
 IMPL_CONV(ConvBiasForward);
 
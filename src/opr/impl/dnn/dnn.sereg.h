@@ -547,6 +547,7 @@ MGB_SEREG_OPR(ROIPoolingBackward, 4);
 using MaskConvolutionV2 = MaskConvolution;
 MGB_SEREG_OPR(MaskConvolutionV2, 3);
 MGB_SEREG_OPR(MaskPropagate, 1);
+MGB_SEREG_OPR(ConvPooling, 3);
 
 MGB_SEREG_OPR(Convolution3D, 0);
 MGB_SEREG_OPR(Convolution3DBackwardData, 0);
@@ -626,4 +626,31 @@ SymbolVar DctChannelSelectForward::make(
 
 MEGDNN_OPR_INIT1(DctChannelSelectForward, "dct_channel_select")
 
+/* ======================= ImagePreprocessForward ======================= */
+
+MGB_DYN_TYPE_OBJ_FINAL_IMPL(ImagePreprocessForward);
+
+ImagePreprocessForward::ImagePreprocessForward(
+        VarNode* src, VarNode* scale, VarNode* bias, const Param& param,
+        const OperatorNodeConfig& config)
+        : Super(src->owner_graph(), config, "image_preprocess", {src, scale, bias}) {
+    init_megdnn_opr(*this, param);
+    add_input({src, scale, bias});
+}
+
+SymbolVar ImagePreprocessForward::make(
+        SymbolVar src, SymbolVar scale, SymbolVar bias, const Param& param,
+        const OperatorNodeConfig& config) {
+    return src.insert_single_output_opr<ImagePreprocessForward>(
+            src.node(), scale.node(), bias.node(), param, config);
+}
+
+void ImagePreprocessForward::init_output_dtype() {
+    if (config().output_dtype().valid()) {
+        output(0)->dtype(config().output_dtype());
+    } else {
+        output(0)->dtype(dtype::Float32());
+    }
+}
+
 // vim: syntax=cpp.doxygen foldmethod=marker foldmarker=f{{{,f}}}
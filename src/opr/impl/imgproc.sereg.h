@@ -182,6 +182,8 @@ MGB_SEREG_OPR(ResizeV2, 2);
 
 using DctChannelSelectV1 = opr::DctChannelSelect;
 MGB_SEREG_OPR(DctChannelSelectV1, 0);
+
+MGB_SEREG_OPR(ImagePreprocess, 3);
 }  // namespace opr
 
 }  // namespace mgb
@@ -1307,12 +1307,35 @@ void Concat::scn_do_execute() {
             real_axis += in.shape().ndim;
         end = begin + in.shape().shape[real_axis];
         if (!in.layout().is_empty()) {
-            out.sub(Slice(begin, end).apply(out.layout(), real_axis))
-                    .copy_from_fixlayout(in);
+            auto sub = out.sub(Slice(begin, end).apply(out.layout(), real_axis));
+            // the input may have been written in place by mem_plan_fwd_out2in
+            if (sub.raw_ptr() != in.raw_ptr()) {
+                sub.copy_from_fixlayout(in);
+            }
         }
     }
 }
 
+void Concat::mem_plan_fwd_out2in() {
+    auto out = output(0);
+    auto real_axis = m_axis;
+    if (real_axis < 0)
+        real_axis += out->shape().ndim;
+    ThinHashSet<VarNode*> visited;
+    size_t end = 0;
+    for (auto i : input()) {
+        auto begin = end;
+        end = begin + i->shape().shape[real_axis];
+        // an input appearing more than once can only live in one place; the
+        // forwarding fails by itself if the sub tensor is not contiguous
+        if (begin == end || !visited.insert(i).second)
+            continue;
+        bool succ = i->set_fwd_out2in(
+                out, Slice(begin, end).apply(out->layout(), real_axis));
+        MGB_MARK_USED_VAR(succ);
+    }
+}
+
 Concat::NodeProp* Concat::do_make_node_prop() const {
     auto rst = Super::do_make_node_prop();
     rst->add_flag(NodeProp::Flag::CROSS_COMP_NODE_MEMORY);
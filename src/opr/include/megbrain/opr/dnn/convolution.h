@@ -266,6 +266,26 @@ public:
             SymbolVar src, const Param& param, const OperatorNodeConfig& config = {});
 };
 
+/*!
+ * \brief conv + per-channel bias + nonlinearity + pooling in one opr
+ *
+ * The conv output is consumed by the pooling while it is still in cache and
+ * is never materialized on CPU; usually created by the FuseConvBiasPooling
+ * gopt pass rather than by hand.
+ */
+MGB_DEFINE_OPR_CLASS_WITH_EXPORT(
+        ConvPoolingForward, intl::MegDNNOprWrapperFwd<megdnn::ConvPoolingForward>) // {
+public:
+    MGE_WIN_DECLSPEC_FUC ConvPoolingForward(
+            VarNode* src, VarNode* filter, VarNode* bias, const Param& param,
+            const OperatorNodeConfig& config);
+
+    MGE_WIN_DECLSPEC_FUC static SymbolVar make(
+            SymbolVar src, SymbolVar filter, SymbolVar bias, const Param& param,
+            const OperatorNodeConfig& config = {});
+};
+using ConvPooling = ConvPoolingForward;
+
 MGB_DEFINE_OPR_CLASS_WITH_EXPORT(
         Convolution3DForward, intl::MegDNNOprWrapperFwd<megdnn::Convolution3DForward>,
         public mixin::AlgoChooserHelper) // {
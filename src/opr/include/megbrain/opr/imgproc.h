@@ -303,6 +303,33 @@ public:
 
 using DctChannelSelect = DctChannelSelectForward;
 
+/*!
+ * \brief resize, swap channels and normalize NHWC uint8 images in one pass
+ *
+ * Input src shape: batch, height, width, channel; scale and bias are float32
+ * vectors of length channel. The output is NCHW or NCHW88 float32, or
+ * QuantizedS8 if given by the output dtype in \p config.
+ *
+ * Usually created by gopt::FuseImagePreprocessPass from a chain of Resize,
+ * CvtColor, TypeCvt, Dimshuffle and Elemwise rather than by hand.
+ */
+MGB_DEFINE_OPR_CLASS(
+        ImagePreprocessForward,
+        intl::MegDNNOprWrapperFwd<megdnn::ImagePreprocessForward>) // {
+public:
+    ImagePreprocessForward(
+            VarNode* src, VarNode* scale, VarNode* bias, const Param& param,
+            const OperatorNodeConfig& config);
+
+    MGE_WIN_DECLSPEC_FUC static SymbolVar make(
+            SymbolVar src, SymbolVar scale, SymbolVar bias, const Param& param = {},
+            const OperatorNodeConfig& config = {});
+
+private:
+    void init_output_dtype() override;
+};
+using ImagePreprocess = ImagePreprocessForward;
+
 }  // namespace opr
 }  // namespace mgb
 
@@ -1446,6 +1446,49 @@ TEST(TestTensorManip, ConcatEmpty2) {
     ASSERT_EQ(TensorShape({2, 0, 11}), host_z.shape());
 }
 
+TEST(TestTensorManip, ConcatMemFwdOut2In) {
+    HostTensorGenerator<> gen;
+    auto run = [&](size_t n) {
+        auto host_x = gen({n, 3, 4, 5}), host_y = gen({n, 2, 4, 5});
+        auto graph = ComputingGraph::make();
+        graph->options().graph_opt_level = 0;
+        graph->options().seq_opt.enable_mem_fwd_out2in = true;
+        auto x = opr::Host2DeviceCopy::make(*graph, host_x),
+             y = opr::Host2DeviceCopy::make(*graph, host_y),
+             a = x + 1.f, b = opr::exp(a), c = y * 2.f,
+             // densenet style: a is read both by b and by the concat
+             z0 = opr::Concat::make({a, b}, 1), z1 = opr::Concat::make({z0, c}, 1);
+        HostTensorND host_a, host_b, host_c, host_z1;
+        auto func = graph->compile(
+                {make_callback_copy(a, host_a), make_callback_copy(b, host_b),
+                 make_callback_copy(c, host_c), make_callback_copy(z1, host_z1)});
+        func->execute();
+
+        HostTensorND expect{host_x->comp_node(), {n, 8, 4, 5}, dtype::Float32()};
+        auto pe = expect.ptr<float>();
+        for (size_t i = 0; i < n; ++i) {
+            for (auto&& t : {&host_a, &host_b, &host_c}) {
+                size_t size = t->shape(1) * 20;
+                memcpy(pe, t->ptr<float>() + i * size, size * sizeof(float));
+                pe += size;
+            }
+        }
+        MGB_ASSERT_TENSOR_EQ(expect, host_z1);
+
+        auto z_ptr = static_cast<const uint8_t*>(prev_dev_ptr(z1));
+        bool fwd = z_ptr == prev_dev_ptr(a);
+        // only batch 1 makes the channel slices contiguous
+        ASSERT_EQ(n == 1, fwd);
+        if (fwd) {
+            ASSERT_EQ(z_ptr, prev_dev_ptr(z0));
+            ASSERT_EQ(z_ptr + 3 * 20 * sizeof(float), prev_dev_ptr(b));
+            ASSERT_EQ(z_ptr + 6 * 20 * sizeof(float), prev_dev_ptr(c));
+        }
+    };
+    run(1);
+    run(2);
+}
+
 TEST(TestTensorManip, AxisAddRemove) {
     HostTensorGenerator<> gen;
     for (bool dyn_shape : {false, true}) {